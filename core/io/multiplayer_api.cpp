@@ -32,6 +32,7 @@
 
 #include "core/debugger/engine_debugger.h"
 #include "core/io/marshalls.h"
+#include "core/io/multiplayer_sync_encoding.h"
 #include "scene/main/node.h"
 
 #include <stdint.h>
@@ -103,6 +104,9 @@ void MultiplayerAPI::poll() {
 		return;
 	}
 
+	// Queue what was sent since the last flush, before the peer sends it out.
+	flush_batches();
+
 	network_peer->poll();
 
 	if (!network_peer.is_valid()) { // It's possible that polling might have resulted in a disconnection, so check here.
@@ -136,6 +140,12 @@ void MultiplayerAPI::clear() {
 	path_send_cache.clear();
 	packet_cache.clear();
 	last_send_cache_id = 1;
+	sync_peers.clear();
+	sync_sequence = 0;
+	for (int i = 0; i <= NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE; i++) {
+		batches[i].clear();
+		batches_used[i] = 0;
+	}
 }
 
 void MultiplayerAPI::set_root_node(Node *p_node) {
@@ -310,6 +320,18 @@ void MultiplayerAPI::_process_packet(int p_from, const uint8_t *p_packet, int p_
 		case NETWORK_COMMAND_RAW: {
 			_process_raw(p_from, p_packet, p_packet_len);
 		} break;
+
+		case NETWORK_COMMAND_SYNC: {
+			_process_sync(p_from, p_packet, p_packet_len);
+		} break;
+
+		case NETWORK_COMMAND_SYNC_ACK: {
+			_process_sync_ack(p_from, p_packet, p_packet_len);
+		} break;
+
+		case NETWORK_COMMAND_BATCH: {
+			_process_batch(p_from, p_packet, p_packet_len);
+		} break;
 	}
 }
 
@@ -504,9 +526,7 @@ void MultiplayerAPI::_process_simplify_path(int p_from, const uint8_t *p_packet,
 	packet.write[1] = valid_rpc_checksum;
 	encode_cstring(pname.get_data(), &packet.write[2]);
 
-	network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
-	network_peer->set_target_peer(p_from);
-	network_peer->put_packet(packet.ptr(), packet.size());
+	_put_packet(p_from, NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE, packet.ptr(), packet.size());
 }
 
 void MultiplayerAPI::_process_confirm_path(int p_from, const uint8_t *p_packet, int p_packet_len) {
@@ -582,9 +602,7 @@ bool MultiplayerAPI::_send_confirm_path(Node *p_node, NodePath p_path, PathSentC
 		ofs += encode_cstring(path.get_data(), &packet.write[ofs]);
 
 		for (List<int>::Element *E = peers_to_add.front(); E; E = E->next()) {
-			network_peer->set_target_peer(E->get()); // To all of you.
-			network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
-			network_peer->put_packet(packet.ptr(), packet.size());
+			_put_packet(E->get(), NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE, packet.ptr(), packet.size()); // To all of you.
 
 			psc->confirmed_peers.insert(E->get(), false); // Insert into confirmed, but as false since it was not confirmed.
 		}
@@ -605,6 +623,60 @@ bool MultiplayerAPI::_send_confirm_path(Node *p_node, NodePath p_path, PathSentC
 #define ENCODE_16 1 << 5
 #define ENCODE_32 2 << 5
 #define ENCODE_64 3 << 5
+
+// Small typed values are written without the generic `encode_variant` header.
+// Reals use ENCODE_32 or ENCODE_64 depending on the precision, strings use the
+// mode for the size of their length.
+static _FORCE_INLINE_ int _encode_real(real_t p_real, uint8_t *r_buffer) {
+#ifdef REAL_T_IS_DOUBLE
+	return r_buffer ? encode_double(p_real, r_buffer) : 8;
+#else
+	return r_buffer ? encode_float(p_real, r_buffer) : 4;
+#endif
+}
+
+static _FORCE_INLINE_ real_t _decode_real(const uint8_t *p_buffer, uint8_t p_encode_mode) {
+	return p_encode_mode == (ENCODE_64) ? decode_double(p_buffer) : decode_float(p_buffer);
+}
+
+// Same as `String::utf8`, but writes in place so no temporary is needed.
+static int _encode_utf8(const String &p_string, uint8_t *r_buffer) {
+	const char32_t *d = p_string.ptr();
+	int len = 0;
+	for (int i = 0; i < p_string.length(); i++) {
+		uint32_t c = d[i];
+		ERR_FAIL_COND_V_MSG(c > 0x0010ffff || (c >= 0xd800 && c <= 0xdfff), -1, "Unicode parsing error: Invalid unicode codepoint " + String::num_int64(c, 16) + ".");
+		if (c <= 0x7f) {
+			if (r_buffer) {
+				r_buffer[len] = c;
+			}
+			len += 1;
+		} else if (c <= 0x7ff) {
+			if (r_buffer) {
+				r_buffer[len] = 0xc0 | ((c >> 6) & 0x1f);
+				r_buffer[len + 1] = 0x80 | (c & 0x3f);
+			}
+			len += 2;
+		} else if (c <= 0xffff) {
+			if (r_buffer) {
+				r_buffer[len] = 0xe0 | ((c >> 12) & 0x0f);
+				r_buffer[len + 1] = 0x80 | ((c >> 6) & 0x3f);
+				r_buffer[len + 2] = 0x80 | (c & 0x3f);
+			}
+			len += 3;
+		} else {
+			if (r_buffer) {
+				r_buffer[len] = 0xf0 | ((c >> 18) & 0x07);
+				r_buffer[len + 1] = 0x80 | ((c >> 12) & 0x3f);
+				r_buffer[len + 2] = 0x80 | ((c >> 6) & 0x3f);
+				r_buffer[len + 3] = 0x80 | (c & 0x3f);
+			}
+			len += 4;
+		}
+	}
+	return len;
+}
+
 Error MultiplayerAPI::_encode_and_compress_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len) {
 	// Unreachable because `VARIANT_MAX` == 27 and `ENCODE_VARIANT_MASK` == 31
 	CRASH_COND(p_variant.get_type() > VARIANT_META_TYPE_MASK);
@@ -664,6 +736,75 @@ Error MultiplayerAPI::_encode_and_compress_variant(const Variant &p_variant, uin
 				buf[0] = encode_mode | p_variant.get_type();
 			}
 		} break;
+		case Variant::FLOAT: {
+			double val = p_variant;
+			// Use 32 bits when no precision is lost.
+			if ((double)(float)val == val) {
+				encode_mode = ENCODE_32;
+				if (buf) {
+					encode_float(val, buf + 1);
+				}
+				r_len += 1 + 4;
+			} else {
+				encode_mode = ENCODE_64;
+				if (buf) {
+					encode_double(val, buf + 1);
+				}
+				r_len += 1 + 8;
+			}
+			if (buf) {
+				buf[0] = encode_mode | p_variant.get_type();
+			}
+		} break;
+		case Variant::VECTOR2: {
+			Vector2 val = p_variant;
+			encode_mode = sizeof(real_t) == 8 ? ENCODE_64 : ENCODE_32;
+			r_len += 1;
+			r_len += _encode_real(val.x, buf ? buf + r_len : nullptr);
+			r_len += _encode_real(val.y, buf ? buf + r_len : nullptr);
+			if (buf) {
+				buf[0] = encode_mode | p_variant.get_type();
+			}
+		} break;
+		case Variant::VECTOR3: {
+			Vector3 val = p_variant;
+			encode_mode = sizeof(real_t) == 8 ? ENCODE_64 : ENCODE_32;
+			r_len += 1;
+			r_len += _encode_real(val.x, buf ? buf + r_len : nullptr);
+			r_len += _encode_real(val.y, buf ? buf + r_len : nullptr);
+			r_len += _encode_real(val.z, buf ? buf + r_len : nullptr);
+			if (buf) {
+				buf[0] = encode_mode | p_variant.get_type();
+			}
+		} break;
+		case Variant::STRING: {
+			const String val = p_variant;
+			int len = _encode_utf8(val, nullptr);
+			ERR_FAIL_COND_V(len < 0, ERR_INVALID_DATA);
+			int len_size;
+			if (len <= UINT8_MAX) {
+				encode_mode = ENCODE_8;
+				len_size = 1;
+			} else if (len <= UINT16_MAX) {
+				encode_mode = ENCODE_16;
+				len_size = 2;
+			} else {
+				encode_mode = ENCODE_32;
+				len_size = 4;
+			}
+			if (buf) {
+				buf[0] = encode_mode | p_variant.get_type();
+				if (len_size == 1) {
+					buf[1] = len;
+				} else if (len_size == 2) {
+					encode_uint16(len, buf + 1);
+				} else {
+					encode_uint32(len, buf + 1);
+				}
+				_encode_utf8(val, buf + 1 + len_size);
+			}
+			r_len += 1 + len_size + len;
+		} break;
 		default:
 			// Any other case is not yet compressed.
 			Error err = encode_variant(p_variant, r_buffer, r_len, allow_object_decoding);
@@ -738,6 +879,64 @@ Error MultiplayerAPI::_decode_and_decompress_variant(Variant &r_variant, const u
 				}
 			}
 		} break;
+		case Variant::FLOAT: {
+			buf += 1;
+			len -= 1;
+			if (encode_mode == ENCODE_64) {
+				ERR_FAIL_COND_V(len < 8, ERR_INVALID_DATA);
+				r_variant = decode_double(buf);
+			} else {
+				ERR_FAIL_COND_V(len < 4, ERR_INVALID_DATA);
+				r_variant = decode_float(buf);
+			}
+			if (r_len) {
+				*r_len = encode_mode == ENCODE_64 ? 9 : 5;
+			}
+		} break;
+		case Variant::VECTOR2:
+		case Variant::VECTOR3: {
+			const int components = type == Variant::VECTOR2 ? 2 : 3;
+			const int size = encode_mode == ENCODE_64 ? 8 : 4;
+			ERR_FAIL_COND_V(len < 1 + components * size, ERR_INVALID_DATA);
+			real_t c[3];
+			for (int i = 0; i < components; i++) {
+				c[i] = _decode_real(buf + 1 + i * size, encode_mode);
+			}
+			if (type == Variant::VECTOR2) {
+				r_variant = Vector2(c[0], c[1]);
+			} else {
+				r_variant = Vector3(c[0], c[1], c[2]);
+			}
+			if (r_len) {
+				*r_len = 1 + components * size;
+			}
+		} break;
+		case Variant::STRING: {
+			buf += 1;
+			len -= 1;
+			int len_size;
+			uint32_t str_len;
+			if (encode_mode == ENCODE_8) {
+				ERR_FAIL_COND_V(len < 1, ERR_INVALID_DATA);
+				len_size = 1;
+				str_len = buf[0];
+			} else if (encode_mode == ENCODE_16) {
+				ERR_FAIL_COND_V(len < 2, ERR_INVALID_DATA);
+				len_size = 2;
+				str_len = decode_uint16(buf);
+			} else {
+				ERR_FAIL_COND_V(len < 4, ERR_INVALID_DATA);
+				len_size = 4;
+				str_len = decode_uint32(buf);
+			}
+			ERR_FAIL_COND_V(str_len > uint32_t(len - len_size), ERR_INVALID_DATA);
+			String val;
+			val.parse_utf8((const char *)buf + len_size, str_len);
+			r_variant = val;
+			if (r_len) {
+				*r_len = 1 + len_size + str_len;
+			}
+		} break;
 		default:
 			Error err = decode_variant(r_variant, p_buffer, p_len, r_len, allow_object_decoding);
 			if (err != OK) {
@@ -922,13 +1121,11 @@ void MultiplayerAPI::_send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p
 	_profile_bandwidth_data("out", ofs);
 #endif
 
-	// Take chance and set transfer mode, since all send methods will use it.
-	network_peer->set_transfer_mode(p_unreliable ? NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE : NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
+	const NetworkedMultiplayerPeer::TransferMode transfer_mode = p_unreliable ? NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE : NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE;
 
 	if (has_all_peers) {
 		// They all have verified paths, so send fast.
-		network_peer->set_target_peer(p_to); // To all of you.
-		network_peer->put_packet(packet_cache.ptr(), ofs); // A message with love.
+		_put_packet(p_to, transfer_mode, packet_cache.ptr(), ofs); // A message with love.
 	} else {
 		// Unreachable because the node ID is never compressed if the peers doesn't know it.
 		CRASH_COND(node_id_compression != NETWORK_NODE_ID_COMPRESSION_32);
@@ -953,16 +1150,15 @@ void MultiplayerAPI::_send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p
 			Map<int, bool>::Element *F = psc->confirmed_peers.find(E->get());
 			ERR_CONTINUE(!F); // Should never happen.
 
-			network_peer->set_target_peer(E->get()); // To this one specifically.
-
+			// To this one specifically.
 			if (F->get()) {
 				// This one confirmed path, so use id.
 				encode_uint32(psc->id, &(packet_cache.write[1]));
-				network_peer->put_packet(packet_cache.ptr(), ofs);
+				_put_packet(E->get(), transfer_mode, packet_cache.ptr(), ofs);
 			} else {
 				// This one did not confirm path yet, so use entire path (sorry!).
 				encode_uint32(0x80000000 | ofs, &(packet_cache.write[1])); // Offset to path and flag.
-				network_peer->put_packet(packet_cache.ptr(), ofs + path_len);
+				_put_packet(E->get(), transfer_mode, packet_cache.ptr(), ofs + path_len);
 			}
 		}
 	}
@@ -978,6 +1174,16 @@ void MultiplayerAPI::_del_peer(int p_id) {
 	connected_peers.erase(p_id);
 	// Cleanup get cache.
 	path_get_cache.erase(p_id);
+	sync_peers.erase(p_id);
+	// Drop what is still queued for it.
+	for (int i = 0; i <= NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE; i++) {
+		for (uint32_t j = 0; j < batches_used[i]; j++) {
+			if (batches[i][j].target == p_id) {
+				batches[i][j].count = 0;
+				batches[i][j].data.clear();
+			}
+		}
+	}
 	// Cleanup sent cache.
 	// Some refactoring is needed to make this faster and do paths GC.
 	List<NodePath> keys;
@@ -1141,10 +1347,166 @@ Error MultiplayerAPI::send_bytes(Vector<uint8_t> p_data, int p_to, NetworkedMult
 	packet_cache.write[0] = NETWORK_COMMAND_RAW;
 	memcpy(&packet_cache.write[1], &r[0], p_data.size());
 
-	network_peer->set_target_peer(p_to);
+	// Raw packets are not batched, so the caller gets the error from the network peer.
+	return _put_packet(p_to, p_mode, packet_cache.ptr(), p_data.size() + 1, false);
+}
+
+// Outgoing packets are queued in per target batches, and sent as one packet
+// each when flushed. Packets with overlapping targets are never reordered:
+// a packet can only be added to an earlier batch if no batch after it
+// reaches any of the same peers.
+static bool _batch_targets_overlap(int p_a, int p_b) {
+	if (p_a > 0 && p_b > 0) {
+		return p_a == p_b;
+	}
+	if (p_a > 0 && p_b < 0) {
+		return p_a != -p_b;
+	}
+	if (p_a < 0 && p_b > 0) {
+		return p_b != -p_a;
+	}
+	return true;
+}
+
+static int _batch_put_size(uint32_t p_value, uint8_t *r_data) {
+	int len = 0;
+	do {
+		uint8_t byte = p_value & 0x7F;
+		p_value >>= 7;
+		if (p_value) {
+			byte |= 0x80;
+		}
+		if (r_data) {
+			r_data[len] = byte;
+		}
+		len++;
+	} while (p_value);
+	return len;
+}
+
+static int _batch_get_size(const uint8_t *p_data, int p_len, uint32_t &r_value) {
+	r_value = 0;
+	for (int i = 0; i < p_len && i < 5; i++) {
+		r_value |= uint32_t(p_data[i] & 0x7F) << (i * 7);
+		if (!(p_data[i] & 0x80)) {
+			return i + 1;
+		}
+	}
+	return 0;
+}
+
+// Batched packets are only sent by flush_batches(), which reports their errors.
+Error MultiplayerAPI::_put_packet(int p_to, NetworkedMultiplayerPeer::TransferMode p_mode, const uint8_t *p_packet, int p_packet_len, bool p_can_batch) {
+	ERR_FAIL_INDEX_V(p_mode, NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE + 1, ERR_INVALID_PARAMETER);
+
+	const int size_len = _batch_put_size(p_packet_len, nullptr);
+	if (!p_can_batch || !batching_enabled || 1 + size_len + p_packet_len > BATCH_MAX_SIZE) {
+		// Send it right away, after what was queued before it.
+		Error err = OK;
+		for (uint32_t i = 0; i < batches_used[p_mode]; i++) {
+			Error batch_err = _send_batch(p_mode, batches[p_mode][i]);
+			if (err == OK) {
+				err = batch_err;
+			}
+		}
+		batches_used[p_mode] = 0;
+		network_peer->set_target_peer(p_to);
+		network_peer->set_transfer_mode(p_mode);
+		Error packet_err = network_peer->put_packet(p_packet, p_packet_len);
+		return packet_err != OK ? packet_err : err;
+	}
+
+	LocalVector<PacketBatch> &mode_batches = batches[p_mode];
+	PacketBatch *batch = nullptr;
+	for (int i = batches_used[p_mode] - 1; i >= 0; i--) {
+		PacketBatch &b = mode_batches[i];
+		if (b.count && b.target == p_to && b.data.size() + size_len + p_packet_len <= BATCH_MAX_SIZE) {
+			batch = &b;
+			break;
+		}
+		if (b.count && _batch_targets_overlap(b.target, p_to)) {
+			break;
+		}
+	}
+
+	if (!batch) {
+		if (batches_used[p_mode] == mode_batches.size()) {
+			mode_batches.push_back(PacketBatch());
+		}
+		batch = &mode_batches[batches_used[p_mode]++];
+		batch->target = p_to;
+		batch->count = 0;
+		batch->data.clear();
+		batch->data.push_back(NETWORK_COMMAND_BATCH);
+	}
+
+	// Each packet is prefixed with its size.
+	const uint32_t ofs = batch->data.size();
+	batch->data.resize(ofs + size_len + p_packet_len);
+	_batch_put_size(p_packet_len, &batch->data[ofs]);
+	memcpy(&batch->data[ofs + size_len], p_packet, p_packet_len);
+	batch->count++;
+	return OK;
+}
+
+Error MultiplayerAPI::_send_batch(NetworkedMultiplayerPeer::TransferMode p_mode, PacketBatch &p_batch) {
+	if (p_batch.count == 0) {
+		return OK;
+	}
+
+	network_peer->set_target_peer(p_batch.target);
 	network_peer->set_transfer_mode(p_mode);
+	Error err;
+	if (p_batch.count == 1) {
+		// Nothing to batch with, send the packet alone.
+		uint32_t len;
+		int size_len = _batch_get_size(&p_batch.data[1], p_batch.data.size() - 1, len);
+		err = network_peer->put_packet(&p_batch.data[1 + size_len], len);
+	} else {
+		err = network_peer->put_packet(p_batch.data.ptr(), p_batch.data.size());
+	}
+
+	p_batch.count = 0;
+	p_batch.data.clear(); // Keeps the memory for the next batch.
+	return err;
+}
+
+Error MultiplayerAPI::flush_batches() {
+	if (!network_peer.is_valid()) {
+		return OK;
+	}
+
+	// Every batch is sent even if one fails, the first error is returned.
+	Error err = OK;
+	for (int i = 0; i <= NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE; i++) {
+		for (uint32_t j = 0; j < batches_used[i]; j++) {
+			Error batch_err = _send_batch((NetworkedMultiplayerPeer::TransferMode)i, batches[i][j]);
+			if (err == OK) {
+				err = batch_err;
+			}
+		}
+		batches_used[i] = 0;
+	}
+	return err;
+}
+
+void MultiplayerAPI::_process_batch(int p_from, const uint8_t *p_packet, int p_packet_len) {
+	int ofs = 1;
+	while (ofs < p_packet_len) {
+		uint32_t len;
+		const int size_len = _batch_get_size(&p_packet[ofs], p_packet_len - ofs, len);
+		ERR_FAIL_COND_MSG(size_len == 0, "Invalid packet received. Unable to decode batched packet size.");
+		ofs += size_len;
+		ERR_FAIL_COND_MSG(len < 1 || len > uint32_t(p_packet_len - ofs), "Invalid packet received. Batched packet size is too big.");
+		ERR_FAIL_COND_MSG((p_packet[ofs] & 7) == NETWORK_COMMAND_BATCH, "Invalid packet received. Batches can't be nested.");
+
+		_process_packet(p_from, &p_packet[ofs], len);
+		ofs += len;
 
-	return network_peer->put_packet(packet_cache.ptr(), p_data.size() + 1);
+		if (!network_peer.is_valid()) {
+			break; // A packet or RPC caused a disconnection.
+		}
+	}
 }
 
 void MultiplayerAPI::_process_raw(int p_from, const uint8_t *p_packet, int p_packet_len) {
@@ -1200,6 +1562,339 @@ bool MultiplayerAPI::is_object_decoding_allowed() const {
 	return allow_object_decoding;
 }
 
+void MultiplayerAPI::set_batching_enabled(bool p_enabled) {
+	if (!p_enabled) {
+		flush_batches();
+	}
+	batching_enabled = p_enabled;
+}
+
+bool MultiplayerAPI::is_batching_enabled() const {
+	return batching_enabled;
+}
+
+// State replication.
+// Each call to `sync_send` is a tick with its own sequence number. For every
+// peer, the state of each visible node is encoded as a delta from the last
+// state that peer acknowledged (its baseline), so both sides can rebuild the
+// full state even when packets are lost or reordered. Values are bit packed,
+// numbers are sent as variable length deltas and can be quantized.
+
+void MultiplayerAPI::sync_add_property(Node *p_node, const StringName &p_property, real_t p_quantization) {
+	ERR_FAIL_NULL(p_node);
+	ERR_FAIL_COND_MSG(p_quantization < 0, "Quantization step can't be negative.");
+
+	SyncNode &sync = sync_nodes[p_node->get_instance_id()];
+	for (int i = 0; i < sync.properties.size(); i++) {
+		if (sync.properties[i].name == p_property) {
+			sync.properties.write[i].quantization = p_quantization;
+			return;
+		}
+	}
+	ERR_FAIL_COND_MSG(sync.properties.size() >= SYNC_MAX_PROPERTIES, "Too many replicated properties on node: " + p_node->get_path() + ".");
+
+	SyncProperty property;
+	property.name = p_property;
+	property.quantization = p_quantization;
+	sync.properties.push_back(property);
+
+	// The layout changed, so previous states can't be used as baselines anymore.
+	for (Map<int, SyncPeer>::Element *E = sync_peers.front(); E; E = E->next()) {
+		E->get().baselines.erase(p_node->get_instance_id());
+	}
+}
+
+void MultiplayerAPI::sync_remove_node(Node *p_node) {
+	ERR_FAIL_NULL(p_node);
+	const ObjectID id = p_node->get_instance_id();
+	sync_nodes.erase(id);
+	for (Map<int, SyncPeer>::Element *E = sync_peers.front(); E; E = E->next()) {
+		E->get().baselines.erase(id);
+	}
+}
+
+void MultiplayerAPI::sync_set_visibility(Node *p_node, int p_peer_id, bool p_visible) {
+	ERR_FAIL_NULL(p_node);
+	Map<ObjectID, SyncNode>::Element *E = sync_nodes.find(p_node->get_instance_id());
+	ERR_FAIL_COND_MSG(!E, "Node is not replicated: " + p_node->get_path() + ".");
+
+	if (p_peer_id == 0) {
+		E->get().visible = p_visible;
+		E->get().peer_visibility.clear();
+	} else {
+		E->get().peer_visibility[p_peer_id] = p_visible;
+	}
+}
+
+bool MultiplayerAPI::sync_is_visible(Node *p_node, int p_peer_id) const {
+	ERR_FAIL_NULL_V(p_node, false);
+	const Map<ObjectID, SyncNode>::Element *E = sync_nodes.find(p_node->get_instance_id());
+	ERR_FAIL_COND_V_MSG(!E, false, "Node is not replicated: " + p_node->get_path() + ".");
+
+	const Map<int, bool>::Element *F = E->get().peer_visibility.find(p_peer_id);
+	return F ? F->get() : E->get().visible;
+}
+
+void MultiplayerAPI::sync_send() {
+	ERR_FAIL_COND_MSG(!network_peer.is_valid(), "Trying to send state while no network peer is active.");
+	ERR_FAIL_COND_MSG(network_peer->get_connection_status() != NetworkedMultiplayerPeer::CONNECTION_CONNECTED, "Trying to send state via a network peer which is not connected.");
+	ERR_FAIL_COND_MSG(root_node == nullptr, "Multiplayer root node was not initialized.");
+
+	sync_sequence++;
+
+	// Read the state once, it is shared by all peers.
+	sync_gather.clear();
+	List<ObjectID> freed;
+	for (Map<ObjectID, SyncNode>::Element *E = sync_nodes.front(); E; E = E->next()) {
+		Node *node = Object::cast_to<Node>(ObjectDB::get_instance(E->key()));
+		if (!node) {
+			freed.push_back(E->key());
+			continue;
+		}
+		if (!node->is_inside_tree() || !node->is_network_master()) {
+			continue;
+		}
+
+		SyncGather gather;
+		gather.node = node;
+		gather.sync = &E->get();
+		gather.path = root_node->get_path().rel_path_to(node->get_path());
+		gather.psc = path_send_cache.getptr(gather.path);
+		if (!gather.psc) {
+			path_send_cache[gather.path] = PathSentCache();
+			gather.psc = path_send_cache.getptr(gather.path);
+			gather.psc->id = last_send_cache_id++;
+		}
+
+		const Vector<SyncProperty> &properties = E->get().properties;
+		gather.values.resize(properties.size());
+		Variant *w = gather.values.ptrw();
+		for (int i = 0; i < properties.size(); i++) {
+			w[i] = node->get(properties[i].name);
+			if (properties[i].quantization > 0) {
+				w[i] = sync_quantize_value(w[i], properties[i].quantization);
+			}
+		}
+		sync_gather.push_back(gather);
+	}
+
+	for (List<ObjectID>::Element *E = freed.front(); E; E = E->next()) {
+		sync_nodes.erase(E->get());
+		for (Map<int, SyncPeer>::Element *F = sync_peers.front(); F; F = F->next()) {
+			F->get().baselines.erase(E->get());
+		}
+	}
+
+	if (sync_gather.size() == 0) {
+		return;
+	}
+
+	// Header: command, sequence and node count.
+	const int header_size = 1 + 4 + 2;
+
+	for (Set<int>::Element *P = connected_peers.front(); P; P = P->next()) {
+		const int peer_id = P->get();
+		SyncPeer &peer = sync_peers[peer_id];
+		SyncSent &sent = peer.sent[sync_sequence & (SYNC_HISTORY - 1)];
+		sent.sequence = sync_sequence;
+		sent.nodes.clear();
+
+		SyncBitWriter w(packet_cache, header_size);
+		int node_count = 0;
+
+		for (uint32_t i = 0; i < sync_gather.size() && node_count < UINT16_MAX; i++) {
+			const SyncGather &gather = sync_gather[i];
+			const ObjectID id = gather.node->get_instance_id();
+
+			// Interest management.
+			if (gather.node->get_network_master() == peer_id || !sync_is_visible(gather.node, peer_id)) {
+				continue;
+			}
+			if (!_send_confirm_path(gather.node, gather.path, gather.psc, peer_id)) {
+				continue; // Sent once the peer knows the path.
+			}
+
+			const SyncSnapshot *baseline = nullptr;
+			Map<ObjectID, SyncSnapshot>::Element *B = peer.baselines.find(id);
+			if (B && sync_sequence - B->get().sequence < SYNC_HISTORY && B->get().values.size() == gather.values.size()) {
+				baseline = &B->get();
+			}
+
+			const int property_count = gather.values.size();
+			uint64_t changed = 0;
+			for (int j = 0; j < property_count; j++) {
+				if (!baseline || gather.values[j] != baseline->values[j]) {
+					changed |= uint64_t(1) << j;
+				}
+			}
+
+			// Unchanged nodes are still sent now and then, so the baseline doesn't get too old.
+			if (!changed && baseline && sync_sequence - baseline->sequence < SYNC_HISTORY / 2) {
+				continue;
+			}
+
+			w.put_varint(gather.psc->id);
+			w.put_bits(baseline ? sync_sequence - baseline->sequence : 0, SYNC_HISTORY_BITS);
+			for (int j = 0; j < property_count; j++) {
+				w.put_bits((changed >> j) & 1, 1);
+			}
+			for (int j = 0; j < property_count; j++) {
+				if (changed & (uint64_t(1) << j)) {
+					Error err = sync_encode_value(w, gather.values[j], baseline ? baseline->values[j] : Variant(), gather.sync->properties[j].quantization, allow_object_decoding);
+					ERR_FAIL_COND_MSG(err != OK, "Unable to encode replicated property '" + String(gather.sync->properties[j].name) + "'.");
+				}
+			}
+
+			SyncSentNode sent_node;
+			sent_node.id = id;
+			sent_node.values = gather.values;
+			sent.nodes.push_back(sent_node);
+			node_count++;
+		}
+
+		if (node_count == 0) {
+			continue;
+		}
+
+		packet_cache.write[0] = NETWORK_COMMAND_SYNC;
+		encode_uint32(sync_sequence, &packet_cache.write[1]);
+		encode_uint16(node_count, &packet_cache.write[5]);
+		const int size = (w.get_bit_offset() + 7) >> 3;
+
+#ifdef DEBUG_ENABLED
+		_profile_bandwidth_data("out", size);
+#endif
+
+		_put_packet(peer_id, NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE, packet_cache.ptr(), size);
+	}
+}
+
+void MultiplayerAPI::_process_sync(int p_from, const uint8_t *p_packet, int p_packet_len) {
+	ERR_FAIL_COND_MSG(p_packet_len < 7, "Invalid packet received. Size too small.");
+
+	const uint32_t sequence = decode_uint32(&p_packet[1]);
+	const int node_count = decode_uint16(&p_packet[5]);
+	// Each node takes at least a cache ID group and a baseline distance.
+	ERR_FAIL_COND_MSG((int64_t)node_count * (5 + SYNC_HISTORY_BITS) > (int64_t)(p_packet_len - 7) * 8, "Invalid packet received. Size too small.");
+
+	SyncPeer &peer = sync_peers[p_from];
+	if (sequence <= peer.last_received) {
+		return; // Late or duplicated, a newer state was already applied.
+	}
+
+	Map<int, PathGetCache>::Element *C = path_get_cache.find(p_from);
+	ERR_FAIL_COND_MSG(!C, "Invalid packet received. Requests invalid peer cache.");
+
+	struct Update {
+		Node *node;
+		const SyncNode *sync;
+		SyncReceived *received;
+		Vector<Variant> values;
+	};
+	LocalVector<Update> updates;
+	updates.resize(node_count);
+
+	// Decode everything first, nothing is applied if the packet is malformed.
+	SyncBitReader r(p_packet + 7, p_packet_len - 7);
+	for (int i = 0; i < node_count; i++) {
+		const int cache_id = r.get_varint();
+		const uint32_t distance = r.get_bits(SYNC_HISTORY_BITS);
+		ERR_FAIL_COND_MSG(r.has_error(), "Invalid packet received. Size too small.");
+
+		Map<int, PathGetCache::NodeInfo>::Element *F = C->get().nodes.find(cache_id);
+		ERR_FAIL_COND_MSG(!F, "Invalid packet received. Unabled to find requested cached node.");
+		Node *node = root_node->get_node_or_null(F->get().path);
+		ERR_FAIL_COND_MSG(!node, "Failed to get replicated node: " + String(F->get().path) + ".");
+		ERR_FAIL_COND_MSG(node->get_network_master() != p_from, "Replicated state for node " + node->get_path() + " was sent by " + itos(p_from) + ", but master is " + itos(node->get_network_master()) + ".");
+		Map<ObjectID, SyncNode>::Element *S = sync_nodes.find(node->get_instance_id());
+		ERR_FAIL_COND_MSG(!S, "Received state for a node which is not replicated: " + node->get_path() + ".");
+
+		const Vector<SyncProperty> &properties = S->get().properties;
+		SyncReceived &received = peer.received[cache_id];
+
+		const SyncSnapshot *baseline = nullptr;
+		if (distance) {
+			baseline = &received.snapshots[(sequence - distance) & (SYNC_HISTORY - 1)];
+			ERR_FAIL_COND_MSG(baseline->sequence != sequence - distance || baseline->values.size() != properties.size(), "Invalid packet received. Replication baseline is unknown.");
+		}
+
+		uint64_t changed = 0;
+		for (int j = 0; j < properties.size(); j++) {
+			changed |= uint64_t(r.get_bits(1)) << j;
+		}
+
+		Update &update = updates[i];
+		update.node = node;
+		update.sync = &S->get();
+		update.received = &received;
+		if (baseline) {
+			update.values = baseline->values;
+		} else {
+			update.values.resize(properties.size());
+		}
+		for (int j = 0; j < properties.size(); j++) {
+			if (changed & (uint64_t(1) << j)) {
+				Error err = sync_decode_value(r, update.values.write[j], baseline ? baseline->values[j] : Variant(), properties[j].quantization, allow_object_decoding);
+				ERR_FAIL_COND_MSG(err != OK, "Invalid packet received. Unable to decode replicated property.");
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < updates.size(); i++) {
+		Update &update = updates[i];
+
+		// Only set what differs from the last applied state.
+		const SyncSnapshot &latest = update.received->snapshots[update.received->latest & (SYNC_HISTORY - 1)];
+		const bool has_latest = update.received->latest != 0 && latest.sequence == update.received->latest && latest.values.size() == update.values.size();
+		for (int j = 0; j < update.values.size(); j++) {
+			if (has_latest && latest.values[j] == update.values[j]) {
+				continue;
+			}
+			bool valid;
+			update.node->set(update.sync->properties[j].name, update.values[j], &valid);
+			if (!valid) {
+				ERR_PRINT("Error setting replicated property '" + String(update.sync->properties[j].name) + "', not found in object of type " + update.node->get_class() + ".");
+			}
+		}
+
+		SyncSnapshot &snapshot = update.received->snapshots[sequence & (SYNC_HISTORY - 1)];
+		snapshot.sequence = sequence;
+		snapshot.values = update.values;
+		update.received->latest = sequence;
+	}
+
+	peer.last_received = sequence;
+
+	uint8_t ack[5];
+	ack[0] = NETWORK_COMMAND_SYNC_ACK;
+	encode_uint32(sequence, &ack[1]);
+	_put_packet(p_from, NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE, ack, 5);
+}
+
+void MultiplayerAPI::_process_sync_ack(int p_from, const uint8_t *p_packet, int p_packet_len) {
+	ERR_FAIL_COND_MSG(p_packet_len < 5, "Invalid packet received. Size too small.");
+
+	const uint32_t sequence = decode_uint32(&p_packet[1]);
+	Map<int, SyncPeer>::Element *E = sync_peers.find(p_from);
+	if (!E) {
+		return;
+	}
+
+	SyncSent &sent = E->get().sent[sequence & (SYNC_HISTORY - 1)];
+	if (sent.sequence != sequence) {
+		return; // Too old, no longer useful as a baseline.
+	}
+
+	// The peer has these states now, use them as baselines.
+	for (uint32_t i = 0; i < sent.nodes.size(); i++) {
+		SyncSnapshot &baseline = E->get().baselines[sent.nodes[i].id];
+		if (baseline.sequence < sequence) {
+			baseline.sequence = sequence;
+			baseline.values = sent.nodes[i].values;
+		}
+	}
+}
+
 void MultiplayerAPI::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_root_node", "node"), &MultiplayerAPI::set_root_node);
 	ClassDB::bind_method(D_METHOD("send_bytes", "bytes", "id", "mode"), &MultiplayerAPI::send_bytes, DEFVAL(NetworkedMultiplayerPeer::TARGET_PEER_BROADCAST), DEFVAL(NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE));
@@ -1210,6 +1905,7 @@ void MultiplayerAPI::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_rpc_sender_id"), &MultiplayerAPI::get_rpc_sender_id);
 	ClassDB::bind_method(D_METHOD("set_network_peer", "peer"), &MultiplayerAPI::set_network_peer);
 	ClassDB::bind_method(D_METHOD("poll"), &MultiplayerAPI::poll);
+	ClassDB::bind_method(D_METHOD("flush_batches"), &MultiplayerAPI::flush_batches);
 	ClassDB::bind_method(D_METHOD("clear"), &MultiplayerAPI::clear);
 
 	ClassDB::bind_method(D_METHOD("get_network_connected_peers"), &MultiplayerAPI::get_network_connected_peers);
@@ -1217,8 +1913,16 @@ void MultiplayerAPI::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_refusing_new_network_connections"), &MultiplayerAPI::is_refusing_new_network_connections);
 	ClassDB::bind_method(D_METHOD("set_allow_object_decoding", "enable"), &MultiplayerAPI::set_allow_object_decoding);
 	ClassDB::bind_method(D_METHOD("is_object_decoding_allowed"), &MultiplayerAPI::is_object_decoding_allowed);
+	ClassDB::bind_method(D_METHOD("set_batching_enabled", "enabled"), &MultiplayerAPI::set_batching_enabled);
+	ClassDB::bind_method(D_METHOD("is_batching_enabled"), &MultiplayerAPI::is_batching_enabled);
+	ClassDB::bind_method(D_METHOD("sync_add_property", "node", "property", "quantization"), &MultiplayerAPI::sync_add_property, DEFVAL(0.0));
+	ClassDB::bind_method(D_METHOD("sync_remove_node", "node"), &MultiplayerAPI::sync_remove_node);
+	ClassDB::bind_method(D_METHOD("sync_set_visibility", "node", "peer_id", "visible"), &MultiplayerAPI::sync_set_visibility);
+	ClassDB::bind_method(D_METHOD("sync_is_visible", "node", "peer_id"), &MultiplayerAPI::sync_is_visible);
+	ClassDB::bind_method(D_METHOD("sync_send"), &MultiplayerAPI::sync_send);
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "allow_object_decoding"), "set_allow_object_decoding", "is_object_decoding_allowed");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "batching_enabled"), "set_batching_enabled", "is_batching_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "refuse_new_network_connections"), "set_refuse_new_network_connections", "is_refusing_new_network_connections");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "network_peer", PROPERTY_HINT_RESOURCE_TYPE, "NetworkedMultiplayerPeer", 0), "set_network_peer", "get_network_peer");
 	ADD_PROPERTY_DEFAULT("refuse_new_network_connections", false);
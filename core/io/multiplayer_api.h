@@ -33,6 +33,7 @@
 
 #include "core/io/networked_multiplayer_peer.h"
 #include "core/object/reference.h"
+#include "core/templates/local_vector.h"
 
 class MultiplayerAPI : public Reference {
 	GDCLASS(MultiplayerAPI, Reference);
@@ -64,6 +65,81 @@ private:
 	Node *root_node = nullptr;
 	bool allow_object_decoding = false;
 
+	//outgoing batches
+	enum {
+		BATCH_MAX_SIZE = 1200, // Fits a typical MTU, so unreliable batches aren't fragmented.
+	};
+
+	struct PacketBatch {
+		int target = 0;
+		int count = 0;
+		LocalVector<uint8_t> data;
+	};
+
+	LocalVector<PacketBatch> batches[NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE + 1];
+	uint32_t batches_used[NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE + 1] = {};
+	bool batching_enabled = true;
+
+	//state replication
+	enum {
+		SYNC_HISTORY_BITS = 5,
+		SYNC_HISTORY = 1 << SYNC_HISTORY_BITS, // Baselines older than this many ticks are dropped.
+		SYNC_MAX_PROPERTIES = 64,
+	};
+
+	struct SyncProperty {
+		StringName name;
+		real_t quantization = 0;
+	};
+
+	struct SyncNode {
+		Vector<SyncProperty> properties;
+		bool visible = true;
+		Map<int, bool> peer_visibility;
+	};
+
+	struct SyncSnapshot {
+		uint32_t sequence = 0;
+		Vector<Variant> values;
+	};
+
+	struct SyncSentNode {
+		ObjectID id;
+		Vector<Variant> values;
+	};
+
+	struct SyncSent {
+		uint32_t sequence = 0;
+		LocalVector<SyncSentNode> nodes; // Cleared and refilled when the slot is reused, keeping its memory.
+	};
+
+	struct SyncReceived {
+		uint32_t latest = 0;
+		SyncSnapshot snapshots[SYNC_HISTORY];
+	};
+
+	struct SyncPeer {
+		// Sending side, states acknowledged by the peer and states waiting for it.
+		Map<ObjectID, SyncSnapshot> baselines;
+		SyncSent sent[SYNC_HISTORY];
+		// Receiving side, states received from the peer by path cache ID.
+		uint32_t last_received = 0;
+		Map<int, SyncReceived> received;
+	};
+
+	struct SyncGather {
+		Node *node = nullptr;
+		const SyncNode *sync = nullptr;
+		NodePath path;
+		PathSentCache *psc = nullptr;
+		Vector<Variant> values;
+	};
+
+	Map<ObjectID, SyncNode> sync_nodes;
+	Map<int, SyncPeer> sync_peers;
+	LocalVector<SyncGather> sync_gather;
+	uint32_t sync_sequence = 0;
+
 protected:
 	static void _bind_methods();
 
@@ -74,6 +150,12 @@ protected:
 	void _process_rpc(Node *p_node, const uint16_t p_rpc_method_id, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset);
 	void _process_rset(Node *p_node, const uint16_t p_rpc_property_id, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset);
 	void _process_raw(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void _process_sync(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void _process_sync_ack(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void _process_batch(int p_from, const uint8_t *p_packet, int p_packet_len);
+
+	Error _put_packet(int p_to, NetworkedMultiplayerPeer::TransferMode p_mode, const uint8_t *p_packet, int p_packet_len, bool p_can_batch = true);
+	Error _send_batch(NetworkedMultiplayerPeer::TransferMode p_mode, PacketBatch &p_batch);
 
 	void _send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, const StringName &p_name, const Variant **p_arg, int p_argcount);
 	bool _send_confirm_path(Node *p_node, NodePath p_path, PathSentCache *psc, int p_target);
@@ -88,6 +170,9 @@ public:
 		NETWORK_COMMAND_SIMPLIFY_PATH,
 		NETWORK_COMMAND_CONFIRM_PATH,
 		NETWORK_COMMAND_RAW,
+		NETWORK_COMMAND_SYNC,
+		NETWORK_COMMAND_SYNC_ACK,
+		NETWORK_COMMAND_BATCH,
 	};
 
 	enum NetworkNodeIdCompression {
@@ -113,6 +198,7 @@ public:
 	};
 
 	void poll();
+	Error flush_batches();
 	void clear();
 	void set_root_node(Node *p_node);
 	void set_network_peer(const Ref<NetworkedMultiplayerPeer> &p_peer);
@@ -141,6 +227,15 @@ public:
 	void set_allow_object_decoding(bool p_enable);
 	bool is_object_decoding_allowed() const;
 
+	void set_batching_enabled(bool p_enabled);
+	bool is_batching_enabled() const;
+
+	void sync_add_property(Node *p_node, const StringName &p_property, real_t p_quantization = 0.0);
+	void sync_remove_node(Node *p_node);
+	void sync_set_visibility(Node *p_node, int p_peer_id, bool p_visible);
+	bool sync_is_visible(Node *p_node, int p_peer_id) const;
+	void sync_send();
+
 	MultiplayerAPI();
 	~MultiplayerAPI();
 };
@@ -0,0 +1,187 @@
+/*************************************************************************/
+/*  multiplayer_sync_encoding.cpp                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "multiplayer_sync_encoding.h"
+
+#include "core/io/marshalls.h"
+
+static _FORCE_INLINE_ real_t _sync_quantize(real_t p_value, real_t p_step) {
+	return Math::round(p_value / p_step) * p_step;
+}
+
+Variant sync_quantize_value(const Variant &p_value, real_t p_step) {
+	switch (p_value.get_type()) {
+		case Variant::FLOAT: {
+			return _sync_quantize(p_value, p_step);
+		}
+		case Variant::VECTOR2: {
+			Vector2 v = p_value;
+			return Vector2(_sync_quantize(v.x, p_step), _sync_quantize(v.y, p_step));
+		}
+		case Variant::VECTOR3: {
+			Vector3 v = p_value;
+			return Vector3(_sync_quantize(v.x, p_step), _sync_quantize(v.y, p_step), _sync_quantize(v.z, p_step));
+		}
+		default:
+			return p_value;
+	}
+}
+
+// Quantized values are sent as a number of steps. Beyond 2^53 steps doubles
+// don't hold every integer anyway, so the count is clamped there: converting
+// huge or non finite values to int64_t would overflow, and so would the
+// difference between two counts.
+static const int64_t SYNC_MAX_STEPS = int64_t(1) << 53;
+
+static int64_t _sync_get_steps(real_t p_value, real_t p_step) {
+	const double steps = Math::round((double)p_value / (double)p_step);
+	if (Math::is_nan(steps)) {
+		return 0;
+	}
+	return (int64_t)CLAMP(steps, (double)-SYNC_MAX_STEPS, (double)SYNC_MAX_STEPS);
+}
+
+static void _sync_put_real(SyncBitWriter &w, real_t p_value, real_t p_base, real_t p_step) {
+	if (p_step > 0) {
+		w.put_zigzag(_sync_get_steps(p_value, p_step) - _sync_get_steps(p_base, p_step));
+	} else {
+		float f = p_value;
+		uint32_t bits;
+		memcpy(&bits, &f, 4);
+		w.put_bits(bits, 32);
+	}
+}
+
+static real_t _sync_get_real(SyncBitReader &r, real_t p_base, real_t p_step) {
+	if (p_step > 0) {
+		// The delta comes from the packet, keep the sum in range too.
+		int64_t delta = r.get_zigzag();
+		delta = CLAMP(delta, -2 * SYNC_MAX_STEPS, 2 * SYNC_MAX_STEPS);
+		const int64_t q = _sync_get_steps(p_base, p_step) + delta;
+		return CLAMP(q, -SYNC_MAX_STEPS, SYNC_MAX_STEPS) * p_step;
+	} else {
+		uint32_t bits = r.get_bits(32);
+		float f;
+		memcpy(&f, &bits, 4);
+		return f;
+	}
+}
+
+Error sync_encode_value(SyncBitWriter &w, const Variant &p_value, const Variant &p_base, real_t p_step, bool p_allow_objects) {
+	const Variant::Type type = p_value.get_type();
+	const bool has_base = p_base.get_type() == type;
+	w.put_bits(type, SYNC_TYPE_BITS);
+
+	switch (type) {
+		case Variant::NIL: {
+		} break;
+		case Variant::BOOL: {
+			w.put_bits(p_value.operator bool() ? 1 : 0, 1);
+		} break;
+		case Variant::INT: {
+			w.put_zigzag(p_value.operator int64_t() - (has_base ? p_base.operator int64_t() : 0));
+		} break;
+		case Variant::FLOAT: {
+			_sync_put_real(w, p_value, has_base ? p_base.operator real_t() : 0, p_step);
+		} break;
+		case Variant::VECTOR2: {
+			Vector2 v = p_value;
+			Vector2 b = has_base ? p_base.operator Vector2() : Vector2();
+			_sync_put_real(w, v.x, b.x, p_step);
+			_sync_put_real(w, v.y, b.y, p_step);
+		} break;
+		case Variant::VECTOR3: {
+			Vector3 v = p_value;
+			Vector3 b = has_base ? p_base.operator Vector3() : Vector3();
+			_sync_put_real(w, v.x, b.x, p_step);
+			_sync_put_real(w, v.y, b.y, p_step);
+			_sync_put_real(w, v.z, b.z, p_step);
+		} break;
+		default: {
+			int len = 0;
+			Error err = encode_variant(p_value, nullptr, len, p_allow_objects);
+			ERR_FAIL_COND_V(err != OK, err);
+			Vector<uint8_t> bytes;
+			bytes.resize(len);
+			encode_variant(p_value, bytes.ptrw(), len, p_allow_objects);
+			w.put_varint(len);
+			w.put_bytes(bytes.ptr(), len);
+		} break;
+	}
+	return OK;
+}
+
+Error sync_decode_value(SyncBitReader &r, Variant &r_value, const Variant &p_base, real_t p_step, bool p_allow_objects) {
+	const uint32_t type = r.get_bits(SYNC_TYPE_BITS);
+	ERR_FAIL_COND_V(type >= Variant::VARIANT_MAX, ERR_INVALID_DATA);
+	const bool has_base = p_base.get_type() == (Variant::Type)type;
+
+	switch (type) {
+		case Variant::NIL: {
+			r_value = Variant();
+		} break;
+		case Variant::BOOL: {
+			r_value = r.get_bits(1) != 0;
+		} break;
+		case Variant::INT: {
+			r_value = r.get_zigzag() + (has_base ? p_base.operator int64_t() : 0);
+		} break;
+		case Variant::FLOAT: {
+			r_value = _sync_get_real(r, has_base ? p_base.operator real_t() : 0, p_step);
+		} break;
+		case Variant::VECTOR2: {
+			Vector2 b = has_base ? p_base.operator Vector2() : Vector2();
+			Vector2 v;
+			v.x = _sync_get_real(r, b.x, p_step);
+			v.y = _sync_get_real(r, b.y, p_step);
+			r_value = v;
+		} break;
+		case Variant::VECTOR3: {
+			Vector3 b = has_base ? p_base.operator Vector3() : Vector3();
+			Vector3 v;
+			v.x = _sync_get_real(r, b.x, p_step);
+			v.y = _sync_get_real(r, b.y, p_step);
+			v.z = _sync_get_real(r, b.z, p_step);
+			r_value = v;
+		} break;
+		default: {
+			uint64_t len = r.get_varint();
+			ERR_FAIL_COND_V(r.has_error() || len > (1 << 24), ERR_INVALID_DATA);
+			Vector<uint8_t> bytes;
+			bytes.resize(len);
+			r.get_bytes(bytes.ptrw(), len);
+			ERR_FAIL_COND_V(r.has_error(), ERR_INVALID_DATA);
+			Error err = decode_variant(r_value, bytes.ptr(), len, nullptr, p_allow_objects);
+			ERR_FAIL_COND_V(err != OK, err);
+		} break;
+	}
+	return r.has_error() ? ERR_INVALID_DATA : OK;
+}
@@ -0,0 +1,149 @@
+/*************************************************************************/
+/*  multiplayer_sync_encoding.h                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef MULTIPLAYER_SYNC_ENCODING_H
+#define MULTIPLAYER_SYNC_ENCODING_H
+
+#include "core/variant/variant.h"
+
+// Bit packed encoding of the state replicated by MultiplayerAPI.
+
+enum {
+	SYNC_TYPE_BITS = 6,
+};
+
+static_assert(Variant::VARIANT_MAX <= (1 << SYNC_TYPE_BITS), "Variant types don't fit in the replicated state encoding.");
+
+class SyncBitWriter {
+	Vector<uint8_t> &buffer;
+	int bit_offset;
+
+public:
+	void put_bits(uint32_t p_value, int p_bits) {
+		int end = (bit_offset + p_bits + 7) >> 3;
+		if (buffer.size() < end) {
+			buffer.resize(end);
+		}
+		uint8_t *w = buffer.ptrw();
+		for (int i = 0; i < p_bits; i++) {
+			int byte = bit_offset >> 3;
+			int bit = bit_offset & 7;
+			if (bit == 0) {
+				w[byte] = 0;
+			}
+			w[byte] |= ((p_value >> i) & 1) << bit;
+			bit_offset++;
+		}
+	}
+
+	// Four bits per group, plus one telling if another group follows.
+	void put_varint(uint64_t p_value) {
+		while (p_value >= 16) {
+			put_bits((p_value & 15) | 16, 5);
+			p_value >>= 4;
+		}
+		put_bits(p_value, 5);
+	}
+
+	void put_zigzag(int64_t p_value) {
+		put_varint(((uint64_t)p_value << 1) ^ (uint64_t)(p_value >> 63));
+	}
+
+	void put_bytes(const uint8_t *p_data, int p_len) {
+		for (int i = 0; i < p_len; i++) {
+			put_bits(p_data[i], 8);
+		}
+	}
+
+	int get_bit_offset() const { return bit_offset; }
+
+	SyncBitWriter(Vector<uint8_t> &r_buffer, int p_byte_offset) :
+			buffer(r_buffer),
+			bit_offset(p_byte_offset << 3) {}
+};
+
+class SyncBitReader {
+	const uint8_t *data;
+	int bit_size;
+	int bit_offset = 0;
+	bool error = false;
+
+public:
+	uint32_t get_bits(int p_bits) {
+		if (bit_offset + p_bits > bit_size) {
+			error = true;
+			return 0;
+		}
+		uint32_t value = 0;
+		for (int i = 0; i < p_bits; i++) {
+			value |= ((data[bit_offset >> 3] >> (bit_offset & 7)) & 1) << i;
+			bit_offset++;
+		}
+		return value;
+	}
+
+	uint64_t get_varint() {
+		uint64_t value = 0;
+		for (int shift = 0; shift < 64 && !error; shift += 4) {
+			uint32_t group = get_bits(5);
+			value |= (uint64_t)(group & 15) << shift;
+			if (!(group & 16)) {
+				break;
+			}
+		}
+		return value;
+	}
+
+	int64_t get_zigzag() {
+		uint64_t value = get_varint();
+		return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+	}
+
+	void get_bytes(uint8_t *r_data, int p_len) {
+		for (int i = 0; i < p_len; i++) {
+			r_data[i] = get_bits(8);
+		}
+	}
+
+	bool has_error() const { return error; }
+
+	SyncBitReader(const uint8_t *p_data, int p_len) :
+			data(p_data),
+			bit_size(p_len << 3) {}
+};
+
+Variant sync_quantize_value(const Variant &p_value, real_t p_step);
+
+// Numbers are sent relative to the baseline value, when it has the same type.
+Error sync_encode_value(SyncBitWriter &w, const Variant &p_value, const Variant &p_base, real_t p_step, bool p_allow_objects);
+Error sync_decode_value(SyncBitReader &r, Variant &r_value, const Variant &p_base, real_t p_step, bool p_allow_objects);
+
+#endif // MULTIPLAYER_SYNC_ENCODING_H
@@ -196,20 +196,23 @@ bool ResourceFormatImporter::can_be_imported(const String &p_path) const {
 	return ResourceFormatLoader::recognize_path(p_path);
 }
 
-int ResourceFormatImporter::get_import_order(const String &p_path) const {
-	Ref<ResourceImporter> importer;
-
+Ref<ResourceImporter> ResourceFormatImporter::get_importer_for_file(const String &p_path) const {
 	if (FileAccess::exists(p_path + ".import")) {
 		PathAndType pat;
 		Error err = _get_path_and_type(p_path, pat);
 
 		if (err == OK) {
-			importer = get_importer_by_name(pat.importer);
+			return get_importer_by_name(pat.importer);
 		}
-	} else {
-		importer = get_importer_by_extension(p_path.get_extension().to_lower());
+		return Ref<ResourceImporter>();
 	}
 
+	return get_importer_by_extension(p_path.get_extension().to_lower());
+}
+
+int ResourceFormatImporter::get_import_order(const String &p_path) const {
+	Ref<ResourceImporter> importer = get_importer_for_file(p_path);
+
 	if (importer.is_valid()) {
 		return importer->get_import_order();
 	}
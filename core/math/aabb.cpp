@@ -30,6 +30,8 @@
 
 #include "aabb.h"
 
+#include "core/math/math_simd.h"
+#include "core/math/transform.h"
 #include "core/string/print_string.h"
 #include "core/variant/variant.h"
 
@@ -394,3 +396,178 @@ Variant AABB::intersects_ray_bind(const Vector3 &p_from, const Vector3 &p_dir) c
 AABB::operator String() const {
 	return String() + position + " - " + size;
 }
+
+// Same test as intersects_convex_shape(), with the points reduced to their bounds:
+// all of them are past a face of the box exactly when their bounds are.
+static _FORCE_INLINE_ bool _intersects_convex_bounds(const AABB &p_aabb, const Plane *p_planes, int p_plane_count, const Vector3 &p_points_min, const Vector3 &p_points_max) {
+	Vector3 half_extents = p_aabb.size * 0.5;
+	Vector3 ofs = p_aabb.position + half_extents;
+
+	for (int i = 0; i < p_plane_count; i++) {
+		const Plane &p = p_planes[i];
+		Vector3 point(
+				(p.normal.x > 0) ? -half_extents.x : half_extents.x,
+				(p.normal.y > 0) ? -half_extents.y : half_extents.y,
+				(p.normal.z > 0) ? -half_extents.z : half_extents.z);
+		point += ofs;
+		if (p.is_point_over(point)) {
+			return false;
+		}
+	}
+
+	for (int k = 0; k < 3; k++) {
+		if (p_points_min.coord[k] > ofs.coord[k] + half_extents.coord[k]) {
+			return false;
+		}
+		if (p_points_max.coord[k] < ofs.coord[k] - half_extents.coord[k]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int AABB::intersects_convex_shape_array(const AABB *p_aabbs, int p_count, const Plane *p_planes, int p_plane_count, const Vector3 *p_points, int p_point_count, bool *r_results) {
+	if (p_point_count == 0) {
+		// Like intersects_convex_shape(), nothing intersects a shape without points.
+		for (int i = 0; i < p_count; i++) {
+			r_results[i] = false;
+		}
+		return 0;
+	}
+
+	Vector3 points_min = p_points[0];
+	Vector3 points_max = p_points[0];
+	for (int i = 1; i < p_point_count; i++) {
+		for (int k = 0; k < 3; k++) {
+			points_min.coord[k] = MIN(points_min.coord[k], p_points[i].coord[k]);
+			points_max.coord[k] = MAX(points_max.coord[k], p_points[i].coord[k]);
+		}
+	}
+
+	int count = 0;
+	int i = 0;
+
+#ifdef MATH_SIMD
+	// Four boxes at once, one per lane.
+	const MathVec4 half = math_vec4_splat(0.5);
+	for (; i + 4 <= p_count; i += 4) {
+		const AABB *a = p_aabbs + i;
+		MathVec4 half_extents[3];
+		MathVec4 ofs[3];
+		for (int k = 0; k < 3; k++) {
+			half_extents[k] = math_vec4_mul(math_vec4_set(a[0].size.coord[k], a[1].size.coord[k], a[2].size.coord[k], a[3].size.coord[k]), half);
+			ofs[k] = math_vec4_add(math_vec4_set(a[0].position.coord[k], a[1].position.coord[k], a[2].position.coord[k], a[3].position.coord[k]), half_extents[k]);
+		}
+
+		int separated = 0;
+		for (int j = 0; j < p_plane_count; j++) {
+			const Plane &p = p_planes[j];
+			MathVec4 point[3];
+			for (int k = 0; k < 3; k++) {
+				point[k] = (p.normal.coord[k] > 0) ? math_vec4_sub(ofs[k], half_extents[k]) : math_vec4_add(ofs[k], half_extents[k]);
+			}
+			MathVec4 dist = math_vec4_add(math_vec4_mul(math_vec4_splat(p.normal.x), point[0]), math_vec4_mul(math_vec4_splat(p.normal.y), point[1]));
+			dist = math_vec4_add(dist, math_vec4_mul(math_vec4_splat(p.normal.z), point[2]));
+			separated |= math_vec4_greater_mask(dist, math_vec4_splat(p.d));
+		}
+
+		for (int k = 0; k < 3; k++) {
+			separated |= math_vec4_greater_mask(math_vec4_splat(points_min.coord[k]), math_vec4_add(ofs[k], half_extents[k]));
+			separated |= math_vec4_greater_mask(math_vec4_sub(ofs[k], half_extents[k]), math_vec4_splat(points_max.coord[k]));
+		}
+
+		for (int l = 0; l < 4; l++) {
+			r_results[i + l] = !(separated & (1 << l));
+			count += r_results[i + l];
+		}
+	}
+#endif
+
+	for (; i < p_count; i++) {
+		r_results[i] = _intersects_convex_bounds(p_aabbs[i], p_planes, p_plane_count, points_min, points_max);
+		count += r_results[i];
+	}
+
+	return count;
+}
+
+AABB AABB::merge_transformed_array(const AABB *p_aabbs, int p_aabb_stride, const float *p_xforms, int p_xform_stride, int p_count) {
+	if (p_count <= 0) {
+		return AABB();
+	}
+
+	Vector3 min = Vector3(Math_INF, Math_INF, Math_INF);
+	Vector3 max = -min;
+	int i = 0;
+
+#ifdef MATH_SIMD
+	// Four instances at once, one per lane, transforming the center and the extents
+	// of each box. The per-lane bounds are reduced once at the end.
+	if (p_count >= 4) {
+		const MathVec4 half = math_vec4_splat(0.5);
+		MathVec4 acc_min[3];
+		MathVec4 acc_max[3];
+		for (int k = 0; k < 3; k++) {
+			acc_min[k] = math_vec4_splat(Math_INF);
+			acc_max[k] = math_vec4_splat(-Math_INF);
+		}
+
+		for (; i + 4 <= p_count; i += 4) {
+			const AABB *a[4];
+			const float *m[4];
+			for (int l = 0; l < 4; l++) {
+				a[l] = p_aabbs + (i + l) * p_aabb_stride;
+				m[l] = p_xforms + (i + l) * p_xform_stride;
+			}
+
+			MathVec4 extent[3];
+			MathVec4 center[3];
+			for (int k = 0; k < 3; k++) {
+				extent[k] = math_vec4_mul(math_vec4_set(a[0]->size.coord[k], a[1]->size.coord[k], a[2]->size.coord[k], a[3]->size.coord[k]), half);
+				center[k] = math_vec4_add(math_vec4_set(a[0]->position.coord[k], a[1]->position.coord[k], a[2]->position.coord[k], a[3]->position.coord[k]), extent[k]);
+			}
+
+			for (int r = 0; r < 3; r++) {
+				MathVec4 c = math_vec4_set(m[0][r * 4 + 3], m[1][r * 4 + 3], m[2][r * 4 + 3], m[3][r * 4 + 3]);
+				MathVec4 e = math_vec4_splat(0);
+				for (int k = 0; k < 3; k++) {
+					MathVec4 b = math_vec4_set(m[0][r * 4 + k], m[1][r * 4 + k], m[2][r * 4 + k], m[3][r * 4 + k]);
+					c = math_vec4_add(c, math_vec4_mul(b, center[k]));
+					e = math_vec4_add(e, math_vec4_mul(math_vec4_abs(b), extent[k]));
+				}
+				acc_min[r] = math_vec4_min(acc_min[r], math_vec4_sub(c, e));
+				acc_max[r] = math_vec4_max(acc_max[r], math_vec4_add(c, e));
+			}
+		}
+
+		for (int k = 0; k < 3; k++) {
+			float lanes_min[4];
+			float lanes_max[4];
+			math_vec4_store(lanes_min, acc_min[k]);
+			math_vec4_store(lanes_max, acc_max[k]);
+			for (int l = 0; l < 4; l++) {
+				min.coord[k] = MIN(min.coord[k], lanes_min[l]);
+				max.coord[k] = MAX(max.coord[k], lanes_max[l]);
+			}
+		}
+	}
+#endif
+
+	for (; i < p_count; i++) {
+		const float *m = p_xforms + i * p_xform_stride;
+		Transform t;
+		for (int r = 0; r < 3; r++) {
+			t.basis.elements[r] = Vector3(m[r * 4 + 0], m[r * 4 + 1], m[r * 4 + 2]);
+			t.origin.coord[r] = m[r * 4 + 3];
+		}
+
+		AABB aabb = t.xform(p_aabbs[i * p_aabb_stride]);
+		for (int k = 0; k < 3; k++) {
+			min.coord[k] = MIN(min.coord[k], aabb.position.coord[k]);
+			max.coord[k] = MAX(max.coord[k], aabb.position.coord[k] + aabb.size.coord[k]);
+		}
+	}
+
+	return AABB(min, max - min);
+}
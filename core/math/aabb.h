@@ -77,6 +77,11 @@ public:
 
 	_FORCE_INLINE_ bool intersects_convex_shape(const Plane *p_planes, int p_plane_count, const Vector3 *p_points, int p_point_count) const;
 	_FORCE_INLINE_ bool inside_convex_shape(const Plane *p_planes, int p_plane_count) const;
+	// Batch version of intersects_convex_shape(), sets r_results[i] for each box and returns how many intersect.
+	static int intersects_convex_shape_array(const AABB *p_aabbs, int p_count, const Plane *p_planes, int p_plane_count, const Vector3 *p_points, int p_point_count, bool *r_results);
+	// Merges p_aabbs[i * p_aabb_stride] transformed by the 3x4 row-major matrix at p_xforms + i * p_xform_stride, for each i below p_count.
+	// A p_aabb_stride of 0 transforms the same box every time. Returns an empty AABB if p_count is 0.
+	static AABB merge_transformed_array(const AABB *p_aabbs, int p_aabb_stride, const float *p_xforms, int p_xform_stride, int p_count);
 	bool intersects_plane(const Plane &p_plane) const;
 
 	_FORCE_INLINE_ bool has_point(const Vector3 &p_point) const;
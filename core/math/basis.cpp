@@ -31,6 +31,7 @@
 #include "basis.h"
 
 #include "core/math/math_funcs.h"
+#include "core/math/math_simd.h"
 #include "core/os/copymem.h"
 #include "core/string/print_string.h"
 
@@ -756,6 +757,25 @@ bool Basis::operator!=(const Basis &p_matrix) const {
 	return (!(*this == p_matrix));
 }
 
+void Basis::xform_array(const Vector3 *p_src, Vector3 *r_dst, int p_count) const {
+#ifdef MATH_SIMD
+	// Same operations as xform(), so results are identical, but the matrix stays in registers.
+	const MathVec4 col_x = math_vec4_set(elements[0][0], elements[1][0], elements[2][0], 0);
+	const MathVec4 col_y = math_vec4_set(elements[0][1], elements[1][1], elements[2][1], 0);
+	const MathVec4 col_z = math_vec4_set(elements[0][2], elements[1][2], elements[2][2], 0);
+
+	for (int i = 0; i < p_count; i++) {
+		const Vector3 &v = p_src[i];
+		MathVec4 r = math_vec4_add(math_vec4_mul(col_x, math_vec4_splat(v.x)), math_vec4_mul(col_y, math_vec4_splat(v.y)));
+		math_vec4_store3(&r_dst[i].x, math_vec4_add(r, math_vec4_mul(col_z, math_vec4_splat(v.z))));
+	}
+#else
+	for (int i = 0; i < p_count; i++) {
+		r_dst[i] = xform(p_src[i]);
+	}
+#endif
+}
+
 Basis::operator String() const {
 	String mtx;
 	for (int i = 0; i < 3; i++) {
@@ -855,9 +855,8 @@ Vector<Plane> Geometry3D::build_capsule_planes(real_t p_radius, real_t p_height,
 	return planes;
 }
 
-Vector<Vector3> Geometry3D::compute_convex_mesh_points(const Plane *p_planes, int p_plane_count) {
-	Vector<Vector3> points;
-
+template <class V>
+static void _compute_convex_mesh_points(const Plane *p_planes, int p_plane_count, V &r_points) {
 	// Iterate through every unique combination of any three planes.
 	for (int i = p_plane_count - 1; i >= 0; i--) {
 		for (int j = i - 1; j >= 0; j--) {
@@ -881,16 +880,24 @@ Vector<Vector3> Geometry3D::compute_convex_mesh_points(const Plane *p_planes, in
 
 					// Only add the point if it passed all tests.
 					if (!excluded) {
-						points.push_back(convex_shape_point);
+						r_points.push_back(convex_shape_point);
 					}
 				}
 			}
 		}
 	}
+}
 
+Vector<Vector3> Geometry3D::compute_convex_mesh_points(const Plane *p_planes, int p_plane_count) {
+	Vector<Vector3> points;
+	_compute_convex_mesh_points(p_planes, p_plane_count, points);
 	return points;
 }
 
+void Geometry3D::compute_convex_mesh_points(const Plane *p_planes, int p_plane_count, FrameVector<Vector3> &r_points) {
+	_compute_convex_mesh_points(p_planes, p_plane_count, r_points);
+}
+
 #define square(m_s) ((m_s) * (m_s))
 #define INF 1e20
 
@@ -33,6 +33,7 @@
 
 #include "core/math/face3.h"
 #include "core/object/object.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/vector.h"
 
 class Geometry3D {
@@ -643,6 +644,7 @@ public:
 	static Vector<Plane> build_capsule_planes(real_t p_radius, real_t p_height, int p_sides, int p_lats, Vector3::Axis p_axis = Vector3::AXIS_Z);
 
 	static Vector<Vector3> compute_convex_mesh_points(const Plane *p_planes, int p_plane_count);
+	static void compute_convex_mesh_points(const Plane *p_planes, int p_plane_count, FrameVector<Vector3> &r_points);
 
 #define FINDMINMAX(x0, x1, x2, min, max) \
 	min = max = x0;                      \
@@ -0,0 +1,175 @@
+/*************************************************************************/
+/*  math_simd.h                                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef MATH_SIMD_H
+#define MATH_SIMD_H
+
+#include "core/math/math_defs.h"
+#include "core/typedefs.h"
+
+// Four-wide helpers for the batch math functions (Transform::xform_array(),
+// AABB::intersects_convex_shape_array(), ...). SSE2 and NEON are part of the
+// baseline of the platforms that have them, so they are selected at compile
+// time. Double precision builds use the scalar paths.
+
+#ifndef REAL_T_IS_DOUBLE
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MATH_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define MATH_NEON
+#endif
+#endif
+
+#if defined(MATH_SSE) || defined(MATH_NEON)
+#define MATH_SIMD
+
+#ifdef MATH_SSE
+typedef __m128 MathVec4;
+#else
+typedef float32x4_t MathVec4;
+#endif
+
+_FORCE_INLINE_ MathVec4 math_vec4_set(float p_x, float p_y, float p_z, float p_w) {
+#ifdef MATH_SSE
+	return _mm_set_ps(p_w, p_z, p_y, p_x);
+#else
+	const float values[4] = { p_x, p_y, p_z, p_w };
+	return vld1q_f32(values);
+#endif
+}
+
+_FORCE_INLINE_ MathVec4 math_vec4_splat(float p_value) {
+#ifdef MATH_SSE
+	return _mm_set1_ps(p_value);
+#else
+	return vdupq_n_f32(p_value);
+#endif
+}
+
+_FORCE_INLINE_ MathVec4 math_vec4_load(const float *p_src) {
+#ifdef MATH_SSE
+	return _mm_loadu_ps(p_src);
+#else
+	return vld1q_f32(p_src);
+#endif
+}
+
+_FORCE_INLINE_ void math_vec4_store(float *p_dst, MathVec4 p_value) {
+#ifdef MATH_SSE
+	_mm_storeu_ps(p_dst, p_value);
+#else
+	vst1q_f32(p_dst, p_value);
+#endif
+}
+
+// Loads three floats, the fourth lane is zero. Never reads past p_src[2].
+_FORCE_INLINE_ MathVec4 math_vec4_load3(const float *p_src) {
+#ifdef MATH_SSE
+	return _mm_movelh_ps(_mm_castpd_ps(_mm_load_sd((const double *)p_src)), _mm_load_ss(p_src + 2));
+#else
+	return vcombine_f32(vld1_f32(p_src), vld1_lane_f32(p_src + 2, vdup_n_f32(0), 0));
+#endif
+}
+
+// Stores the first three lanes. Never writes past p_dst[2].
+_FORCE_INLINE_ void math_vec4_store3(float *p_dst, MathVec4 p_value) {
+#ifdef MATH_SSE
+	_mm_store_sd((double *)p_dst, _mm_castps_pd(p_value));
+	_mm_store_ss(p_dst + 2, _mm_movehl_ps(p_value, p_value));
+#else
+	vst1_f32(p_dst, vget_low_f32(p_value));
+	vst1q_lane_f32(p_dst + 2, p_value, 2);
+#endif
+}
+
+_FORCE_INLINE_ MathVec4 math_vec4_add(MathVec4 p_a, MathVec4 p_b) {
+#ifdef MATH_SSE
+	return _mm_add_ps(p_a, p_b);
+#else
+	return vaddq_f32(p_a, p_b);
+#endif
+}
+
+_FORCE_INLINE_ MathVec4 math_vec4_sub(MathVec4 p_a, MathVec4 p_b) {
+#ifdef MATH_SSE
+	return _mm_sub_ps(p_a, p_b);
+#else
+	return vsubq_f32(p_a, p_b);
+#endif
+}
+
+_FORCE_INLINE_ MathVec4 math_vec4_mul(MathVec4 p_a, MathVec4 p_b) {
+#ifdef MATH_SSE
+	return _mm_mul_ps(p_a, p_b);
+#else
+	return vmulq_f32(p_a, p_b);
+#endif
+}
+
+_FORCE_INLINE_ MathVec4 math_vec4_min(MathVec4 p_a, MathVec4 p_b) {
+#ifdef MATH_SSE
+	return _mm_min_ps(p_a, p_b);
+#else
+	return vminq_f32(p_a, p_b);
+#endif
+}
+
+_FORCE_INLINE_ MathVec4 math_vec4_max(MathVec4 p_a, MathVec4 p_b) {
+#ifdef MATH_SSE
+	return _mm_max_ps(p_a, p_b);
+#else
+	return vmaxq_f32(p_a, p_b);
+#endif
+}
+
+_FORCE_INLINE_ MathVec4 math_vec4_abs(MathVec4 p_value) {
+#ifdef MATH_SSE
+	return _mm_andnot_ps(_mm_set1_ps(-0.0f), p_value);
+#else
+	return vabsq_f32(p_value);
+#endif
+}
+
+// Bit i of the result is set if lane i of p_a is greater than lane i of p_b.
+_FORCE_INLINE_ int math_vec4_greater_mask(MathVec4 p_a, MathVec4 p_b) {
+#ifdef MATH_SSE
+	return _mm_movemask_ps(_mm_cmpgt_ps(p_a, p_b));
+#else
+	static const uint32_t bits[4] = { 1, 2, 4, 8 };
+	uint32x4_t masked = vandq_u32(vcgtq_f32(p_a, p_b), vld1q_u32(bits));
+	uint32x2_t sum = vpadd_u32(vget_low_u32(masked), vget_high_u32(masked));
+	return vget_lane_u32(vpadd_u32(sum, sum), 0);
+#endif
+}
+
+#endif // MATH_SIMD
+
+#endif // MATH_SIMD_H
@@ -0,0 +1,433 @@
+/*************************************************************************/
+/*  mesh_optimizer.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "mesh_optimizer.h"
+
+#include "core/math/math_funcs.h"
+#include "core/templates/local_vector.h"
+
+// Size of the LRU cache simulated while scoring vertices in optimize_vertex_cache().
+static const int SCORE_CACHE_SIZE = 32;
+
+static float _vertex_score(int p_cache_position, uint32_t p_remaining_triangles) {
+	if (p_remaining_triangles == 0) {
+		return -1.0;
+	}
+
+	float score = 0;
+	if (p_cache_position >= 0) {
+		if (p_cache_position < 3) {
+			// Used by the last triangle, fixed so fans aren't favored over strips.
+			score = 0.75;
+		} else {
+			score = Math::pow(1.0f - float(p_cache_position - 3) / (SCORE_CACHE_SIZE - 3), 1.5f);
+		}
+	}
+
+	// Finish off vertices with few triangles left, they would only cost a reload later.
+	return score + 2.0f * Math::pow(float(p_remaining_triangles), -0.5f);
+}
+
+// FIFO cache simulation, a vertex is cached if it was loaded less than FIFO_CACHE_SIZE misses ago.
+struct MeshOptimizerFIFOCache {
+	LocalVector<uint32_t> timestamps;
+	uint32_t time = 0;
+
+	void reset() {
+		time += MeshOptimizer::FIFO_CACHE_SIZE + 1;
+	}
+
+	int add_triangle(const int *p_triangle) {
+		int misses = 0;
+		for (int i = 0; i < 3; i++) {
+			uint32_t &timestamp = timestamps[p_triangle[i]];
+			if (time - timestamp > MeshOptimizer::FIFO_CACHE_SIZE) {
+				timestamp = time++;
+				misses++;
+			}
+		}
+		return misses;
+	}
+
+	MeshOptimizerFIFOCache(int p_vertex_count) {
+		timestamps.resize(p_vertex_count);
+		for (int i = 0; i < p_vertex_count; i++) {
+			timestamps[i] = 0;
+		}
+		reset();
+	}
+};
+
+struct MeshOptimizerCluster {
+	uint32_t begin;
+	uint32_t end;
+	float sort_key;
+
+	bool operator<(const MeshOptimizerCluster &p_cluster) const {
+		return sort_key > p_cluster.sort_key;
+	}
+};
+
+Vector<int> MeshOptimizer::optimize_vertex_cache(const Vector<int> &p_indices, int p_vertex_count) {
+	ERR_FAIL_COND_V(p_indices.size() % 3 != 0, p_indices);
+
+	for (int i = 0; i < p_indices.size(); i++) {
+		ERR_FAIL_INDEX_V(p_indices[i], p_vertex_count, p_indices);
+	}
+
+	// Degenerate triangles draw nothing, and would be listed more than once around their repeated vertex.
+	Vector<int> source;
+	source.resize(p_indices.size());
+	uint32_t index_count = 0;
+	{
+		const int *r = p_indices.ptr();
+		int *w = source.ptrw();
+		for (int i = 0; i < p_indices.size(); i += 3) {
+			if (r[i + 0] == r[i + 1] || r[i + 1] == r[i + 2] || r[i + 2] == r[i + 0]) {
+				continue;
+			}
+			w[index_count++] = r[i + 0];
+			w[index_count++] = r[i + 1];
+			w[index_count++] = r[i + 2];
+		}
+	}
+	if (index_count == 0) {
+		return p_indices; // Nothing is drawn either way, keep the surface valid.
+	}
+	source.resize(index_count);
+
+	const int *indices = source.ptr();
+	uint32_t triangle_count = index_count / 3;
+
+	if (triangle_count < 2) {
+		return source;
+	}
+
+	// Triangles around each vertex, the first remaining_triangles[v] of them not emitted yet.
+	LocalVector<uint32_t> remaining_triangles;
+	LocalVector<uint32_t> adjacency_offsets;
+	LocalVector<uint32_t> adjacency;
+	remaining_triangles.resize(p_vertex_count);
+	adjacency_offsets.resize(p_vertex_count + 1);
+	adjacency.resize(index_count);
+
+	for (int i = 0; i < p_vertex_count; i++) {
+		remaining_triangles[i] = 0;
+	}
+	for (uint32_t i = 0; i < index_count; i++) {
+		remaining_triangles[indices[i]]++;
+	}
+	adjacency_offsets[0] = 0;
+	for (int i = 0; i < p_vertex_count; i++) {
+		adjacency_offsets[i + 1] = adjacency_offsets[i] + remaining_triangles[i];
+		remaining_triangles[i] = 0;
+	}
+	for (uint32_t i = 0; i < index_count; i++) {
+		uint32_t v = indices[i];
+		adjacency[adjacency_offsets[v] + remaining_triangles[v]++] = i / 3;
+	}
+
+	LocalVector<int> cache_positions;
+	LocalVector<float> vertex_scores;
+	cache_positions.resize(p_vertex_count);
+	vertex_scores.resize(p_vertex_count);
+	for (int i = 0; i < p_vertex_count; i++) {
+		cache_positions[i] = -1;
+		vertex_scores[i] = _vertex_score(-1, remaining_triangles[i]);
+	}
+
+	LocalVector<float> triangle_scores;
+	LocalVector<uint8_t> emitted;
+	triangle_scores.resize(triangle_count);
+	emitted.resize(triangle_count);
+	for (uint32_t i = 0; i < triangle_count; i++) {
+		triangle_scores[i] = vertex_scores[indices[i * 3 + 0]] + vertex_scores[indices[i * 3 + 1]] + vertex_scores[indices[i * 3 + 2]];
+		emitted[i] = 0;
+	}
+
+	uint32_t cache[SCORE_CACHE_SIZE + 3];
+	uint32_t new_cache[SCORE_CACHE_SIZE + 3];
+	uint32_t cache_count = 0;
+
+	Vector<int> result;
+	result.resize(index_count);
+	int *w = result.ptrw();
+
+	int best = -1;
+	uint32_t cursor = 0;
+
+	for (uint32_t emitted_count = 0; emitted_count < triangle_count; emitted_count++) {
+		if (best < 0) {
+			// Nothing left around the cache, continue in source order.
+			while (emitted[cursor]) {
+				cursor++;
+			}
+			best = cursor;
+		}
+
+		const int *triangle = &indices[best * 3];
+		w[emitted_count * 3 + 0] = triangle[0];
+		w[emitted_count * 3 + 1] = triangle[1];
+		w[emitted_count * 3 + 2] = triangle[2];
+		emitted[best] = 1;
+
+		// Most recently used first, then what was already in the cache.
+		uint32_t new_cache_count = 0;
+		for (int i = 0; i < 3; i++) {
+			uint32_t v = triangle[i];
+			new_cache[new_cache_count++] = v;
+
+			uint32_t *triangles = &adjacency[adjacency_offsets[v]];
+			for (uint32_t j = 0; j < remaining_triangles[v];) {
+				if (triangles[j] == (uint32_t)best) {
+					triangles[j] = triangles[--remaining_triangles[v]];
+				} else {
+					j++;
+				}
+			}
+		}
+		for (uint32_t i = 0; i < cache_count; i++) {
+			uint32_t v = cache[i];
+			if (v != (uint32_t)triangle[0] && v != (uint32_t)triangle[1] && v != (uint32_t)triangle[2]) {
+				new_cache[new_cache_count++] = v;
+			}
+		}
+
+		// Rescore everything that moved, including the vertices pushed out of the cache.
+		for (uint32_t i = 0; i < new_cache_count; i++) {
+			uint32_t v = new_cache[i];
+			cache_positions[v] = i < SCORE_CACHE_SIZE ? int(i) : -1;
+
+			float score = _vertex_score(cache_positions[v], remaining_triangles[v]);
+			float delta = score - vertex_scores[v];
+			vertex_scores[v] = score;
+
+			const uint32_t *triangles = &adjacency[adjacency_offsets[v]];
+			for (uint32_t j = 0; j < remaining_triangles[v]; j++) {
+				triangle_scores[triangles[j]] += delta;
+			}
+		}
+
+		cache_count = MIN(new_cache_count, (uint32_t)SCORE_CACHE_SIZE);
+		memcpy(cache, new_cache, cache_count * sizeof(uint32_t));
+
+		best = -1;
+		float best_score = -1.0;
+		for (uint32_t i = 0; i < cache_count; i++) {
+			uint32_t v = cache[i];
+			const uint32_t *triangles = &adjacency[adjacency_offsets[v]];
+			for (uint32_t j = 0; j < remaining_triangles[v]; j++) {
+				if (!emitted[triangles[j]] && triangle_scores[triangles[j]] > best_score) {
+					best_score = triangle_scores[triangles[j]];
+					best = triangles[j];
+				}
+			}
+		}
+	}
+
+	return result;
+}
+
+Vector<int> MeshOptimizer::optimize_overdraw(const Vector<int> &p_indices, const Vector<Vector3> &p_vertices, float p_threshold) {
+	ERR_FAIL_COND_V(p_indices.size() % 3 != 0, p_indices);
+
+	const int *indices = p_indices.ptr();
+	const Vector3 *vertices = p_vertices.ptr();
+	int vertex_count = p_vertices.size();
+	uint32_t triangle_count = p_indices.size() / 3;
+
+	for (int i = 0; i < p_indices.size(); i++) {
+		ERR_FAIL_INDEX_V(indices[i], vertex_count, p_indices);
+	}
+
+	if (triangle_count < 2) {
+		return p_indices;
+	}
+
+	// Hard boundaries where the cache order already starts over, as none of the vertices are cached.
+	LocalVector<uint32_t> hard_boundaries;
+	{
+		MeshOptimizerFIFOCache cache(vertex_count);
+		for (uint32_t i = 0; i < triangle_count; i++) {
+			if (cache.add_triangle(&indices[i * 3]) == 3 || i == 0) {
+				hard_boundaries.push_back(i);
+			}
+		}
+		hard_boundaries.push_back(triangle_count);
+	}
+
+	// Soft boundaries inside those, wherever restarting with an empty cache is still cheap enough.
+	LocalVector<MeshOptimizerCluster> clusters;
+	{
+		MeshOptimizerFIFOCache cache(vertex_count);
+
+		for (uint32_t i = 0; i + 1 < hard_boundaries.size(); i++) {
+			uint32_t begin = hard_boundaries[i];
+			uint32_t end = hard_boundaries[i + 1];
+
+			cache.reset();
+			int misses = 0;
+			for (uint32_t j = begin; j < end; j++) {
+				misses += cache.add_triangle(&indices[j * 3]);
+			}
+			float cluster_threshold = p_threshold * float(misses) / float(end - begin);
+
+			cache.reset();
+			MeshOptimizerCluster cluster;
+			cluster.begin = begin;
+			misses = 0;
+			for (uint32_t j = begin; j < end; j++) {
+				misses += cache.add_triangle(&indices[j * 3]);
+				if (j + 1 < end && float(misses) <= float(j + 1 - cluster.begin) * cluster_threshold) {
+					cluster.end = j + 1;
+					clusters.push_back(cluster);
+					cluster.begin = j + 1;
+					misses = 0;
+					cache.reset();
+				}
+			}
+			cluster.end = end;
+			clusters.push_back(cluster);
+		}
+	}
+
+	// Area weighted centroids and normals.
+	LocalVector<Vector3> cluster_centroids;
+	LocalVector<Vector3> cluster_normals;
+	cluster_centroids.resize(clusters.size());
+	cluster_normals.resize(clusters.size());
+
+	Vector3 mesh_centroid;
+	real_t mesh_area = 0;
+
+	for (uint32_t i = 0; i < clusters.size(); i++) {
+		Vector3 centroid;
+		Vector3 normal;
+		real_t area = 0;
+
+		for (uint32_t j = clusters[i].begin; j < clusters[i].end; j++) {
+			const Vector3 &a = vertices[indices[j * 3 + 0]];
+			const Vector3 &b = vertices[indices[j * 3 + 1]];
+			const Vector3 &c = vertices[indices[j * 3 + 2]];
+
+			Vector3 cross = (b - a).cross(c - a);
+			real_t triangle_area = cross.length();
+
+			centroid += (a + b + c) * (triangle_area / 3.0);
+			normal += cross;
+			area += triangle_area;
+		}
+
+		mesh_centroid += centroid;
+		mesh_area += area;
+
+		cluster_centroids[i] = area > 0 ? centroid / area : Vector3();
+		cluster_normals[i] = normal.normalized();
+	}
+
+	if (mesh_area > 0) {
+		mesh_centroid /= mesh_area;
+	}
+
+	for (uint32_t i = 0; i < clusters.size(); i++) {
+		clusters[i].sort_key = (cluster_centroids[i] - mesh_centroid).dot(cluster_normals[i]);
+	}
+
+	clusters.sort();
+
+	Vector<int> result;
+	result.resize(p_indices.size());
+	int *w = result.ptrw();
+
+	for (uint32_t i = 0; i < clusters.size(); i++) {
+		uint32_t size = (clusters[i].end - clusters[i].begin) * 3;
+		memcpy(w, &indices[clusters[i].begin * 3], size * sizeof(int));
+		w += size;
+	}
+
+	return result;
+}
+
+Vector<int> MeshOptimizer::optimize_vertex_fetch(Vector<int> &r_indices, int p_vertex_count, int &r_new_vertex_count) {
+	Vector<int> remap;
+	remap.resize(p_vertex_count);
+	int *remap_w = remap.ptrw();
+	for (int i = 0; i < p_vertex_count; i++) {
+		remap_w[i] = -1;
+	}
+
+	r_new_vertex_count = 0;
+
+	int *w = r_indices.ptrw();
+	for (int i = 0; i < r_indices.size(); i++) {
+		ERR_FAIL_INDEX_V(w[i], p_vertex_count, Vector<int>());
+
+		int &new_index = remap_w[w[i]];
+		if (new_index < 0) {
+			new_index = r_new_vertex_count++;
+		}
+		w[i] = new_index;
+	}
+
+	return remap;
+}
+
+void MeshOptimizer::analyze_vertex_cache(const Vector<int> &p_indices, int p_vertex_count, float &r_acmr, float &r_atvr) {
+	r_acmr = 0;
+	r_atvr = 0;
+
+	const int *indices = p_indices.ptr();
+	int triangle_count = p_indices.size() / 3;
+	if (triangle_count == 0) {
+		return;
+	}
+
+	MeshOptimizerFIFOCache cache(p_vertex_count);
+	LocalVector<uint8_t> used;
+	used.resize(p_vertex_count);
+	memset(used.ptr(), 0, p_vertex_count);
+
+	int misses = 0;
+	int used_count = 0;
+
+	for (int i = 0; i < triangle_count; i++) {
+		for (int j = 0; j < 3; j++) {
+			ERR_FAIL_INDEX(indices[i * 3 + j], p_vertex_count);
+			if (!used[indices[i * 3 + j]]) {
+				used[indices[i * 3 + j]] = 1;
+				used_count++;
+			}
+		}
+		misses += cache.add_triangle(&indices[i * 3]);
+	}
+
+	r_acmr = float(misses) / triangle_count;
+	r_atvr = float(misses) / used_count;
+}
@@ -0,0 +1,62 @@
+/*************************************************************************/
+/*  mesh_optimizer.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include "core/math/vector3.h"
+#include "core/templates/vector.h"
+
+class MeshOptimizer {
+public:
+	// Size of the FIFO post-transform cache that statistics and overdraw clustering assume.
+	enum {
+		FIFO_CACHE_SIZE = 16
+	};
+
+	// Reorders triangles so consecutive ones share vertices (Forsyth's linear-speed algorithm),
+	// which works for any cache size or replacement policy. Degenerate triangles are dropped.
+	static Vector<int> optimize_vertex_cache(const Vector<int> &p_indices, int p_vertex_count);
+
+	// Splits cache optimized triangles into clusters, then draws the outward facing clusters first so
+	// they occlude the rest. Clusters are only split while the cache efficiency stays within p_threshold
+	// of the input (1.05 allows 5% more cache misses).
+	static Vector<int> optimize_overdraw(const Vector<int> &p_indices, const Vector<Vector3> &p_vertices, float p_threshold = 1.05);
+
+	// Rewrites r_indices so vertices are numbered in the order they're first used, and returns the
+	// remap from old to new vertex numbers (-1 for unused vertices, which are dropped).
+	static Vector<int> optimize_vertex_fetch(Vector<int> &r_indices, int p_vertex_count, int &r_new_vertex_count);
+
+	// Average cache miss ratio (misses per triangle, 0.5 at best) and average transformed to
+	// vertex ratio (misses per vertex, 1.0 at best) on a FIFO_CACHE_SIZE cache.
+	static void analyze_vertex_cache(const Vector<int> &p_indices, int p_vertex_count, float &r_acmr, float &r_atvr);
+};
+
+#endif // MESH_OPTIMIZER_H
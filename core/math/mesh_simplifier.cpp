@@ -0,0 +1,428 @@
+/*************************************************************************/
+/*  mesh_simplifier.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "mesh_simplifier.h"
+
+#include "core/math/aabb.h"
+#include "core/templates/local_vector.h"
+
+// The attribute penalty is scaled by the length of the collapsed edge, so it is in mesh units like the quadric error.
+static const double NORMAL_ERROR_WEIGHT = 0.5;
+static const double UV_ERROR_WEIGHT = 0.25;
+
+struct MeshSimplifierQuadric {
+	double a00 = 0, a11 = 0, a22 = 0;
+	double a01 = 0, a02 = 0, a12 = 0;
+	double b0 = 0, b1 = 0, b2 = 0;
+	double c = 0;
+	double weight = 0;
+
+	void add_plane(const Vector3 &p_normal, double p_d, double p_weight) {
+		double x = p_normal.x;
+		double y = p_normal.y;
+		double z = p_normal.z;
+
+		a00 += p_weight * x * x;
+		a11 += p_weight * y * y;
+		a22 += p_weight * z * z;
+		a01 += p_weight * x * y;
+		a02 += p_weight * x * z;
+		a12 += p_weight * y * z;
+		b0 += p_weight * x * p_d;
+		b1 += p_weight * y * p_d;
+		b2 += p_weight * z * p_d;
+		c += p_weight * p_d * p_d;
+		weight += p_weight;
+	}
+
+	void operator+=(const MeshSimplifierQuadric &p_quadric) {
+		a00 += p_quadric.a00;
+		a11 += p_quadric.a11;
+		a22 += p_quadric.a22;
+		a01 += p_quadric.a01;
+		a02 += p_quadric.a02;
+		a12 += p_quadric.a12;
+		b0 += p_quadric.b0;
+		b1 += p_quadric.b1;
+		b2 += p_quadric.b2;
+		c += p_quadric.c;
+		weight += p_quadric.weight;
+	}
+
+	// Weighted mean squared distance from p_point to the accumulated planes.
+	double get_error(const Vector3 &p_point) const {
+		if (weight <= 0) {
+			return 0;
+		}
+
+		double x = p_point.x;
+		double y = p_point.y;
+		double z = p_point.z;
+
+		double e = a00 * x * x + a11 * y * y + a22 * z * z;
+		e += 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z);
+		e += 2.0 * (b0 * x + b1 * y + b2 * z);
+		e += c;
+
+		return MAX(e, 0.0) / weight;
+	}
+};
+
+struct MeshSimplifierSortedVertex {
+	Vector3 position;
+	uint32_t index;
+
+	bool operator<(const MeshSimplifierSortedVertex &p_vertex) const {
+		if (position == p_vertex.position) {
+			return index < p_vertex.index;
+		}
+		return position < p_vertex.position;
+	}
+};
+
+struct MeshSimplifierCollapse {
+	uint32_t from;
+	uint32_t to;
+	float error;
+
+	bool operator<(const MeshSimplifierCollapse &p_collapse) const {
+		return error < p_collapse.error;
+	}
+};
+
+Vector<int> MeshSimplifier::simplify(const Vector<Vector3> &p_vertices, const Vector<Vector3> &p_normals, const Vector<Vector2> &p_uvs, const Vector<int> &p_indices, int p_target_index_count, float p_max_error, float *r_error) {
+	if (r_error) {
+		*r_error = 0;
+	}
+
+	uint32_t vertex_count = p_vertices.size();
+	ERR_FAIL_COND_V(p_indices.size() % 3 != 0, p_indices);
+	ERR_FAIL_COND_V(p_normals.size() && (uint32_t)p_normals.size() != vertex_count, p_indices);
+	ERR_FAIL_COND_V(p_uvs.size() && (uint32_t)p_uvs.size() != vertex_count, p_indices);
+
+	if (p_indices.size() <= p_target_index_count || vertex_count == 0) {
+		return p_indices;
+	}
+
+	const Vector3 *vertices = p_vertices.ptr();
+	const Vector3 *normals = p_normals.size() ? p_normals.ptr() : nullptr;
+	const Vector2 *uvs = p_uvs.size() ? p_uvs.ptr() : nullptr;
+
+	LocalVector<uint32_t> indices;
+	indices.resize(p_indices.size());
+	for (int i = 0; i < p_indices.size(); i++) {
+		ERR_FAIL_INDEX_V(p_indices[i], (int)vertex_count, p_indices);
+		indices[i] = p_indices[i];
+	}
+
+	AABB aabb;
+	aabb.position = vertices[0];
+	for (uint32_t i = 1; i < vertex_count; i++) {
+		aabb.expand_to(vertices[i]);
+	}
+
+	float max_error = p_max_error * aabb.get_longest_axis_size();
+	if (max_error <= 0) {
+		return p_indices;
+	}
+
+	// Vertices sharing a position are welded for the quadrics and the topology,
+	// each position is represented by its lowest vertex index.
+	LocalVector<uint32_t> position_ids;
+	position_ids.resize(vertex_count);
+	{
+		LocalVector<MeshSimplifierSortedVertex> sorted;
+		sorted.resize(vertex_count);
+		for (uint32_t i = 0; i < vertex_count; i++) {
+			sorted[i].position = vertices[i];
+			sorted[i].index = i;
+		}
+		sorted.sort();
+
+		for (uint32_t i = 0; i < vertex_count; i++) {
+			if (i > 0 && sorted[i].position == sorted[i - 1].position) {
+				position_ids[sorted[i].index] = position_ids[sorted[i - 1].index];
+			} else {
+				position_ids[sorted[i].index] = sorted[i].index;
+			}
+		}
+	}
+
+	LocalVector<MeshSimplifierQuadric> quadrics;
+	quadrics.resize(vertex_count);
+
+	for (uint32_t i = 0; i < indices.size(); i += 3) {
+		const Vector3 &v0 = vertices[indices[i + 0]];
+		Vector3 normal = (vertices[indices[i + 1]] - v0).cross(vertices[indices[i + 2]] - v0);
+		real_t length = normal.length();
+		if (length == 0) {
+			continue;
+		}
+		normal /= length;
+
+		// Weighted by area, so small triangles don't hold back collapses on large flat regions.
+		double d = -normal.dot(v0);
+		for (uint32_t j = 0; j < 3; j++) {
+			quadrics[position_ids[indices[i + j]]].add_plane(normal, d, length * 0.5);
+		}
+	}
+
+	// Border and non-manifold edges, as well as positions referenced through more than one vertex
+	// (UV or normal seams), must stay in place or the silhouette and the seams would open up.
+	LocalVector<uint8_t> locked;
+	locked.resize(vertex_count);
+	memset(locked.ptr(), 0, vertex_count);
+	{
+		LocalVector<uint32_t> position_vertex;
+		position_vertex.resize(vertex_count);
+		for (uint32_t i = 0; i < vertex_count; i++) {
+			position_vertex[i] = UINT32_MAX;
+		}
+
+		LocalVector<uint64_t> edges;
+		edges.resize(indices.size());
+
+		for (uint32_t i = 0; i < indices.size(); i++) {
+			uint32_t position = position_ids[indices[i]];
+			if (position_vertex[position] == UINT32_MAX) {
+				position_vertex[position] = indices[i];
+			} else if (position_vertex[position] != indices[i]) {
+				locked[position] = 1;
+			}
+
+			uint32_t a = position;
+			uint32_t b = position_ids[indices[(i % 3) == 2 ? i - 2 : i + 1]];
+			if (a > b) {
+				SWAP(a, b);
+			}
+			edges[i] = (uint64_t(a) << 32) | b;
+		}
+
+		edges.sort();
+
+		for (uint32_t i = 0; i < edges.size();) {
+			uint32_t count = 1;
+			while (i + count < edges.size() && edges[i + count] == edges[i]) {
+				count++;
+			}
+			if (count != 2) {
+				locked[edges[i] >> 32] = 1;
+				locked[edges[i] & 0xFFFFFFFF] = 1;
+			}
+			i += count;
+		}
+	}
+
+	LocalVector<uint32_t> adjacency_offsets;
+	LocalVector<uint32_t> adjacency;
+	LocalVector<MeshSimplifierCollapse> collapses;
+	LocalVector<uint8_t> touched;
+	LocalVector<uint32_t> remap;
+	adjacency_offsets.resize(vertex_count + 1);
+	touched.resize(vertex_count);
+	remap.resize(vertex_count);
+
+	float result_error = 0;
+
+	// Each pass applies as many independent collapses as it can, cheapest first, then rebuilds the index list.
+	while (indices.size() > (uint32_t)p_target_index_count) {
+		// Triangles around each vertex.
+		memset(adjacency_offsets.ptr(), 0, sizeof(uint32_t) * (vertex_count + 1));
+		for (uint32_t i = 0; i < indices.size(); i++) {
+			adjacency_offsets[indices[i] + 1]++;
+		}
+		for (uint32_t i = 0; i < vertex_count; i++) {
+			adjacency_offsets[i + 1] += adjacency_offsets[i];
+		}
+		adjacency.resize(indices.size());
+		for (uint32_t i = 0; i < indices.size(); i++) {
+			adjacency[adjacency_offsets[indices[i]]++] = i / 3;
+		}
+		// Filling advanced every offset to the start of the next vertex, shift them back.
+		for (uint32_t i = vertex_count; i > 0; i--) {
+			adjacency_offsets[i] = adjacency_offsets[i - 1];
+		}
+		adjacency_offsets[0] = 0;
+
+		// Cheapest collapse of every free vertex onto one of its neighbours.
+		collapses.clear();
+		for (uint32_t u = 0; u < vertex_count; u++) {
+			uint32_t pu = position_ids[u];
+			if (locked[pu] || adjacency_offsets[u] == adjacency_offsets[u + 1]) {
+				continue;
+			}
+
+			MeshSimplifierCollapse best;
+			best.from = u;
+			best.to = UINT32_MAX;
+			best.error = 0;
+
+			for (uint32_t i = adjacency_offsets[u]; i < adjacency_offsets[u + 1]; i++) {
+				const uint32_t *triangle = &indices[adjacency[i] * 3];
+
+				for (uint32_t j = 0; j < 3; j++) {
+					uint32_t v = triangle[j];
+					uint32_t pv = position_ids[v];
+					if (pv == pu) {
+						continue;
+					}
+
+					MeshSimplifierQuadric quadric = quadrics[pu];
+					quadric += quadrics[pv];
+					double error = Math::sqrt(quadric.get_error(vertices[v]));
+
+					double attribute_error = 0;
+					if (normals) {
+						attribute_error += NORMAL_ERROR_WEIGHT * (normals[u] - normals[v]).length();
+					}
+					if (uvs) {
+						attribute_error += UV_ERROR_WEIGHT * (uvs[u] - uvs[v]).length();
+					}
+					error += attribute_error * (vertices[v] - vertices[u]).length();
+
+					if (best.to == UINT32_MAX || error < best.error) {
+						best.to = v;
+						best.error = error;
+					}
+				}
+			}
+
+			if (best.to != UINT32_MAX && best.error <= max_error) {
+				collapses.push_back(best);
+			}
+		}
+
+		if (collapses.empty()) {
+			break;
+		}
+
+		collapses.sort();
+
+		memset(touched.ptr(), 0, vertex_count);
+		for (uint32_t i = 0; i < vertex_count; i++) {
+			remap[i] = i;
+		}
+
+		uint32_t remove_goal = (indices.size() - p_target_index_count + 2) / 3;
+		uint32_t removed = 0;
+
+		for (uint32_t i = 0; i < collapses.size() && removed < remove_goal; i++) {
+			const MeshSimplifierCollapse &collapse = collapses[i];
+			uint32_t pu = position_ids[collapse.from];
+			uint32_t pv = position_ids[collapse.to];
+			if (touched[pu] || touched[pv]) {
+				continue;
+			}
+
+			// Reject collapses that would flip a surviving triangle.
+			const Vector3 &target = vertices[collapse.to];
+			uint32_t collapsed = 0;
+			bool flips = false;
+
+			for (uint32_t j = adjacency_offsets[collapse.from]; j < adjacency_offsets[collapse.from + 1]; j++) {
+				const uint32_t *triangle = &indices[adjacency[j] * 3];
+				if (position_ids[triangle[0]] == pv || position_ids[triangle[1]] == pv || position_ids[triangle[2]] == pv) {
+					collapsed++;
+					continue;
+				}
+
+				Vector3 corners[3];
+				for (uint32_t k = 0; k < 3; k++) {
+					corners[k] = vertices[triangle[k]];
+				}
+				Vector3 normal = (corners[1] - corners[0]).cross(corners[2] - corners[0]);
+
+				for (uint32_t k = 0; k < 3; k++) {
+					if (triangle[k] == collapse.from) {
+						corners[k] = target;
+					}
+				}
+				Vector3 new_normal = (corners[1] - corners[0]).cross(corners[2] - corners[0]);
+
+				if (normal.dot(new_normal) <= 0) {
+					flips = true;
+					break;
+				}
+			}
+
+			if (flips) {
+				continue;
+			}
+
+			// Everything around the collapse is off limits for the rest of the pass,
+			// so the flip test above stays valid.
+			for (uint32_t j = adjacency_offsets[collapse.from]; j < adjacency_offsets[collapse.from + 1]; j++) {
+				const uint32_t *triangle = &indices[adjacency[j] * 3];
+				for (uint32_t k = 0; k < 3; k++) {
+					touched[position_ids[triangle[k]]] = 1;
+				}
+			}
+
+			remap[collapse.from] = collapse.to;
+			quadrics[pv] += quadrics[pu];
+			removed += collapsed;
+			result_error = MAX(result_error, collapse.error);
+		}
+
+		if (removed == 0) {
+			break;
+		}
+
+		uint32_t index_count = 0;
+		for (uint32_t i = 0; i < indices.size(); i += 3) {
+			uint32_t a = remap[indices[i + 0]];
+			uint32_t b = remap[indices[i + 1]];
+			uint32_t c = remap[indices[i + 2]];
+
+			if (position_ids[a] == position_ids[b] || position_ids[b] == position_ids[c] || position_ids[a] == position_ids[c]) {
+				continue;
+			}
+
+			indices[index_count + 0] = a;
+			indices[index_count + 1] = b;
+			indices[index_count + 2] = c;
+			index_count += 3;
+		}
+		indices.resize(index_count);
+	}
+
+	if (r_error) {
+		*r_error = result_error;
+	}
+
+	Vector<int> result;
+	result.resize(indices.size());
+	int *w = result.ptrw();
+	for (uint32_t i = 0; i < indices.size(); i++) {
+		w[i] = indices[i];
+	}
+
+	return result;
+}
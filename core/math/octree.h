@@ -304,6 +304,11 @@ private:
 		uint32_t mask;
 	};
 
+	enum {
+		CULL_CONVEX_BATCH = 16
+	};
+
+	bool _cull_convex_elements(List<Element *, AL> &p_elements, _CullConvexData *p_cull);
 	void _cull_convex(Octant *p_octant, _CullConvexData *p_cull);
 	void _cull_aabb(Octant *p_octant, const AABB &p_aabb, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask);
 	void _cull_segment(Octant *p_octant, const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask);
@@ -334,6 +339,7 @@ public:
 	int get_subindex(OctreeElementID p_id) const;
 
 	int cull_convex(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF);
+	int cull_convex(const Plane *p_planes, int p_plane_count, T **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF);
 	int cull_aabb(const AABB &p_aabb, T **p_result_array, int p_result_max, int *p_subindex_array = nullptr, uint32_t p_mask = 0xFFFFFFFF);
 	int cull_segment(const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int p_result_max, int *p_subindex_array = nullptr, uint32_t p_mask = 0xFFFFFFFF);
 
@@ -938,60 +944,75 @@ void Octree<T, use_pairs, AL>::erase(OctreeElementID p_id) {
 }
 
 template <class T, bool use_pairs, class AL>
-void Octree<T, use_pairs, AL>::_cull_convex(Octant *p_octant, _CullConvexData *p_cull) {
-	if (*p_cull->result_idx == p_cull->result_max) {
-		return; //pointless
-	}
+bool Octree<T, use_pairs, AL>::_cull_convex_elements(List<Element *, AL> &p_elements, _CullConvexData *p_cull) {
+	// Elements are tested in batches, so their boxes can be tested against the shape together.
+	Element *batch[CULL_CONVEX_BATCH];
+	AABB batch_aabbs[CULL_CONVEX_BATCH];
+	bool batch_results[CULL_CONVEX_BATCH];
+	int batch_count = 0;
 
-	if (!p_octant->elements.empty()) {
-		typename List<Element *, AL>::Element *I;
-		I = p_octant->elements.front();
+	for (typename List<Element *, AL>::Element *I = p_elements.front(); I; I = I->next()) {
+		Element *e = I->get();
 
-		for (; I; I = I->next()) {
-			Element *e = I->get();
+		if (e->last_pass != pass && (!use_pairs || (e->pairable_type & p_cull->mask))) {
+			e->last_pass = pass;
+			batch[batch_count] = e;
+			batch_aabbs[batch_count] = e->aabb;
+			batch_count++;
+		}
+
+		if (batch_count == 0 || (batch_count < CULL_CONVEX_BATCH && I->next())) {
+			continue;
+		}
 
-			if (e->last_pass == pass || (use_pairs && !(e->pairable_type & p_cull->mask))) {
+		AABB::intersects_convex_shape_array(batch_aabbs, batch_count, p_cull->planes, p_cull->plane_count, p_cull->points, p_cull->point_count, batch_results);
+		for (int i = 0; i < batch_count; i++) {
+			if (!batch_results[i]) {
 				continue;
 			}
-			e->last_pass = pass;
-
-			if (e->aabb.intersects_convex_shape(p_cull->planes, p_cull->plane_count, p_cull->points, p_cull->point_count)) {
-				if (*p_cull->result_idx < p_cull->result_max) {
-					p_cull->result_array[*p_cull->result_idx] = e->userdata;
-					(*p_cull->result_idx)++;
-				} else {
-					return; // pointless to continue
-				}
+			if (*p_cull->result_idx < p_cull->result_max) {
+				p_cull->result_array[*p_cull->result_idx] = batch[i]->userdata;
+				(*p_cull->result_idx)++;
+			} else {
+				return false; // pointless to continue
 			}
 		}
+		batch_count = 0;
 	}
 
-	if (use_pairs && !p_octant->pairable_elements.empty()) {
-		typename List<Element *, AL>::Element *I;
-		I = p_octant->pairable_elements.front();
+	return true;
+}
 
-		for (; I; I = I->next()) {
-			Element *e = I->get();
+template <class T, bool use_pairs, class AL>
+void Octree<T, use_pairs, AL>::_cull_convex(Octant *p_octant, _CullConvexData *p_cull) {
+	if (*p_cull->result_idx == p_cull->result_max) {
+		return; //pointless
+	}
 
-			if (e->last_pass == pass || (use_pairs && !(e->pairable_type & p_cull->mask))) {
-				continue;
-			}
-			e->last_pass = pass;
+	if (!p_octant->elements.empty() && !_cull_convex_elements(p_octant->elements, p_cull)) {
+		return;
+	}
 
-			if (e->aabb.intersects_convex_shape(p_cull->planes, p_cull->plane_count, p_cull->points, p_cull->point_count)) {
-				if (*p_cull->result_idx < p_cull->result_max) {
-					p_cull->result_array[*p_cull->result_idx] = e->userdata;
-					(*p_cull->result_idx)++;
-				} else {
-					return; // pointless to continue
-				}
-			}
-		}
+	if (use_pairs && !p_octant->pairable_elements.empty() && !_cull_convex_elements(p_octant->pairable_elements, p_cull)) {
+		return;
 	}
 
+	Octant *children[8];
+	AABB children_aabbs[8];
+	bool children_results[8];
+	int child_count = 0;
 	for (int i = 0; i < 8; i++) {
-		if (p_octant->children[i] && p_octant->children[i]->aabb.intersects_convex_shape(p_cull->planes, p_cull->plane_count, p_cull->points, p_cull->point_count)) {
-			_cull_convex(p_octant->children[i], p_cull);
+		if (p_octant->children[i]) {
+			children[child_count] = p_octant->children[i];
+			children_aabbs[child_count] = p_octant->children[i]->aabb;
+			child_count++;
+		}
+	}
+
+	AABB::intersects_convex_shape_array(children_aabbs, child_count, p_cull->planes, p_cull->plane_count, p_cull->points, p_cull->point_count, children_results);
+	for (int i = 0; i < child_count; i++) {
+		if (children_results[i]) {
+			_cull_convex(children[i], p_cull);
 		}
 	}
 }
@@ -1197,11 +1218,18 @@ void Octree<T, use_pairs, AL>::_cull_point(Octant *p_octant, const Vector3 &p_po
 
 template <class T, bool use_pairs, class AL>
 int Octree<T, use_pairs, AL>::cull_convex(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask) {
-	if (!root || p_convex.size() == 0) {
+	return cull_convex(p_convex.ptr(), p_convex.size(), p_result_array, p_result_max, p_mask);
+}
+
+template <class T, bool use_pairs, class AL>
+int Octree<T, use_pairs, AL>::cull_convex(const Plane *p_planes, int p_plane_count, T **p_result_array, int p_result_max, uint32_t p_mask) {
+	if (!root || p_plane_count == 0) {
 		return 0;
 	}
 
-	Vector<Vector3> convex_points = Geometry3D::compute_convex_mesh_points(&p_convex[0], p_convex.size());
+	// Culling runs every frame, keep the points out of the heap.
+	FrameVector<Vector3> convex_points;
+	Geometry3D::compute_convex_mesh_points(p_planes, p_plane_count, convex_points);
 	if (convex_points.size() == 0) {
 		return 0;
 	}
@@ -1209,9 +1237,9 @@ int Octree<T, use_pairs, AL>::cull_convex(const Vector<Plane> &p_convex, T **p_r
 	int result_count = 0;
 	pass++;
 	_CullConvexData cdata;
-	cdata.planes = &p_convex[0];
-	cdata.plane_count = p_convex.size();
-	cdata.points = &convex_points[0];
+	cdata.planes = p_planes;
+	cdata.plane_count = p_plane_count;
+	cdata.points = convex_points.ptr();
 	cdata.point_count = convex_points.size();
 	cdata.result_array = p_result_array;
 	cdata.result_max = p_result_max;
@@ -31,6 +31,7 @@
 #include "transform.h"
 
 #include "core/math/math_funcs.h"
+#include "core/math/math_simd.h"
 #include "core/os/copymem.h"
 #include "core/string/print_string.h"
 
@@ -191,6 +192,65 @@ Transform Transform::operator*(const Transform &p_transform) const {
 	return t;
 }
 
+void Transform::xform_array(const Vector3 *p_src, Vector3 *r_dst, int p_count) const {
+#ifdef MATH_SIMD
+	// Same operations as xform(), so results are identical, but the matrix stays in registers.
+	const MathVec4 col_x = math_vec4_set(basis.elements[0][0], basis.elements[1][0], basis.elements[2][0], 0);
+	const MathVec4 col_y = math_vec4_set(basis.elements[0][1], basis.elements[1][1], basis.elements[2][1], 0);
+	const MathVec4 col_z = math_vec4_set(basis.elements[0][2], basis.elements[1][2], basis.elements[2][2], 0);
+	const MathVec4 ofs = math_vec4_load3(&origin.x);
+
+	for (int i = 0; i < p_count; i++) {
+		const Vector3 &v = p_src[i];
+		MathVec4 r = math_vec4_add(math_vec4_mul(col_x, math_vec4_splat(v.x)), math_vec4_mul(col_y, math_vec4_splat(v.y)));
+		r = math_vec4_add(r, math_vec4_mul(col_z, math_vec4_splat(v.z)));
+		math_vec4_store3(&r_dst[i].x, math_vec4_add(r, ofs));
+	}
+#else
+	for (int i = 0; i < p_count; i++) {
+		r_dst[i] = xform(p_src[i]);
+	}
+#endif
+}
+
+void Transform::xform_array(const Transform *p_src, Transform *r_dst, int p_count) const {
+#ifdef MATH_SIMD
+	// Each row of the result is a combination of the rows of p_src[i], weighted by the row of this basis.
+	MathVec4 weights[3][3];
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			weights[i][j] = math_vec4_splat(basis.elements[i][j]);
+		}
+	}
+	const MathVec4 col_x = math_vec4_set(basis.elements[0][0], basis.elements[1][0], basis.elements[2][0], 0);
+	const MathVec4 col_y = math_vec4_set(basis.elements[0][1], basis.elements[1][1], basis.elements[2][1], 0);
+	const MathVec4 col_z = math_vec4_set(basis.elements[0][2], basis.elements[1][2], basis.elements[2][2], 0);
+	const MathVec4 ofs = math_vec4_load3(&origin.x);
+
+	for (int i = 0; i < p_count; i++) {
+		const Transform &t = p_src[i];
+		const MathVec4 rows[3] = {
+			math_vec4_load3(&t.basis.elements[0].x),
+			math_vec4_load3(&t.basis.elements[1].x),
+			math_vec4_load3(&t.basis.elements[2].x),
+		};
+		MathVec4 o = math_vec4_add(math_vec4_mul(col_x, math_vec4_splat(t.origin.x)), math_vec4_mul(col_y, math_vec4_splat(t.origin.y)));
+		o = math_vec4_add(math_vec4_add(o, math_vec4_mul(col_z, math_vec4_splat(t.origin.z))), ofs);
+
+		Transform &dst = r_dst[i];
+		for (int j = 0; j < 3; j++) {
+			MathVec4 row = math_vec4_add(math_vec4_mul(rows[0], weights[j][0]), math_vec4_mul(rows[1], weights[j][1]));
+			math_vec4_store3(&dst.basis.elements[j].x, math_vec4_add(row, math_vec4_mul(rows[2], weights[j][2])));
+		}
+		math_vec4_store3(&dst.origin.x, o);
+	}
+#else
+	for (int i = 0; i < p_count; i++) {
+		r_dst[i] = *this * p_src[i];
+	}
+#endif
+}
+
 Transform::operator String() const {
 	return basis.operator String() + " - " + origin.operator String();
 }
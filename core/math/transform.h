@@ -86,6 +86,10 @@ public:
 	_FORCE_INLINE_ Vector<Vector3> xform(const Vector<Vector3> &p_array) const;
 	_FORCE_INLINE_ Vector<Vector3> xform_inv(const Vector<Vector3> &p_array) const;
 
+	// Batch versions for hot loops, p_src and r_dst may be the same array.
+	void xform_array(const Vector3 *p_src, Vector3 *r_dst, int p_count) const; ///< Same as xform() on each point
+	void xform_array(const Transform *p_src, Transform *r_dst, int p_count) const; ///< r_dst[i] = *this * p_src[i]
+
 	void operator*=(const Transform &p_transform);
 	Transform operator*(const Transform &p_transform) const;
 
@@ -207,12 +211,7 @@ Vector<Vector3> Transform::xform(const Vector<Vector3> &p_array) const {
 	Vector<Vector3> array;
 	array.resize(p_array.size());
 
-	const Vector3 *r = p_array.ptr();
-	Vector3 *w = array.ptrw();
-
-	for (int i = 0; i < p_array.size(); ++i) {
-		w[i] = xform(r[i]);
-	}
+	xform_array(p_array.ptr(), array.ptrw(), p_array.size());
 	return array;
 }
 
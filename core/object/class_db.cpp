@@ -238,7 +238,7 @@ ClassDB::APIType ClassDB::get_current_api() {
 	return current_api;
 }
 
-HashMap<StringName, ClassDB::ClassInfo> ClassDB::classes;
+OrderedHashMap<StringName, ClassDB::ClassInfo> ClassDB::classes;
 HashMap<StringName, StringName> ClassDB::resource_base_extensions;
 HashMap<StringName, StringName> ClassDB::compat_classes;
 
@@ -264,10 +264,8 @@ bool ClassDB::is_parent_class(const StringName &p_class, const StringName &p_inh
 void ClassDB::get_class_list(List<StringName> *p_classes) {
 	OBJTYPE_RLOCK;
 
-	const StringName *k = nullptr;
-
-	while ((k = classes.next(k))) {
-		p_classes->push_back(*k);
+	for (OrderedHashMap<StringName, ClassInfo>::Element E = classes.front(); E; E = E.next()) {
+		p_classes->push_back(E.key());
 	}
 
 	p_classes->sort();
@@ -276,11 +274,9 @@ void ClassDB::get_class_list(List<StringName> *p_classes) {
 void ClassDB::get_inheriters_from_class(const StringName &p_class, List<StringName> *p_classes) {
 	OBJTYPE_RLOCK;
 
-	const StringName *k = nullptr;
-
-	while ((k = classes.next(k))) {
-		if (*k != p_class && _is_parent_class(*k, p_class)) {
-			p_classes->push_back(*k);
+	for (OrderedHashMap<StringName, ClassInfo>::Element E = classes.front(); E; E = E.next()) {
+		if (E.key() != p_class && _is_parent_class(E.key(), p_class)) {
+			p_classes->push_back(E.key());
 		}
 	}
 }
@@ -288,11 +284,9 @@ void ClassDB::get_inheriters_from_class(const StringName &p_class, List<StringNa
 void ClassDB::get_direct_inheriters_from_class(const StringName &p_class, List<StringName> *p_classes) {
 	OBJTYPE_RLOCK;
 
-	const StringName *k = nullptr;
-
-	while ((k = classes.next(k))) {
-		if (*k != p_class && _get_parent_class(*k) == p_class) {
-			p_classes->push_back(*k);
+	for (OrderedHashMap<StringName, ClassInfo>::Element E = classes.front(); E; E = E.next()) {
+		if (E.key() != p_class && _get_parent_class(E.key()) == p_class) {
+			p_classes->push_back(E.key());
 		}
 	}
 }
@@ -348,10 +342,8 @@ uint64_t ClassDB::get_api_hash(APIType p_api) {
 
 	List<StringName> names;
 
-	const StringName *k = nullptr;
-
-	while ((k = classes.next(k))) {
-		names.push_back(*k);
+	for (OrderedHashMap<StringName, ClassInfo>::Element E = classes.front(); E; E = E.next()) {
+		names.push_back(E.key());
 	}
 	//must be alphabetically sorted for hash to compute
 	names.sort_custom<StringName::AlphCompare>();
@@ -369,7 +361,7 @@ uint64_t ClassDB::get_api_hash(APIType p_api) {
 
 			List<StringName> snames;
 
-			k = nullptr;
+			const StringName *k = nullptr;
 
 			while ((k = t->method_map.next(k))) {
 				String name = k->operator String();
@@ -415,7 +407,7 @@ uint64_t ClassDB::get_api_hash(APIType p_api) {
 
 			List<StringName> snames;
 
-			k = nullptr;
+			const StringName *k = nullptr;
 
 			while ((k = t->constant_map.next(k))) {
 				snames.push_back(*k);
@@ -433,7 +425,7 @@ uint64_t ClassDB::get_api_hash(APIType p_api) {
 
 			List<StringName> snames;
 
-			k = nullptr;
+			const StringName *k = nullptr;
 
 			while ((k = t->signal_map.next(k))) {
 				snames.push_back(*k);
@@ -454,7 +446,7 @@ uint64_t ClassDB::get_api_hash(APIType p_api) {
 
 			List<StringName> snames;
 
-			k = nullptr;
+			const StringName *k = nullptr;
 
 			while ((k = t->property_setget.next(k))) {
 				snames.push_back(*k);
@@ -1551,10 +1543,8 @@ void ClassDB::cleanup_defaults() {
 void ClassDB::cleanup() {
 	//OBJTYPE_LOCK; hah not here
 
-	const StringName *k = nullptr;
-
-	while ((k = classes.next(k))) {
-		ClassInfo &ti = classes[*k];
+	for (OrderedHashMap<StringName, ClassInfo>::Element E = classes.front(); E; E = E.next()) {
+		ClassInfo &ti = E.value();
 
 		const StringName *m = nullptr;
 		while ((m = ti.method_map.next(m))) {
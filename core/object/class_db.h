@@ -34,6 +34,7 @@
 #include "core/object/method_bind.h"
 #include "core/object/object.h"
 #include "core/string/print_string.h"
+#include "core/templates/ordered_hash_map.h"
 
 /** To bind more then 6 parameters include this:
  *
@@ -147,7 +148,7 @@ public:
 	}
 
 	static RWLock *lock;
-	static HashMap<StringName, ClassInfo> classes;
+	static OrderedHashMap<StringName, ClassInfo> classes;
 	static HashMap<StringName, StringName> resource_base_extensions;
 	static HashMap<StringName, StringName> compat_classes;
 
@@ -0,0 +1,75 @@
+/*************************************************************************/
+/*  dir_watcher.h                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef DIR_WATCHER_H
+#define DIR_WATCHER_H
+
+#include "core/string/ustring.h"
+#include "core/templates/local_vector.h"
+
+// Notifies about changes in watched directories (not recursive, each directory needs its own watch).
+// Platforms without support leave create() returning nullptr, users must then assume everything changed.
+class DirWatcher {
+public:
+	struct Event {
+		int watch = -1; // -1 when events were lost, anything may have changed.
+		bool watch_removed = false; // The watch is no longer valid (directory deleted or moved).
+	};
+
+	typedef DirWatcher *(*CreateFunc)();
+
+private:
+	static CreateFunc create_func;
+
+protected:
+	template <class T>
+	static DirWatcher *_create_builtin() {
+		return memnew(T);
+	}
+
+public:
+	static DirWatcher *create();
+
+	template <class T>
+	static void make_default() {
+		create_func = _create_builtin<T>;
+	}
+
+	// Returns a watch ID, or -1 on failure (e.g. out of watches). When removals only, just deletions and moves out are reported.
+	virtual int add_watch(const String &p_path, bool p_removals_only = false) = 0;
+	// Non blocking, appends the pending events.
+	virtual void poll(LocalVector<Event> &r_events) = 0;
+
+	DirWatcher() {}
+	virtual ~DirWatcher() {}
+};
+
+#endif // DIR_WATCHER_H
@@ -0,0 +1,257 @@
+/*************************************************************************/
+/*  frame_arena.cpp                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "frame_arena.h"
+
+#include "core/error/error_macros.h"
+#include "core/os/memory.h"
+
+#include <atomic>
+#include <string.h>
+
+struct FrameArena::Chunk {
+	Chunk *prev;
+	size_t size;
+};
+
+struct FrameArena::Header {
+	size_t size;
+	Arena *owner;
+};
+
+struct FrameArena::Arena {
+	// Newest chunk, allocations are only made from it.
+	Chunk *chunk;
+	uint8_t *pos;
+	uint8_t *end;
+	// Most recent allocation, if nothing was allocated after it.
+	uint8_t *last;
+	uint32_t live;
+	size_t capacity;
+	size_t next_chunk_size;
+	// Highest usage since the last trim.
+	size_t peak;
+	uint64_t trim_frame;
+	bool initialized;
+	bool released;
+};
+
+struct FrameArena::ArenaReleaser {
+	void touch() {}
+	~ArenaReleaser() {
+		FrameArena::_release_arena();
+	}
+};
+
+thread_local FrameArena::Arena FrameArena::arena;
+thread_local FrameArena::ArenaReleaser FrameArena::arena_releaser;
+
+static std::atomic<uint64_t> frame_arena_frame;
+
+static _FORCE_INLINE_ size_t _frame_arena_align(size_t p_bytes) {
+	return (p_bytes + 15) & ~size_t(15);
+}
+
+uint8_t *FrameArena::_alloc_from_new_chunk(size_t p_size) {
+	Arena &a = arena;
+
+	if (unlikely(!a.initialized)) {
+		// Makes sure the chunks are freed when the thread exits.
+		arena_releaser.touch();
+		a.initialized = true;
+	}
+
+	// Grow geometrically while chunks are being added within a frame.
+	size_t chunk_size = MAX(MAX(a.next_chunk_size, a.capacity), (size_t)MIN_CHUNK_SIZE);
+	while (chunk_size < p_size + ALIGN) {
+		chunk_size <<= 1;
+	}
+
+	Chunk *chunk = (Chunk *)Memory::alloc_static(chunk_size);
+	if (!chunk) {
+		return nullptr;
+	}
+	chunk->prev = a.chunk;
+	chunk->size = chunk_size;
+
+	a.chunk = chunk;
+	a.capacity += chunk_size;
+	a.next_chunk_size = 0;
+
+	uint8_t *block = (uint8_t *)chunk + ALIGN;
+	a.pos = block + p_size;
+	a.end = (uint8_t *)chunk + chunk_size;
+	return block;
+}
+
+void *FrameArena::alloc(size_t p_bytes) {
+	Arena &a = arena;
+	size_t size = HEADER_SIZE + _frame_arena_align(p_bytes);
+
+	uint8_t *block;
+	if (likely(size <= size_t(a.end - a.pos))) {
+		block = a.pos;
+		a.pos += size;
+	} else {
+		block = _alloc_from_new_chunk(size);
+		if (!block) {
+			return nullptr;
+		}
+	}
+
+	Header *header = (Header *)block;
+	header->size = size - HEADER_SIZE;
+	header->owner = &a;
+
+	a.live++;
+	a.last = block + HEADER_SIZE;
+	return a.last;
+}
+
+void *FrameArena::realloc(void *p_ptr, size_t p_bytes) {
+	if (!p_ptr) {
+		return alloc(p_bytes);
+	}
+	if (p_bytes == 0) {
+		free(p_ptr);
+		return nullptr;
+	}
+
+	Arena &a = arena;
+	Header *header = (Header *)((uint8_t *)p_ptr - HEADER_SIZE);
+	ERR_FAIL_COND_V_MSG(header->owner != &a, nullptr, "Frame arena memory must be reallocated by the thread that allocated it.");
+
+	size_t size = _frame_arena_align(p_bytes);
+	if (p_ptr == a.last) {
+		// Nothing was allocated after it, so it can grow or shrink in place.
+		if (size <= size_t(a.end - (uint8_t *)p_ptr)) {
+			header->size = size;
+			a.pos = (uint8_t *)p_ptr + size;
+			return p_ptr;
+		}
+	} else if (size <= header->size) {
+		return p_ptr;
+	}
+
+	void *mem = alloc(p_bytes);
+	if (!mem) {
+		return nullptr;
+	}
+	memcpy(mem, p_ptr, MIN(header->size, size));
+
+	// The old block can't be the most recent one anymore, it is only counted out.
+	a.live--;
+	return mem;
+}
+
+void FrameArena::free(void *p_ptr) {
+	if (!p_ptr) {
+		return;
+	}
+
+	Arena &a = arena;
+	Header *header = (Header *)((uint8_t *)p_ptr - HEADER_SIZE);
+	ERR_FAIL_COND_MSG(header->owner != &a, "Frame arena memory must be freed by the thread that allocated it.");
+
+	a.live--;
+	if (p_ptr == a.last) {
+		a.pos = (uint8_t *)header;
+		a.last = nullptr;
+	}
+	if (a.live == 0) {
+		_rewind();
+	}
+}
+
+void FrameArena::_rewind() {
+	Arena &a = arena;
+	if (!a.chunk) {
+		return;
+	}
+
+	a.last = nullptr;
+
+	bool release = a.released;
+	if (a.chunk->prev) {
+		// Several chunks were needed, replace them with a single one fitting all.
+		a.peak = MAX(a.peak, a.capacity);
+		a.next_chunk_size = a.capacity;
+		release = true;
+	} else {
+		a.peak = MAX(a.peak, size_t(a.pos - ((uint8_t *)a.chunk + ALIGN)));
+
+		uint64_t frame = frame_arena_frame.load(std::memory_order_relaxed);
+		if (frame - a.trim_frame >= TRIM_FRAMES) {
+			if (a.chunk->size > MIN_CHUNK_SIZE && a.peak * 4 < a.chunk->size) {
+				// Mostly unused for a while, shrink to what was needed.
+				a.next_chunk_size = a.peak;
+				release = true;
+			}
+			a.peak = 0;
+			a.trim_frame = frame;
+		}
+	}
+
+	if (release) {
+		while (a.chunk) {
+			Chunk *prev = a.chunk->prev;
+			Memory::free_static(a.chunk);
+			a.chunk = prev;
+		}
+		a.pos = nullptr;
+		a.end = nullptr;
+		a.capacity = 0;
+	} else {
+		a.pos = (uint8_t *)a.chunk + ALIGN;
+	}
+}
+
+void FrameArena::_release_arena() {
+	Arena &a = arena;
+	a.released = true;
+	a.next_chunk_size = 0;
+
+	// Otherwise, released when the last allocation is freed.
+	if (a.live == 0) {
+		_rewind();
+	}
+}
+
+void FrameArena::end_frame() {
+	frame_arena_frame.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t FrameArena::get_frame() {
+	return frame_arena_frame.load(std::memory_order_relaxed);
+}
+
+size_t FrameArena::get_thread_capacity() {
+	return arena.capacity;
+}
@@ -0,0 +1,91 @@
+/*************************************************************************/
+/*  frame_arena.h                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include "core/typedefs.h"
+
+#include <stddef.h>
+
+/**
+ * Per-thread linear allocator for scratch memory that doesn't outlive the frame.
+ *
+ * Allocations bump a pointer in the chunk owned by the calling thread, and
+ * frees only give memory back when they release the most recent allocation.
+ * Once a thread has no live allocations left its arena rewinds to the start.
+ * If a frame needed more than one chunk, they are merged into a single chunk
+ * when the arena rewinds. end_frame() is called by Main once per frame, and
+ * chunks that stay mostly unused for a while are shrunk.
+ *
+ * Memory must be freed by the thread that allocated it. Keep it to locals,
+ * a live allocation kept around prevents its thread's arena from rewinding.
+ */
+class FrameArena {
+	enum {
+		ALIGN = 16,
+		HEADER_SIZE = 16,
+		MIN_CHUNK_SIZE = 65536,
+		TRIM_FRAMES = 256,
+	};
+
+	struct Chunk;
+	struct Header;
+	struct Arena;
+	struct ArenaReleaser;
+
+	static thread_local Arena arena;
+	static thread_local ArenaReleaser arena_releaser;
+
+	static uint8_t *_alloc_from_new_chunk(size_t p_size);
+	static void _rewind();
+	static void _release_arena();
+
+public:
+	static void *alloc(size_t p_bytes);
+	static void *realloc(void *p_ptr, size_t p_bytes);
+	static void free(void *p_ptr);
+
+	static void end_frame();
+	static uint64_t get_frame();
+
+	// Bytes reserved by the calling thread's arena.
+	static size_t get_thread_capacity();
+};
+
+// For use as the allocator of containers, see FrameVector.
+class FrameAllocator {
+public:
+	_FORCE_INLINE_ static void *alloc(size_t p_memory) { return FrameArena::alloc(p_memory); }
+	_FORCE_INLINE_ static void *realloc(void *p_ptr, size_t p_memory) { return FrameArena::realloc(p_ptr, p_memory); }
+	_FORCE_INLINE_ static void free(void *p_ptr) { FrameArena::free(p_ptr); }
+};
+
+#endif // FRAME_ARENA_H
@@ -32,8 +32,10 @@
 
 #include "core/error/error_macros.h"
 #include "core/os/copymem.h"
+#include "core/os/small_object_allocator.h"
 #include "core/templates/safe_refcount.h"
 
+#include <atomic>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -45,6 +47,10 @@ void *operator new(size_t p_size, void *(*p_allocfunc)(size_t p_size)) {
 	return p_allocfunc(p_size);
 }
 
+void *operator new(size_t p_size, Memory::Tag p_tag) {
+	return Memory::alloc_static(p_size, false, p_tag);
+}
+
 #ifdef _MSC_VER
 void operator delete(void *p_mem, const char *p_description) {
 	CRASH_NOW_MSG("Call to placement delete should not happen.");
@@ -54,41 +60,156 @@ void operator delete(void *p_mem, void *(*p_allocfunc)(size_t p_size)) {
 	CRASH_NOW_MSG("Call to placement delete should not happen.");
 }
 
+void operator delete(void *p_mem, Memory::Tag p_tag) {
+	CRASH_NOW_MSG("Call to placement delete should not happen.");
+}
+
 void operator delete(void *p_mem, void *p_pointer, size_t check, const char *p_description) {
 	CRASH_NOW_MSG("Call to placement delete should not happen.");
 }
 #endif
 
+// The padding starts with the allocation size, the tag is kept in the top bits.
+#define MEMORY_TAG_SHIFT 56
+#define MEMORY_SIZE_MASK ((uint64_t(1) << MEMORY_TAG_SHIFT) - 1)
+
+// Statistics are accumulated per thread, and only added to the shared
+// counters once enough changed, so threads don't contend on them.
+#define MEMORY_STATS_FLUSH_BYTES 65536
+#define MEMORY_STATS_FLUSH_COUNT 1024
+
+struct Memory::ThreadStats {
+	int64_t usage;
+	int64_t tag_usage[TAG_MAX];
+	int64_t alloc_count;
+	bool initialized;
+	bool released;
+};
+
+struct Memory::ThreadStatsReleaser {
+	void touch() {}
+	~ThreadStatsReleaser() {
+		Memory::_flush_thread_stats();
+		Memory::thread_stats.released = true;
+	}
+};
+
+thread_local Memory::ThreadStats Memory::thread_stats;
+thread_local Memory::ThreadStatsReleaser Memory::thread_stats_releaser;
+
 #ifdef DEBUG_ENABLED
-uint64_t Memory::mem_usage = 0;
-uint64_t Memory::max_usage = 0;
+static std::atomic<int64_t> mem_usage;
+static std::atomic<int64_t> max_usage;
+static std::atomic<int64_t> tag_usage[Memory::TAG_MAX];
 #endif
 
-uint64_t Memory::alloc_count = 0;
+static std::atomic<int64_t> alloc_count;
+
+void Memory::_flush_thread_stats() {
+	ThreadStats &stats = thread_stats;
 
-void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
+#ifdef DEBUG_ENABLED
+	if (stats.usage) {
+		int64_t usage = mem_usage.fetch_add(stats.usage, std::memory_order_relaxed) + stats.usage;
+		int64_t max = max_usage.load(std::memory_order_relaxed);
+		while (usage > max && !max_usage.compare_exchange_weak(max, usage, std::memory_order_relaxed)) {
+		}
+		stats.usage = 0;
+	}
+	for (int i = 0; i < TAG_MAX; i++) {
+		if (stats.tag_usage[i]) {
+			tag_usage[i].fetch_add(stats.tag_usage[i], std::memory_order_relaxed);
+			stats.tag_usage[i] = 0;
+		}
+	}
+#endif
+
+	if (stats.alloc_count) {
+		alloc_count.fetch_add(stats.alloc_count, std::memory_order_relaxed);
+		stats.alloc_count = 0;
+	}
+}
+
+void Memory::_update_stats(Tag p_tag, int64_t p_bytes, int64_t p_count) {
+	ThreadStats &stats = thread_stats;
+
+	if (unlikely(!stats.initialized)) {
+		// Makes sure the pending statistics are flushed when the thread exits.
+		thread_stats_releaser.touch();
+		stats.initialized = true;
+	}
+
+#ifdef DEBUG_ENABLED
+	stats.usage += p_bytes;
+	stats.tag_usage[p_tag] += p_bytes;
+#endif
+	stats.alloc_count += p_count;
+
+	if (unlikely(stats.released || ABS(stats.usage) >= MEMORY_STATS_FLUSH_BYTES || ABS(stats.alloc_count) >= MEMORY_STATS_FLUSH_COUNT)) {
+		_flush_thread_stats();
+	}
+}
+
+static _FORCE_INLINE_ void *_alloc_block(size_t p_bytes) {
+	void *mem = p_bytes <= SmallObjectAllocator::MAX_SIZE ? SmallObjectAllocator::alloc(p_bytes) : nullptr;
+	if (!mem) {
+		mem = malloc(p_bytes);
+	}
+	return mem;
+}
+
+static _FORCE_INLINE_ void _free_block(void *p_mem) {
+	if (SmallObjectAllocator::owns(p_mem)) {
+		SmallObjectAllocator::free(p_mem);
+	} else {
+		free(p_mem);
+	}
+}
+
+static void *_realloc_block(void *p_mem, size_t p_bytes) {
+	if (!SmallObjectAllocator::owns(p_mem)) {
+		return realloc(p_mem, p_bytes);
+	}
+
+	if (p_bytes == 0) {
+		SmallObjectAllocator::free(p_mem);
+		return nullptr;
+	}
+
+	size_t block_size = SmallObjectAllocator::get_block_size(p_mem);
+	if (p_bytes <= block_size && p_bytes > block_size / 2) {
+		return p_mem;
+	}
+
+	void *mem = _alloc_block(p_bytes);
+	if (!mem) {
+		return nullptr;
+	}
+
+	copymem(mem, p_mem, MIN(block_size, p_bytes));
+	SmallObjectAllocator::free(p_mem);
+	return mem;
+}
+
+void *Memory::alloc_static(size_t p_bytes, bool p_pad_align, Tag p_tag) {
 #ifdef DEBUG_ENABLED
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
 #endif
 
-	void *mem = malloc(p_bytes + (prepad ? PAD_ALIGN : 0));
+	void *mem = _alloc_block(p_bytes + (prepad ? PAD_ALIGN : 0));
 
 	ERR_FAIL_COND_V(!mem, nullptr);
 
-	atomic_increment(&alloc_count);
+	_update_stats(p_tag, prepad ? p_bytes : 0, 1);
 
 	if (prepad) {
 		uint64_t *s = (uint64_t *)mem;
-		*s = p_bytes;
+		*s = p_bytes | (uint64_t(p_tag) << MEMORY_TAG_SHIFT);
 
 		uint8_t *s8 = (uint8_t *)mem;
 
-#ifdef DEBUG_ENABLED
-		atomic_add(&mem_usage, p_bytes);
-		atomic_exchange_if_greater(&max_usage, mem_usage);
-#endif
 		return s8 + PAD_ALIGN;
 	} else {
 		return mem;
@@ -111,33 +232,27 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 	if (prepad) {
 		mem -= PAD_ALIGN;
 		uint64_t *s = (uint64_t *)mem;
-
-#ifdef DEBUG_ENABLED
-		if (p_bytes > *s) {
-			atomic_add(&mem_usage, p_bytes - *s);
-			atomic_exchange_if_greater(&max_usage, mem_usage);
-		} else {
-			atomic_sub(&mem_usage, *s - p_bytes);
-		}
-#endif
+		uint64_t size = *s & MEMORY_SIZE_MASK;
+		Tag tag = Tag(*s >> MEMORY_TAG_SHIFT);
 
 		if (p_bytes == 0) {
-			free(mem);
+			_update_stats(tag, -int64_t(size), -1);
+			_free_block(mem);
 			return nullptr;
 		} else {
-			*s = p_bytes;
+			_update_stats(tag, int64_t(p_bytes) - int64_t(size), 0);
 
-			mem = (uint8_t *)realloc(mem, p_bytes + PAD_ALIGN);
+			mem = (uint8_t *)_realloc_block(mem, p_bytes + PAD_ALIGN);
 			ERR_FAIL_COND_V(!mem, nullptr);
 
 			s = (uint64_t *)mem;
 
-			*s = p_bytes;
+			*s = p_bytes | (uint64_t(tag) << MEMORY_TAG_SHIFT);
 
 			return mem + PAD_ALIGN;
 		}
 	} else {
-		mem = (uint8_t *)realloc(mem, p_bytes);
+		mem = (uint8_t *)_realloc_block(mem, p_bytes);
 
 		ERR_FAIL_COND_V(mem == nullptr && p_bytes > 0, nullptr);
 
@@ -156,19 +271,17 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 	bool prepad = p_pad_align;
 #endif
 
-	atomic_decrement(&alloc_count);
-
 	if (prepad) {
 		mem -= PAD_ALIGN;
 
-#ifdef DEBUG_ENABLED
 		uint64_t *s = (uint64_t *)mem;
-		atomic_sub(&mem_usage, *s);
-#endif
+		_update_stats(Tag(*s >> MEMORY_TAG_SHIFT), -int64_t(*s & MEMORY_SIZE_MASK), -1);
 
-		free(mem);
+		_free_block(mem);
 	} else {
-		free(mem);
+		_update_stats(TAG_DEFAULT, 0, -1);
+
+		_free_block(mem);
 	}
 }
 
@@ -178,7 +291,8 @@ uint64_t Memory::get_mem_available() {
 
 uint64_t Memory::get_mem_usage() {
 #ifdef DEBUG_ENABLED
-	return mem_usage;
+	_flush_thread_stats();
+	return MAX(mem_usage.load(std::memory_order_relaxed), 0);
 #else
 	return 0;
 #endif
@@ -186,12 +300,35 @@ uint64_t Memory::get_mem_usage() {
 
 uint64_t Memory::get_mem_max_usage() {
 #ifdef DEBUG_ENABLED
-	return max_usage;
+	_flush_thread_stats();
+	return MAX(max_usage.load(std::memory_order_relaxed), 0);
+#else
+	return 0;
+#endif
+}
+
+uint64_t Memory::get_mem_usage_by_tag(Tag p_tag) {
+	ERR_FAIL_INDEX_V(p_tag, TAG_MAX, 0);
+#ifdef DEBUG_ENABLED
+	_flush_thread_stats();
+	return MAX(tag_usage[p_tag].load(std::memory_order_relaxed), 0);
 #else
 	return 0;
 #endif
 }
 
+const char *Memory::get_tag_name(Tag p_tag) {
+	static const char *names[TAG_MAX] = {
+		"Default",
+		"Container",
+		"String",
+		"Variant",
+	};
+
+	ERR_FAIL_INDEX_V(p_tag, TAG_MAX, "");
+	return names[p_tag];
+}
+
 _GlobalNil::_GlobalNil() {
 	left = this;
 	right = this;
@@ -41,32 +41,49 @@
 #endif
 
 class Memory {
+public:
+	// Subsystem an allocation is accounted to, for the usage statistics of debug builds.
+	enum Tag {
+		TAG_DEFAULT,
+		TAG_CONTAINER,
+		TAG_STRING,
+		TAG_VARIANT,
+		TAG_MAX
+	};
+
+private:
 	Memory();
-#ifdef DEBUG_ENABLED
-	static uint64_t mem_usage;
-	static uint64_t max_usage;
-#endif
 
-	static uint64_t alloc_count;
+	struct ThreadStats;
+	struct ThreadStatsReleaser;
+	static thread_local ThreadStats thread_stats;
+	static thread_local ThreadStatsReleaser thread_stats_releaser;
+
+	static void _update_stats(Tag p_tag, int64_t p_bytes, int64_t p_count);
+	static void _flush_thread_stats();
 
 public:
-	static void *alloc_static(size_t p_bytes, bool p_pad_align = false);
+	static void *alloc_static(size_t p_bytes, bool p_pad_align = false, Tag p_tag = TAG_DEFAULT);
 	static void *realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align = false);
 	static void free_static(void *p_ptr, bool p_pad_align = false);
 
 	static uint64_t get_mem_available();
 	static uint64_t get_mem_usage();
 	static uint64_t get_mem_max_usage();
+	static uint64_t get_mem_usage_by_tag(Tag p_tag);
+	static const char *get_tag_name(Tag p_tag);
 };
 
 class DefaultAllocator {
 public:
-	_FORCE_INLINE_ static void *alloc(size_t p_memory) { return Memory::alloc_static(p_memory, false); }
+	_FORCE_INLINE_ static void *alloc(size_t p_memory) { return Memory::alloc_static(p_memory, false, Memory::TAG_CONTAINER); }
+	_FORCE_INLINE_ static void *realloc(void *p_ptr, size_t p_memory) { return p_ptr ? Memory::realloc_static(p_ptr, p_memory, false) : alloc(p_memory); }
 	_FORCE_INLINE_ static void free(void *p_ptr) { Memory::free_static(p_ptr, false); }
 };
 
 void *operator new(size_t p_size, const char *p_description); ///< operator new that takes a description and uses MemoryStaticPool
 void *operator new(size_t p_size, void *(*p_allocfunc)(size_t p_size)); ///< operator new that takes a description and uses MemoryStaticPool
+void *operator new(size_t p_size, Memory::Tag p_tag); ///< operator new that accounts the allocation to a subsystem tag
 
 void *operator new(size_t p_size, void *p_pointer, size_t check, const char *p_description); ///< operator new that takes a description and uses a pointer to the preallocated memory
 
@@ -75,6 +92,7 @@ void *operator new(size_t p_size, void *p_pointer, size_t check, const char *p_d
 // The purpose of the following definitions is to muffle these warnings, not to provide a usable implementation of placement delete.
 void operator delete(void *p_mem, const char *p_description);
 void operator delete(void *p_mem, void *(*p_allocfunc)(size_t p_size));
+void operator delete(void *p_mem, Memory::Tag p_tag);
 void operator delete(void *p_mem, void *p_pointer, size_t check, const char *p_description);
 #endif
 
@@ -91,6 +109,7 @@ _ALWAYS_INLINE_ T *_post_initialize(T *p_obj) {
 }
 
 #define memnew(m_class) _post_initialize(new ("") m_class)
+#define memnew_tagged(m_class, m_tag) _post_initialize(new (m_tag) m_class)
 
 _ALWAYS_INLINE_ void *operator new(size_t p_size, void *p_pointer, size_t check, const char *p_description) {
 	//void *failptr=0;
@@ -0,0 +1,307 @@
+/*************************************************************************/
+/*  small_object_allocator.cpp                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "small_object_allocator.h"
+
+#include "core/os/spin_lock.h"
+
+#include <atomic>
+#include <stdlib.h>
+
+struct SmallObjectAllocator::FreeBlock {
+	FreeBlock *next;
+};
+
+struct SmallObjectAllocator::SpanHeader {
+	uint32_t size_class;
+};
+
+struct SmallObjectAllocator::Pool {
+	SpinLock lock;
+	FreeBlock *free_list = nullptr;
+	// Not yet carved part of the current span.
+	uint8_t *carve_from = nullptr;
+	uint8_t *carve_end = nullptr;
+};
+
+// One bit per span sized region of the address space, set for regions owned
+// by the allocator. Read without locking, bits are only ever set.
+struct SmallObjectAllocator::SpanMap {
+	std::atomic<std::atomic<uint64_t> *> leaves[SPAN_MAP_SIZE] = {};
+
+	// Spans reserved but not handed out yet.
+	SpinLock lock;
+	uint8_t *next = nullptr;
+	uint8_t *end = nullptr;
+	bool exhausted = false;
+};
+
+struct SmallObjectAllocator::ThreadCache {
+	FreeBlock *free_list[SIZE_CLASS_COUNT];
+	uint32_t count[SIZE_CLASS_COUNT];
+	bool initialized;
+	bool released;
+};
+
+struct SmallObjectAllocator::ThreadCacheReleaser {
+	void touch() {}
+	~ThreadCacheReleaser() {
+		SmallObjectAllocator::_release_thread_cache();
+	}
+};
+
+SmallObjectAllocator::Pool SmallObjectAllocator::pools[SIZE_CLASS_COUNT];
+thread_local SmallObjectAllocator::ThreadCache SmallObjectAllocator::thread_cache;
+thread_local SmallObjectAllocator::ThreadCacheReleaser SmallObjectAllocator::thread_cache_releaser;
+SmallObjectAllocator::SpanMap SmallObjectAllocator::span_map;
+
+uint8_t *SmallObjectAllocator::_alloc_span(uint32_t p_size_class) {
+	span_map.lock.lock();
+
+	if (span_map.next == span_map.end) {
+		if (span_map.exhausted) {
+			span_map.lock.unlock();
+			return nullptr;
+		}
+
+		// Reserve several spans at once, with room to align them to their size.
+		uint8_t *block = (uint8_t *)malloc(SPAN_SIZE * (SPANS_PER_BLOCK + 1));
+		if (!block) {
+			span_map.lock.unlock();
+			return nullptr;
+		}
+
+		uint8_t *first = (uint8_t *)(((uintptr_t)block + SPAN_SIZE - 1) & ~(uintptr_t)(SPAN_SIZE - 1));
+		uintptr_t first_index = (uintptr_t)first >> SPAN_SHIFT;
+		uintptr_t last_index = first_index + SPANS_PER_BLOCK - 1;
+
+		if ((last_index >> SPAN_MAP_LEAF_SHIFT) >= SPAN_MAP_SIZE) {
+			// Outside of the addresses the map covers, keep using malloc.
+			::free(block);
+			span_map.exhausted = true;
+			span_map.lock.unlock();
+			return nullptr;
+		}
+
+		// Spans can cross into a second leaf, create leaves before marking anything.
+		for (uintptr_t leaf_index = first_index >> SPAN_MAP_LEAF_SHIFT; leaf_index <= (last_index >> SPAN_MAP_LEAF_SHIFT); leaf_index++) {
+			if (span_map.leaves[leaf_index].load(std::memory_order_relaxed)) {
+				continue;
+			}
+			std::atomic<uint64_t> *leaf = (std::atomic<uint64_t> *)calloc(SPAN_MAP_LEAF_SIZE / 64, sizeof(std::atomic<uint64_t>));
+			if (!leaf) {
+				::free(block);
+				span_map.lock.unlock();
+				return nullptr;
+			}
+			span_map.leaves[leaf_index].store(leaf, std::memory_order_release);
+		}
+
+		for (uintptr_t index = first_index; index <= last_index; index++) {
+			std::atomic<uint64_t> *leaf = span_map.leaves[index >> SPAN_MAP_LEAF_SHIFT].load(std::memory_order_relaxed);
+			uintptr_t bit = index & (SPAN_MAP_LEAF_SIZE - 1);
+			leaf[bit >> 6].fetch_or(uint64_t(1) << (bit & 63), std::memory_order_release);
+		}
+
+		span_map.next = first;
+		span_map.end = first + SPAN_SIZE * SPANS_PER_BLOCK;
+	}
+
+	uint8_t *span = span_map.next;
+	span_map.next += SPAN_SIZE;
+
+	span_map.lock.unlock();
+
+	((SpanHeader *)span)->size_class = p_size_class;
+	return span;
+}
+
+SmallObjectAllocator::FreeBlock *SmallObjectAllocator::_take_from_pool(uint32_t p_size_class, uint32_t p_count, uint32_t &r_taken) {
+	Pool &pool = pools[p_size_class];
+	uint32_t block_size = (p_size_class + 1) * SIZE_CLASS_GRANULARITY;
+
+	FreeBlock *first = nullptr;
+	r_taken = 0;
+
+	pool.lock.lock();
+
+	while (r_taken < p_count && pool.free_list) {
+		FreeBlock *block = pool.free_list;
+		pool.free_list = block->next;
+		block->next = first;
+		first = block;
+		r_taken++;
+	}
+
+	while (r_taken < p_count) {
+		if (pool.carve_from + block_size > pool.carve_end) {
+			uint8_t *span = _alloc_span(p_size_class);
+			if (!span) {
+				break;
+			}
+			pool.carve_from = span + SPAN_HEADER_SIZE;
+			pool.carve_end = span + SPAN_SIZE;
+		}
+
+		FreeBlock *block = (FreeBlock *)pool.carve_from;
+		pool.carve_from += block_size;
+		block->next = first;
+		first = block;
+		r_taken++;
+	}
+
+	pool.lock.unlock();
+
+	return first;
+}
+
+void SmallObjectAllocator::_return_to_pool(uint32_t p_size_class, FreeBlock *p_first, FreeBlock *p_last) {
+	Pool &pool = pools[p_size_class];
+
+	pool.lock.lock();
+	p_last->next = pool.free_list;
+	pool.free_list = p_first;
+	pool.lock.unlock();
+}
+
+void SmallObjectAllocator::_release_thread_cache() {
+	ThreadCache &cache = thread_cache;
+
+	for (uint32_t i = 0; i < SIZE_CLASS_COUNT; i++) {
+		FreeBlock *first = cache.free_list[i];
+		if (!first) {
+			continue;
+		}
+
+		FreeBlock *last = first;
+		while (last->next) {
+			last = last->next;
+		}
+
+		_return_to_pool(i, first, last);
+		cache.free_list[i] = nullptr;
+		cache.count[i] = 0;
+	}
+
+	// Blocks allocated or freed later in this thread's shutdown go straight to the pools.
+	cache.released = true;
+}
+
+void *SmallObjectAllocator::alloc(size_t p_bytes) {
+	if (unlikely(p_bytes > MAX_SIZE)) {
+		return nullptr;
+	}
+
+	uint32_t size_class = p_bytes ? uint32_t((p_bytes - 1) / SIZE_CLASS_GRANULARITY) : 0;
+	ThreadCache &cache = thread_cache;
+
+	if (unlikely(cache.released)) {
+		uint32_t taken = 0;
+		return _take_from_pool(size_class, 1, taken);
+	}
+
+	if (unlikely(!cache.initialized)) {
+		// Makes sure the cache is released when the thread exits.
+		thread_cache_releaser.touch();
+		cache.initialized = true;
+	}
+
+	FreeBlock *block = cache.free_list[size_class];
+
+	if (unlikely(!block)) {
+		uint32_t taken = 0;
+		block = _take_from_pool(size_class, _get_batch_size(size_class), taken);
+		if (!block) {
+			return nullptr;
+		}
+		cache.count[size_class] = taken;
+	}
+
+	cache.free_list[size_class] = block->next;
+	cache.count[size_class]--;
+
+	return block;
+}
+
+void SmallObjectAllocator::free(void *p_ptr) {
+	SpanHeader *span = (SpanHeader *)((uintptr_t)p_ptr & ~(uintptr_t)(SPAN_SIZE - 1));
+	uint32_t size_class = span->size_class;
+	FreeBlock *block = (FreeBlock *)p_ptr;
+	ThreadCache &cache = thread_cache;
+
+	if (unlikely(cache.released)) {
+		_return_to_pool(size_class, block, block);
+		return;
+	}
+
+	if (unlikely(!cache.initialized)) {
+		thread_cache_releaser.touch();
+		cache.initialized = true;
+	}
+
+	block->next = cache.free_list[size_class];
+	cache.free_list[size_class] = block;
+	cache.count[size_class]++;
+
+	uint32_t batch = _get_batch_size(size_class);
+	if (unlikely(cache.count[size_class] > batch * 2)) {
+		// Keep one batch cached, hand the rest back so other threads can use it.
+		FreeBlock *first = cache.free_list[size_class];
+		FreeBlock *last = first;
+		for (uint32_t i = 1; i < batch; i++) {
+			last = last->next;
+		}
+		cache.free_list[size_class] = last->next;
+		cache.count[size_class] -= batch;
+		_return_to_pool(size_class, first, last);
+	}
+}
+
+bool SmallObjectAllocator::owns(const void *p_ptr) {
+	uintptr_t index = (uintptr_t)p_ptr >> SPAN_SHIFT;
+	uintptr_t leaf_index = index >> SPAN_MAP_LEAF_SHIFT;
+
+	if (unlikely(leaf_index >= SPAN_MAP_SIZE)) {
+		return false;
+	}
+
+	std::atomic<uint64_t> *leaf = span_map.leaves[leaf_index].load(std::memory_order_acquire);
+	if (!leaf) {
+		return false;
+	}
+
+	uintptr_t bit = index & (SPAN_MAP_LEAF_SIZE - 1);
+	return (leaf[bit >> 6].load(std::memory_order_relaxed) >> (bit & 63)) & 1;
+}
+
+size_t SmallObjectAllocator::get_block_size(const void *p_ptr) {
+	const SpanHeader *span = (const SpanHeader *)((uintptr_t)p_ptr & ~(uintptr_t)(SPAN_SIZE - 1));
+	return (span->size_class + 1) * SIZE_CLASS_GRANULARITY;
+}
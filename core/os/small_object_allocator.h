@@ -0,0 +1,101 @@
+/*************************************************************************/
+/*  small_object_allocator.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SMALL_OBJECT_ALLOCATOR_H
+#define SMALL_OBJECT_ALLOCATOR_H
+
+#include "core/typedefs.h"
+
+#include <stddef.h>
+
+/**
+ * Size class allocator used by Memory for small blocks.
+ *
+ * Blocks are carved out of spans of SPAN_SIZE bytes, aligned to their size,
+ * each span serving a single size class. Every thread keeps a cache of free
+ * blocks per size class, so most allocations and frees don't lock or touch
+ * shared state. Caches are refilled from, and flushed back to, a shared pool
+ * per size class in batches.
+ *
+ * A block may be freed from any thread. Spans are never returned to the
+ * system, freed blocks are only reused by later allocations.
+ */
+class SmallObjectAllocator {
+public:
+	enum {
+		SIZE_CLASS_GRANULARITY = 16,
+		SIZE_CLASS_COUNT = 16,
+		MAX_SIZE = SIZE_CLASS_GRANULARITY * SIZE_CLASS_COUNT,
+	};
+
+private:
+	enum {
+		SPAN_SHIFT = 16,
+		SPAN_SIZE = 1 << SPAN_SHIFT,
+		SPAN_HEADER_SIZE = 64,
+		SPANS_PER_BLOCK = 16,
+		CACHE_BATCH_BYTES = 4096,
+		SPAN_MAP_LEAF_SHIFT = 16,
+		SPAN_MAP_LEAF_SIZE = 1 << SPAN_MAP_LEAF_SHIFT,
+		// Enough for 48 bit addresses on 64 bit platforms.
+		SPAN_MAP_SIZE = sizeof(void *) == 8 ? 1 << (48 - SPAN_SHIFT - SPAN_MAP_LEAF_SHIFT) : 1,
+	};
+
+	struct FreeBlock;
+	struct SpanHeader;
+	struct Pool;
+	struct SpanMap;
+	struct ThreadCache;
+	struct ThreadCacheReleaser;
+
+	static Pool pools[SIZE_CLASS_COUNT];
+	static SpanMap span_map;
+	static thread_local ThreadCache thread_cache;
+	static thread_local ThreadCacheReleaser thread_cache_releaser;
+
+	static uint8_t *_alloc_span(uint32_t p_size_class);
+	static FreeBlock *_take_from_pool(uint32_t p_size_class, uint32_t p_count, uint32_t &r_taken);
+	static void _return_to_pool(uint32_t p_size_class, FreeBlock *p_first, FreeBlock *p_last);
+	static void _release_thread_cache();
+
+	_FORCE_INLINE_ static uint32_t _get_batch_size(uint32_t p_size_class) {
+		return CACHE_BATCH_BYTES / ((p_size_class + 1) * SIZE_CLASS_GRANULARITY);
+	}
+
+public:
+	// Returns nullptr if p_bytes is above MAX_SIZE or no span could be reserved.
+	static void *alloc(size_t p_bytes);
+	static void free(void *p_ptr);
+
+	static bool owns(const void *p_ptr);
+	static size_t get_block_size(const void *p_ptr);
+};
+
+#endif // SMALL_OBJECT_ALLOCATOR_H
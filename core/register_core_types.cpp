@@ -70,6 +70,7 @@
 #include "core/os/main_loop.h"
 #include "core/string/compressed_translation.h"
 #include "core/string/translation.h"
+#include "core/templates/thread_work_pool.h"
 
 static Ref<ResourceFormatSaverBinary> resource_saver_binary;
 static Ref<ResourceFormatLoaderBinary> resource_loader_binary;
@@ -277,6 +278,8 @@ void register_core_singletons() {
 }
 
 void unregister_core_types() {
+	ThreadWorkPool::finish_shared();
+
 	memdelete(_resource_loader);
 	memdelete(_resource_saver);
 	memdelete(_os);
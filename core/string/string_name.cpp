@@ -185,7 +185,7 @@ StringName::StringName(const char *p_name) {
 		}
 	}
 
-	_data = memnew(_Data);
+	_data = memnew_tagged(_Data, Memory::TAG_STRING);
 	_data->name = p_name;
 	_data->refcount.init();
 	_data->hash = hash;
@@ -229,7 +229,7 @@ StringName::StringName(const StaticCString &p_static_string) {
 		}
 	}
 
-	_data = memnew(_Data);
+	_data = memnew_tagged(_Data, Memory::TAG_STRING);
 
 	_data->refcount.init();
 	_data->hash = hash;
@@ -273,7 +273,7 @@ StringName::StringName(const String &p_name) {
 		}
 	}
 
-	_data = memnew(_Data);
+	_data = memnew_tagged(_Data, Memory::TAG_STRING);
 	_data->name = p_name;
 	_data->refcount.init();
 	_data->hash = hash;
@@ -60,6 +60,193 @@
 #define IS_DIGIT(m_d) ((m_d) >= '0' && (m_d) <= '9')
 #define IS_HEX_DIGIT(m_d) (((m_d) >= '0' && (m_d) <= '9') || ((m_d) >= 'a' && (m_d) <= 'f') || ((m_d) >= 'A' && (m_d) <= 'F'))
 
+// SIMD helpers for the hot loops over text, working on 4 UTF-32 or 16 UTF-8
+// code units at a time. SSE2 and NEON are part of the baseline of the
+// platforms that have them, so no runtime detection is needed.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define STRING_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define STRING_NEON
+#endif
+
+#if defined(STRING_SSE2) || defined(STRING_NEON)
+#define STRING_SIMD
+
+// Bit i is set if p_src[i] == p_char, for i in [0, 4).
+static _FORCE_INLINE_ uint32_t _char32_eq_mask4(const char32_t *p_src, char32_t p_char) {
+#ifdef STRING_SSE2
+	__m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)p_src), _mm_set1_epi32(p_char));
+	return _mm_movemask_ps(_mm_castsi128_ps(eq));
+#else
+	static const uint32_t bits[4] = { 1, 2, 4, 8 };
+	uint32x4_t eq = vandq_u32(vceqq_u32(vld1q_u32((const uint32_t *)p_src), vdupq_n_u32(p_char)), vld1q_u32(bits));
+	uint32x2_t sum = vpadd_u32(vget_low_u32(eq), vget_high_u32(eq));
+	return vget_lane_u32(vpadd_u32(sum, sum), 0);
+#endif
+}
+
+// True if all of the 16 characters are ASCII.
+static _FORCE_INLINE_ bool _char32_is_ascii16(const char32_t *p_src) {
+#ifdef STRING_SSE2
+	const __m128i *src = (const __m128i *)p_src;
+	__m128i any = _mm_or_si128(_mm_or_si128(_mm_loadu_si128(src), _mm_loadu_si128(src + 1)), _mm_or_si128(_mm_loadu_si128(src + 2), _mm_loadu_si128(src + 3)));
+	return _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(any, _mm_set1_epi32(~0x7f)), _mm_setzero_si128())) == 0xffff;
+#else
+	const uint32_t *src = (const uint32_t *)p_src;
+	uint32x4_t any = vorrq_u32(vorrq_u32(vld1q_u32(src), vld1q_u32(src + 4)), vorrq_u32(vld1q_u32(src + 8), vld1q_u32(src + 12)));
+	uint32x2_t folded = vorr_u32(vget_low_u32(any), vget_high_u32(any));
+	return ((vget_lane_u32(folded, 0) | vget_lane_u32(folded, 1)) & ~0x7fu) == 0;
+#endif
+}
+
+// Narrows 16 ASCII characters to bytes.
+static _FORCE_INLINE_ void _char32_pack_ascii16(const char32_t *p_src, uint8_t *p_dst) {
+#ifdef STRING_SSE2
+	const __m128i *src = (const __m128i *)p_src;
+	__m128i low = _mm_packs_epi32(_mm_loadu_si128(src), _mm_loadu_si128(src + 1));
+	__m128i high = _mm_packs_epi32(_mm_loadu_si128(src + 2), _mm_loadu_si128(src + 3));
+	_mm_storeu_si128((__m128i *)p_dst, _mm_packus_epi16(low, high));
+#else
+	const uint32_t *src = (const uint32_t *)p_src;
+	uint16x8_t low = vcombine_u16(vmovn_u32(vld1q_u32(src)), vmovn_u32(vld1q_u32(src + 4)));
+	uint16x8_t high = vcombine_u16(vmovn_u32(vld1q_u32(src + 8)), vmovn_u32(vld1q_u32(src + 12)));
+	vst1q_u8(p_dst, vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+#endif
+}
+
+// True if the 16 bytes are ASCII and none of them is zero.
+static _FORCE_INLINE_ bool _utf8_is_ascii16(const char *p_src) {
+#ifdef STRING_SSE2
+	__m128i src = _mm_loadu_si128((const __m128i *)p_src);
+	return (_mm_movemask_epi8(src) | _mm_movemask_epi8(_mm_cmpeq_epi8(src, _mm_setzero_si128()))) == 0;
+#else
+	uint8x16_t src = vld1q_u8((const uint8_t *)p_src);
+	uint8x16_t bad = vorrq_u8(vcgeq_u8(src, vdupq_n_u8(0x80)), vceqq_u8(src, vdupq_n_u8(0)));
+	uint8x8_t any = vorr_u8(vget_low_u8(bad), vget_high_u8(bad));
+	return vget_lane_u64(vreinterpret_u64_u8(any), 0) == 0;
+#endif
+}
+
+// Widens 16 ASCII bytes to characters.
+static _FORCE_INLINE_ void _utf8_widen_ascii16(const char *p_src, char32_t *p_dst) {
+#ifdef STRING_SSE2
+	__m128i src = _mm_loadu_si128((const __m128i *)p_src);
+	__m128i zero = _mm_setzero_si128();
+	__m128i low = _mm_unpacklo_epi8(src, zero);
+	__m128i high = _mm_unpackhi_epi8(src, zero);
+	__m128i *dst = (__m128i *)p_dst;
+	_mm_storeu_si128(dst, _mm_unpacklo_epi16(low, zero));
+	_mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(low, zero));
+	_mm_storeu_si128(dst + 2, _mm_unpacklo_epi16(high, zero));
+	_mm_storeu_si128(dst + 3, _mm_unpackhi_epi16(high, zero));
+#else
+	uint8x16_t src = vld1q_u8((const uint8_t *)p_src);
+	uint16x8_t low = vmovl_u8(vget_low_u8(src));
+	uint16x8_t high = vmovl_u8(vget_high_u8(src));
+	uint32_t *dst = (uint32_t *)p_dst;
+	vst1q_u32(dst, vmovl_u16(vget_low_u16(low)));
+	vst1q_u32(dst + 4, vmovl_u16(vget_high_u16(low)));
+	vst1q_u32(dst + 8, vmovl_u16(vget_low_u16(high)));
+	vst1q_u32(dst + 12, vmovl_u16(vget_high_u16(high)));
+#endif
+}
+
+// Converts 4 characters between ASCII cases, shifting [p_from, p_to] by p_delta.
+// Returns false, leaving them untouched, if any of them isn't ASCII.
+static _FORCE_INLINE_ bool _char32_ascii_case4(char32_t *p_chars, char32_t p_from, char32_t p_to, int32_t p_delta) {
+#ifdef STRING_SSE2
+	__m128i src = _mm_loadu_si128((const __m128i *)p_chars);
+	if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(src, _mm_set1_epi32(~0x7f)), _mm_setzero_si128())) != 0xffff) {
+		return false;
+	}
+	__m128i in_range = _mm_and_si128(_mm_cmpgt_epi32(src, _mm_set1_epi32(p_from - 1)), _mm_cmplt_epi32(src, _mm_set1_epi32(p_to + 1)));
+	_mm_storeu_si128((__m128i *)p_chars, _mm_add_epi32(src, _mm_and_si128(in_range, _mm_set1_epi32(p_delta))));
+#else
+	uint32x4_t src = vld1q_u32((const uint32_t *)p_chars);
+	uint32x4_t non_ascii = vandq_u32(src, vdupq_n_u32(~0x7fu));
+	uint32x2_t any = vorr_u32(vget_low_u32(non_ascii), vget_high_u32(non_ascii));
+	if ((vget_lane_u32(any, 0) | vget_lane_u32(any, 1)) != 0) {
+		return false;
+	}
+	uint32x4_t in_range = vandq_u32(vcgeq_u32(src, vdupq_n_u32(p_from)), vcleq_u32(src, vdupq_n_u32(p_to)));
+	vst1q_u32((uint32_t *)p_chars, vaddq_u32(src, vandq_u32(in_range, vdupq_n_u32(p_delta))));
+#endif
+	return true;
+}
+#endif // STRING_SIMD
+
+// djb2 over four characters at once, the multiplications don't depend on each other.
+template <class H, class C>
+static _FORCE_INLINE_ H _djb2_hash4(H p_hash, const C *p_chr) {
+	return p_hash * H(33 * 33 * 33 * 33) + H(p_chr[0]) * H(33 * 33 * 33) + H(p_chr[1]) * H(33 * 33) + H(p_chr[2]) * H(33) + H(p_chr[3]);
+}
+
+// Hashes whole blocks of four characters until the end or a null character,
+// returns how many were consumed.
+template <class H>
+static _FORCE_INLINE_ int _hash_blocks(const char32_t *p_chr, int p_len, H &r_hash) {
+	int i = 0;
+	for (; i + 4 <= p_len; i += 4) {
+#ifdef STRING_SIMD
+		if (_char32_eq_mask4(p_chr + i, 0)) {
+			break;
+		}
+#else
+		if (!p_chr[i] || !p_chr[i + 1] || !p_chr[i + 2] || !p_chr[i + 3]) {
+			break;
+		}
+#endif
+		r_hash = _djb2_hash4(r_hash, p_chr + i);
+	}
+	return i;
+}
+
+// Searches p_key in p_src, starting at p_from.
+template <class C>
+static int _find_in_char32(const char32_t *p_src, int p_len, const C *p_key, int p_key_len, int p_from) {
+	const int last_start = p_len - p_key_len;
+	const char32_t first = char32_t(p_key[0]);
+	int i = p_from;
+
+#ifdef STRING_SIMD
+	// Test the first and last characters of the key at four positions at once,
+	// the rest is only compared where both match.
+	const char32_t last = char32_t(p_key[p_key_len - 1]);
+	for (; i + 3 <= last_start; i += 4) {
+		uint32_t candidates = _char32_eq_mask4(p_src + i, first) & _char32_eq_mask4(p_src + i + p_key_len - 1, last);
+		for (int k = 0; candidates; k++, candidates >>= 1) {
+			if (!(candidates & 1)) {
+				continue;
+			}
+			int j = 1;
+			while (j < p_key_len - 1 && p_src[i + k + j] == char32_t(p_key[j])) {
+				j++;
+			}
+			if (j >= p_key_len - 1) {
+				return i + k;
+			}
+		}
+	}
+#endif
+
+	for (; i <= last_start; i++) {
+		if (p_src[i] != first) {
+			continue;
+		}
+		int j = 1;
+		while (j < p_key_len && p_src[i + j] == char32_t(p_key[j])) {
+			j++;
+		}
+		if (j == p_key_len) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
 const char CharString::_null = 0;
 const char16_t Char16String::_null = 0;
 const char32_t String::_null = 0;
@@ -1268,32 +1455,51 @@ char32_t String::char_lowercase(char32_t p_char) {
 	return _find_lower(p_char);
 }
 
-String String::to_upper() const {
-	String upper = *this;
-
-	for (int i = 0; i < upper.size(); i++) {
-		const char32_t s = upper[i];
-		const char32_t t = _find_upper(s);
-		if (s != t) { // avoid copy on write
-			upper[i] = t;
-		}
+static _FORCE_INLINE_ char32_t _to_case(char32_t p_char, bool p_upper) {
+	if (p_char < 128) {
+		return p_upper ? UPPERCASE(p_char) : LOWERCASE(p_char);
 	}
-
-	return upper;
+	return p_upper ? _find_upper(p_char) : _find_lower(p_char);
 }
 
-String String::to_lower() const {
-	String lower = *this;
+static String _string_to_case(const String &p_string, bool p_upper) {
+	String result = p_string;
+	const int len = p_string.length();
+	const char32_t *src = p_string.get_data();
+
+	// Find the first character that changes, so unchanged strings avoid copy on write.
+	int i = 0;
+	while (i < len && _to_case(src[i], p_upper) == src[i]) {
+		i++;
+	}
+	if (i == len) {
+		return result;
+	}
+
+	char32_t *dst = result.ptrw();
+	const char32_t from = p_upper ? 'a' : 'A';
+	const char32_t to = p_upper ? 'z' : 'Z';
+	const int32_t delta = p_upper ? 'A' - 'a' : 'a' - 'A';
 
-	for (int i = 0; i < lower.size(); i++) {
-		const char32_t s = lower[i];
-		const char32_t t = _find_lower(s);
-		if (s != t) { // avoid copy on write
-			lower[i] = t;
+	for (; i < len; i++) {
+#ifdef STRING_SIMD
+		if (i + 4 <= len && _char32_ascii_case4(dst + i, from, to, delta)) {
+			i += 3;
+			continue;
 		}
+#endif
+		dst[i] = _to_case(dst[i], p_upper);
 	}
 
-	return lower;
+	return result;
+}
+
+String String::to_upper() const {
+	return _string_to_case(*this, true);
+}
+
+String String::to_lower() const {
+	return _string_to_case(*this, false);
 }
 
 String String::chr(char32_t p_char) {
@@ -1725,11 +1931,26 @@ bool String::parse_utf8(const char *p_utf8, int p_len) {
 		}
 	}
 
+#ifdef STRING_SIMD
+	// The length is needed to know how far ahead blocks can be read.
+	if (p_len < 0) {
+		p_len = strlen(p_utf8);
+	}
+#endif
+
 	{
 		const char *ptrtmp = p_utf8;
 		const char *ptrtmp_limit = &p_utf8[p_len];
 		int skip = 0;
 		while (ptrtmp != ptrtmp_limit && *ptrtmp) {
+#ifdef STRING_SIMD
+			if (skip == 0 && ptrtmp_limit - ptrtmp >= 16 && _utf8_is_ascii16(ptrtmp)) {
+				str_size += 16;
+				cstr_size += 16;
+				ptrtmp += 16;
+				continue;
+			}
+#endif
 			if (skip == 0) {
 				uint8_t c = *ptrtmp >= 0 ? *ptrtmp : uint8_t(256 + *ptrtmp);
 
@@ -1778,6 +1999,15 @@ bool String::parse_utf8(const char *p_utf8, int p_len) {
 	dst[str_size] = 0;
 
 	while (cstr_size) {
+#ifdef STRING_SIMD
+		if (cstr_size >= 16 && _utf8_is_ascii16(p_utf8)) {
+			_utf8_widen_ascii16(p_utf8, dst);
+			dst += 16;
+			p_utf8 += 16;
+			cstr_size -= 16;
+			continue;
+		}
+#endif
 		int len = 0;
 
 		/* Determine the number of characters in sequence */
@@ -1848,6 +2078,13 @@ CharString String::utf8() const {
 	const char32_t *d = &operator[](0);
 	int fl = 0;
 	for (int i = 0; i < l; i++) {
+#ifdef STRING_SIMD
+		if (i + 16 <= l && _char32_is_ascii16(d + i)) {
+			fl += 16;
+			i += 15;
+			continue;
+		}
+#endif
 		uint32_t c = d[i];
 		if (c <= 0x7f) { // 7 bits.
 			fl += 1;
@@ -1878,6 +2115,14 @@ CharString String::utf8() const {
 #define APPEND_CHAR(m_c) *(cdst++) = m_c
 
 	for (int i = 0; i < l; i++) {
+#ifdef STRING_SIMD
+		if (i + 16 <= l && _char32_is_ascii16(d + i)) {
+			_char32_pack_ascii16(d + i, cdst);
+			cdst += 16;
+			i += 15;
+			continue;
+		}
+#endif
 		uint32_t c = d[i];
 
 		if (c <= 0x7f) { // 7 bits.
@@ -2605,7 +2850,11 @@ uint32_t String::hash(const char *p_cstr) {
 
 uint32_t String::hash(const char *p_cstr, int p_len) {
 	uint32_t hashv = 5381;
-	for (int i = 0; i < p_len; i++) {
+	int i = 0;
+	for (; i + 4 <= p_len; i += 4) {
+		hashv = _djb2_hash4(hashv, p_cstr + i);
+	}
+	for (; i < p_len; i++) {
 		hashv = ((hashv << 5) + hashv) + p_cstr[i]; /* hash * 33 + c */
 	}
 
@@ -2634,7 +2883,11 @@ uint32_t String::hash(const wchar_t *p_cstr) {
 
 uint32_t String::hash(const char32_t *p_cstr, int p_len) {
 	uint32_t hashv = 5381;
-	for (int i = 0; i < p_len; i++) {
+	int i = 0;
+	for (; i + 4 <= p_len; i += 4) {
+		hashv = _djb2_hash4(hashv, p_cstr + i);
+	}
+	for (; i < p_len; i++) {
 		hashv = ((hashv << 5) + hashv) + p_cstr[i]; /* hash * 33 + c */
 	}
 
@@ -2659,6 +2912,7 @@ uint32_t String::hash() const {
 	uint32_t hashv = 5381;
 	uint32_t c;
 
+	chr += _hash_blocks(chr, length(), hashv);
 	while ((c = *chr++)) {
 		hashv = ((hashv << 5) + hashv) + c; /* hash * 33 + c */
 	}
@@ -2673,6 +2927,7 @@ uint64_t String::hash64() const {
 	uint64_t hashv = 5381;
 	uint64_t c;
 
+	chr += _hash_blocks(chr, length(), hashv);
 	while ((c = *chr++)) {
 		hashv = ((hashv << 5) + hashv) + c; /* hash * 33 + c */
 	}
@@ -2798,31 +3053,7 @@ int String::find(const String &p_str, int p_from) const {
 		return -1; // won't find anything!
 	}
 
-	const char32_t *src = get_data();
-	const char32_t *str = p_str.get_data();
-
-	for (int i = p_from; i <= (len - src_len); i++) {
-		bool found = true;
-		for (int j = 0; j < src_len; j++) {
-			int read_pos = i + j;
-
-			if (read_pos >= len) {
-				ERR_PRINT("read_pos>=len");
-				return -1;
-			}
-
-			if (src[read_pos] != str[j]) {
-				found = false;
-				break;
-			}
-		}
-
-		if (found) {
-			return i;
-		}
-	}
-
-	return -1;
+	return _find_in_char32(get_data(), len, p_str.get_data(), src_len, p_from);
 }
 
 int String::find(const char *p_str, int p_from) const {
@@ -2836,46 +3067,16 @@ int String::find(const char *p_str, int p_from) const {
 		return -1; // won't find anything!
 	}
 
-	const char32_t *src = get_data();
-
 	int src_len = 0;
 	while (p_str[src_len] != '\0') {
 		src_len++;
 	}
 
-	if (src_len == 1) {
-		const char32_t needle = p_str[0];
-
-		for (int i = p_from; i < len; i++) {
-			if (src[i] == needle) {
-				return i;
-			}
-		}
-
-	} else {
-		for (int i = p_from; i <= (len - src_len); i++) {
-			bool found = true;
-			for (int j = 0; j < src_len; j++) {
-				int read_pos = i + j;
-
-				if (read_pos >= len) {
-					ERR_PRINT("read_pos>=len");
-					return -1;
-				}
-
-				if (src[read_pos] != (char32_t)p_str[j]) {
-					found = false;
-					break;
-				}
-			}
-
-			if (found) {
-				return i;
-			}
-		}
+	if (src_len == 0) {
+		return p_from <= len ? p_from : -1;
 	}
 
-	return -1;
+	return _find_in_char32(get_data(), len, p_str, src_len, p_from);
 }
 
 int String::find_char(const char32_t &p_char, int p_from) const {
@@ -36,6 +36,7 @@
 #include "core/templates/safe_refcount.h"
 
 #include <string.h>
+#include <type_traits>
 
 template <class T>
 class Vector;
@@ -83,6 +84,11 @@ private:
 		return reinterpret_cast<T *>(_ptr);
 	}
 
+	// Character data of String, CharString and Char16String is accounted as strings.
+	_FORCE_INLINE_ static Memory::Tag _get_alloc_tag() {
+		return (std::is_same<T, char32_t>::value || std::is_same<T, char16_t>::value || std::is_same<T, char>::value) ? Memory::TAG_STRING : Memory::TAG_CONTAINER;
+	}
+
 	_FORCE_INLINE_ size_t _get_alloc_size(size_t p_elements) const {
 		return next_power_of_2(p_elements * sizeof(T));
 	}
@@ -112,6 +118,7 @@ private:
 	void _ref(const CowData *p_from);
 	void _ref(const CowData &p_from);
 	void _copy_on_write();
+	bool _copy_to_unique(uint32_t p_count, size_t p_alloc_size);
 
 public:
 	void operator=(const CowData<T> &p_from) { _ref(p_from); }
@@ -194,7 +201,9 @@ void CowData<T>::_unref(void *p_data) {
 
 	uint32_t *refc = _get_refcount();
 
-	if (atomic_decrement(refc) > 0) {
+	// When this is the only reference, nothing else can reference it concurrently,
+	// so the atomic decrement can be skipped.
+	if (atomic_load_acquire(refc) != 1 && atomic_decrement(refc) > 0) {
 		return; // still in use
 	}
 	// clean up
@@ -224,27 +233,33 @@ void CowData<T>::_copy_on_write() {
 	if (unlikely(*refc > 1)) {
 		/* in use by more than me */
 		uint32_t current_size = *_get_size();
+		_copy_to_unique(current_size, _get_alloc_size(current_size));
+	}
+}
 
-		uint32_t *mem_new = (uint32_t *)Memory::alloc_static(_get_alloc_size(current_size), true);
+template <class T>
+bool CowData<T>::_copy_to_unique(uint32_t p_count, size_t p_alloc_size) {
+	uint32_t *mem_new = (uint32_t *)Memory::alloc_static(p_alloc_size, true, _get_alloc_tag());
+	ERR_FAIL_COND_V(!mem_new, false);
 
-		*(mem_new - 2) = 1; //refcount
-		*(mem_new - 1) = current_size; //size
+	*(mem_new - 2) = 1; //refcount
+	*(mem_new - 1) = p_count; //size
 
-		T *_data = (T *)(mem_new);
+	T *_data = (T *)(mem_new);
 
-		// initialize new elements
-		if (__has_trivial_copy(T)) {
-			memcpy(mem_new, _ptr, current_size * sizeof(T));
+	// initialize new elements
+	if (__has_trivial_copy(T)) {
+		memcpy(mem_new, _ptr, p_count * sizeof(T));
 
-		} else {
-			for (uint32_t i = 0; i < current_size; i++) {
-				memnew_placement(&_data[i], T(_get_data()[i]));
-			}
+	} else {
+		for (uint32_t i = 0; i < p_count; i++) {
+			memnew_placement(&_data[i], T(_get_data()[i]));
 		}
-
-		_unref(_ptr);
-		_ptr = _data;
 	}
+
+	_unref(_ptr);
+	_ptr = _data;
+	return true;
 }
 
 template <class T>
@@ -264,18 +279,23 @@ Error CowData<T>::resize(int p_size) {
 		return OK;
 	}
 
-	// possibly changing size, copy on write
-	_copy_on_write();
-
 	size_t current_alloc_size = _get_alloc_size(current_size);
 	size_t alloc_size;
 	ERR_FAIL_COND_V(!_get_alloc_size_checked(p_size, &alloc_size), ERR_OUT_OF_MEMORY);
 
+	// possibly changing size, copy on write
+	if (current_size > 0 && unlikely(*_get_refcount() > 1)) {
+		// Copy only the elements kept straight into a buffer of the new size,
+		// rather than copying everything and reallocating afterwards.
+		ERR_FAIL_COND_V(!_copy_to_unique(MIN(current_size, p_size), alloc_size), ERR_OUT_OF_MEMORY);
+		current_alloc_size = alloc_size;
+	}
+
 	if (p_size > current_size) {
 		if (alloc_size != current_alloc_size) {
 			if (current_size == 0) {
 				// alloc from scratch
-				uint32_t *ptr = (uint32_t *)Memory::alloc_static(alloc_size, true);
+				uint32_t *ptr = (uint32_t *)Memory::alloc_static(alloc_size, true, _get_alloc_tag());
 				ERR_FAIL_COND_V(!ptr, ERR_OUT_OF_MEMORY);
 				*(ptr - 1) = 0; //size, currently none
 				*(ptr - 2) = 1; //refcount
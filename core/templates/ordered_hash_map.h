@@ -31,9 +31,8 @@
 #ifndef ORDERED_HASH_MAP_H
 #define ORDERED_HASH_MAP_H
 
-#include "core/templates/hash_map.h"
-#include "core/templates/list.h"
-#include "core/templates/pair.h"
+#include "core/os/memory.h"
+#include "core/templates/hashfuncs.h"
 
 /**
  * A hash map which allows to iterate elements in insertion order.
@@ -42,29 +41,228 @@
  * former is more frequently used and is more coherent with the rest of the
  * codebase.
  * Deletion during iteration is safe and will preserve the order.
+ *
+ * Keys are found through an open addressing index using Robin Hood hashing
+ * (see OAHashMap), which only stores hashes and entry indices, so probing
+ * never touches the keys of other entries unless the hashes match.
+ * Keys and values are stored separately in contiguous pages that are never
+ * moved, so pointers and references to them stay valid until the element is
+ * erased. Insertion order is kept with index links between entries, and
+ * erased entries are reused by later insertions.
  */
-template <class K, class V, class Hasher = HashMapHasherDefault, class Comparator = HashMapComparatorDefault<K>, uint8_t MIN_HASH_TABLE_POWER = 3, uint8_t RELATIONSHIP = 8>
+template <class K, class V, class Hasher = HashMapHasherDefault, class Comparator = HashMapComparatorDefault<K>>
 class OrderedHashMap {
-	typedef List<Pair<const K *, V>> InternalList;
-	typedef HashMap<K, typename InternalList::Element *, Hasher, Comparator, MIN_HASH_TABLE_POWER, RELATIONSHIP> InternalMap;
+	static const uint32_t EMPTY_HASH = 0;
+	static const uint32_t INVALID_ENTRY = 0xFFFFFFFF;
+	static const uint32_t MIN_INDEX_CAPACITY = 8;
+	static const uint32_t PAGE_SHIFT = 5;
+	static const uint32_t PAGE_SIZE = 1 << PAGE_SHIFT;
+	static const uint32_t PAGE_MASK = PAGE_SIZE - 1;
+
+	// Entries, keys and values are only constructed while in use.
+	K **key_pages = nullptr;
+	V **value_pages = nullptr;
+	uint32_t *entry_prev = nullptr;
+	uint32_t *entry_next = nullptr; // Also links the free entries.
+	uint32_t page_count = 0;
+	uint32_t entries_used = 0;
+	uint32_t free_entry = INVALID_ENTRY;
+
+	// Index, power of two capacity.
+	uint32_t *index_hashes = nullptr;
+	uint32_t *index_entries = nullptr;
+	uint32_t index_capacity = 0;
+
+	uint32_t head = INVALID_ENTRY;
+	uint32_t tail = INVALID_ENTRY;
+	uint32_t num_elements = 0;
+
+	_FORCE_INLINE_ static uint32_t _hash(const K &p_key) {
+		uint32_t hash = Hasher::hash(p_key);
+
+		if (hash == EMPTY_HASH) {
+			hash = EMPTY_HASH + 1;
+		}
+
+		return hash;
+	}
+
+	_FORCE_INLINE_ K &_key(uint32_t p_entry) const {
+		return key_pages[p_entry >> PAGE_SHIFT][p_entry & PAGE_MASK];
+	}
+
+	_FORCE_INLINE_ V &_value(uint32_t p_entry) const {
+		return value_pages[p_entry >> PAGE_SHIFT][p_entry & PAGE_MASK];
+	}
+
+	_FORCE_INLINE_ uint32_t _get_probe_length(uint32_t p_pos, uint32_t p_hash) const {
+		return (p_pos - p_hash) & (index_capacity - 1);
+	}
+
+	bool _lookup_pos(const K &p_key, uint32_t p_hash, uint32_t &r_pos) const {
+		if (index_capacity == 0) {
+			return false;
+		}
+
+		uint32_t mask = index_capacity - 1;
+		uint32_t pos = p_hash & mask;
+		uint32_t distance = 0;
+
+		while (true) {
+			uint32_t hash = index_hashes[pos];
+
+			if (hash == EMPTY_HASH) {
+				return false;
+			}
+
+			if (distance > _get_probe_length(pos, hash)) {
+				return false;
+			}
+
+			if (hash == p_hash && Comparator::compare(_key(index_entries[pos]), p_key)) {
+				r_pos = pos;
+				return true;
+			}
+
+			pos = (pos + 1) & mask;
+			distance++;
+		}
+	}
+
+	void _insert_index(uint32_t p_hash, uint32_t p_entry) {
+		uint32_t mask = index_capacity - 1;
+		uint32_t hash = p_hash;
+		uint32_t entry = p_entry;
+		uint32_t pos = hash & mask;
+		uint32_t distance = 0;
+
+		while (true) {
+			if (index_hashes[pos] == EMPTY_HASH) {
+				index_hashes[pos] = hash;
+				index_entries[pos] = entry;
+				return;
+			}
+
+			// Not an empty slot, let's check the probing length of the existing one.
+			uint32_t existing_probe_len = _get_probe_length(pos, index_hashes[pos]);
+			if (existing_probe_len < distance) {
+				SWAP(hash, index_hashes[pos]);
+				SWAP(entry, index_entries[pos]);
+				distance = existing_probe_len;
+			}
+
+			pos = (pos + 1) & mask;
+			distance++;
+		}
+	}
+
+	void _erase_index(uint32_t p_pos) {
+		uint32_t mask = index_capacity - 1;
+		uint32_t pos = p_pos;
+		uint32_t next_pos = (pos + 1) & mask;
+
+		// Backward shift deletion.
+		while (index_hashes[next_pos] != EMPTY_HASH && _get_probe_length(next_pos, index_hashes[next_pos]) != 0) {
+			index_hashes[pos] = index_hashes[next_pos];
+			index_entries[pos] = index_entries[next_pos];
+			pos = next_pos;
+			next_pos = (next_pos + 1) & mask;
+		}
+
+		index_hashes[pos] = EMPTY_HASH;
+	}
+
+	void _resize_index(uint32_t p_new_capacity) {
+		uint32_t old_capacity = index_capacity;
+		uint32_t *old_hashes = index_hashes;
+		uint32_t *old_entries = index_entries;
+
+		index_capacity = p_new_capacity;
+		index_hashes = (uint32_t *)memalloc(sizeof(uint32_t) * index_capacity);
+		index_entries = (uint32_t *)memalloc(sizeof(uint32_t) * index_capacity);
+
+		for (uint32_t i = 0; i < index_capacity; i++) {
+			index_hashes[i] = EMPTY_HASH;
+		}
+
+		if (old_capacity == 0) {
+			return;
+		}
+
+		// Only hashes and entry indices move, keys are not rehashed.
+		for (uint32_t i = 0; i < old_capacity; i++) {
+			if (old_hashes[i] != EMPTY_HASH) {
+				_insert_index(old_hashes[i], old_entries[i]);
+			}
+		}
+
+		memfree(old_hashes);
+		memfree(old_entries);
+	}
+
+	uint32_t _alloc_entry() {
+		if (free_entry != INVALID_ENTRY) {
+			uint32_t entry = free_entry;
+			free_entry = entry_next[entry];
+			return entry;
+		}
 
-	InternalList list;
-	InternalMap map;
+		if (entries_used == page_count * PAGE_SIZE) {
+			page_count++;
+			key_pages = (K **)memrealloc(key_pages, sizeof(K *) * page_count);
+			value_pages = (V **)memrealloc(value_pages, sizeof(V *) * page_count);
+			key_pages[page_count - 1] = (K *)memalloc(sizeof(K) * PAGE_SIZE);
+			value_pages[page_count - 1] = (V *)memalloc(sizeof(V) * PAGE_SIZE);
+			entry_prev = (uint32_t *)memrealloc(entry_prev, sizeof(uint32_t) * page_count * PAGE_SIZE);
+			entry_next = (uint32_t *)memrealloc(entry_next, sizeof(uint32_t) * page_count * PAGE_SIZE);
+		}
+
+		return entries_used++;
+	}
+
+	void _erase_at(uint32_t p_pos) {
+		uint32_t entry = index_entries[p_pos];
+		_erase_index(p_pos);
+
+		uint32_t prev = entry_prev[entry];
+		uint32_t next = entry_next[entry];
+
+		if (prev != INVALID_ENTRY) {
+			entry_next[prev] = next;
+		} else {
+			head = next;
+		}
+
+		if (next != INVALID_ENTRY) {
+			entry_prev[next] = prev;
+		} else {
+			tail = prev;
+		}
+
+		_key(entry).~K();
+		_value(entry).~V();
+
+		entry_next[entry] = free_entry;
+		free_entry = entry;
+		num_elements--;
+	}
 
 public:
 	class Element {
-		friend class OrderedHashMap<K, V, Hasher, Comparator, MIN_HASH_TABLE_POWER, RELATIONSHIP>;
+		friend class OrderedHashMap<K, V, Hasher, Comparator>;
 
-		typename InternalList::Element *list_element = nullptr;
-		typename InternalList::Element *prev_element = nullptr;
-		typename InternalList::Element *next_element = nullptr;
+		OrderedHashMap *map = nullptr;
+		uint32_t entry = INVALID_ENTRY;
+		uint32_t prev_entry = INVALID_ENTRY;
+		uint32_t next_entry = INVALID_ENTRY;
 
-		Element(typename InternalList::Element *p_element) {
-			list_element = p_element;
+		Element(OrderedHashMap *p_map, uint32_t p_entry) {
+			map = p_map;
+			entry = p_entry;
 
-			if (list_element) {
-				next_element = list_element->next();
-				prev_element = list_element->prev();
+			if (entry != INVALID_ENTRY) {
+				next_entry = map->entry_next[entry];
+				prev_entry = map->entry_prev[entry];
 			}
 		}
 
@@ -72,166 +270,183 @@ public:
 		_FORCE_INLINE_ Element() {}
 
 		Element next() const {
-			return Element(next_element);
+			return Element(map, next_entry);
 		}
 
 		Element prev() const {
-			return Element(prev_element);
-		}
-
-		Element(const Element &other) :
-				list_element(other.list_element),
-				prev_element(other.prev_element),
-				next_element(other.next_element) {
-		}
-
-		Element &operator=(const Element &other) {
-			list_element = other.list_element;
-			next_element = other.next_element;
-			prev_element = other.prev_element;
-			return *this;
+			return Element(map, prev_entry);
 		}
 
 		_FORCE_INLINE_ bool operator==(const Element &p_other) const {
-			return this->list_element == p_other.list_element;
+			return entry == p_other.entry && (entry == INVALID_ENTRY || map == p_other.map);
 		}
 		_FORCE_INLINE_ bool operator!=(const Element &p_other) const {
-			return this->list_element != p_other.list_element;
+			return !(*this == p_other);
 		}
 
 		operator bool() const {
-			return (list_element != nullptr);
+			return (entry != INVALID_ENTRY);
 		}
 
 		const K &key() const {
-			CRASH_COND(!list_element);
-			return *(list_element->get().first);
+			CRASH_COND(entry == INVALID_ENTRY);
+			return map->_key(entry);
 		}
 
 		V &value() {
-			CRASH_COND(!list_element);
-			return list_element->get().second;
+			CRASH_COND(entry == INVALID_ENTRY);
+			return map->_value(entry);
 		}
 
 		const V &value() const {
-			CRASH_COND(!list_element);
-			return list_element->get().second;
+			CRASH_COND(entry == INVALID_ENTRY);
+			return map->_value(entry);
 		}
 
 		V &get() {
-			CRASH_COND(!list_element);
-			return list_element->get().second;
+			CRASH_COND(entry == INVALID_ENTRY);
+			return map->_value(entry);
 		}
 
 		const V &get() const {
-			CRASH_COND(!list_element);
-			return list_element->get().second;
+			CRASH_COND(entry == INVALID_ENTRY);
+			return map->_value(entry);
 		}
 	};
 
 	class ConstElement {
-		friend class OrderedHashMap<K, V, Hasher, Comparator, MIN_HASH_TABLE_POWER, RELATIONSHIP>;
+		friend class OrderedHashMap<K, V, Hasher, Comparator>;
 
-		const typename InternalList::Element *list_element = nullptr;
+		const OrderedHashMap *map = nullptr;
+		uint32_t entry = INVALID_ENTRY;
 
-		ConstElement(const typename InternalList::Element *p_element) :
-				list_element(p_element) {
+		ConstElement(const OrderedHashMap *p_map, uint32_t p_entry) :
+				map(p_map),
+				entry(p_entry) {
 		}
 
 	public:
 		_FORCE_INLINE_ ConstElement() {}
 
-		ConstElement(const ConstElement &other) :
-				list_element(other.list_element) {
-		}
-
-		ConstElement &operator=(const ConstElement &other) {
-			list_element = other.list_element;
-			return *this;
-		}
-
 		ConstElement next() const {
-			return ConstElement(list_element ? list_element->next() : nullptr);
+			return ConstElement(map, entry != INVALID_ENTRY ? map->entry_next[entry] : INVALID_ENTRY);
 		}
 
 		ConstElement prev() const {
-			return ConstElement(list_element ? list_element->prev() : nullptr);
+			return ConstElement(map, entry != INVALID_ENTRY ? map->entry_prev[entry] : INVALID_ENTRY);
 		}
 
 		_FORCE_INLINE_ bool operator==(const ConstElement &p_other) const {
-			return this->list_element == p_other.list_element;
+			return entry == p_other.entry && (entry == INVALID_ENTRY || map == p_other.map);
 		}
 		_FORCE_INLINE_ bool operator!=(const ConstElement &p_other) const {
-			return this->list_element != p_other.list_element;
+			return !(*this == p_other);
 		}
 
 		operator bool() const {
-			return (list_element != nullptr);
+			return (entry != INVALID_ENTRY);
 		}
 
 		const K &key() const {
-			CRASH_COND(!list_element);
-			return *(list_element->get().first);
+			CRASH_COND(entry == INVALID_ENTRY);
+			return map->_key(entry);
 		}
 
 		const V &value() const {
-			CRASH_COND(!list_element);
-			return list_element->get().second;
+			CRASH_COND(entry == INVALID_ENTRY);
+			return map->_value(entry);
 		}
 
 		const V &get() const {
-			CRASH_COND(!list_element);
-			return list_element->get().second;
+			CRASH_COND(entry == INVALID_ENTRY);
+			return map->_value(entry);
 		}
 	};
 
 	ConstElement find(const K &p_key) const {
-		typename InternalList::Element *const *list_element = map.getptr(p_key);
-		if (list_element) {
-			return ConstElement(*list_element);
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, _hash(p_key), pos)) {
+			return ConstElement(this, index_entries[pos]);
 		}
-		return ConstElement(nullptr);
+		return ConstElement(this, INVALID_ENTRY);
 	}
 
 	Element find(const K &p_key) {
-		typename InternalList::Element **list_element = map.getptr(p_key);
-		if (list_element) {
-			return Element(*list_element);
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, _hash(p_key), pos)) {
+			return Element(this, index_entries[pos]);
+		}
+		return Element(this, INVALID_ENTRY);
+	}
+
+	const V *getptr(const K &p_key) const {
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, _hash(p_key), pos)) {
+			return &_value(index_entries[pos]);
 		}
-		return Element(nullptr);
+		return nullptr;
+	}
+
+	V *getptr(const K &p_key) {
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, _hash(p_key), pos)) {
+			return &_value(index_entries[pos]);
+		}
+		return nullptr;
 	}
 
 	Element insert(const K &p_key, const V &p_value) {
-		typename InternalList::Element **list_element = map.getptr(p_key);
-		if (list_element) {
-			(*list_element)->get().second = p_value;
-			return Element(*list_element);
+		uint32_t hash = _hash(p_key);
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, hash, pos)) {
+			_value(index_entries[pos]) = p_value;
+			return Element(this, index_entries[pos]);
+		}
+
+		// Keep the load factor of the index under 75%.
+		if ((num_elements + 1) * 4 > index_capacity * 3) {
+			_resize_index(index_capacity == 0 ? MIN_INDEX_CAPACITY : index_capacity * 2);
+		}
+
+		uint32_t entry = _alloc_entry();
+		memnew_placement(&_key(entry), K(p_key));
+		memnew_placement(&_value(entry), V(p_value));
+
+		entry_prev[entry] = tail;
+		entry_next[entry] = INVALID_ENTRY;
+		if (tail != INVALID_ENTRY) {
+			entry_next[tail] = entry;
+		} else {
+			head = entry;
 		}
-		typename InternalList::Element *new_element = list.push_back(Pair<const K *, V>(nullptr, p_value));
-		typename InternalMap::Element *e = map.set(p_key, new_element);
-		new_element->get().first = &e->key();
+		tail = entry;
+
+		_insert_index(hash, entry);
+		num_elements++;
 
-		return Element(new_element);
+		return Element(this, entry);
 	}
 
 	void erase(Element &p_element) {
-		map.erase(p_element.key());
-		list.erase(p_element.list_element);
-		p_element.list_element = nullptr;
+		uint32_t pos = 0;
+		if (_lookup_pos(p_element.key(), _hash(p_element.key()), pos)) {
+			_erase_at(pos);
+		}
+		p_element.entry = INVALID_ENTRY;
 	}
 
 	bool erase(const K &p_key) {
-		typename InternalList::Element **list_element = map.getptr(p_key);
-		if (list_element) {
-			list.erase(*list_element);
-			map.erase(p_key);
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, _hash(p_key), pos)) {
+			_erase_at(pos);
 			return true;
 		}
 		return false;
 	}
 
 	inline bool has(const K &p_key) const {
-		return map.has(p_key);
+		uint32_t pos = 0;
+		return _lookup_pos(p_key, _hash(p_key), pos);
 	}
 
 	const V &operator[](const K &p_key) const {
@@ -250,31 +465,44 @@ public:
 	}
 
 	inline Element front() {
-		return Element(list.front());
+		return Element(this, head);
 	}
 
 	inline Element back() {
-		return Element(list.back());
+		return Element(this, tail);
 	}
 
 	inline ConstElement front() const {
-		return ConstElement(list.front());
+		return ConstElement(this, head);
 	}
 
 	inline ConstElement back() const {
-		return ConstElement(list.back());
+		return ConstElement(this, tail);
 	}
 
-	inline bool empty() const { return list.empty(); }
-	inline int size() const { return list.size(); }
+	inline bool empty() const { return num_elements == 0; }
+	inline int size() const { return num_elements; }
 
 	const void *id() const {
-		return list.id();
+		return this;
 	}
 
 	void clear() {
-		map.clear();
-		list.clear();
+		for (uint32_t entry = head; entry != INVALID_ENTRY; entry = entry_next[entry]) {
+			_key(entry).~K();
+			_value(entry).~V();
+		}
+
+		for (uint32_t i = 0; i < index_capacity; i++) {
+			index_hashes[i] = EMPTY_HASH;
+		}
+
+		// Pages are kept for reuse.
+		entries_used = 0;
+		free_entry = INVALID_ENTRY;
+		head = INVALID_ENTRY;
+		tail = INVALID_ENTRY;
+		num_elements = 0;
 	}
 
 private:
@@ -286,6 +514,10 @@ private:
 
 public:
 	void operator=(const OrderedHashMap &p_map) {
+		if (this == &p_map) {
+			return;
+		}
+		clear();
 		_copy_from(p_map);
 	}
 
@@ -294,6 +526,27 @@ public:
 	}
 
 	_FORCE_INLINE_ OrderedHashMap() {}
+
+	~OrderedHashMap() {
+		clear();
+
+		for (uint32_t i = 0; i < page_count; i++) {
+			memfree(key_pages[i]);
+			memfree(value_pages[i]);
+		}
+
+		if (page_count) {
+			memfree(key_pages);
+			memfree(value_pages);
+			memfree(entry_prev);
+			memfree(entry_next);
+		}
+
+		if (index_capacity) {
+			memfree(index_hashes);
+			memfree(index_entries);
+		}
+	}
 };
 
 #endif // ORDERED_HASH_MAP_H
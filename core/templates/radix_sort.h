@@ -0,0 +1,97 @@
+/*************************************************************************/
+/*  radix_sort.h                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include "core/os/copymem.h"
+#include "core/typedefs.h"
+
+// Stable LSD radix sort on 64-bit keys, one byte per pass.
+// KeyGetter returns the key of an element, like Comparator does for SortArray.
+template <class T, class KeyGetter>
+class RadixSort {
+public:
+	struct Pair {
+		uint64_t key;
+		T value;
+	};
+
+	KeyGetter get_key;
+
+	// p_pairs and p_pairs_tmp must hold p_count pairs each, so callers can keep them around between sorts.
+	void sort(T *p_array, int p_count, Pair *p_pairs, Pair *p_pairs_tmp) const {
+		if (p_count < 2) {
+			return;
+		}
+
+		uint32_t histogram[8][256];
+		zeromem(histogram, sizeof(histogram));
+
+		//keys are copied next to the values so passes don't chase them, all digit histograms are built at once
+		for (int i = 0; i < p_count; i++) {
+			uint64_t key = get_key(p_array[i]);
+			p_pairs[i].key = key;
+			p_pairs[i].value = p_array[i];
+			for (int j = 0; j < 8; j++) {
+				histogram[j][(key >> (j * 8)) & 0xFF]++;
+			}
+		}
+
+		Pair *src = p_pairs;
+		Pair *dst = p_pairs_tmp;
+
+		for (int j = 0; j < 8; j++) {
+			uint32_t *h = histogram[j];
+			if (h[(src[0].key >> (j * 8)) & 0xFF] == uint32_t(p_count)) {
+				continue; //all keys share this digit, nothing to reorder
+			}
+
+			uint32_t offset = 0;
+			for (int k = 0; k < 256; k++) {
+				uint32_t c = h[k];
+				h[k] = offset;
+				offset += c;
+			}
+
+			for (int i = 0; i < p_count; i++) {
+				dst[h[(src[i].key >> (j * 8)) & 0xFF]++] = src[i];
+			}
+
+			SWAP(src, dst);
+		}
+
+		for (int i = 0; i < p_count; i++) {
+			p_array[i] = src[i].value;
+		}
+	}
+};
+
+#endif // RADIX_SORT_H
@@ -40,6 +40,7 @@
 #include "core/templates/safe_refcount.h"
 #include "core/templates/set.h"
 
+#include <atomic>
 #include <stdio.h>
 #include <typeinfo>
 
@@ -67,55 +68,94 @@ public:
 
 template <class T, bool THREAD_SAFE = false>
 class RID_Alloc : public RID_AllocBase {
-	T **chunks = nullptr;
+	// Lookups (getornull, owns) never lock. The chunk directory is only ever
+	// replaced by a bigger copy, published atomically. Replaced directories
+	// are kept alive until destruction, so a reader still holding one keeps
+	// seeing valid chunks. Validators are atomic, and only become valid once
+	// the element is fully constructed.
+	struct Directory {
+		Directory *retired = nullptr;
+		uint32_t capacity = 0;
+		T **chunks = nullptr;
+		std::atomic<uint32_t> **validator_chunks = nullptr;
+	};
+
+	static constexpr std::memory_order READ_ORDER = THREAD_SAFE ? std::memory_order_acquire : std::memory_order_relaxed;
+	static constexpr std::memory_order WRITE_ORDER = THREAD_SAFE ? std::memory_order_release : std::memory_order_relaxed;
+
+	std::atomic<Directory *> directory = { nullptr };
 	uint32_t **free_list_chunks = nullptr;
-	uint32_t **validator_chunks = nullptr;
 
 	uint32_t elements_in_chunk;
-	uint32_t max_alloc = 0;
+	std::atomic<uint32_t> max_alloc = { 0 };
 	uint32_t alloc_count = 0;
 
 	const char *description = nullptr;
 
 	SpinLock spin_lock;
 
+	Directory *_grow_directory(Directory *p_directory, uint32_t p_chunk_count) {
+		uint32_t capacity = p_directory ? p_directory->capacity * 2 : 8;
+
+		//one block: header, then chunk pointers, then validator chunk pointers
+		uint8_t *mem = (uint8_t *)memalloc(sizeof(Directory) + (sizeof(T *) + sizeof(std::atomic<uint32_t> *)) * capacity);
+		Directory *dir = memnew_placement(mem, Directory);
+		dir->capacity = capacity;
+		dir->chunks = (T **)(mem + sizeof(Directory));
+		dir->validator_chunks = (std::atomic<uint32_t> **)(mem + sizeof(Directory) + sizeof(T *) * capacity);
+		dir->retired = p_directory;
+
+		for (uint32_t i = 0; i < p_chunk_count; i++) {
+			dir->chunks[i] = p_directory->chunks[i];
+			dir->validator_chunks[i] = p_directory->validator_chunks[i];
+		}
+
+		free_list_chunks = (uint32_t **)memrealloc(free_list_chunks, sizeof(uint32_t *) * capacity);
+
+		return dir;
+	}
+
 public:
 	RID make_rid(const T &p_value) {
 		if (THREAD_SAFE) {
 			spin_lock.lock();
 		}
 
-		if (alloc_count == max_alloc) {
+		uint32_t current_max = max_alloc.load(std::memory_order_relaxed);
+
+		if (alloc_count == current_max) {
 			//allocate a new chunk
-			uint32_t chunk_count = alloc_count == 0 ? 0 : (max_alloc / elements_in_chunk);
+			uint32_t chunk_count = current_max / elements_in_chunk;
+			Directory *dir = directory.load(std::memory_order_relaxed);
 
-			//grow chunks
-			chunks = (T **)memrealloc(chunks, sizeof(T *) * (chunk_count + 1));
-			chunks[chunk_count] = (T *)memalloc(sizeof(T) * elements_in_chunk); //but don't initialize
+			if (!dir || chunk_count == dir->capacity) {
+				//copies are published before the chunk count grows, readers only index chunks they know exist
+				dir = _grow_directory(dir, chunk_count);
+				directory.store(dir, WRITE_ORDER);
+			}
 
-			//grow validators
-			validator_chunks = (uint32_t **)memrealloc(validator_chunks, sizeof(uint32_t *) * (chunk_count + 1));
-			validator_chunks[chunk_count] = (uint32_t *)memalloc(sizeof(uint32_t) * elements_in_chunk);
-			//grow free lists
-			free_list_chunks = (uint32_t **)memrealloc(free_list_chunks, sizeof(uint32_t *) * (chunk_count + 1));
+			dir->chunks[chunk_count] = (T *)memalloc(sizeof(T) * elements_in_chunk); //but don't initialize
+			dir->validator_chunks[chunk_count] = (std::atomic<uint32_t> *)memalloc(sizeof(std::atomic<uint32_t>) * elements_in_chunk);
 			free_list_chunks[chunk_count] = (uint32_t *)memalloc(sizeof(uint32_t) * elements_in_chunk);
 
 			//initialize
 			for (uint32_t i = 0; i < elements_in_chunk; i++) {
 				//dont initialize chunk
-				validator_chunks[chunk_count][i] = 0xFFFFFFFF;
+				dir->validator_chunks[chunk_count][i].store(0xFFFFFFFF, std::memory_order_relaxed);
 				free_list_chunks[chunk_count][i] = alloc_count + i;
 			}
 
-			max_alloc += elements_in_chunk;
+			max_alloc.store(current_max + elements_in_chunk, WRITE_ORDER);
 		}
 
+		Directory *dir = directory.load(std::memory_order_relaxed);
+
 		uint32_t free_index = free_list_chunks[alloc_count / elements_in_chunk][alloc_count % elements_in_chunk];
 
 		uint32_t free_chunk = free_index / elements_in_chunk;
 		uint32_t free_element = free_index % elements_in_chunk;
 
-		T *ptr = &chunks[free_chunk][free_element];
+		T *ptr = &dir->chunks[free_chunk][free_element];
 		memnew_placement(ptr, T(p_value));
 
 		uint32_t validator = (uint32_t)(_gen_id() & 0xFFFFFFFF);
@@ -123,7 +163,7 @@ public:
 		id <<= 32;
 		id |= free_index;
 
-		validator_chunks[free_chunk][free_element] = validator;
+		dir->validator_chunks[free_chunk][free_element].store(validator, WRITE_ORDER);
 		alloc_count++;
 
 		if (THREAD_SAFE) {
@@ -134,65 +174,38 @@ public:
 	}
 
 	_FORCE_INLINE_ T *getornull(const RID &p_rid) {
-		if (THREAD_SAFE) {
-			spin_lock.lock();
-		}
-
 		uint64_t id = p_rid.get_id();
 		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
+		if (unlikely(idx >= max_alloc.load(READ_ORDER))) {
 			return nullptr;
 		}
 
+		Directory *dir = directory.load(READ_ORDER);
 		uint32_t idx_chunk = idx / elements_in_chunk;
 		uint32_t idx_element = idx % elements_in_chunk;
 
 		uint32_t validator = uint32_t(id >> 32);
-		if (unlikely(validator_chunks[idx_chunk][idx_element] != validator)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
+		if (unlikely(dir->validator_chunks[idx_chunk][idx_element].load(READ_ORDER) != validator)) {
 			return nullptr;
 		}
 
-		T *ptr = &chunks[idx_chunk][idx_element];
-
-		if (THREAD_SAFE) {
-			spin_lock.unlock();
-		}
-
-		return ptr;
+		return &dir->chunks[idx_chunk][idx_element];
 	}
 
 	_FORCE_INLINE_ bool owns(const RID &p_rid) {
-		if (THREAD_SAFE) {
-			spin_lock.lock();
-		}
-
 		uint64_t id = p_rid.get_id();
 		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
+		if (unlikely(idx >= max_alloc.load(READ_ORDER))) {
 			return false;
 		}
 
+		Directory *dir = directory.load(READ_ORDER);
 		uint32_t idx_chunk = idx / elements_in_chunk;
 		uint32_t idx_element = idx % elements_in_chunk;
 
 		uint32_t validator = uint32_t(id >> 32);
 
-		bool owned = validator_chunks[idx_chunk][idx_element] == validator;
-
-		if (THREAD_SAFE) {
-			spin_lock.unlock();
-		}
-
-		return owned;
+		return dir->validator_chunks[idx_chunk][idx_element].load(READ_ORDER) == validator;
 	}
 
 	_FORCE_INLINE_ void free(const RID &p_rid) {
@@ -202,26 +215,27 @@ public:
 
 		uint64_t id = p_rid.get_id();
 		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
+		if (unlikely(idx >= max_alloc.load(std::memory_order_relaxed))) {
 			if (THREAD_SAFE) {
 				spin_lock.unlock();
 			}
 			ERR_FAIL();
 		}
 
+		Directory *dir = directory.load(std::memory_order_relaxed);
 		uint32_t idx_chunk = idx / elements_in_chunk;
 		uint32_t idx_element = idx % elements_in_chunk;
 
 		uint32_t validator = uint32_t(id >> 32);
-		if (unlikely(validator_chunks[idx_chunk][idx_element] != validator)) {
+		if (unlikely(dir->validator_chunks[idx_chunk][idx_element].load(std::memory_order_relaxed) != validator)) {
 			if (THREAD_SAFE) {
 				spin_lock.unlock();
 			}
 			ERR_FAIL();
 		}
 
-		chunks[idx_chunk][idx_element].~T();
-		validator_chunks[idx_chunk][idx_element] = 0xFFFFFFFF; // go invalid
+		dir->validator_chunks[idx_chunk][idx_element].store(0xFFFFFFFF, WRITE_ORDER); // go invalid before destruction
+		dir->chunks[idx_chunk][idx_element].~T();
 
 		alloc_count--;
 		free_list_chunks[alloc_count / elements_in_chunk][alloc_count % elements_in_chunk] = idx;
@@ -240,8 +254,9 @@ public:
 		if (THREAD_SAFE) {
 			spin_lock.lock();
 		}
+		Directory *dir = directory.load(std::memory_order_relaxed);
 		uint64_t idx = free_list_chunks[p_index / elements_in_chunk][p_index % elements_in_chunk];
-		T *ptr = &chunks[idx / elements_in_chunk][idx % elements_in_chunk];
+		T *ptr = &dir->chunks[idx / elements_in_chunk][idx % elements_in_chunk];
 		if (THREAD_SAFE) {
 			spin_lock.unlock();
 		}
@@ -253,8 +268,9 @@ public:
 		if (THREAD_SAFE) {
 			spin_lock.lock();
 		}
+		Directory *dir = directory.load(std::memory_order_relaxed);
 		uint64_t idx = free_list_chunks[p_index / elements_in_chunk][p_index % elements_in_chunk];
-		uint64_t validator = validator_chunks[idx / elements_in_chunk][idx % elements_in_chunk];
+		uint64_t validator = dir->validator_chunks[idx / elements_in_chunk][idx % elements_in_chunk].load(std::memory_order_relaxed);
 
 		RID rid = _make_from_id((validator << 32) | idx);
 		if (THREAD_SAFE) {
@@ -267,8 +283,10 @@ public:
 		if (THREAD_SAFE) {
 			spin_lock.lock();
 		}
-		for (size_t i = 0; i < max_alloc; i++) {
-			uint64_t validator = validator_chunks[i / elements_in_chunk][i % elements_in_chunk];
+		Directory *dir = directory.load(std::memory_order_relaxed);
+		uint32_t current_max = max_alloc.load(std::memory_order_relaxed);
+		for (size_t i = 0; i < current_max; i++) {
+			uint64_t validator = dir->validator_chunks[i / elements_in_chunk][i % elements_in_chunk].load(std::memory_order_relaxed);
 			if (validator != 0xFFFFFFFF) {
 				p_owned->push_back(_make_from_id((validator << 32) | i));
 			}
@@ -287,6 +305,9 @@ public:
 	}
 
 	~RID_Alloc() {
+		Directory *dir = directory.load(std::memory_order_relaxed);
+		uint32_t current_max = max_alloc.load(std::memory_order_relaxed);
+
 		if (alloc_count) {
 			if (description) {
 				print_error("ERROR: " + itos(alloc_count) + " RID allocations of type '" + description + "' were leaked at exit.");
@@ -298,25 +319,29 @@ public:
 #endif
 			}
 
-			for (size_t i = 0; i < max_alloc; i++) {
-				uint64_t validator = validator_chunks[i / elements_in_chunk][i % elements_in_chunk];
+			for (size_t i = 0; i < current_max; i++) {
+				uint64_t validator = dir->validator_chunks[i / elements_in_chunk][i % elements_in_chunk].load(std::memory_order_relaxed);
 				if (validator != 0xFFFFFFFF) {
-					chunks[i / elements_in_chunk][i % elements_in_chunk].~T();
+					dir->chunks[i / elements_in_chunk][i % elements_in_chunk].~T();
 				}
 			}
 		}
 
-		uint32_t chunk_count = max_alloc / elements_in_chunk;
+		uint32_t chunk_count = current_max / elements_in_chunk;
 		for (uint32_t i = 0; i < chunk_count; i++) {
-			memfree(chunks[i]);
-			memfree(validator_chunks[i]);
+			memfree(dir->chunks[i]);
+			memfree(dir->validator_chunks[i]);
 			memfree(free_list_chunks[i]);
 		}
 
-		if (chunks) {
-			memfree(chunks);
+		if (free_list_chunks) {
 			memfree(free_list_chunks);
-			memfree(validator_chunks);
+		}
+
+		while (dir) {
+			Directory *retired = dir->retired;
+			memfree(dir);
+			dir = retired;
 		}
 	}
 };
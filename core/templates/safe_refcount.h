@@ -35,6 +35,10 @@
 #include "core/typedefs.h"
 #include "platform_config.h"
 
+#if defined(_MSC_VER)
+#include <atomic>
+#endif
+
 // Atomic functions, these are used for multithread safe reference counters!
 
 #ifdef NO_THREADS
@@ -59,6 +63,11 @@ static _ALWAYS_INLINE_ T atomic_decrement(volatile T *pw) {
 	return *pw;
 }
 
+template <class T>
+static _ALWAYS_INLINE_ T atomic_load_acquire(volatile T *pw) {
+	return *pw;
+}
+
 template <class T>
 static _ALWAYS_INLINE_ T atomic_increment(volatile T *pw) {
 	(*pw)++;
@@ -114,6 +123,11 @@ static _ALWAYS_INLINE_ T atomic_decrement(volatile T *pw) {
 	return __sync_sub_and_fetch(pw, 1);
 }
 
+template <class T>
+static _ALWAYS_INLINE_ T atomic_load_acquire(volatile T *pw) {
+	return __atomic_load_n(pw, __ATOMIC_ACQUIRE);
+}
+
 template <class T>
 static _ALWAYS_INLINE_ T atomic_increment(volatile T *pw) {
 	return __sync_add_and_fetch(pw, 1);
@@ -159,6 +173,13 @@ uint64_t atomic_sub(volatile uint64_t *pw, volatile uint64_t val);
 uint64_t atomic_add(volatile uint64_t *pw, volatile uint64_t val);
 uint64_t atomic_exchange_if_greater(volatile uint64_t *pw, volatile uint64_t val);
 
+template <class T>
+static _ALWAYS_INLINE_ T atomic_load_acquire(volatile T *pw) {
+	T value = *pw;
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return value;
+}
+
 #else
 //no threads supported?
 #error Must provide atomic functions for this platform or compiler!
@@ -30,8 +30,12 @@
 
 #include "thread_work_pool.h"
 
+#include "core/os/mutex.h"
 #include "core/os/os.h"
 
+static ThreadWorkPool *shared_pool = nullptr;
+static Mutex shared_pool_mutex;
+
 void ThreadWorkPool::_thread_function(ThreadData *p_thread) {
 	while (true) {
 		p_thread->start.wait();
@@ -79,3 +83,27 @@ void ThreadWorkPool::finish() {
 ThreadWorkPool::~ThreadWorkPool() {
 	finish();
 }
+
+ThreadWorkPool *ThreadWorkPool::_lock_shared() {
+	if (!OS::get_singleton()->can_use_threads() || shared_pool_mutex.try_lock() != OK) {
+		return nullptr;
+	}
+
+	if (!shared_pool) {
+		shared_pool = memnew(ThreadWorkPool);
+		shared_pool->init();
+	}
+	return shared_pool;
+}
+
+void ThreadWorkPool::_unlock_shared() {
+	shared_pool_mutex.unlock();
+}
+
+void ThreadWorkPool::finish_shared() {
+	MutexLock lock(shared_pool_mutex);
+	if (shared_pool) {
+		memdelete(shared_pool);
+		shared_pool = nullptr;
+	}
+}
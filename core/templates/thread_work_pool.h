@@ -77,6 +77,9 @@ class ThreadWorkPool {
 
 	static void _thread_function(ThreadData *p_thread);
 
+	static ThreadWorkPool *_lock_shared();
+	static void _unlock_shared();
+
 public:
 	template <class C, class M, class U>
 	void begin_work(uint32_t p_elements, C *p_instance, M p_method, U p_userdata) {
@@ -125,6 +128,24 @@ public:
 		end_work();
 	}
 
+	// Runs the work on a pool shared by the engine, created on first use. With fewer than
+	// p_min_threaded_elements elements waking the threads doesn't pay off, so the work runs on
+	// the calling thread instead, as it does when threads are not available or the pool is busy.
+	template <class C, class M, class U>
+	static void do_shared_work(uint32_t p_elements, C *p_instance, M p_method, U p_userdata, uint32_t p_min_threaded_elements = 4) {
+		ThreadWorkPool *pool = p_elements >= p_min_threaded_elements ? _lock_shared() : nullptr;
+		if (pool) {
+			pool->do_work(p_elements, p_instance, p_method, p_userdata);
+			_unlock_shared();
+		} else {
+			for (uint32_t i = 0; i < p_elements; i++) {
+				(p_instance->*p_method)(i, p_userdata);
+			}
+		}
+	}
+
+	static void finish_shared();
+
 	void init(int p_thread_count = -1);
 	void finish();
 	~ThreadWorkPool();
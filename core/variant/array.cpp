@@ -526,7 +526,7 @@ const void *Array::id() const {
 }
 
 Array::Array(const Array &p_from, uint32_t p_type, const StringName &p_class_name, const Variant &p_script) {
-	_p = memnew(ArrayPrivate);
+	_p = memnew_tagged(ArrayPrivate, Memory::TAG_VARIANT);
 	_p->refcount.init();
 	set_typed(p_type, p_class_name, p_script);
 	_assign(p_from);
@@ -552,7 +552,7 @@ Array::Array(const Array &p_from) {
 }
 
 Array::Array() {
-	_p = memnew(ArrayPrivate);
+	_p = memnew_tagged(ArrayPrivate, Memory::TAG_VARIANT);
 	_p->refcount.init();
 }
 
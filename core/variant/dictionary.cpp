@@ -264,7 +264,7 @@ Dictionary::Dictionary(const Dictionary &p_from) {
 }
 
 Dictionary::Dictionary() {
-	_p = memnew(DictionaryPrivate);
+	_p = memnew_tagged(DictionaryPrivate, Memory::TAG_VARIANT);
 	_p->refcount.init();
 }
 
@@ -966,6 +966,8 @@ public:
 	bool free(RID p_rid) override { return true; }
 	void update() override {}
 
+	int get_render_info(RS::RenderInfo p_info) override { return 0; }
+
 	RasterizerCanvasDummy() {}
 	~RasterizerCanvasDummy() {}
 };
@@ -31,6 +31,7 @@
 #include "rendering_device_vulkan.h"
 
 #include "core/config/project_settings.h"
+#include "core/io/marshalls.h"
 #include "core/os/file_access.h"
 #include "core/os/os.h"
 #include "core/templates/hashfuncs.h"
@@ -5404,7 +5405,7 @@ RID RenderingDeviceVulkan::render_pipeline_create(RID p_shader, FramebufferForma
 	graphics_pipeline_create_info.basePipelineIndex = 0;
 
 	RenderPipeline pipeline;
-	VkResult err = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &graphics_pipeline_create_info, nullptr, &pipeline.pipeline);
+	VkResult err = vkCreateGraphicsPipelines(device, pipeline_cache, 1, &graphics_pipeline_create_info, nullptr, &pipeline.pipeline);
 	ERR_FAIL_COND_V_MSG(err, RID(), "vkCreateGraphicsPipelines failed with error " + itos(err) + ".");
 
 	pipeline.set_formats = shader->set_formats;
@@ -5477,7 +5478,7 @@ RID RenderingDeviceVulkan::compute_pipeline_create(RID p_shader) {
 	compute_pipeline_create_info.basePipelineIndex = 0;
 
 	ComputePipeline pipeline;
-	VkResult err = vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &compute_pipeline_create_info, nullptr, &pipeline.pipeline);
+	VkResult err = vkCreateComputePipelines(device, pipeline_cache, 1, &compute_pipeline_create_info, nullptr, &pipeline.pipeline);
 	ERR_FAIL_COND_V_MSG(err, RID(), "vkCreateComputePipelines failed with error " + itos(err) + ".");
 
 	pipeline.set_formats = shader->set_formats;
@@ -7257,6 +7258,8 @@ void RenderingDeviceVulkan::initialize(VulkanContext *p_context, bool p_local_de
 		vmaCreateAllocator(&allocatorInfo, &allocator);
 	}
 
+	_create_pipeline_cache(Vector<uint8_t>());
+
 	frames = memnew_arr(Frame, frame_count);
 	frame = 0;
 	//create setup and frame buffers
@@ -7638,6 +7641,9 @@ void RenderingDeviceVulkan::finalize() {
 	for (int i = 0; i < framebuffer_formats.size(); i++) {
 		vkDestroyRenderPass(device, framebuffer_formats[i].render_pass, nullptr);
 	}
+
+	vkDestroyPipelineCache(device, pipeline_cache, nullptr);
+	pipeline_cache = VK_NULL_HANDLE;
 	framebuffer_formats.clear();
 
 	//all these should be clear at this point
@@ -7646,6 +7652,65 @@ void RenderingDeviceVulkan::finalize() {
 	ERR_FAIL_COND(reverse_dependency_map.size());
 }
 
+void RenderingDeviceVulkan::_create_pipeline_cache(const Vector<uint8_t> &p_data) {
+	VkPipelineCacheCreateInfo cache_create_info;
+	cache_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	cache_create_info.pNext = nullptr;
+	cache_create_info.flags = 0;
+	cache_create_info.initialDataSize = p_data.size();
+	cache_create_info.pInitialData = p_data.ptr();
+
+	VkPipelineCache new_cache;
+	VkResult err = vkCreatePipelineCache(device, &cache_create_info, nullptr, &new_cache);
+	ERR_FAIL_COND_MSG(err, "vkCreatePipelineCache failed with error " + itos(err) + ".");
+
+	if (pipeline_cache != VK_NULL_HANDLE) {
+		vkDestroyPipelineCache(device, pipeline_cache, nullptr);
+	}
+	pipeline_cache = new_cache;
+}
+
+Vector<uint8_t> RenderingDeviceVulkan::pipeline_cache_get_data() {
+	_THREAD_SAFE_METHOD_
+
+	Vector<uint8_t> data;
+	if (pipeline_cache == VK_NULL_HANDLE) {
+		return data;
+	}
+
+	size_t size = 0;
+	VkResult err = vkGetPipelineCacheData(device, pipeline_cache, &size, nullptr);
+	ERR_FAIL_COND_V_MSG(err, data, "vkGetPipelineCacheData failed with error " + itos(err) + ".");
+
+	data.resize(size);
+	err = vkGetPipelineCacheData(device, pipeline_cache, &size, data.ptrw());
+	if (err != VK_SUCCESS) { //VK_INCOMPLETE included, a partial cache is not worth keeping
+		data.clear();
+		return data;
+	}
+	data.resize(size);
+	return data;
+}
+
+void RenderingDeviceVulkan::pipeline_cache_set_data(const Vector<uint8_t> &p_data) {
+	_THREAD_SAFE_METHOD_
+
+	//drivers should ignore data saved by another device or driver version, but not all of them check, so the header is validated here
+	VkPhysicalDeviceProperties props;
+	vkGetPhysicalDeviceProperties(context->get_physical_device(), &props);
+
+	const int header_size = 16 + VK_UUID_SIZE;
+	if (p_data.size() < header_size) {
+		return;
+	}
+	const uint8_t *r = p_data.ptr();
+	if (decode_uint32(&r[0]) < uint32_t(header_size) || decode_uint32(&r[4]) != VK_PIPELINE_CACHE_HEADER_VERSION_ONE || decode_uint32(&r[8]) != props.vendorID || decode_uint32(&r[12]) != props.deviceID || memcmp(&r[16], props.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+		return; //saved on another device or driver, start empty
+	}
+
+	_create_pipeline_cache(p_data);
+}
+
 RenderingDevice *RenderingDeviceVulkan::create_local_device() {
 	RenderingDeviceVulkan *rd = memnew(RenderingDeviceVulkan);
 	rd->initialize(context, true);
@@ -903,6 +903,9 @@ class RenderingDeviceVulkan : public RenderingDevice {
 
 	VmaAllocator allocator;
 
+	VkPipelineCache pipeline_cache = VK_NULL_HANDLE; //shared by all pipelines, persisted through pipeline_cache_get_data()
+	void _create_pipeline_cache(const Vector<uint8_t> &p_data);
+
 	VulkanContext *context;
 
 	void _free_internal(RID p_id);
@@ -1085,6 +1088,9 @@ public:
 
 	virtual uint64_t get_memory_usage() const;
 
+	virtual Vector<uint8_t> pipeline_cache_get_data();
+	virtual void pipeline_cache_set_data(const Vector<uint8_t> &p_data);
+
 	RenderingDeviceVulkan();
 	~RenderingDeviceVulkan();
 };
@@ -47,6 +47,7 @@
 #include "editor_node.h"
 #include "editor_settings.h"
 #include "scene/resources/resource_format_text.h"
+#include "servers/rendering/rasterizer_rd/shader_rd.h"
 
 static int _get_pad(int p_alignment, int p_n) {
 	int rest = p_n % p_alignment;
@@ -1889,3 +1890,32 @@ void EditorExportTextSceneToBinaryPlugin::_export_file(const String &p_path, con
 EditorExportTextSceneToBinaryPlugin::EditorExportTextSceneToBinaryPlugin() {
 	GLOBAL_DEF("editor/convert_text_resources_to_binary_on_export", false);
 }
+
+void EditorExportShaderCachePlugin::_export_begin(const Set<String> &p_features, bool p_debug, const String &p_path, int p_flags) {
+	bool include = GLOBAL_GET("rendering/shader_cache/include_in_export");
+	if (!include) {
+		return;
+	}
+
+	// The editor compiles the same shaders the exported project uses, so the
+	// files of its cache used in this session are shipped as a read-only
+	// precompiled cache. Other files are stale or belong to unused shaders.
+	String cache_dir = ShaderRD::shader_cache_get_dir();
+	if (cache_dir.empty()) {
+		return;
+	}
+
+	List<String> files;
+	ShaderRD::shader_cache_get_live_files(&files);
+	for (List<String>::Element *E = files.front(); E; E = E->next()) {
+		Error err;
+		Vector<uint8_t> data = FileAccess::get_file_as_array(cache_dir.plus_file(E->get()), &err);
+		if (err == OK && data.size()) {
+			add_file(String(ShaderRD::SHADER_CACHE_EXPORT_DIR).plus_file(E->get()), data, false);
+		}
+	}
+}
+
+EditorExportShaderCachePlugin::EditorExportShaderCachePlugin() {
+	GLOBAL_DEF("rendering/shader_cache/include_in_export", true);
+}
@@ -476,4 +476,12 @@ public:
 	EditorExportTextSceneToBinaryPlugin();
 };
 
+class EditorExportShaderCachePlugin : public EditorExportPlugin {
+	GDCLASS(EditorExportShaderCachePlugin, EditorExportPlugin);
+
+public:
+	virtual void _export_begin(const Set<String> &p_features, bool p_debug, const String &p_path, int p_flags) override;
+	EditorExportShaderCachePlugin();
+};
+
 #endif // EDITOR_IMPORT_EXPORT_H
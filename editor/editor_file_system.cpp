@@ -34,8 +34,10 @@
 #include "core/io/resource_importer.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
+#include "core/os/dir_watcher.h"
 #include "core/os/file_access.h"
 #include "core/os/os.h"
+#include "core/templates/thread_work_pool.h"
 #include "core/variant/variant_parser.h"
 #include "editor_node.h"
 #include "editor_resource_preview.h"
@@ -43,7 +45,7 @@
 
 EditorFileSystem *EditorFileSystem::singleton = nullptr;
 //the name is the version, to keep compatibility with different versions of Godot
-#define CACHE_FILE_NAME "filesystem_cache6"
+#define CACHE_FILE_NAME "filesystem_cache7"
 
 void EditorFileSystemDirectory::sort_files() {
 	files.sort_custom<FileInfoSort>();
@@ -229,7 +231,7 @@ void EditorFileSystem::_scan_filesystem() {
 
 			} else {
 				Vector<String> split = l.split("::");
-				ERR_CONTINUE(split.size() != 8);
+				ERR_CONTINUE(split.size() != 9);
 				String name = split[0];
 				String file;
 
@@ -255,6 +257,11 @@ void EditorFileSystem::_scan_filesystem() {
 					}
 				}
 
+				String dest_paths = split[8].strip_edges();
+				if (dest_paths.length()) {
+					fc.import_dest_paths = dest_paths.split("<>");
+				}
+
 				file_cache[name] = fc;
 			}
 		}
@@ -324,7 +331,7 @@ void EditorFileSystem::_thread_func(void *_userdata) {
 	sd->_scan_filesystem();
 }
 
-bool EditorFileSystem::_test_for_reimport(const String &p_path, bool p_only_imported_files) {
+bool EditorFileSystem::_test_for_reimport(const String &p_path, bool p_only_imported_files, Vector<String> *r_import_dest_paths) {
 	if (!reimport_on_missing_imported_files && p_only_imported_files) {
 		return false;
 	}
@@ -399,6 +406,12 @@ bool EditorFileSystem::_test_for_reimport(const String &p_path, bool p_only_impo
 
 	memdelete(f);
 
+	if (r_import_dest_paths) {
+		for (List<String>::Element *E = to_check.front(); E; E = E->next()) {
+			r_import_dest_paths->push_back(E->get());
+		}
+	}
+
 	// Read the md5's from a separate file (so the import parameters aren't dependent on the file version
 	String base_path = ResourceFormatImporter::get_singleton()->get_import_base_path(p_path);
 	FileAccess *md5s = FileAccess::open(base_path + ".md5", FileAccess::READ, &err);
@@ -468,6 +481,30 @@ bool EditorFileSystem::_test_for_reimport(const String &p_path, bool p_only_impo
 	return false; //nothing changed
 }
 
+// Same as _test_for_reimport(p_path, true) for a file whose .import did not change since r_import_dest_paths was cached.
+bool EditorFileSystem::_test_for_missing_imports(const String &p_path, Vector<String> &r_import_dest_paths) {
+	if (r_import_dest_paths.empty() || revalidate_import_files) {
+		r_import_dest_paths.clear();
+		return _test_for_reimport(p_path, true, &r_import_dest_paths);
+	}
+
+	if (!reimport_on_missing_imported_files) {
+		return false;
+	}
+
+	if (!FileAccess::exists(ResourceFormatImporter::get_singleton()->get_import_base_path(p_path) + ".md5")) {
+		return true;
+	}
+
+	for (int i = 0; i < r_import_dest_paths.size(); i++) {
+		if (!FileAccess::exists(r_import_dest_paths[i])) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 bool EditorFileSystem::_update_scan_actions() {
 	sources_changed.clear();
 
@@ -495,6 +532,7 @@ bool EditorFileSystem::_update_scan_actions() {
 				} else {
 					ia.dir->subdirs.insert(idx, ia.new_dir);
 				}
+				_watch_add_dir(ia.new_dir);
 
 				fs_changed = true;
 			} break;
@@ -544,6 +582,7 @@ bool EditorFileSystem::_update_scan_actions() {
 					//update modified times, to avoid reimport
 					ia.dir->files[idx]->modified_time = FileAccess::get_modified_time(full_path);
 					ia.dir->files[idx]->import_modified_time = FileAccess::get_modified_time(full_path + ".import");
+					ia.dir->files[idx]->import_dest_paths.clear(); // May be stale if the .import file changed.
 				}
 
 				fs_changed = true;
@@ -601,6 +640,7 @@ void EditorFileSystem::scan() {
 		filesystem = new_filesystem;
 		new_filesystem = nullptr;
 		_update_scan_actions();
+		_watch_start();
 		scanning = false;
 		emit_signal("filesystem_changed");
 		emit_signal("sources_changed", sources_changed.size() > 0);
@@ -736,9 +776,10 @@ void EditorFileSystem::_scan_new_dir(EditorFileSystemDirectory *p_dir, DirAccess
 				import_mt = FileAccess::get_modified_time(path + ".import");
 			}
 
-			if (fc && fc->modification_time == mt && fc->import_modification_time == import_mt && !_test_for_reimport(path, true)) {
+			if (fc && fc->modification_time == mt && fc->import_modification_time == import_mt && !_test_for_missing_imports(path, fc->import_dest_paths)) {
 				fi->type = fc->type;
 				fi->deps = fc->deps;
+				fi->import_dest_paths = fc->import_dest_paths;
 				fi->modified_time = fc->modification_time;
 				fi->import_modified_time = fc->import_modification_time;
 
@@ -805,12 +846,14 @@ void EditorFileSystem::_scan_new_dir(EditorFileSystemDirectory *p_dir, DirAccess
 }
 
 void EditorFileSystem::_scan_fs_changes(EditorFileSystemDirectory *p_dir, const ScanProgress &p_progress) {
-	uint64_t current_mtime = FileAccess::get_modified_time(p_dir->get_path());
-
 	bool updated_dir = false;
 	String cd = p_dir->get_path();
 
-	if (current_mtime != p_dir->modified_time || using_fat32_or_exfat) {
+	// When directories are watched, the ones without events since the last scan need no checks (subdirectories are still visited).
+	bool check_dir = !watcher || watch_scan_all || watch_changed_dirs.has(cd);
+	uint64_t current_mtime = check_dir ? FileAccess::get_modified_time(cd) : p_dir->modified_time;
+
+	if (check_dir && (current_mtime != p_dir->modified_time || using_fat32_or_exfat)) {
 		updated_dir = true;
 		p_dir->modified_time = current_mtime;
 		//ooooops, dir changed, see what's going on
@@ -923,58 +966,60 @@ void EditorFileSystem::_scan_fs_changes(EditorFileSystemDirectory *p_dir, const
 		memdelete(da);
 	}
 
-	for (int i = 0; i < p_dir->files.size(); i++) {
-		if (updated_dir && !p_dir->files[i]->verified) {
-			//this file was removed, add action to remove it
-			ItemAction ia;
-			ia.action = ItemAction::ACTION_FILE_REMOVE;
-			ia.dir = p_dir;
-			ia.file = p_dir->files[i]->file;
-			scan_actions.push_back(ia);
-			continue;
-		}
+	if (check_dir) {
+		for (int i = 0; i < p_dir->files.size(); i++) {
+			if (updated_dir && !p_dir->files[i]->verified) {
+				//this file was removed, add action to remove it
+				ItemAction ia;
+				ia.action = ItemAction::ACTION_FILE_REMOVE;
+				ia.dir = p_dir;
+				ia.file = p_dir->files[i]->file;
+				scan_actions.push_back(ia);
+				continue;
+			}
 
-		String path = cd.plus_file(p_dir->files[i]->file);
+			String path = cd.plus_file(p_dir->files[i]->file);
 
-		if (import_extensions.has(p_dir->files[i]->file.get_extension().to_lower())) {
-			//check here if file must be imported or not
+			if (import_extensions.has(p_dir->files[i]->file.get_extension().to_lower())) {
+				//check here if file must be imported or not
 
-			uint64_t mt = FileAccess::get_modified_time(path);
+				uint64_t mt = FileAccess::get_modified_time(path);
 
-			bool reimport = false;
+				bool reimport = false;
 
-			if (mt != p_dir->files[i]->modified_time) {
-				reimport = true; //it was modified, must be reimported.
-			} else if (!FileAccess::exists(path + ".import")) {
-				reimport = true; //no .import file, obviously reimport
-			} else {
-				uint64_t import_mt = FileAccess::get_modified_time(path + ".import");
-				if (import_mt != p_dir->files[i]->import_modified_time) {
-					reimport = true;
-				} else if (_test_for_reimport(path, true)) {
-					reimport = true;
+				if (mt != p_dir->files[i]->modified_time) {
+					reimport = true; //it was modified, must be reimported.
+				} else if (!FileAccess::exists(path + ".import")) {
+					reimport = true; //no .import file, obviously reimport
+				} else {
+					uint64_t import_mt = FileAccess::get_modified_time(path + ".import");
+					if (import_mt != p_dir->files[i]->import_modified_time) {
+						reimport = true;
+					} else if (_test_for_missing_imports(path, p_dir->files[i]->import_dest_paths)) {
+						reimport = true;
+					}
 				}
-			}
 
-			if (reimport) {
-				ItemAction ia;
-				ia.action = ItemAction::ACTION_FILE_TEST_REIMPORT;
-				ia.dir = p_dir;
-				ia.file = p_dir->files[i]->file;
-				scan_actions.push_back(ia);
-			}
-		} else if (ResourceCache::has(path)) { //test for potential reload
+				if (reimport) {
+					ItemAction ia;
+					ia.action = ItemAction::ACTION_FILE_TEST_REIMPORT;
+					ia.dir = p_dir;
+					ia.file = p_dir->files[i]->file;
+					scan_actions.push_back(ia);
+				}
+			} else if (ResourceCache::has(path)) { //test for potential reload
 
-			uint64_t mt = FileAccess::get_modified_time(path);
+				uint64_t mt = FileAccess::get_modified_time(path);
 
-			if (mt != p_dir->files[i]->modified_time) {
-				p_dir->files[i]->modified_time = mt; //save new time, but test for reload
+				if (mt != p_dir->files[i]->modified_time) {
+					p_dir->files[i]->modified_time = mt; //save new time, but test for reload
 
-				ItemAction ia;
-				ia.action = ItemAction::ACTION_FILE_RELOAD;
-				ia.dir = p_dir;
-				ia.file = p_dir->files[i]->file;
-				scan_actions.push_back(ia);
+					ItemAction ia;
+					ia.action = ItemAction::ACTION_FILE_RELOAD;
+					ia.dir = p_dir;
+					ia.file = p_dir->files[i]->file;
+					scan_actions.push_back(ia);
+				}
 			}
 		}
 	}
@@ -1031,6 +1076,7 @@ void EditorFileSystem::scan_changes() {
 	}
 
 	_update_extensions();
+	_watch_poll();
 	sources_changed.clear();
 	scanning_changes = true;
 	scanning_changes_done = false;
@@ -1046,6 +1092,8 @@ void EditorFileSystem::scan_changes() {
 			sp.low = 0;
 			scan_total = 0;
 			_scan_fs_changes(filesystem, sp);
+			watch_changed_dirs.clear();
+			watch_scan_all = false;
 			if (_update_scan_actions()) {
 				emit_signal("filesystem_changed");
 			}
@@ -1085,6 +1133,8 @@ void EditorFileSystem::_notification(int p_what) {
 				set_process(false);
 			}
 
+			_watch_stop();
+
 			if (filesystem) {
 				memdelete(filesystem);
 			}
@@ -1106,6 +1156,8 @@ void EditorFileSystem::_notification(int p_what) {
 						Thread::wait_to_finish(thread_sources);
 						memdelete(thread_sources);
 						thread_sources = nullptr;
+						watch_changed_dirs.clear();
+						watch_scan_all = false;
 						if (_update_scan_actions()) {
 							emit_signal("filesystem_changed");
 						}
@@ -1125,6 +1177,7 @@ void EditorFileSystem::_notification(int p_what) {
 					memdelete(thread);
 					thread = nullptr;
 					_update_scan_actions();
+					_watch_start();
 					emit_signal("filesystem_changed");
 					emit_signal("sources_changed", sources_changed.size() > 0);
 					_queue_update_script_classes();
@@ -1170,6 +1223,13 @@ void EditorFileSystem::_save_filesystem_cache(EditorFileSystemDirectory *p_dir,
 			}
 			s += p_dir->files[i]->deps[j];
 		}
+		s += "::";
+		for (int j = 0; j < p_dir->files[i]->import_dest_paths.size(); j++) {
+			if (j > 0) {
+				s += "<>";
+			}
+			s += p_dir->files[i]->import_dest_paths[j];
+		}
 
 		p_file->store_line(s);
 	}
@@ -1654,12 +1714,7 @@ Error EditorFileSystem::_reimport_group(const String &p_group_file, const Vector
 	return err;
 }
 
-void EditorFileSystem::_reimport_file(const String &p_file) {
-	EditorFileSystemDirectory *fs = nullptr;
-	int cpos = -1;
-	bool found = _find_file(p_file, &fs, cpos);
-	ERR_FAIL_COND_MSG(!found, "Can't find file '" + p_file + "'.");
-
+bool EditorFileSystem::_import_file(const String &p_file, ImportResult &r_result) {
 	//try to obtain existing params
 
 	Map<StringName, Variant> params;
@@ -1684,7 +1739,7 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 		}
 
 	} else {
-		late_added_files.insert(p_file); //imported files do not call update_file(), but just in case..
+		r_result.late_added = true; //imported files do not call update_file(), but just in case..
 	}
 
 	Ref<ResourceImporter> importer;
@@ -1700,7 +1755,7 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 		load_default = true;
 		if (importer.is_null()) {
 			ERR_PRINT("BUG: File queued for import, but can't be imported!");
-			ERR_FAIL();
+			return false;
 		}
 	}
 
@@ -1740,7 +1795,7 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 	//as import is complete, save the .import file
 
 	FileAccess *f = FileAccess::open(p_file + ".import", FileAccess::WRITE);
-	ERR_FAIL_COND_MSG(!f, "Cannot open file from path '" + p_file + ".import'.");
+	ERR_FAIL_COND_V_MSG(!f, false, "Cannot open file from path '" + p_file + ".import'.");
 
 	//write manually, as order matters ([remap] has to go first for performance).
 	f->store_line("[remap]");
@@ -1821,7 +1876,7 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 
 	// Store the md5's of the various files. These are stored separately so that the .import files can be version controlled.
 	FileAccess *md5s = FileAccess::open(base_path + ".md5", FileAccess::WRITE);
-	ERR_FAIL_COND_MSG(!md5s, "Cannot open MD5 file '" + base_path + ".md5'.");
+	ERR_FAIL_COND_V_MSG(!md5s, false, "Cannot open MD5 file '" + base_path + ".md5'.");
 
 	md5s->store_line("source_md5=\"" + FileAccess::get_md5(p_file) + "\"");
 	if (dest_paths.size()) {
@@ -1830,11 +1885,31 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 	md5s->close();
 	memdelete(md5s);
 
+	r_result.type = importer->get_resource_type();
+	r_result.dest_paths = dest_paths;
+	return true;
+}
+
+void EditorFileSystem::_apply_import_result(const String &p_file, const ImportResult &p_result) {
+	if (p_result.late_added) {
+		late_added_files.insert(p_file);
+	}
+
+	if (!p_result.imported) {
+		return;
+	}
+
+	EditorFileSystemDirectory *fs = nullptr;
+	int cpos = -1;
+	bool found = _find_file(p_file, &fs, cpos);
+	ERR_FAIL_COND_MSG(!found, "Can't find file '" + p_file + "'.");
+
 	//update modified times, to avoid reimport
 	fs->files[cpos]->modified_time = FileAccess::get_modified_time(p_file);
 	fs->files[cpos]->import_modified_time = FileAccess::get_modified_time(p_file + ".import");
 	fs->files[cpos]->deps = _get_dependencies(p_file);
-	fs->files[cpos]->type = importer->get_resource_type();
+	fs->files[cpos]->import_dest_paths = p_result.dest_paths;
+	fs->files[cpos]->type = p_result.type;
 	fs->files[cpos]->import_valid = ResourceLoader::is_import_valid(p_file);
 
 	//if file is currently up, maybe the source it was loaded from changed, so import math must be updated for it
@@ -1852,6 +1927,17 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 	EditorResourcePreview::get_singleton()->check_for_invalidation(p_file);
 }
 
+void EditorFileSystem::_reimport_file(const String &p_file) {
+	EditorFileSystemDirectory *fs = nullptr;
+	int cpos = -1;
+	bool found = _find_file(p_file, &fs, cpos);
+	ERR_FAIL_COND_MSG(!found, "Can't find file '" + p_file + "'.");
+
+	ImportResult result;
+	result.imported = _import_file(p_file, result);
+	_apply_import_result(p_file, result);
+}
+
 void EditorFileSystem::_find_group_files(EditorFileSystemDirectory *efd, Map<String, Vector<String>> &group_files, Set<String> &groups_to_reimport) {
 	int fc = efd->files.size();
 	const EditorFileSystemDirectory::FileInfo *const *files = efd->files.ptr();
@@ -1869,6 +1955,12 @@ void EditorFileSystem::_find_group_files(EditorFileSystemDirectory *efd, Map<Str
 	}
 }
 
+void EditorFileSystem::_reimport_thread(uint32_t p_index, ImportThreadData *p_import_data) {
+	// Only imports, the results are applied to the file system on the main thread.
+	ImportResult &result = p_import_data->results[p_index];
+	result.imported = _import_file(p_import_data->reimport_files[p_index].path, result);
+}
+
 void EditorFileSystem::reimport_files(const Vector<String> &p_files) {
 	{
 		// Ensure that ProjectSettings::IMPORTED_FILES_PATH exists.
@@ -1904,7 +1996,12 @@ void EditorFileSystem::reimport_files(const Vector<String> &p_files) {
 			//it's a regular file
 			ImportFile ifile;
 			ifile.path = p_files[i];
-			ifile.order = ResourceFormatImporter::get_singleton()->get_import_order(p_files[i]);
+			Ref<ResourceImporter> importer = ResourceFormatImporter::get_singleton()->get_importer_for_file(p_files[i]);
+			if (importer.is_valid()) {
+				ifile.importer = importer->get_importer_name();
+				ifile.order = importer->get_import_order();
+				ifile.threaded = importer->can_import_threaded();
+			}
 			files.push_back(ifile);
 		}
 
@@ -1918,9 +2015,38 @@ void EditorFileSystem::reimport_files(const Vector<String> &p_files) {
 
 	files.sort();
 
+	int from = 0;
 	for (int i = 0; i < files.size(); i++) {
-		pr.step(files[i].path.get_file(), i);
-		_reimport_file(files[i].path);
+		if (i + 1 < files.size() && files[i + 1].order == files[i].order && files[i + 1].importer == files[i].importer) {
+			continue;
+		}
+
+		// Files from..i share the same importer.
+		int count = i - from + 1;
+
+		if (files[from].threaded && count > 1 && OS::get_singleton()->can_use_threads()) {
+			// The main loop must not iterate while the workers run, so progress is only shown before.
+			pr.step(files[from].path.get_file(), from);
+
+			Vector<ImportResult> results;
+			results.resize(count);
+
+			ImportThreadData data;
+			data.reimport_files = files.ptr() + from;
+			data.results = results.ptrw();
+			ThreadWorkPool::do_shared_work(count, this, &EditorFileSystem::_reimport_thread, &data, 2);
+
+			for (int j = 0; j < count; j++) {
+				_apply_import_result(files[from + j].path, results[j]);
+			}
+		} else {
+			for (int j = from; j <= i; j++) {
+				pr.step(files[j].path.get_file(), j);
+				_reimport_file(files[j].path);
+			}
+		}
+
+		from = i + 1;
 	}
 
 	//reimport groups
@@ -2041,6 +2167,78 @@ void EditorFileSystem::_update_extensions() {
 	}
 }
 
+void EditorFileSystem::_watch_start() {
+	_watch_stop();
+
+	watcher = DirWatcher::create();
+	if (!watcher) {
+		return; // Not fatal, changes scans just check every directory.
+	}
+
+	// Removing imported files must trigger a full check, as they are tested for when deciding whether to reimport.
+	watch_imported_dir = watcher->add_watch(ProjectSettings::get_singleton()->globalize_path(ProjectSettings::IMPORTED_FILES_PATH), true);
+
+	_watch_add_dir(filesystem);
+	watch_scan_all = true; // Changes done before the watches were added would be missed otherwise.
+}
+
+void EditorFileSystem::_watch_stop() {
+	if (watcher) {
+		memdelete(watcher);
+		watcher = nullptr;
+	}
+	watch_imported_dir = -1;
+	watch_dirs.clear();
+	watch_changed_dirs.clear();
+	watch_scan_all = true;
+}
+
+void EditorFileSystem::_watch_add_dir(EditorFileSystemDirectory *p_dir) {
+	if (!watcher || !p_dir) {
+		return;
+	}
+
+	String path = p_dir->get_path();
+	int wd = watcher->add_watch(ProjectSettings::get_singleton()->globalize_path(path));
+	if (wd < 0) {
+		// Most likely out of watches, fall back to checking every directory on changes scans.
+		WARN_PRINT("Unable to watch directory '" + path + "' for changes, filesystem scans will be slower.");
+		_watch_stop();
+		return;
+	}
+	watch_dirs[wd] = path;
+
+	for (int i = 0; i < p_dir->get_subdir_count(); i++) {
+		_watch_add_dir(p_dir->get_subdir(i));
+	}
+}
+
+void EditorFileSystem::_watch_poll() {
+	if (!watcher) {
+		return;
+	}
+
+	LocalVector<DirWatcher::Event> events;
+	watcher->poll(events);
+
+	for (uint32_t i = 0; i < events.size(); i++) {
+		const DirWatcher::Event &event = events[i];
+		if (event.watch < 0 || event.watch == watch_imported_dir) {
+			watch_scan_all = true;
+			continue;
+		}
+
+		const String *path = watch_dirs.getptr(event.watch);
+		if (!path) {
+			continue;
+		}
+		watch_changed_dirs.insert(*path);
+		if (event.watch_removed) {
+			watch_dirs.erase(event.watch);
+		}
+	}
+}
+
 EditorFileSystem::EditorFileSystem() {
 	ResourceLoader::import = _resource_import;
 	reimport_on_missing_imported_files = GLOBAL_DEF("editor/reimport_missing_imported_files", true);
@@ -2073,7 +2271,12 @@ EditorFileSystem::EditorFileSystem() {
 	first_scan = true;
 	scan_changes_pending = false;
 	revalidate_import_files = false;
+
+	watcher = nullptr;
+	watch_imported_dir = -1;
+	watch_scan_all = true;
 }
 
 EditorFileSystem::~EditorFileSystem() {
+	_watch_stop();
 }
@@ -36,6 +36,7 @@
 #include "core/os/thread_safe.h"
 #include "core/templates/set.h"
 #include "scene/main/node.h"
+class DirWatcher;
 class FileAccess;
 
 struct EditorProgressBG;
@@ -57,6 +58,7 @@ class EditorFileSystemDirectory : public Object {
 		bool import_valid;
 		String import_group_file;
 		Vector<String> deps;
+		Vector<String> import_dest_paths; // Files generated by the import, so they can be checked without parsing the .import file.
 		bool verified; //used for checking changes
 		String script_class_name;
 		String script_class_extends;
@@ -165,6 +167,7 @@ class EditorFileSystem : public Node {
 		uint64_t modification_time;
 		uint64_t import_modification_time;
 		Vector<String> deps;
+		Vector<String> import_dest_paths;
 		bool import_valid;
 		String import_group_file;
 		String script_class_name;
@@ -174,6 +177,18 @@ class EditorFileSystem : public Node {
 
 	HashMap<String, FileCache> file_cache;
 
+	/* Platform directory watcher (if supported), so changes scans only visit the directories that changed */
+	DirWatcher *watcher;
+	HashMap<int, String> watch_dirs; // Watch descriptor to directory path.
+	int watch_imported_dir;
+	Set<String> watch_changed_dirs;
+	bool watch_scan_all; // Events may have been lost, so the next changes scan checks every directory.
+
+	void _watch_start();
+	void _watch_stop();
+	void _watch_add_dir(EditorFileSystemDirectory *p_dir);
+	void _watch_poll();
+
 	struct ScanProgress {
 		float low;
 		float hi;
@@ -209,10 +224,20 @@ class EditorFileSystem : public Node {
 
 	void _update_extensions();
 
+	struct ImportResult {
+		String type;
+		Vector<String> dest_paths;
+		bool late_added = false;
+		bool imported = false;
+	};
+
+	bool _import_file(const String &p_file, ImportResult &r_result);
+	void _apply_import_result(const String &p_file, const ImportResult &p_result);
 	void _reimport_file(const String &p_file);
 	Error _reimport_group(const String &p_group_file, const Vector<String> &p_files);
 
-	bool _test_for_reimport(const String &p_path, bool p_only_imported_files);
+	bool _test_for_reimport(const String &p_path, bool p_only_imported_files, Vector<String> *r_import_dest_paths = nullptr);
+	bool _test_for_missing_imports(const String &p_path, Vector<String> &r_import_dest_paths);
 
 	bool reimport_on_missing_imported_files;
 
@@ -220,12 +245,22 @@ class EditorFileSystem : public Node {
 
 	struct ImportFile {
 		String path;
-		int order;
+		String importer;
+		int order = 0;
+		bool threaded = false;
 		bool operator<(const ImportFile &p_if) const {
-			return order < p_if.order;
+			// Keeps the files of each importer together, so they can be imported in parallel.
+			return order == p_if.order ? importer < p_if.importer : order < p_if.order;
 		}
 	};
 
+	struct ImportThreadData {
+		const ImportFile *reimport_files = nullptr;
+		ImportResult *results = nullptr;
+	};
+
+	void _reimport_thread(uint32_t p_index, ImportThreadData *p_import_data);
+
 	void _scan_script_classes(EditorFileSystemDirectory *p_dir);
 	volatile bool update_script_classes_queued;
 	void _queue_update_script_classes();
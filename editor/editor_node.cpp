@@ -43,6 +43,7 @@
 #include "core/os/file_access.h"
 #include "core/os/keyboard.h"
 #include "core/os/os.h"
+#include "core/os/thread.h"
 #include "core/string/print_string.h"
 #include "core/string/translation.h"
 #include "core/version.h"
@@ -495,6 +496,7 @@ void EditorNode::_notification(int p_what) {
 				RS::get_singleton()->directional_shadow_quality_set(directional_shadow_quality);
 				float probe_update_speed = GLOBAL_GET("rendering/lightmapper/probe_capture_update_speed");
 				RS::get_singleton()->lightmap_set_probe_capture_update_speed(probe_update_speed);
+				RS::get_singleton()->mesh_lod_set_threshold_pixels(GLOBAL_GET("rendering/quality/mesh_lod/threshold_pixels"));
 				RS::EnvironmentSDFGIFramesToConverge frames_to_converge = RS::EnvironmentSDFGIFramesToConverge(int(GLOBAL_GET("rendering/sdfgi/frames_to_converge")));
 				RS::get_singleton()->environment_set_sdfgi_frames_to_converge(frames_to_converge);
 				RS::EnvironmentSDFGIRayCount ray_count = RS::EnvironmentSDFGIRayCount(int(GLOBAL_GET("rendering/sdfgi/probe_ray_count")));
@@ -3571,9 +3573,18 @@ void EditorNode::notify_all_debug_sessions_exited() {
 }
 
 void EditorNode::add_io_error(const String &p_error) {
+	if (Thread::get_caller_id() != Thread::get_main_id()) {
+		// Reported by an importer running on a worker thread.
+		MessageQueue::get_singleton()->push_callable(callable_mp(singleton, &EditorNode::_add_io_error_deferred), p_error);
+		return;
+	}
 	_load_error_notify(singleton, p_error);
 }
 
+void EditorNode::_add_io_error_deferred(const String &p_error) {
+	_load_error_notify(this, p_error);
+}
+
 void EditorNode::_load_error_notify(void *p_ud, const String &p_text) {
 	EditorNode *en = (EditorNode *)p_ud;
 	en->load_errors->add_image(en->gui_base->get_theme_icon("Error", "EditorIcons"));
@@ -5348,6 +5359,12 @@ void EditorNode::_video_driver_selected(int p_which) {
 }
 
 void EditorNode::_resource_saved(RES p_resource, const String &p_path) {
+	if (Thread::get_caller_id() != Thread::get_main_id()) {
+		// Saved by an importer running on a worker thread, the file system can only be updated from the main thread.
+		MessageQueue::get_singleton()->push_callable(callable_mp(singleton, &EditorNode::_resource_saved_deferred), p_resource, p_path);
+		return;
+	}
+
 	if (EditorFileSystem::get_singleton()) {
 		EditorFileSystem::get_singleton()->update_file(p_path);
 	}
@@ -5355,6 +5372,10 @@ void EditorNode::_resource_saved(RES p_resource, const String &p_path) {
 	singleton->editor_folding.save_resource_folding(p_resource, p_path);
 }
 
+void EditorNode::_resource_saved_deferred(RES p_resource, const String &p_path) {
+	_resource_saved(p_resource, p_path);
+}
+
 void EditorNode::_resource_loaded(RES p_resource, const String &p_path) {
 	singleton->editor_folding.load_resource_folding(p_resource, p_path);
 }
@@ -6713,6 +6734,11 @@ EditorNode::EditorNode() {
 
 	EditorExport::get_singleton()->add_export_plugin(export_text_to_binary_plugin);
 
+	Ref<EditorExportShaderCachePlugin> export_shader_cache_plugin;
+	export_shader_cache_plugin.instance();
+
+	EditorExport::get_singleton()->add_export_plugin(export_shader_cache_plugin);
+
 	Ref<PackedSceneEditorTranslationParserPlugin> packed_scene_translation_parser_plugin;
 	packed_scene_translation_parser_plugin.instance();
 	EditorTranslationParser::get_singleton()->add_parser(packed_scene_translation_parser_plugin, EditorTranslationParser::STANDARD);
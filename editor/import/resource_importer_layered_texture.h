@@ -102,6 +102,7 @@ public:
 	virtual void get_recognized_extensions(List<String> *p_extensions) const override;
 	virtual String get_save_extension() const override;
 	virtual String get_resource_type() const override;
+	virtual bool can_import_threaded() const override { return true; }
 
 	enum CompressMode {
 		COMPRESS_LOSSLESS,
@@ -31,6 +31,7 @@
 #include "resource_importer_scene.h"
 
 #include "core/io/resource_saver.h"
+#include "core/templates/thread_work_pool.h"
 #include "editor/editor_node.h"
 #include "scene/3d/collision_shape_3d.h"
 #include "scene/3d/mesh_instance_3d.h"
@@ -279,12 +280,32 @@ static String _fixstr(const String &p_what, const String &p_str) {
 	return what;
 }
 
-static void _gen_shape_list(const Ref<Mesh> &mesh, List<Ref<Shape3D>> &r_shape_list, bool p_convex) {
+// Whether _fix_node() generates convex shapes for the mesh of a MeshInstance3D, following the order of its suffix checks.
+static bool _uses_convex_collision(const String &p_name, const Ref<Mesh> &p_mesh) {
+	if (_teststr(p_name, "colonly") || _teststr(p_name, "convcolonly")) {
+		return !_teststr(p_name, "colonly");
+	}
+	if (_teststr(p_name, "rigid")) {
+		return true;
+	}
+	if (_teststr(p_name, "col") || _teststr(p_name, "convcol")) {
+		return !_teststr(p_name, "col");
+	}
+	if (_teststr(p_name, "navmesh") || _teststr(p_name, "vehicle") || _teststr(p_name, "wheel")) {
+		return false;
+	}
+
+	//collision inside the mesh data
+	Ref<ArrayMesh> array_mesh = p_mesh;
+	return array_mesh.is_valid() && !_teststr(array_mesh->get_name(), "col") && _teststr(array_mesh->get_name(), "convcol");
+}
+
+static void _gen_shape_list(const Ref<Mesh> &mesh, List<Ref<Shape3D>> &r_shape_list, bool p_convex, const Mesh::ConvexDecompositionSettings &p_convex_settings) {
 	if (!p_convex) {
 		Ref<Shape3D> shape = mesh->create_trimesh_shape();
 		r_shape_list.push_back(shape);
 	} else {
-		Vector<Ref<Shape3D>> cd = mesh->convex_decompose();
+		Vector<Ref<Shape3D>> cd = mesh->convex_decompose(p_convex_settings);
 		if (cd.size()) {
 			for (int i = 0; i < cd.size(); i++) {
 				r_shape_list.push_back(cd[i]);
@@ -293,10 +314,51 @@ static void _gen_shape_list(const Ref<Mesh> &mesh, List<Ref<Shape3D>> &r_shape_l
 	}
 }
 
-Node *ResourceImporterScene::_fix_node(Node *p_node, Node *p_root, Map<Ref<Mesh>, List<Ref<Shape3D>>> &collision_map, LightBakeMode p_light_bake_mode) {
+void ResourceImporterScene::_find_convex_meshes(Node *p_node, Set<Ref<Mesh>> &r_meshes) {
+	for (int i = 0; i < p_node->get_child_count(); i++) {
+		_find_convex_meshes(p_node->get_child(i), r_meshes);
+	}
+
+	MeshInstance3D *mi = Object::cast_to<MeshInstance3D>(p_node);
+	if (!mi || mi->get_mesh().is_null()) {
+		return;
+	}
+
+	if (_uses_convex_collision(p_node->get_name(), mi->get_mesh())) {
+		r_meshes.insert(mi->get_mesh());
+	}
+}
+
+void ResourceImporterScene::_convex_decompose_job(uint32_t p_index, ConvexDecompositionJobs *p_jobs) {
+	Mesh::convex_composition_function(p_jobs->faces[p_index], p_jobs->settings);
+}
+
+void ResourceImporterScene::_convex_decompose_meshes(Node *p_scene, const Mesh::ConvexDecompositionSettings &p_settings) {
+	if (!Mesh::convex_composition_function) {
+		return;
+	}
+
+	Set<Ref<Mesh>> meshes;
+	_find_convex_meshes(p_scene, meshes);
+	if (meshes.size() < 2 || !OS::get_singleton()->can_use_threads()) {
+		return; // Decomposed one by one in _fix_node().
+	}
+
+	// Faces are read here, as meshes may need the rendering server to provide them.
+	ConvexDecompositionJobs jobs;
+	jobs.settings = p_settings;
+	for (Set<Ref<Mesh>>::Element *E = meshes.front(); E; E = E->next()) {
+		jobs.faces.push_back(E->get()->get_faces());
+	}
+
+	// The results are cached by the decomposition function, so _fix_node() gets them back without recomputing.
+	ThreadWorkPool::do_shared_work(jobs.faces.size(), this, &ResourceImporterScene::_convex_decompose_job, &jobs, 2);
+}
+
+Node *ResourceImporterScene::_fix_node(Node *p_node, Node *p_root, Map<Ref<Mesh>, List<Ref<Shape3D>>> &collision_map, LightBakeMode p_light_bake_mode, const Mesh::ConvexDecompositionSettings &p_convex_settings) {
 	// children first
 	for (int i = 0; i < p_node->get_child_count(); i++) {
-		Node *r = _fix_node(p_node->get_child(i), p_root, collision_map, p_light_bake_mode);
+		Node *r = _fix_node(p_node->get_child(i), p_root, collision_map, p_light_bake_mode, p_convex_settings);
 		if (!r) {
 			i--; //was erased
 		}
@@ -377,11 +439,8 @@ Node *ResourceImporterScene::_fix_node(Node *p_node, Node *p_root, Map<Ref<Mesh>
 				String fixed_name;
 				if (collision_map.has(mesh)) {
 					shapes = collision_map[mesh];
-				} else if (_teststr(name, "colonly")) {
-					_gen_shape_list(mesh, shapes, false);
-					collision_map[mesh] = shapes;
-				} else if (_teststr(name, "convcolonly")) {
-					_gen_shape_list(mesh, shapes, true);
+				} else {
+					_gen_shape_list(mesh, shapes, _uses_convex_collision(name, mesh), p_convex_settings);
 					collision_map[mesh] = shapes;
 				}
 
@@ -461,7 +520,7 @@ Node *ResourceImporterScene::_fix_node(Node *p_node, Node *p_root, Map<Ref<Mesh>
 			if (collision_map.has(mesh)) {
 				shapes = collision_map[mesh];
 			} else {
-				_gen_shape_list(mesh, shapes, true);
+				_gen_shape_list(mesh, shapes, true, p_convex_settings);
 			}
 
 			RigidBody3D *rigid_body = memnew(RigidBody3D);
@@ -496,11 +555,8 @@ Node *ResourceImporterScene::_fix_node(Node *p_node, Node *p_root, Map<Ref<Mesh>
 			String fixed_name;
 			if (collision_map.has(mesh)) {
 				shapes = collision_map[mesh];
-			} else if (_teststr(name, "col")) {
-				_gen_shape_list(mesh, shapes, false);
-				collision_map[mesh] = shapes;
-			} else if (_teststr(name, "convcol")) {
-				_gen_shape_list(mesh, shapes, true);
+			} else {
+				_gen_shape_list(mesh, shapes, _uses_convex_collision(name, mesh), p_convex_settings);
 				collision_map[mesh] = shapes;
 			}
 
@@ -605,14 +661,10 @@ Node *ResourceImporterScene::_fix_node(Node *p_node, Node *p_root, Map<Ref<Mesh>
 			List<Ref<Shape3D>> shapes;
 			if (collision_map.has(mesh)) {
 				shapes = collision_map[mesh];
-			} else if (_teststr(mesh->get_name(), "col")) {
-				_gen_shape_list(mesh, shapes, false);
-				collision_map[mesh] = shapes;
-				mesh->set_name(_fixstr(mesh->get_name(), "col"));
-			} else if (_teststr(mesh->get_name(), "convcol")) {
-				_gen_shape_list(mesh, shapes, true);
+			} else if (_teststr(mesh->get_name(), "col") || _teststr(mesh->get_name(), "convcol")) {
+				_gen_shape_list(mesh, shapes, _uses_convex_collision(name, mesh), p_convex_settings);
 				collision_map[mesh] = shapes;
-				mesh->set_name(_fixstr(mesh->get_name(), "convcol"));
+				mesh->set_name(_fixstr(mesh->get_name(), _teststr(mesh->get_name(), "col") ? "col" : "convcol"));
 			}
 
 			if (shapes.size()) {
@@ -1122,9 +1174,13 @@ void ResourceImporterScene::get_import_options(List<ImportOption> *r_options, in
 	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "materials/keep_on_reimport"), materials_out));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "meshes/compress"), true));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "meshes/ensure_tangents"), true));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "meshes/optimize"), true));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "meshes/generate_lods"), false));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "meshes/storage", PROPERTY_HINT_ENUM, "Built-In,Files (.mesh),Files (.tres)"), meshes_out ? 1 : 0));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "meshes/light_baking", PROPERTY_HINT_ENUM, "Disabled,Enable,Gen Lightmaps", PROPERTY_USAGE_DEFAULT | PROPERTY_USAGE_UPDATE_ALL_IF_MODIFIED), 0));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::FLOAT, "meshes/lightmap_texel_size", PROPERTY_HINT_RANGE, "0.001,100,0.001"), 0.1));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "meshes/convex_decomposition_resolution", PROPERTY_HINT_RANGE, "10000,64000000,1000"), 100000));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "meshes/convex_decomposition_max_hulls", PROPERTY_HINT_RANGE, "1,1024,1"), 1024));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "skins/use_named_skins"), true));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "external_files/store_in_subdir"), false));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "animation/import", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_DEFAULT | PROPERTY_USAGE_UPDATE_ALL_IF_MODIFIED), true));
@@ -1321,9 +1377,14 @@ Error ResourceImporterScene::import(const String &p_source_file, const String &p
 	float anim_optimizer_maxang = p_options["animation/optimizer/max_angle"];
 	int light_bake_mode = p_options["meshes/light_baking"];
 
+	Mesh::ConvexDecompositionSettings convex_settings;
+	convex_settings.resolution = p_options["meshes/convex_decomposition_resolution"];
+	convex_settings.max_convex_hulls = p_options["meshes/convex_decomposition_max_hulls"];
+	_convex_decompose_meshes(scene, convex_settings);
+
 	Map<Ref<Mesh>, List<Ref<Shape3D>>> collision_map;
 
-	scene = _fix_node(scene, scene, collision_map, LightBakeMode(light_bake_mode));
+	scene = _fix_node(scene, scene, collision_map, LightBakeMode(light_bake_mode), convex_settings);
 
 	if (use_optimizer) {
 		_optimize_animations(scene, anim_optimizer_linerr, anim_optimizer_angerr, anim_optimizer_maxang);
@@ -1375,7 +1436,7 @@ Error ResourceImporterScene::import(const String &p_source_file, const String &p
 		}
 	}
 
-	if (light_bake_mode == 2 /* || generate LOD */) {
+	if (light_bake_mode == 2) {
 		Map<Ref<ArrayMesh>, Transform> meshes;
 		_find_meshes(scene, meshes);
 
@@ -1485,6 +1546,42 @@ Error ResourceImporterScene::import(const String &p_source_file, const String &p
 		}
 	}
 
+	if (bool(p_options["meshes/optimize"])) {
+		// After unwrapping too, which indexes vertices in the order they come out.
+		Map<Ref<ArrayMesh>, Transform> meshes;
+		_find_meshes(scene, meshes);
+
+		for (Map<Ref<ArrayMesh>, Transform>::Element *E = meshes.front(); E; E = E->next()) {
+			Ref<ArrayMesh> mesh = E->key();
+			if (mesh->optimize_surfaces() != OK) {
+				EditorNode::add_io_error("Mesh '" + mesh->get_name() + "' failed optimization.");
+			}
+		}
+	}
+
+	if (bool(p_options["meshes/generate_lods"])) {
+		// After unwrapping, which rebuilds the surfaces without LODs.
+		Map<Ref<ArrayMesh>, Transform> meshes;
+		_find_meshes(scene, meshes);
+
+		EditorProgress progress2("gen_lods", TTR("Generating LODs"), meshes.size());
+		int step = 0;
+		for (Map<Ref<ArrayMesh>, Transform>::Element *E = meshes.front(); E; E = E->next()) {
+			Ref<ArrayMesh> mesh = E->key();
+			String name = mesh->get_name();
+			if (name == "") {
+				name = "Mesh " + itos(step);
+			}
+
+			progress2.step(TTR("Generating for Mesh: ") + name + " (" + itos(step) + "/" + itos(meshes.size()) + ")", step);
+
+			if (mesh->generate_lods() != OK) {
+				EditorNode::add_io_error("Mesh '" + name + "' failed LOD generation.");
+			}
+			step++;
+		}
+	}
+
 	if (external_animations || external_materials || external_meshes) {
 		Map<Ref<Animation>, Ref<Animation>> anim_map;
 		Map<Ref<Material>, Ref<Material>> mat_map;
@@ -118,7 +118,15 @@ class ResourceImporterScene : public ResourceImporter {
 		LIGHT_BAKE_LIGHTMAPS
 	};
 
+	struct ConvexDecompositionJobs {
+		Vector<Vector<Face3>> faces;
+		Mesh::ConvexDecompositionSettings settings;
+	};
+
 	void _replace_owner(Node *p_node, Node *p_scene, Node *p_new_owner);
+	void _find_convex_meshes(Node *p_node, Set<Ref<Mesh>> &r_meshes);
+	void _convex_decompose_job(uint32_t p_index, ConvexDecompositionJobs *p_jobs);
+	void _convex_decompose_meshes(Node *p_scene, const Mesh::ConvexDecompositionSettings &p_settings);
 
 public:
 	static ResourceImporterScene *get_singleton() { return singleton; }
@@ -145,7 +153,7 @@ public:
 
 	void _make_external_resources(Node *p_node, const String &p_base_path, bool p_make_animations, bool p_animations_as_text, bool p_keep_animations, bool p_make_materials, bool p_materials_as_text, bool p_keep_materials, bool p_make_meshes, bool p_meshes_as_text, Map<Ref<Animation>, Ref<Animation>> &p_animations, Map<Ref<Material>, Ref<Material>> &p_materials, Map<Ref<ArrayMesh>, Ref<ArrayMesh>> &p_meshes);
 
-	Node *_fix_node(Node *p_node, Node *p_root, Map<Ref<Mesh>, List<Ref<Shape3D>>> &collision_map, LightBakeMode p_light_bake_mode);
+	Node *_fix_node(Node *p_node, Node *p_root, Map<Ref<Mesh>, List<Ref<Shape3D>>> &collision_map, LightBakeMode p_light_bake_mode, const Mesh::ConvexDecompositionSettings &p_convex_settings);
 
 	void _create_clips(Node *scene, const Array &p_clips, bool p_bake_all);
 	void _filter_anim_tracks(Ref<Animation> anim, Set<String> &keep);
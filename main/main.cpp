@@ -44,6 +44,7 @@
 #include "core/io/resource_loader.h"
 #include "core/object/message_queue.h"
 #include "core/os/dir_access.h"
+#include "core/os/frame_arena.h"
 #include "core/os/os.h"
 #include "core/register_core_types.h"
 #include "core/string/translation.h"
@@ -2465,6 +2466,7 @@ bool Main::iteration() {
 
 	frames++;
 	Engine::get_singleton()->_idle_frames++;
+	FrameArena::end_frame();
 
 	if (frame > 1000000) {
 		if (editor || project_manager) {
@@ -283,11 +283,18 @@ void CSGBrush::copy_from(const CSGBrush &p_brush, const Transform &p_xform) {
 void CSGBrushOperation::merge_brushes(Operation p_operation, const CSGBrush &p_brush_a, const CSGBrush &p_brush_b, CSGBrush &r_merged_brush, float p_vertex_snap) {
 	// Check for face collisions and add necessary faces.
 	Build2DFaceCollection build2DFaceCollection;
+	FaceAABBTree tree_b;
+	tree_b.build(p_brush_b);
+
+	LocalVector<int> faces_b;
 	for (int i = 0; i < p_brush_a.faces.size(); i++) {
-		for (int j = 0; j < p_brush_b.faces.size(); j++) {
-			if (p_brush_a.faces[i].aabb.intersects_inclusive(p_brush_b.faces[j].aabb)) {
-				update_faces(p_brush_a, i, p_brush_b, j, build2DFaceCollection, p_vertex_snap);
-			}
+		faces_b.clear();
+		tree_b.cull_aabb(p_brush_a.faces[i].aabb, faces_b);
+		// The resulting faces depend on the insertion order, keep it stable.
+		faces_b.sort();
+
+		for (uint32_t j = 0; j < faces_b.size(); j++) {
+			update_faces(p_brush_a, i, p_brush_b, faces_b[j], build2DFaceCollection, p_vertex_snap);
 		}
 	}
 
@@ -462,6 +469,155 @@ void CSGBrushOperation::merge_brushes(Operation p_operation, const CSGBrush &p_b
 	}
 }
 
+// CSGBrushMergeCache
+
+void CSGBrushMergeCache::clear() {
+	last_inputs.clear();
+	checkpoint_inputs = -1;
+	checkpoint_has_brush = false;
+	checkpoint = CSGBrush();
+}
+
+bool CSGBrushMergeCache::merge(const CSGBrush *p_base, const Vector<Input> &p_inputs, float p_vertex_snap, CSGBrush &r_result) {
+	int first_changed = 0;
+	while (first_changed < p_inputs.size() && first_changed < last_inputs.size() && last_inputs[first_changed].is_same(p_inputs[first_changed])) {
+		first_changed++;
+	}
+
+	int from = 0;
+	bool has_brush = false;
+	if (checkpoint_inputs >= 0 && checkpoint_inputs <= first_changed) {
+		from = checkpoint_inputs;
+		has_brush = checkpoint_has_brush;
+		r_result = checkpoint;
+	} else if (p_base) {
+		has_brush = true;
+		r_result = *p_base;
+	} else {
+		r_result = CSGBrush();
+	}
+
+	checkpoint_inputs = -1;
+	last_merge_count = 0;
+
+	for (int i = from; i < p_inputs.size(); i++) {
+		if (i == first_changed) {
+			checkpoint_inputs = i;
+			checkpoint_has_brush = has_brush;
+			checkpoint = r_result;
+		}
+
+		const Input &input = p_inputs[i];
+		if (!input.brush) {
+			continue;
+		}
+
+		if (!has_brush) {
+			r_result.copy_from(*input.brush, input.transform);
+			has_brush = true;
+		} else {
+			CSGBrush transformed;
+			transformed.copy_from(*input.brush, input.transform);
+
+			CSGBrush merged;
+			CSGBrushOperation bop;
+			bop.merge_brushes(input.operation, r_result, transformed, merged, p_vertex_snap);
+			r_result = merged;
+		}
+		last_merge_count++;
+	}
+
+	if (checkpoint_inputs < 0) {
+		// Nothing changed, keep the full result.
+		checkpoint_inputs = p_inputs.size();
+		checkpoint_has_brush = has_brush;
+		checkpoint = r_result;
+	}
+
+	last_inputs = p_inputs;
+	for (int i = 0; i < last_inputs.size(); i++) {
+		last_inputs.write[i].brush = nullptr;
+	}
+
+	return has_brush;
+}
+
+// CSGBrushOperation::FaceAABBTree
+
+int CSGBrushOperation::FaceAABBTree::_create_node(int p_from, int p_count) {
+	AABB aabb = faces[p_from].aabb;
+	for (int i = 1; i < p_count; i++) {
+		aabb.merge_with(faces[p_from + i].aabb);
+	}
+
+	int index = nodes.size();
+	nodes.push_back(Node());
+	nodes[index].aabb = aabb;
+
+	if (p_count <= LEAF_FACES) {
+		nodes[index].from = p_from;
+		nodes[index].count = p_count;
+		return index;
+	}
+
+	// Split at the median face center along the longest axis.
+	SortArray<FaceRef, FaceRefCmp> sort;
+	sort.compare.axis = aabb.get_longest_axis_index();
+	sort.nth_element(0, p_count, p_count / 2, &faces[p_from]);
+
+	int left = _create_node(p_from, p_count / 2);
+	int right = _create_node(p_from + p_count / 2, p_count - p_count / 2);
+	nodes[index].left = left;
+	nodes[index].right = right;
+
+	return index;
+}
+
+void CSGBrushOperation::FaceAABBTree::build(const CSGBrush &p_brush) {
+	nodes.clear();
+	faces.resize(p_brush.faces.size());
+
+	for (int i = 0; i < p_brush.faces.size(); i++) {
+		faces[i].face = i;
+		faces[i].aabb = p_brush.faces[i].aabb;
+		faces[i].center = faces[i].aabb.position + faces[i].aabb.size * 0.5;
+	}
+
+	if (faces.size()) {
+		_create_node(0, faces.size());
+	}
+}
+
+void CSGBrushOperation::FaceAABBTree::cull_aabb(const AABB &p_aabb, LocalVector<int> &r_faces) const {
+	if (nodes.size() == 0) {
+		return;
+	}
+
+	int stack[MAX_DEPTH];
+	int level = 0;
+	stack[level++] = 0;
+
+	while (level > 0) {
+		const Node &node = nodes[stack[--level]];
+		if (!node.aabb.intersects_inclusive(p_aabb)) {
+			continue;
+		}
+
+		if (node.left == -1) {
+			for (int i = 0; i < node.count; i++) {
+				const FaceRef &ref = faces[node.from + i];
+				if (ref.aabb.intersects_inclusive(p_aabb)) {
+					r_faces.push_back(ref.face);
+				}
+			}
+		} else {
+			ERR_FAIL_COND(level + 2 > MAX_DEPTH);
+			stack[level++] = node.left;
+			stack[level++] = node.right;
+		}
+	}
+}
+
 // CSGBrushOperation::MeshMerge
 
 // Use a limit to speed up bvh and limit the depth.
@@ -38,6 +38,7 @@
 #include "core/math/vector3.h"
 #include "core/object/reference.h"
 #include "core/templates/list.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/map.h"
 #include "core/templates/oa_hash_map.h"
 #include "core/templates/vector.h"
@@ -72,6 +73,45 @@ struct CSGBrushOperation {
 
 	void merge_brushes(Operation p_operation, const CSGBrush &p_brush_a, const CSGBrush &p_brush_b, CSGBrush &r_merged_brush, float p_vertex_snap);
 
+	// Static AABB tree over the faces of a brush, so that only the face pairs that
+	// can intersect are tested when merging.
+	struct FaceAABBTree {
+		enum {
+			LEAF_FACES = 8,
+			MAX_DEPTH = 64
+		};
+
+		struct Node {
+			AABB aabb;
+			int left = -1;
+			int right = -1;
+			// Range of `faces` stored in leaves.
+			int from = 0;
+			int count = 0;
+		};
+
+		struct FaceRef {
+			int face;
+			Vector3 center;
+			AABB aabb;
+		};
+
+		struct FaceRefCmp {
+			int axis = 0;
+			_FORCE_INLINE_ bool operator()(const FaceRef &p_left, const FaceRef &p_right) const {
+				return p_left.center[axis] < p_right.center[axis];
+			}
+		};
+
+		LocalVector<Node> nodes;
+		LocalVector<FaceRef> faces;
+
+		int _create_node(int p_from, int p_count);
+
+		void build(const CSGBrush &p_brush);
+		void cull_aabb(const AABB &p_aabb, LocalVector<int> &r_faces) const;
+	};
+
 	struct MeshMerge {
 		struct Face {
 			bool from_b;
@@ -191,4 +231,30 @@ struct CSGBrushOperation {
 	void update_faces(const CSGBrush &p_brush_a, const int p_face_idx_a, const CSGBrush &p_brush_b, const int p_face_idx_b, Build2DFaceCollection &p_collection, float p_vertex_snap);
 };
 
+// Merges a base brush with a list of inputs in order. Only the merge before the first
+// changed input is kept, so editing the same input again redoes just the merges after it.
+struct CSGBrushMergeCache {
+	struct Input {
+		ObjectID id;
+		uint64_t version = 0;
+		Transform transform;
+		CSGBrushOperation::Operation operation = CSGBrushOperation::OPERATION_UNION;
+		const CSGBrush *brush = nullptr; // Not part of the cache key, nullptr if the input has no faces.
+
+		bool is_same(const Input &p_input) const {
+			return id == p_input.id && version == p_input.version && operation == p_input.operation && transform == p_input.transform;
+		}
+	};
+
+	Vector<Input> last_inputs;
+	int checkpoint_inputs = -1; // The base merged with this many inputs is in `checkpoint`, -1 if none.
+	bool checkpoint_has_brush = false;
+	CSGBrush checkpoint;
+	int last_merge_count = 0; // Inputs merged by the last call.
+
+	void clear();
+	// Returns false if the result has no faces.
+	bool merge(const CSGBrush *p_base, const Vector<Input> &p_inputs, float p_vertex_snap, CSGBrush &r_result);
+};
+
 #endif // CSG_H
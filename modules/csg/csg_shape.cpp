@@ -30,6 +30,7 @@
 
 #include "csg_shape.h"
 #include "core/math/geometry_2d.h"
+#include "core/os/os.h"
 #include "scene/3d/path_3d.h"
 
 void CSGShape3D::set_use_collision(bool p_enable) {
@@ -128,94 +129,210 @@ float CSGShape3D::get_snap() const {
 }
 
 void CSGShape3D::_make_dirty() {
+	own_brush_dirty = true;
+	_make_merge_dirty();
+}
+
+void CSGShape3D::_make_merge_dirty() {
 	if (!is_inside_tree()) {
 		return;
 	}
 
 	if (parent) {
-		parent->_make_dirty();
+		parent->_make_merge_dirty();
 	} else if (!dirty) {
 		call_deferred("_update_shape");
 	}
 
 	dirty = true;
+	dirty_version++;
 }
 
-CSGBrush *CSGShape3D::_get_brush() {
-	if (dirty) {
-		if (brush) {
-			memdelete(brush);
+int CSGShape3D::_prepare_brush_update(LocalVector<BrushUpdate> &r_updates) {
+	if (own_brush_dirty) {
+		if (own_brush) {
+			memdelete(own_brush);
 		}
-		brush = nullptr;
+		own_brush = _build_brush();
+		own_brush_dirty = false;
+		merge_cache.clear();
+	}
 
-		CSGBrush *n = _build_brush();
+	BrushUpdate update;
+	update.id = get_instance_id();
+	update.dirty_version = dirty_version;
+	update.snap = snap;
+	if (own_brush) {
+		update.has_own_brush = true;
+		update.own_brush = *own_brush;
+	}
+	update.merge_cache = merge_cache;
 
-		for (int i = 0; i < get_child_count(); i++) {
-			CSGShape3D *child = Object::cast_to<CSGShape3D>(get_child(i));
-			if (!child) {
-				continue;
-			}
-			if (!child->is_visible_in_tree()) {
-				continue;
-			}
+	for (int i = 0; i < get_child_count(); i++) {
+		CSGShape3D *child = Object::cast_to<CSGShape3D>(get_child(i));
+		if (!child) {
+			continue;
+		}
+		if (!child->is_visible_in_tree()) {
+			continue;
+		}
 
-			CSGBrush *n2 = child->_get_brush();
-			if (!n2) {
+		BrushUpdate::Child update_child;
+		update_child.id = child->get_instance_id();
+		update_child.transform = child->get_transform();
+		update_child.operation = child->get_operation();
+
+		if (child->dirty) {
+			update_child.update = child->_prepare_brush_update(r_updates);
+			update_child.brush_version = child->brush_version + 1;
+		} else {
+			if (!child->brush) {
 				continue;
 			}
-			if (!n) {
-				n = memnew(CSGBrush);
+			update_child.brush_version = child->brush_version;
+			update_child.has_brush = true;
+			update_child.brush = *child->brush;
+		}
 
-				n->copy_from(*n2, child->get_transform());
+		update.children.push_back(update_child);
+	}
 
-			} else {
-				CSGBrush *nn = memnew(CSGBrush);
-				CSGBrush *nn2 = memnew(CSGBrush);
-				nn2->copy_from(*n2, child->get_transform());
-
-				CSGBrushOperation bop;
-
-				switch (child->get_operation()) {
-					case CSGShape3D::OPERATION_UNION:
-						bop.merge_brushes(CSGBrushOperation::OPERATION_UNION, *n, *nn2, *nn, snap);
-						break;
-					case CSGShape3D::OPERATION_INTERSECTION:
-						bop.merge_brushes(CSGBrushOperation::OPERATION_INTERSECTION, *n, *nn2, *nn, snap);
-						break;
-					case CSGShape3D::OPERATION_SUBTRACTION:
-						bop.merge_brushes(CSGBrushOperation::OPERATION_SUBSTRACTION, *n, *nn2, *nn, snap);
-						break;
+	r_updates.push_back(update);
+	return r_updates.size() - 1;
+}
+
+void CSGShape3D::_run_brush_updates(LocalVector<BrushUpdate> &r_updates) {
+	for (uint32_t i = 0; i < r_updates.size(); i++) {
+		BrushUpdate &update = r_updates[i];
+
+		Vector<CSGBrushMergeCache::Input> inputs;
+		inputs.resize(update.children.size());
+		for (int j = 0; j < update.children.size(); j++) {
+			const BrushUpdate::Child &child = update.children[j];
+			CSGBrushMergeCache::Input &input = inputs.write[j];
+			input.id = child.id;
+			input.version = child.brush_version;
+			input.transform = child.transform;
+
+			switch (child.operation) {
+				case CSGShape3D::OPERATION_UNION:
+					input.operation = CSGBrushOperation::OPERATION_UNION;
+					break;
+				case CSGShape3D::OPERATION_INTERSECTION:
+					input.operation = CSGBrushOperation::OPERATION_INTERSECTION;
+					break;
+				case CSGShape3D::OPERATION_SUBTRACTION:
+					input.operation = CSGBrushOperation::OPERATION_SUBSTRACTION;
+					break;
+			}
+
+			if (child.update >= 0) {
+				if (r_updates[child.update].has_brush) {
+					input.brush = &r_updates[child.update].brush;
 				}
-				memdelete(n);
-				memdelete(nn2);
-				n = nn;
+			} else if (child.has_brush) {
+				input.brush = &child.brush;
 			}
 		}
 
-		if (n) {
-			AABB aabb;
-			for (int i = 0; i < n->faces.size(); i++) {
-				for (int j = 0; j < 3; j++) {
-					if (i == 0 && j == 0) {
-						aabb.position = n->faces[i].vertices[j];
+		CSGBrush n;
+		bool has_brush = update.merge_cache.merge(update.has_own_brush ? &update.own_brush : nullptr, inputs, update.snap, n);
+
+		AABB aabb;
+		if (has_brush) {
+			for (int j = 0; j < n.faces.size(); j++) {
+				for (int k = 0; k < 3; k++) {
+					if (j == 0 && k == 0) {
+						aabb.position = n.faces[j].vertices[k];
 					} else {
-						aabb.expand_to(n->faces[i].vertices[j]);
+						aabb.expand_to(n.faces[j].vertices[k]);
 					}
 				}
 			}
-			node_aabb = aabb;
-		} else {
-			node_aabb = AABB();
 		}
 
-		brush = n;
+		update.has_brush = has_brush;
+		update.brush = n;
+		update.aabb = aabb;
+	}
+}
+
+void CSGShape3D::_apply_brush_updates(const LocalVector<BrushUpdate> &p_updates) {
+	for (uint32_t i = 0; i < p_updates.size(); i++) {
+		const BrushUpdate &update = p_updates[i];
+
+		// Skip shapes that were freed, or changed again since the snapshot was taken.
+		CSGShape3D *shape = Object::cast_to<CSGShape3D>(ObjectDB::get_instance(update.id));
+		if (!shape || !shape->dirty || shape->dirty_version != update.dirty_version) {
+			continue;
+		}
+
+		if (shape->brush) {
+			memdelete(shape->brush);
+		}
+		shape->brush = update.has_brush ? memnew(CSGBrush(update.brush)) : nullptr;
+		shape->brush_version++;
+		shape->merge_cache = update.merge_cache;
+		shape->node_aabb = update.aabb;
+		shape->dirty = false;
+	}
+}
 
-		dirty = false;
+CSGBrush *CSGShape3D::_get_brush() {
+	if (dirty) {
+		LocalVector<BrushUpdate> updates;
+		_prepare_brush_update(updates);
+		_run_brush_updates(updates);
+		_apply_brush_updates(updates);
 	}
 
 	return brush;
 }
 
+// Below this many input faces, the shapes are merged without delaying the mesh.
+#define BRUSH_UPDATE_THREAD_MIN_FACES 1024
+
+void CSGShape3D::_brush_update_thread_func(void *p_userdata) {
+	CSGShape3D *shape = (CSGShape3D *)p_userdata;
+	_run_brush_updates(shape->brush_updates);
+	shape->call_deferred("_brush_update_finished");
+}
+
+void CSGShape3D::_brush_update_finished() {
+	_finish_brush_update(true);
+}
+
+void CSGShape3D::_finish_brush_update(bool p_update_mesh) {
+	if (brush_update_thread) {
+		Thread::wait_to_finish(brush_update_thread);
+		memdelete(brush_update_thread);
+		brush_update_thread = nullptr;
+	}
+
+	if (brush_updates.size() == 0) {
+		return;
+	}
+
+	_apply_brush_updates(brush_updates);
+
+	if (p_update_mesh && !parent && is_inside_tree()) {
+		const BrushUpdate &root_update = brush_updates[brush_updates.size() - 1];
+		if (dirty || dirty_version == root_update.dirty_version) {
+			// Show the result even if the shapes changed meanwhile, and start over from there.
+			_update_mesh(root_update.has_brush ? &root_update.brush : nullptr);
+		} else {
+			// Already brought up to date by _get_brush().
+			_update_mesh(brush);
+		}
+
+		if (dirty) {
+			call_deferred("_update_shape");
+		}
+	}
+
+	brush_updates.clear();
+}
+
 int CSGShape3D::mikktGetNumFaces(const SMikkTSpaceContext *pContext) {
 	ShapeUpdateSurface &surface = *((ShapeUpdateSurface *)pContext->m_pUserData);
 
@@ -271,14 +388,40 @@ void CSGShape3D::mikktSetTSpaceDefault(const SMikkTSpaceContext *pContext, const
 }
 
 void CSGShape3D::_update_shape() {
-	if (parent) {
+	if (parent || brush_update_thread) {
+		// A running update reschedules this when it finishes.
 		return;
 	}
 
-	set_base(RID());
-	root_mesh.unref(); //byebye root mesh
+	if (!dirty) {
+		_update_mesh(brush);
+		return;
+	}
+
+	brush_updates.clear();
+	_prepare_brush_update(brush_updates);
+
+	int face_count = 0;
+	for (uint32_t i = 0; i < brush_updates.size(); i++) {
+		face_count += brush_updates[i].own_brush.faces.size();
+		for (int j = 0; j < brush_updates[i].children.size(); j++) {
+			face_count += brush_updates[i].children[j].brush.faces.size();
+		}
+	}
+
+	if (face_count >= BRUSH_UPDATE_THREAD_MIN_FACES && OS::get_singleton()->can_use_threads()) {
+		brush_update_thread = Thread::create(_brush_update_thread_func, this);
+		if (brush_update_thread) {
+			return;
+		}
+	}
 
-	CSGBrush *n = _get_brush();
+	_run_brush_updates(brush_updates);
+	_finish_brush_update(true);
+}
+
+void CSGShape3D::_update_mesh(const CSGBrush *p_brush) {
+	const CSGBrush *n = p_brush;
 	ERR_FAIL_COND_MSG(!n, "Cannot get CSGBrush.");
 
 	OAHashMap<Vector3, Vector3> vec_map;
@@ -406,7 +549,8 @@ void CSGShape3D::_update_shape() {
 		}
 	}
 
-	root_mesh.instance();
+	Ref<ArrayMesh> mesh;
+	mesh.instance();
 	//create surfaces
 
 	for (int i = 0; i < surfaces.size(); i++) {
@@ -443,11 +587,13 @@ void CSGShape3D::_update_shape() {
 			array[Mesh::ARRAY_TANGENT] = surfaces[i].tans;
 		}
 
-		int idx = root_mesh->get_surface_count();
-		root_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, array);
-		root_mesh->surface_set_material(idx, surfaces[i].material);
+		int idx = mesh->get_surface_count();
+		mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, array);
+		mesh->surface_set_material(idx, surfaces[i].material);
 	}
 
+	// The previous mesh is only replaced now that the new one is ready.
+	root_mesh = mesh;
 	set_base(root_mesh->get_rid());
 }
 
@@ -514,19 +660,21 @@ void CSGShape3D::_notification(int p_what) {
 
 	if (p_what == NOTIFICATION_LOCAL_TRANSFORM_CHANGED) {
 		if (parent) {
-			parent->_make_dirty();
+			parent->_make_merge_dirty();
 		}
 	}
 
 	if (p_what == NOTIFICATION_VISIBILITY_CHANGED) {
 		if (parent) {
-			parent->_make_dirty();
+			parent->_make_merge_dirty();
 		}
 	}
 
 	if (p_what == NOTIFICATION_EXIT_TREE) {
+		_finish_brush_update(false);
+
 		if (parent) {
-			parent->_make_dirty();
+			parent->_make_merge_dirty();
 		}
 		parent = nullptr;
 
@@ -569,6 +717,10 @@ void CSGShape3D::_validate_property(PropertyInfo &property) const {
 }
 
 Array CSGShape3D::get_meshes() const {
+	if (brush_update_thread) {
+		const_cast<CSGShape3D *>(this)->_finish_brush_update(true);
+	}
+
 	if (root_mesh.is_valid()) {
 		Array arr;
 		arr.resize(2);
@@ -582,6 +734,7 @@ Array CSGShape3D::get_meshes() const {
 
 void CSGShape3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("_update_shape"), &CSGShape3D::_update_shape);
+	ClassDB::bind_method(D_METHOD("_brush_update_finished"), &CSGShape3D::_brush_update_finished);
 	ClassDB::bind_method(D_METHOD("is_root_shape"), &CSGShape3D::is_root_shape);
 
 	ClassDB::bind_method(D_METHOD("set_operation", "operation"), &CSGShape3D::set_operation);
@@ -628,20 +781,31 @@ CSGShape3D::CSGShape3D() {
 	operation = OPERATION_UNION;
 	parent = nullptr;
 	brush = nullptr;
+	own_brush = nullptr;
+	brush_version = 0;
 	dirty = false;
+	own_brush_dirty = true;
+	dirty_version = 0;
 	snap = 0.001;
 	use_collision = false;
 	collision_layer = 1;
 	collision_mask = 1;
 	calculate_tangents = true;
+	brush_update_thread = nullptr;
 	set_notify_local_transform(true);
 }
 
 CSGShape3D::~CSGShape3D() {
+	_finish_brush_update(false);
+
 	if (brush) {
 		memdelete(brush);
 		brush = nullptr;
 	}
+	if (own_brush) {
+		memdelete(own_brush);
+		own_brush = nullptr;
+	}
 }
 
 //////////////////////////////////
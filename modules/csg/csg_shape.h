@@ -34,6 +34,7 @@
 #define CSGJS_HEADER_ONLY
 
 #include "csg.h"
+#include "core/os/thread.h"
 #include "scene/3d/visual_instance_3d.h"
 #include "scene/resources/concave_polygon_shape_3d.h"
 #include "thirdparty/misc/mikktspace.h"
@@ -54,10 +55,14 @@ private:
 	CSGShape3D *parent;
 
 	CSGBrush *brush;
+	CSGBrush *own_brush;
+	uint64_t brush_version;
 
 	AABB node_aabb;
 
 	bool dirty;
+	bool own_brush_dirty;
+	uint64_t dirty_version;
 	float snap;
 
 	bool use_collision;
@@ -93,6 +98,47 @@ private:
 		float *tansw;
 	};
 
+	// Keeps one checkpoint, before the most recently edited child.
+	CSGBrushMergeCache merge_cache;
+
+	// Snapshot of a dirty shape, taken on the main thread so the merges can run on
+	// a worker thread without touching the scene tree.
+	struct BrushUpdate {
+		struct Child {
+			ObjectID id;
+			Transform transform;
+			Operation operation = OPERATION_UNION;
+			uint64_t brush_version = 0;
+			int update = -1; // Index of the child's own update, or -1 to use `brush`.
+			bool has_brush = false;
+			CSGBrush brush;
+		};
+
+		ObjectID id;
+		uint64_t dirty_version = 0;
+		float snap = 0;
+		bool has_own_brush = false;
+		CSGBrush own_brush;
+		Vector<Child> children;
+		CSGBrushMergeCache merge_cache;
+
+		bool has_brush = false;
+		CSGBrush brush;
+		AABB aabb;
+	};
+
+	// Updates of the root shape, children first. The previous mesh is kept until they finish.
+	LocalVector<BrushUpdate> brush_updates;
+	Thread *brush_update_thread;
+
+	int _prepare_brush_update(LocalVector<BrushUpdate> &r_updates);
+	static void _run_brush_updates(LocalVector<BrushUpdate> &r_updates);
+	static void _apply_brush_updates(const LocalVector<BrushUpdate> &p_updates);
+	static void _brush_update_thread_func(void *p_userdata);
+	void _brush_update_finished();
+	void _finish_brush_update(bool p_update_mesh);
+	void _update_mesh(const CSGBrush *p_brush);
+
 	//mikktspace callbacks
 	static int mikktGetNumFaces(const SMikkTSpaceContext *pContext);
 	static int mikktGetNumVerticesOfFace(const SMikkTSpaceContext *pContext, const int iFace);
@@ -108,6 +154,7 @@ protected:
 	void _notification(int p_what);
 	virtual CSGBrush *_build_brush() = 0;
 	void _make_dirty();
+	void _make_merge_dirty();
 
 	static void _bind_methods();
 
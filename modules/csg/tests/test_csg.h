@@ -0,0 +1,217 @@
+/*************************************************************************/
+/*  test_csg.h                                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef TEST_CSG_H
+#define TEST_CSG_H
+
+#include "core/os/thread.h"
+#include "modules/csg/csg.h"
+
+#include "tests/test_macros.h"
+
+namespace TestCSG {
+
+static CSGBrush _make_box(const Vector3 &p_half_size) {
+	Vector<Vector3> faces;
+	Vector<Vector2> uvs;
+	Vector<bool> smooth;
+	Vector<Ref<Material>> materials;
+	Vector<bool> invert;
+
+	for (int i = 0; i < 6; i++) {
+		Vector3 face_points[4];
+		for (int j = 0; j < 4; j++) {
+			float v[3];
+			v[0] = 1.0;
+			v[1] = 1 - 2 * ((j >> 1) & 1);
+			v[2] = v[1] * (1 - 2 * (j & 1));
+
+			for (int k = 0; k < 3; k++) {
+				if (i < 3) {
+					face_points[j][(i + k) % 3] = v[k];
+				} else {
+					face_points[3 - j][(i + k) % 3] = -v[k];
+				}
+			}
+		}
+
+		const int triangles[6] = { 0, 1, 2, 2, 3, 0 };
+		for (int j = 0; j < 6; j++) {
+			faces.push_back(face_points[triangles[j]] * p_half_size);
+			uvs.push_back(Vector2());
+		}
+		for (int j = 0; j < 2; j++) {
+			smooth.push_back(false);
+			materials.push_back(Ref<Material>());
+			invert.push_back(false);
+		}
+	}
+
+	CSGBrush brush;
+	brush.build_from_faces(faces, uvs, smooth, materials, invert);
+	return brush;
+}
+
+static bool _same_brush(const CSGBrush &p_a, const CSGBrush &p_b) {
+	if (p_a.faces.size() != p_b.faces.size()) {
+		return false;
+	}
+	for (int i = 0; i < p_a.faces.size(); i++) {
+		for (int j = 0; j < 3; j++) {
+			if (!p_a.faces[i].vertices[j].is_equal_approx(p_b.faces[i].vertices[j])) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+struct MergeTest {
+	CSGBrush base;
+	CSGBrush box;
+	Vector<CSGBrushMergeCache::Input> inputs;
+
+	MergeTest() {
+		base = _make_box(Vector3(2, 1, 1));
+		box = _make_box(Vector3(0.5, 0.5, 0.5));
+
+		const CSGBrushOperation::Operation operations[3] = { CSGBrushOperation::OPERATION_UNION, CSGBrushOperation::OPERATION_SUBSTRACTION, CSGBrushOperation::OPERATION_UNION };
+		for (int i = 0; i < 3; i++) {
+			CSGBrushMergeCache::Input input;
+			input.id = ObjectID(uint64_t(i + 1));
+			input.version = 1;
+			input.transform.origin = Vector3(i - 1.0, 1, 0);
+			input.operation = operations[i];
+			input.brush = &box;
+			inputs.push_back(input);
+		}
+	}
+
+	void move_input(int p_index, const Vector3 &p_offset) {
+		inputs.write[p_index].transform.origin += p_offset;
+		inputs.write[p_index].version++;
+	}
+
+	CSGBrush merge_uncached() const {
+		CSGBrushMergeCache cache;
+		CSGBrush result;
+		cache.merge(&base, inputs, 0.001, result);
+		return result;
+	}
+};
+
+TEST_CASE("[CSG] Incremental merges match full merges") {
+	MergeTest test;
+	CSGBrushMergeCache cache;
+	CSGBrush result;
+
+	REQUIRE(cache.merge(&test.base, test.inputs, 0.001, result));
+	CHECK(cache.last_merge_count == 3);
+	CHECK(_same_brush(result, test.merge_uncached()));
+
+	// Only the merges after the edited input are redone, from the checkpoint before it.
+	test.move_input(1, Vector3(0, 0.25, 0));
+	REQUIRE(cache.merge(&test.base, test.inputs, 0.001, result));
+	CHECK(cache.checkpoint_inputs == 1);
+	CHECK(_same_brush(result, test.merge_uncached()));
+
+	test.move_input(1, Vector3(0.25, 0, 0));
+	REQUIRE(cache.merge(&test.base, test.inputs, 0.001, result));
+	CHECK(cache.last_merge_count == 2);
+	CHECK(cache.checkpoint_inputs == 1);
+	CHECK(_same_brush(result, test.merge_uncached()));
+
+	// Editing an earlier input starts over and moves the checkpoint.
+	test.move_input(0, Vector3(0, -0.25, 0));
+	REQUIRE(cache.merge(&test.base, test.inputs, 0.001, result));
+	CHECK(cache.last_merge_count == 3);
+	CHECK(cache.checkpoint_inputs == 0);
+	CHECK(_same_brush(result, test.merge_uncached()));
+
+	// Removing an input.
+	test.inputs.remove(2);
+	REQUIRE(cache.merge(&test.base, test.inputs, 0.001, result));
+	CHECK(cache.checkpoint_inputs == 2);
+	CHECK(_same_brush(result, test.merge_uncached()));
+}
+
+TEST_CASE("[CSG] Inputs without faces") {
+	MergeTest test;
+	test.inputs.write[0].brush = nullptr;
+
+	CSGBrushMergeCache cache;
+	CSGBrush result;
+	REQUIRE(cache.merge(nullptr, test.inputs, 0.001, result));
+	CHECK(cache.last_merge_count == 2);
+
+	CSGBrushMergeCache empty_cache;
+	CHECK(!empty_cache.merge(nullptr, Vector<CSGBrushMergeCache::Input>(), 0.001, result));
+	CHECK(result.faces.size() == 0);
+}
+
+struct ThreadedMerge {
+	const MergeTest *test = nullptr;
+	CSGBrushMergeCache cache;
+	CSGBrush result;
+
+	static void thread_func(void *p_userdata) {
+		ThreadedMerge *merge = (ThreadedMerge *)p_userdata;
+		merge->cache.merge(&merge->test->base, merge->test->inputs, 0.001, merge->result);
+	}
+};
+
+TEST_CASE("[CSG] Merging a cache copy on another thread") {
+	MergeTest test;
+	CSGBrushMergeCache cache;
+	CSGBrush result;
+	cache.merge(&test.base, test.inputs, 0.001, result);
+	test.move_input(2, Vector3(0, 0, 0.5));
+	cache.merge(&test.base, test.inputs, 0.001, result);
+	test.move_input(2, Vector3(0, 0, 0.5));
+
+	// Shapes snapshot their cache, merge the copy on a thread, then keep the copy.
+	ThreadedMerge threaded;
+	threaded.test = &test;
+	threaded.cache = cache;
+	Thread *thread = Thread::create(ThreadedMerge::thread_func, &threaded);
+	Thread::wait_to_finish(thread);
+	memdelete(thread);
+
+	CHECK(threaded.cache.last_merge_count == 1);
+	CHECK(_same_brush(threaded.result, test.merge_uncached()));
+
+	// The original cache is untouched by the thread.
+	CHECK(cache.last_inputs[2].version == test.inputs[2].version - 1);
+}
+
+} // namespace TestCSG
+
+#endif // TEST_CSG_H
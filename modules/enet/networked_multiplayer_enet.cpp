@@ -113,6 +113,9 @@ Error NetworkedMultiplayerENet::create_server(int p_port, int p_max_clients, int
 	refuse_connections = false;
 	unique_id = 1;
 	connection_status = CONNECTION_CONNECTED;
+	if (threaded) {
+		_start_thread();
+	}
 	return OK;
 }
 
@@ -204,6 +207,9 @@ Error NetworkedMultiplayerENet::create_client(const String &p_address, int p_por
 	active = true;
 	server = false;
 	refuse_connections = false;
+	if (threaded) {
+		_start_thread();
+	}
 
 	return OK;
 }
@@ -215,219 +221,373 @@ void NetworkedMultiplayerENet::poll() {
 
 	ENetEvent event;
 	/* Keep servicing until there are no available events left in queue. */
-	while (true) {
+	for (int processed = 0; !threaded || processed < THREAD_QUEUE_SIZE; processed++) {
 		if (!host || !active) { // Might have been disconnected while emitting a notification
 			return;
 		}
 
-		int ret = enet_host_service(host, &event, 0);
+		enet_uint32 connect_id;
+		if (threaded) {
+			// The network thread services the host, only handle what it received.
+			ThreadEvent thread_event;
+			if (!thread_events.pop(thread_event)) {
+				break;
+			}
+			event = thread_event.event;
+			connect_id = thread_event.connect_id;
+		} else {
+			int ret = enet_host_service(host, &event, 0);
 
-		if (ret < 0) {
-			// Error, do something?
-			break;
-		} else if (ret == 0) {
-			break;
+			if (ret < 0) {
+				// Error, do something?
+				break;
+			} else if (ret == 0) {
+				break;
+			}
+			connect_id = event.peer ? event.peer->connectID : 0;
 		}
 
-		switch (event.type) {
-			case ENET_EVENT_TYPE_CONNECT: {
-				// Store any relevant client information here.
+		_process_event(event, connect_id);
+	}
+}
 
-				if (server && refuse_connections) {
-					enet_peer_reset(event.peer);
-					break;
-				}
+void NetworkedMultiplayerENet::_process_event(ENetEvent &p_event, enet_uint32 p_connect_id) {
+	switch (p_event.type) {
+		case ENET_EVENT_TYPE_CONNECT: {
+			// Store any relevant client information here.
 
-				// A client joined with an invalid ID (negative values, 0, and 1 are reserved).
-				// Probably trying to exploit us.
-				if (server && ((int)event.data < 2 || peer_map.has((int)event.data))) {
-					enet_peer_reset(event.peer);
-					ERR_CONTINUE(true);
-				}
+			if (server && refuse_connections) {
+				MutexLock lock(host_mutex);
+				enet_peer_reset(p_event.peer);
+				break;
+			}
 
-				int *new_id = memnew(int);
-				*new_id = event.data;
+			// A client joined with an invalid ID (negative values, 0, and 1 are reserved).
+			// Probably trying to exploit us.
+			if (server && ((int)p_event.data < 2 || peer_map.has((int)p_event.data))) {
+				MutexLock lock(host_mutex);
+				enet_peer_reset(p_event.peer);
+				ERR_FAIL_MSG("A client tried to connect with an invalid ID.");
+			}
 
-				if (*new_id == 0) { // Data zero is sent by server (enet won't let you configure this). Server is always 1.
-					*new_id = 1;
-				}
+			int *new_id = memnew(int);
+			*new_id = p_event.data;
 
-				event.peer->data = new_id;
+			if (*new_id == 0) { // Data zero is sent by server (enet won't let you configure this). Server is always 1.
+				*new_id = 1;
+			}
 
-				peer_map[*new_id] = event.peer;
+			{
+				MutexLock lock(host_mutex);
+				p_event.peer->data = new_id;
+			}
 
-				connection_status = CONNECTION_CONNECTED; // If connecting, this means it connected to something!
+			peer_map[*new_id] = p_event.peer;
+			peer_connect_ids[*new_id] = p_connect_id;
 
-				emit_signal("peer_connected", *new_id);
+			connection_status = CONNECTION_CONNECTED; // If connecting, this means it connected to something!
 
-				if (server) {
-					// Do not notify other peers when server_relay is disabled.
-					if (!server_relay) {
-						break;
-					}
+			emit_signal("peer_connected", *new_id);
 
-					// Someone connected, notify all the peers available
-					for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
-						if (E->key() == *new_id) {
-							continue;
-						}
-						// Send existing peers to new peer
-						ENetPacket *packet = enet_packet_create(nullptr, 8, ENET_PACKET_FLAG_RELIABLE);
-						encode_uint32(SYSMSG_ADD_PEER, &packet->data[0]);
-						encode_uint32(E->key(), &packet->data[4]);
-						enet_peer_send(event.peer, SYSCH_CONFIG, packet);
-						// Send the new peer to existing peers
-						packet = enet_packet_create(nullptr, 8, ENET_PACKET_FLAG_RELIABLE);
-						encode_uint32(SYSMSG_ADD_PEER, &packet->data[0]);
-						encode_uint32(*new_id, &packet->data[4]);
-						enet_peer_send(E->get(), SYSCH_CONFIG, packet);
-					}
-				} else {
-					emit_signal("connection_succeeded");
+			if (server) {
+				// Do not notify other peers when server_relay is disabled.
+				if (!server_relay) {
+					break;
 				}
 
-			} break;
-			case ENET_EVENT_TYPE_DISCONNECT: {
-				// Reset the peer's client information.
-
-				int *id = (int *)event.peer->data;
-
-				if (!id) {
-					if (!server) {
-						emit_signal("connection_failed");
+				// Someone connected, notify all the peers available
+				for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
+					if (E->key() == *new_id) {
+						continue;
 					}
-					// Never fully connected.
-					break;
+					// Send existing peers to new peer
+					ENetPacket *packet = enet_packet_create(nullptr, 8, ENET_PACKET_FLAG_RELIABLE);
+					encode_uint32(SYSMSG_ADD_PEER, &packet->data[0]);
+					encode_uint32(E->key(), &packet->data[4]);
+					_send_to_peer(p_event.peer, *new_id, SYSCH_CONFIG, packet);
+					// Send the new peer to existing peers
+					packet = enet_packet_create(nullptr, 8, ENET_PACKET_FLAG_RELIABLE);
+					encode_uint32(SYSMSG_ADD_PEER, &packet->data[0]);
+					encode_uint32(*new_id, &packet->data[4]);
+					_send_to_peer(E->get(), E->key(), SYSCH_CONFIG, packet);
 				}
+			} else {
+				emit_signal("connection_succeeded");
+			}
 
-				if (!server) {
-					// Client just disconnected from server.
-					emit_signal("server_disconnected");
-					close_connection();
-					return;
-				} else if (server_relay) {
-					// Server just received a client disconnect and is in relay mode, notify everyone else.
-					for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
-						if (E->key() == *id) {
-							continue;
-						}
+		} break;
+		case ENET_EVENT_TYPE_DISCONNECT: {
+			// Reset the peer's client information.
 
-						ENetPacket *packet = enet_packet_create(nullptr, 8, ENET_PACKET_FLAG_RELIABLE);
-						encode_uint32(SYSMSG_REMOVE_PEER, &packet->data[0]);
-						encode_uint32(*id, &packet->data[4]);
-						enet_peer_send(E->get(), SYSCH_CONFIG, packet);
-					}
+			int *id = (int *)p_event.peer->data;
+
+			if (!id) {
+				if (!server) {
+					emit_signal("connection_failed");
 				}
+				// Never fully connected.
+				break;
+			}
 
-				emit_signal("peer_disconnected", *id);
-				peer_map.erase(*id);
-				memdelete(id);
-			} break;
-			case ENET_EVENT_TYPE_RECEIVE: {
-				if (event.channelID == SYSCH_CONFIG) {
-					// Some config message
-					ERR_CONTINUE(event.packet->dataLength < 8);
-
-					// Only server can send config messages
-					ERR_CONTINUE(server);
-
-					int msg = decode_uint32(&event.packet->data[0]);
-					int id = decode_uint32(&event.packet->data[4]);
-
-					switch (msg) {
-						case SYSMSG_ADD_PEER: {
-							peer_map[id] = nullptr;
-							emit_signal("peer_connected", id);
-
-						} break;
-						case SYSMSG_REMOVE_PEER: {
-							peer_map.erase(id);
-							emit_signal("peer_disconnected", id);
-						} break;
+			if (!server) {
+				// Client just disconnected from server.
+				emit_signal("server_disconnected");
+				close_connection();
+				return;
+			} else if (server_relay) {
+				// Server just received a client disconnect and is in relay mode, notify everyone else.
+				for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
+					if (E->key() == *id) {
+						continue;
 					}
 
-					enet_packet_destroy(event.packet);
-				} else if (event.channelID < channel_count) {
-					Packet packet;
-					packet.packet = event.packet;
+					ENetPacket *packet = enet_packet_create(nullptr, 8, ENET_PACKET_FLAG_RELIABLE);
+					encode_uint32(SYSMSG_REMOVE_PEER, &packet->data[0]);
+					encode_uint32(*id, &packet->data[4]);
+					_send_to_peer(E->get(), E->key(), SYSCH_CONFIG, packet);
+				}
+			}
 
-					uint32_t *id = (uint32_t *)event.peer->data;
+			emit_signal("peer_disconnected", *id);
+			peer_map.erase(*id);
+			peer_connect_ids.erase(*id);
+			{
+				MutexLock lock(host_mutex);
+				p_event.peer->data = nullptr;
+			}
+			memdelete(id);
+		} break;
+		case ENET_EVENT_TYPE_RECEIVE: {
+			if (p_event.channelID == SYSCH_CONFIG) {
+				// Some config message
+				ERR_FAIL_COND(p_event.packet->dataLength < 8);
+
+				// Only server can send config messages
+				ERR_FAIL_COND(server);
+
+				int msg = decode_uint32(&p_event.packet->data[0]);
+				int id = decode_uint32(&p_event.packet->data[4]);
+
+				switch (msg) {
+					case SYSMSG_ADD_PEER: {
+						peer_map[id] = nullptr;
+						emit_signal("peer_connected", id);
+
+					} break;
+					case SYSMSG_REMOVE_PEER: {
+						peer_map.erase(id);
+						emit_signal("peer_disconnected", id);
+					} break;
+				}
 
-					ERR_CONTINUE(event.packet->dataLength < 8);
+				enet_packet_destroy(p_event.packet);
+			} else if (p_event.channelID < channel_count) {
+				Packet packet;
+				packet.packet = p_event.packet;
 
-					uint32_t source = decode_uint32(&event.packet->data[0]);
-					int target = decode_uint32(&event.packet->data[4]);
+				uint32_t *id = (uint32_t *)p_event.peer->data;
+				if (!id) {
+					// Disconnected before the packet was handled.
+					enet_packet_destroy(p_event.packet);
+					return;
+				}
 
-					packet.from = source;
-					packet.channel = event.channelID;
+				ERR_FAIL_COND(p_event.packet->dataLength < 8);
 
-					if (server) {
-						// Someone is cheating and trying to fake the source!
-						ERR_CONTINUE(source != *id);
+				uint32_t source = decode_uint32(&p_event.packet->data[0]);
+				int target = decode_uint32(&p_event.packet->data[4]);
 
-						packet.from = *id;
+				packet.from = source;
+				packet.channel = p_event.channelID;
 
-						if (target == 1) {
-							// To myself and only myself
-							incoming_packets.push_back(packet);
-						} else if (!server_relay) {
-							// No other destination is allowed when server is not relaying
-							continue;
-						} else if (target == 0) {
-							// Re-send to everyone but sender :|
+				if (server) {
+					// Someone is cheating and trying to fake the source!
+					ERR_FAIL_COND(source != *id);
 
-							incoming_packets.push_back(packet);
-							// And make copies for sending
-							for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
-								if (uint32_t(E->key()) == source) { // Do not resend to self
-									continue;
-								}
+					packet.from = *id;
 
-								ENetPacket *packet2 = enet_packet_create(packet.packet->data, packet.packet->dataLength, packet.packet->flags);
+					if (target == 1) {
+						// To myself and only myself
+						incoming_packets.push_back(packet);
+					} else if (!server_relay) {
+						// No other destination is allowed when server is not relaying
+						return;
+					} else if (target == 0) {
+						// Re-send to everyone but sender :|
 
-								enet_peer_send(E->get(), event.channelID, packet2);
+						incoming_packets.push_back(packet);
+						// And make copies for sending
+						for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
+							if (uint32_t(E->key()) == source) { // Do not resend to self
+								continue;
 							}
 
-						} else if (target < 0) {
-							// To all but one
+							ENetPacket *packet2 = enet_packet_create(packet.packet->data, packet.packet->dataLength, packet.packet->flags);
 
-							// And make copies for sending
-							for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
-								if (uint32_t(E->key()) == source || E->key() == -target) { // Do not resend to self, also do not send to excluded
-									continue;
-								}
+							_send_to_peer(E->get(), E->key(), p_event.channelID, packet2);
+						}
 
-								ENetPacket *packet2 = enet_packet_create(packet.packet->data, packet.packet->dataLength, packet.packet->flags);
+					} else if (target < 0) {
+						// To all but one
 
-								enet_peer_send(E->get(), event.channelID, packet2);
+						// And make copies for sending
+						for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
+							if (uint32_t(E->key()) == source || E->key() == -target) { // Do not resend to self, also do not send to excluded
+								continue;
 							}
 
-							if (-target != 1) {
-								// Server is not excluded
-								incoming_packets.push_back(packet);
-							} else {
-								// Server is excluded, erase packet
-								enet_packet_destroy(packet.packet);
-							}
+							ENetPacket *packet2 = enet_packet_create(packet.packet->data, packet.packet->dataLength, packet.packet->flags);
+
+							_send_to_peer(E->get(), E->key(), p_event.channelID, packet2);
+						}
 
+						if (-target != 1) {
+							// Server is not excluded
+							incoming_packets.push_back(packet);
 						} else {
-							// To someone else, specifically
-							ERR_CONTINUE(!peer_map.has(target));
-							enet_peer_send(peer_map[target], event.channelID, packet.packet);
+							// Server is excluded, erase packet
+							enet_packet_destroy(packet.packet);
 						}
+
 					} else {
-						incoming_packets.push_back(packet);
+						// To someone else, specifically
+						ERR_FAIL_COND(!peer_map.has(target));
+						_send_to_peer(peer_map[target], target, p_event.channelID, packet.packet);
 					}
-
-					// Destroy packet later
 				} else {
-					ERR_CONTINUE(true);
+					incoming_packets.push_back(packet);
 				}
 
-			} break;
-			case ENET_EVENT_TYPE_NONE: {
-				// Do nothing
-			} break;
+				// Destroy packet later
+			} else {
+				ERR_FAIL_MSG("Invalid channel received.");
+			}
+
+		} break;
+		case ENET_EVENT_TYPE_NONE: {
+			// Do nothing
+		} break;
+	}
+}
+
+void NetworkedMultiplayerENet::_send_to_peer(ENetPeer *p_peer, int p_peer_id, int p_channel, ENetPacket *p_packet) {
+	if (!threaded) {
+		if (p_peer) {
+			enet_peer_send(p_peer, p_channel, p_packet);
+		} else {
+			enet_host_broadcast(host, p_channel, p_packet);
+		}
+		return;
+	}
+
+	OutgoingPacket out;
+	out.packet = p_packet;
+	out.peer = p_peer;
+	out.peer_id = p_peer_id;
+	if (p_peer) {
+		const Map<int, enet_uint32>::Element *E = peer_connect_ids.find(p_peer_id);
+		out.connect_id = E ? E->get() : 0;
+	}
+	out.channel = p_channel;
+	if (!thread_outgoing.push(out)) {
+		// The network thread is behind, send what is queued to make room.
+		MutexLock lock(host_mutex);
+		_thread_send_outgoing();
+		thread_outgoing.push(out);
+	}
+}
+
+// Threaded mode.
+// A network thread owns the host: it services it, which receives, decrypts
+// and decompresses packets, and hands the resulting events to poll() through
+// a lock free queue. Packets to send go the other way through another queue.
+// ENet calls made from the main thread (resets, disconnections) lock
+// host_mutex, which the network thread holds while servicing.
+
+void NetworkedMultiplayerENet::_thread_func(void *p_userdata) {
+	NetworkedMultiplayerENet *enet = (NetworkedMultiplayerENet *)p_userdata;
+
+	while (!enet->thread_exit.load()) {
+		enet->_thread_service();
+
+		if (enet->thread_events.is_full()) {
+			// Wait for poll() to catch up.
+			OS::get_singleton()->delay_usec(THREAD_WAIT_MSEC * 1000);
+		} else {
+			// Sleep until something is received, queued packets are sent on the next service.
+			enet_uint32 condition = ENET_SOCKET_WAIT_RECEIVE;
+			enet_socket_wait(enet->host->socket, &condition, THREAD_WAIT_MSEC);
+		}
+	}
+}
+
+void NetworkedMultiplayerENet::_thread_service() {
+	MutexLock lock(host_mutex);
+
+	_thread_send_outgoing();
+
+	ThreadEvent thread_event;
+	while (!thread_events.is_full()) {
+		int ret = enet_host_service(host, &thread_event.event, 0);
+		if (ret <= 0) {
+			break;
+		}
+		thread_event.connect_id = thread_event.event.peer ? thread_event.event.peer->connectID : 0;
+		thread_events.push(thread_event);
+	}
+
+	enet_host_flush(host);
+}
+
+void NetworkedMultiplayerENet::_thread_send_outgoing() {
+	OutgoingPacket out;
+	while (thread_outgoing.pop(out)) {
+		if (!out.peer) {
+			enet_host_broadcast(host, out.channel, out.packet);
+			continue;
+		}
+
+		// The peer might have disconnected, and its slot been reused by another
+		// client, since the packet was queued. ENet gives every connection a new
+		// connectID (and zeroes it on reset), so only send to the same connection.
+		bool sent = false;
+		if (out.connect_id != 0 && out.peer->connectID == out.connect_id) {
+			sent = enet_peer_send(out.peer, out.channel, out.packet) == 0;
+		}
+		if (!sent && out.packet->referenceCount == 0) {
+			enet_packet_destroy(out.packet);
+		}
+	}
+}
+
+void NetworkedMultiplayerENet::_start_thread() {
+	thread_events.resize(THREAD_QUEUE_SIZE);
+	thread_outgoing.resize(THREAD_QUEUE_SIZE);
+	thread_exit.store(false);
+	thread = Thread::create(_thread_func, this);
+}
+
+void NetworkedMultiplayerENet::_stop_thread() {
+	if (!thread) {
+		return;
+	}
+
+	thread_exit.store(true);
+	Thread::wait_to_finish(thread);
+	memdelete(thread);
+	thread = nullptr;
+
+	// Free what was left in the queues.
+	ThreadEvent thread_event;
+	while (thread_events.pop(thread_event)) {
+		if (thread_event.event.type == ENET_EVENT_TYPE_RECEIVE) {
+			enet_packet_destroy(thread_event.event.packet);
+		}
+	}
+	OutgoingPacket out;
+	while (thread_outgoing.pop(out)) {
+		if (out.packet->referenceCount == 0) {
+			enet_packet_destroy(out.packet);
 		}
 	}
 }
@@ -441,6 +601,7 @@ bool NetworkedMultiplayerENet::is_server() const {
 void NetworkedMultiplayerENet::close_connection(uint32_t wait_usec) {
 	ERR_FAIL_COND_MSG(!active, "The multiplayer instance isn't currently active.");
 
+	_stop_thread();
 	_pop_current_packet();
 
 	bool peers_disconnected = false;
@@ -465,6 +626,7 @@ void NetworkedMultiplayerENet::close_connection(uint32_t wait_usec) {
 	active = false;
 	incoming_packets.clear();
 	peer_map.clear();
+	peer_connect_ids.clear();
 	unique_id = 1; // Server is 1
 	connection_status = CONNECTION_DISCONNECTED;
 }
@@ -476,7 +638,11 @@ void NetworkedMultiplayerENet::disconnect_peer(int p_peer, bool now) {
 
 	if (now) {
 		int *id = (int *)peer_map[p_peer]->data;
-		enet_peer_disconnect_now(peer_map[p_peer], 0);
+		{
+			MutexLock lock(host_mutex);
+			peer_map[p_peer]->data = nullptr;
+			enet_peer_disconnect_now(peer_map[p_peer], 0);
+		}
 
 		// enet_peer_disconnect_now doesn't generate ENET_EVENT_TYPE_DISCONNECT,
 		// notify everyone else, send disconnect signal & remove from peer_map like in poll()
@@ -489,7 +655,7 @@ void NetworkedMultiplayerENet::disconnect_peer(int p_peer, bool now) {
 				ENetPacket *packet = enet_packet_create(nullptr, 8, ENET_PACKET_FLAG_RELIABLE);
 				encode_uint32(SYSMSG_REMOVE_PEER, &packet->data[0]);
 				encode_uint32(p_peer, &packet->data[4]);
-				enet_peer_send(E->get(), SYSCH_CONFIG, packet);
+				_send_to_peer(E->get(), E->key(), SYSCH_CONFIG, packet);
 			}
 		}
 
@@ -499,7 +665,9 @@ void NetworkedMultiplayerENet::disconnect_peer(int p_peer, bool now) {
 
 		emit_signal("peer_disconnected", p_peer);
 		peer_map.erase(p_peer);
+		peer_connect_ids.erase(p_peer);
 	} else {
+		MutexLock lock(host_mutex);
 		enet_peer_disconnect_later(peer_map[p_peer], 0);
 	}
 }
@@ -566,7 +734,7 @@ Error NetworkedMultiplayerENet::put_packet(const uint8_t *p_buffer, int p_buffer
 
 	if (server) {
 		if (target_peer == 0) {
-			enet_host_broadcast(host, channel, packet);
+			_send_to_peer(nullptr, 0, channel, packet);
 		} else if (target_peer < 0) {
 			// Send to all but one
 			// and make copies for sending
@@ -580,19 +748,21 @@ Error NetworkedMultiplayerENet::put_packet(const uint8_t *p_buffer, int p_buffer
 
 				ENetPacket *packet2 = enet_packet_create(packet->data, packet->dataLength, packet_flags);
 
-				enet_peer_send(F->get(), channel, packet2);
+				_send_to_peer(F->get(), F->key(), channel, packet2);
 			}
 
 			enet_packet_destroy(packet); // Original packet no longer needed
 		} else {
-			enet_peer_send(E->get(), channel, packet);
+			_send_to_peer(E->get(), target_peer, channel, packet);
 		}
 	} else {
 		ERR_FAIL_COND_V(!peer_map.has(1), ERR_BUG);
-		enet_peer_send(peer_map[1], channel, packet); // Send to server for broadcast
+		_send_to_peer(peer_map[1], 1, channel, packet); // Send to server for broadcast
 	}
 
-	enet_host_flush(host);
+	if (!threaded) {
+		enet_host_flush(host);
+	}
 
 	return OK;
 }
@@ -644,6 +814,7 @@ void NetworkedMultiplayerENet::set_refuse_new_connections(bool p_enable) {
 	refuse_connections = p_enable;
 #ifdef GODOT_ENET
 	if (active) {
+		MutexLock lock(host_mutex);
 		enet_host_refuse_new_connections(host, p_enable);
 	}
 #endif
@@ -822,6 +993,16 @@ bool NetworkedMultiplayerENet::is_server_relay_enabled() const {
 	return server_relay;
 }
 
+void NetworkedMultiplayerENet::set_threaded(bool p_threaded) {
+	ERR_FAIL_COND_MSG(active, "The threaded mode can't be toggled while the multiplayer instance is active.");
+
+	threaded = p_threaded;
+}
+
+bool NetworkedMultiplayerENet::is_threaded() const {
+	return threaded;
+}
+
 void NetworkedMultiplayerENet::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("create_server", "port", "max_clients", "in_bandwidth", "out_bandwidth"), &NetworkedMultiplayerENet::create_server, DEFVAL(32), DEFVAL(0), DEFVAL(0));
 	ClassDB::bind_method(D_METHOD("create_client", "address", "port", "in_bandwidth", "out_bandwidth", "client_port"), &NetworkedMultiplayerENet::create_client, DEFVAL(0), DEFVAL(0), DEFVAL(0));
@@ -849,12 +1030,15 @@ void NetworkedMultiplayerENet::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_always_ordered"), &NetworkedMultiplayerENet::is_always_ordered);
 	ClassDB::bind_method(D_METHOD("set_server_relay_enabled", "enabled"), &NetworkedMultiplayerENet::set_server_relay_enabled);
 	ClassDB::bind_method(D_METHOD("is_server_relay_enabled"), &NetworkedMultiplayerENet::is_server_relay_enabled);
+	ClassDB::bind_method(D_METHOD("set_threaded", "threaded"), &NetworkedMultiplayerENet::set_threaded);
+	ClassDB::bind_method(D_METHOD("is_threaded"), &NetworkedMultiplayerENet::is_threaded);
 
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "compression_mode", PROPERTY_HINT_ENUM, "None,Range Coder,FastLZ,ZLib,ZStd"), "set_compression_mode", "get_compression_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "transfer_channel"), "set_transfer_channel", "get_transfer_channel");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "channel_count"), "set_channel_count", "get_channel_count");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "always_ordered"), "set_always_ordered", "is_always_ordered");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "server_relay"), "set_server_relay_enabled", "is_server_relay_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "threaded"), "set_threaded", "is_threaded");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "dtls_verify"), "set_dtls_verify_enabled", "is_dtls_verify_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_dtls"), "set_dtls_enabled", "is_dtls_enabled");
 
@@ -879,6 +1063,9 @@ NetworkedMultiplayerENet::NetworkedMultiplayerENet() {
 	always_ordered = false;
 	connection_status = CONNECTION_DISCONNECTED;
 	compression_mode = COMPRESS_NONE;
+	threaded = false;
+	thread = nullptr;
+	thread_exit.store(false);
 	enet_compressor.context = this;
 	enet_compressor.compress = enet_compress;
 	enet_compressor.decompress = enet_decompress;
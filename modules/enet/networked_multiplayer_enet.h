@@ -34,9 +34,14 @@
 #include "core/crypto/crypto.h"
 #include "core/io/compression.h"
 #include "core/io/networked_multiplayer_peer.h"
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
+#include "core/templates/local_vector.h"
 
 #include <enet/enet.h>
 
+#include <atomic>
+
 class NetworkedMultiplayerENet : public NetworkedMultiplayerPeer {
 	GDCLASS(NetworkedMultiplayerENet, NetworkedMultiplayerPeer);
 
@@ -83,6 +88,7 @@ private:
 	ConnectionStatus connection_status;
 
 	Map<int, ENetPeer *> peer_map;
+	Map<int, enet_uint32> peer_connect_ids; // ENet connection of each peer, to tell reused peer slots apart.
 
 	struct Packet {
 		ENetPacket *packet;
@@ -94,6 +100,75 @@ private:
 
 	List<Packet> incoming_packets;
 
+	// Single producer, single consumer queue used to talk with the network thread.
+	template <class T>
+	class ThreadQueue {
+		LocalVector<T> buffer;
+		std::atomic<uint32_t> read_pos = { 0 };
+		std::atomic<uint32_t> write_pos = { 0 };
+
+	public:
+		void resize(uint32_t p_size) { // Must be a power of two.
+			buffer.resize(p_size);
+			read_pos.store(0);
+			write_pos.store(0);
+		}
+		bool push(const T &p_value) {
+			const uint32_t write = write_pos.load(std::memory_order_relaxed);
+			if (write - read_pos.load(std::memory_order_acquire) == buffer.size()) {
+				return false; // Full.
+			}
+			buffer[write & (buffer.size() - 1)] = p_value;
+			write_pos.store(write + 1, std::memory_order_release);
+			return true;
+		}
+		bool pop(T &r_value) {
+			const uint32_t read = read_pos.load(std::memory_order_relaxed);
+			if (read == write_pos.load(std::memory_order_acquire)) {
+				return false; // Empty.
+			}
+			r_value = buffer[read & (buffer.size() - 1)];
+			read_pos.store(read + 1, std::memory_order_release);
+			return true;
+		}
+		bool is_full() const {
+			return write_pos.load(std::memory_order_acquire) - read_pos.load(std::memory_order_acquire) == buffer.size();
+		}
+	};
+
+	struct OutgoingPacket {
+		ENetPacket *packet = nullptr;
+		ENetPeer *peer = nullptr; // Null to broadcast.
+		int peer_id = 0;
+		enet_uint32 connect_id = 0; // Connection the packet was queued for.
+		int channel = 0;
+	};
+
+	struct ThreadEvent {
+		ENetEvent event;
+		enet_uint32 connect_id = 0; // The peer's connection when the event was received.
+	};
+
+	enum {
+		THREAD_QUEUE_SIZE = 4096,
+		THREAD_WAIT_MSEC = 1,
+	};
+
+	bool threaded;
+	Thread *thread;
+	std::atomic<bool> thread_exit;
+	Mutex host_mutex; // Guards ENet calls made outside of the network thread.
+	ThreadQueue<ThreadEvent> thread_events;
+	ThreadQueue<OutgoingPacket> thread_outgoing;
+
+	static void _thread_func(void *p_userdata);
+	void _thread_service();
+	void _thread_send_outgoing();
+	void _start_thread();
+	void _stop_thread();
+	void _process_event(ENetEvent &p_event, enet_uint32 p_connect_id);
+	void _send_to_peer(ENetPeer *p_peer, int p_peer_id, int p_channel, ENetPacket *p_packet);
+
 	Packet current_packet;
 
 	uint32_t _gen_unique_id() const;
@@ -165,6 +240,8 @@ public:
 	bool is_always_ordered() const;
 	void set_server_relay_enabled(bool p_enabled);
 	bool is_server_relay_enabled() const;
+	void set_threaded(bool p_threaded);
+	bool is_threaded() const;
 
 	NetworkedMultiplayerENet();
 	~NetworkedMultiplayerENet();
@@ -116,12 +116,13 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		return path;
 	}
 
-	std::vector<gd::NavigationPoly> navigation_polys;
+	// Scratch data, allocated from the frame arena of the calling thread.
+	FrameVector<gd::NavigationPoly> navigation_polys;
 	navigation_polys.reserve(polygons.size() * 0.75);
 
 	// The elements indices in the `navigation_polys`.
 	int least_cost_id(-1);
-	List<uint32_t> open_list;
+	FrameVector<uint32_t> open_list;
 	bool found_route = false;
 
 	navigation_polys.push_back(gd::NavigationPoly(begin_poly));
@@ -161,13 +162,11 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 				const float new_distance = least_cost_poly->poly->center.distance_to(edge.other_polygon->center) + least_cost_poly->traveled_distance;
 #endif
 
-				auto it = std::find(
-						navigation_polys.begin(),
-						navigation_polys.end(),
-						gd::NavigationPoly(edge.other_polygon));
+				int64_t visited_id = navigation_polys.find(gd::NavigationPoly(edge.other_polygon));
 
-				if (it != navigation_polys.end()) {
+				if (visited_id != -1) {
 					// Oh this was visited already, can we win the cost?
+					gd::NavigationPoly *it = &navigation_polys[visited_id];
 					if (it->traveled_distance > new_distance) {
 						it->prev_navigation_poly_id = least_cost_id;
 						it->back_navigation_edge = edge.other_edge;
@@ -236,8 +235,8 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		least_cost_id = -1;
 		float least_cost = 1e30;
 
-		for (auto element = open_list.front(); element != nullptr; element = element->next()) {
-			gd::NavigationPoly *np = &navigation_polys[element->get()];
+		for (uint32_t i = 0; i < open_list.size(); i++) {
+			gd::NavigationPoly *np = &navigation_polys[open_list[i]];
 			float cost = np->traveled_distance;
 #ifdef USE_ENTRY_POINT
 			cost += np->entry.distance_to(end_point);
@@ -746,7 +745,7 @@ void NavMap::dispatch_callbacks() {
 	}
 }
 
-void NavMap::clip_path(const std::vector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly) const {
+void NavMap::clip_path(const FrameVector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly) const {
 	Vector3 from = path[path.size() - 1];
 
 	if (from.distance_to(p_to_point) < CMP_EPSILON) {
@@ -74,7 +74,8 @@ void NavRegion::update_polygons() {
 		return;
 	}
 
-	Vector<Vector3> vertices = mesh->get_vertices();
+	// Vertices are shared by several polygons, transform them all at once.
+	Vector<Vector3> vertices = transform.xform(mesh->get_vertices());
 	int len = vertices.size();
 	if (len == 0) {
 		return;
@@ -105,15 +106,15 @@ void NavRegion::update_polygons() {
 				break;
 			}
 
-			Vector3 point_position = transform.xform(vertices_r[idx]);
+			Vector3 point_position = vertices_r[idx];
 			p.points[j].pos = point_position;
 			p.points[j].key = map->get_point_key(point_position);
 
 			center += point_position; // Composing the center of the polygon
 
 			if (j >= 2) {
-				Vector3 epa = transform.xform(vertices_r[indices[j - 2]]);
-				Vector3 epb = transform.xform(vertices_r[indices[j - 1]]);
+				Vector3 epa = vertices_r[indices[j - 2]];
+				Vector3 epb = vertices_r[indices[j - 1]];
 
 				sum += map->get_up().dot((epb - epa).cross(point_position - epa));
 			}
@@ -118,7 +118,7 @@ struct Connection {
 struct NavigationPoly {
 	uint32_t self_id = 0;
 	/// This poly.
-	const Polygon *poly;
+	const Polygon *poly = nullptr;
 	/// The previous navigation poly (id in the `navigation_poly` array).
 	int prev_navigation_poly_id = -1;
 	/// The edge id in this `Poly` to reach the `prev_navigation_poly_id`.
@@ -128,6 +128,7 @@ struct NavigationPoly {
 	/// The distance to the destination.
 	float traveled_distance = 0.0;
 
+	NavigationPoly() {}
 	NavigationPoly(const Polygon *p_poly) :
 			poly(p_poly) {}
 
@@ -34,6 +34,7 @@
 
 #include "core/math/quick_hull.h"
 #include "core/os/thread.h"
+#include "core/templates/thread_work_pool.h"
 #include "scene/3d/collision_shape_3d.h"
 #include "scene/3d/mesh_instance_3d.h"
 #include "scene/3d/physics_body_3d.h"
@@ -68,7 +69,20 @@ void NavigationMeshGenerator::_add_vertex(const Vector3 &p_vec3, Vector<float> &
 	p_verticies.push_back(p_vec3.z);
 }
 
-void NavigationMeshGenerator::_add_mesh(const Ref<Mesh> &p_mesh, const Transform &p_xform, Vector<float> &p_verticies, Vector<int> &p_indices) {
+bool NavigationMeshGenerator::_is_in_bake_bounds(const AABB &p_aabb, const AABB *p_bake_bounds) {
+	if (!p_bake_bounds) {
+		return true;
+	}
+	// Tiles span the whole height, so only the horizontal extents matter.
+	return p_aabb.position.x <= p_bake_bounds->position.x + p_bake_bounds->size.x && p_aabb.position.x + p_aabb.size.x >= p_bake_bounds->position.x &&
+			p_aabb.position.z <= p_bake_bounds->position.z + p_bake_bounds->size.z && p_aabb.position.z + p_aabb.size.z >= p_bake_bounds->position.z;
+}
+
+void NavigationMeshGenerator::_add_mesh(const Ref<Mesh> &p_mesh, const Transform &p_xform, Vector<float> &p_verticies, Vector<int> &p_indices, const AABB *p_bake_bounds) {
+	if (!_is_in_bake_bounds(p_xform.xform(p_mesh->get_aabb()), p_bake_bounds)) {
+		return;
+	}
+
 	int current_vertex_count;
 
 	for (int i = 0; i < p_mesh->get_surface_count(); i++) {
@@ -123,7 +137,17 @@ void NavigationMeshGenerator::_add_mesh(const Ref<Mesh> &p_mesh, const Transform
 	}
 }
 
-void NavigationMeshGenerator::_add_faces(const PackedVector3Array &p_faces, const Transform &p_xform, Vector<float> &p_verticies, Vector<int> &p_indices) {
+void NavigationMeshGenerator::_add_faces(const PackedVector3Array &p_faces, const Transform &p_xform, Vector<float> &p_verticies, Vector<int> &p_indices, const AABB *p_bake_bounds) {
+	if (p_bake_bounds && p_faces.size()) {
+		AABB aabb(p_faces[0], Vector3());
+		for (int i = 1; i < p_faces.size(); i++) {
+			aabb.expand_to(p_faces[i]);
+		}
+		if (!_is_in_bake_bounds(p_xform.xform(aabb), p_bake_bounds)) {
+			return;
+		}
+	}
+
 	int face_count = p_faces.size() / 3;
 	int current_vertex_count = p_verticies.size() / 3;
 
@@ -138,12 +162,12 @@ void NavigationMeshGenerator::_add_faces(const PackedVector3Array &p_faces, cons
 	}
 }
 
-void NavigationMeshGenerator::_parse_geometry(Transform p_accumulated_transform, Node *p_node, Vector<float> &p_verticies, Vector<int> &p_indices, int p_generate_from, uint32_t p_collision_mask, bool p_recurse_children) {
+void NavigationMeshGenerator::_parse_geometry(Transform p_accumulated_transform, Node *p_node, Vector<float> &p_verticies, Vector<int> &p_indices, int p_generate_from, uint32_t p_collision_mask, bool p_recurse_children, const AABB *p_bake_bounds) {
 	if (Object::cast_to<MeshInstance3D>(p_node) && p_generate_from != NavigationMesh::PARSED_GEOMETRY_STATIC_COLLIDERS) {
 		MeshInstance3D *mesh_instance = Object::cast_to<MeshInstance3D>(p_node);
 		Ref<Mesh> mesh = mesh_instance->get_mesh();
 		if (mesh.is_valid()) {
-			_add_mesh(mesh, p_accumulated_transform * mesh_instance->get_transform(), p_verticies, p_indices);
+			_add_mesh(mesh, p_accumulated_transform * mesh_instance->get_transform(), p_verticies, p_indices, p_bake_bounds);
 		}
 	}
 
@@ -154,7 +178,7 @@ void NavigationMeshGenerator::_parse_geometry(Transform p_accumulated_transform,
 		if (!meshes.empty()) {
 			Ref<Mesh> mesh = meshes[1];
 			if (mesh.is_valid()) {
-				_add_mesh(mesh, p_accumulated_transform * csg_shape->get_transform(), p_verticies, p_indices);
+				_add_mesh(mesh, p_accumulated_transform * csg_shape->get_transform(), p_verticies, p_indices, p_bake_bounds);
 			}
 		}
 	}
@@ -212,7 +236,7 @@ void NavigationMeshGenerator::_parse_geometry(Transform p_accumulated_transform,
 
 					ConcavePolygonShape3D *concave_polygon = Object::cast_to<ConcavePolygonShape3D>(*s);
 					if (concave_polygon) {
-						_add_faces(concave_polygon->get_faces(), transform, p_verticies, p_indices);
+						_add_faces(concave_polygon->get_faces(), transform, p_verticies, p_indices, p_bake_bounds);
 					}
 
 					ConvexPolygonShape3D *convex_polygon = Object::cast_to<ConvexPolygonShape3D>(*s);
@@ -235,12 +259,12 @@ void NavigationMeshGenerator::_parse_geometry(Transform p_accumulated_transform,
 								}
 							}
 
-							_add_faces(faces, transform, p_verticies, p_indices);
+							_add_faces(faces, transform, p_verticies, p_indices, p_bake_bounds);
 						}
 					}
 
 					if (mesh.is_valid()) {
-						_add_mesh(mesh, transform, p_verticies, p_indices);
+						_add_mesh(mesh, transform, p_verticies, p_indices, p_bake_bounds);
 					}
 				}
 			}
@@ -255,7 +279,7 @@ void NavigationMeshGenerator::_parse_geometry(Transform p_accumulated_transform,
 		for (int i = 0; i < meshes.size(); i += 2) {
 			Ref<Mesh> mesh = meshes[i + 1];
 			if (mesh.is_valid()) {
-				_add_mesh(mesh, p_accumulated_transform * xform * meshes[i], p_verticies, p_indices);
+				_add_mesh(mesh, p_accumulated_transform * xform * meshes[i], p_verticies, p_indices, p_bake_bounds);
 			}
 		}
 	}
@@ -268,19 +292,17 @@ void NavigationMeshGenerator::_parse_geometry(Transform p_accumulated_transform,
 
 	if (p_recurse_children) {
 		for (int i = 0; i < p_node->get_child_count(); i++) {
-			_parse_geometry(p_accumulated_transform, p_node->get_child(i), p_verticies, p_indices, p_generate_from, p_collision_mask, p_recurse_children);
+			_parse_geometry(p_accumulated_transform, p_node->get_child(i), p_verticies, p_indices, p_generate_from, p_collision_mask, p_recurse_children, p_bake_bounds);
 		}
 	}
 }
 
-void NavigationMeshGenerator::_convert_detail_mesh_to_native_navigation_mesh(const rcPolyMeshDetail *p_detail_mesh, Ref<NavigationMesh> p_nav_mesh) {
-	Vector<Vector3> nav_vertices;
-
+void NavigationMeshGenerator::_convert_detail_mesh_to_native_navigation_mesh(const rcPolyMeshDetail *p_detail_mesh, BakedTile &r_tile) {
+	r_tile.vertices.resize(p_detail_mesh->nverts);
 	for (int i = 0; i < p_detail_mesh->nverts; i++) {
 		const float *v = &p_detail_mesh->verts[i * 3];
-		nav_vertices.push_back(Vector3(v[0], v[1], v[2]));
+		r_tile.vertices.write[i] = Vector3(v[0], v[1], v[2]);
 	}
-	p_nav_mesh->set_vertices(nav_vertices);
 
 	for (int i = 0; i < p_detail_mesh->nmeshes; i++) {
 		const unsigned int *m = &p_detail_mesh->meshes[i * 4];
@@ -289,46 +311,54 @@ void NavigationMeshGenerator::_convert_detail_mesh_to_native_navigation_mesh(con
 		const unsigned int ntris = m[3];
 		const unsigned char *tris = &p_detail_mesh->tris[btris * 4];
 		for (unsigned int j = 0; j < ntris; j++) {
-			Vector<int> nav_indices;
-			nav_indices.resize(3);
 			// Polygon order in recast is opposite than godot's
-			nav_indices.write[0] = ((int)(bverts + tris[j * 4 + 0]));
-			nav_indices.write[1] = ((int)(bverts + tris[j * 4 + 2]));
-			nav_indices.write[2] = ((int)(bverts + tris[j * 4 + 1]));
-			p_nav_mesh->add_polygon(nav_indices);
+			r_tile.triangles.push_back((int)(bverts + tris[j * 4 + 0]));
+			r_tile.triangles.push_back((int)(bverts + tris[j * 4 + 2]));
+			r_tile.triangles.push_back((int)(bverts + tris[j * 4 + 1]));
 		}
 	}
 }
 
-void NavigationMeshGenerator::_build_recast_navigation_mesh(
-		Ref<NavigationMesh> p_nav_mesh,
-#ifdef TOOLS_ENABLED
-		EditorProgress *ep,
-#endif
-		rcHeightfield *hf,
-		rcCompactHeightfield *chf,
-		rcContourSet *cset,
-		rcPolyMesh *poly_mesh,
-		rcPolyMeshDetail *detail_mesh,
-		Vector<float> &vertices,
-		Vector<int> &indices) {
-	rcContext ctx;
+int NavigationMeshGenerator::_get_tile_border_size(Ref<NavigationMesh> p_nav_mesh) {
+	// Recast needs a border of a few cells around each tile, so the polygons at the edges of neighbor tiles match.
+	return (int)Math::ceil(p_nav_mesh->get_agent_radius() / p_nav_mesh->get_cell_size()) + 3;
+}
 
-#ifdef TOOLS_ENABLED
-	if (ep) {
-		ep->step(TTR("Setting up Configuration..."), 1);
-	}
-#endif
+AABB NavigationMeshGenerator::_get_tile_bake_bounds(Ref<NavigationMesh> p_nav_mesh, const AABB &p_bounds) {
+	// The tiles touched by the bounds, plus the border their triangles are gathered from.
+	const float tile_width = p_nav_mesh->get_tile_size() * p_nav_mesh->get_cell_size();
+	const float border = _get_tile_border_size(p_nav_mesh) * p_nav_mesh->get_cell_size();
+
+	AABB bake_bounds = p_bounds;
+	bake_bounds.position.x = Math::floor(p_bounds.position.x / tile_width) * tile_width - border;
+	bake_bounds.position.z = Math::floor(p_bounds.position.z / tile_width) * tile_width - border;
+	bake_bounds.size.x = (Math::floor((p_bounds.position.x + p_bounds.size.x) / tile_width) + 1) * tile_width + border - bake_bounds.position.x;
+	bake_bounds.size.z = (Math::floor((p_bounds.position.z + p_bounds.size.z) / tile_width) + 1) * tile_width + border - bake_bounds.position.z;
+	return bake_bounds;
+}
 
-	const float *verts = vertices.ptr();
-	const int nverts = vertices.size() / 3;
-	const int *tris = indices.ptr();
-	const int ntris = indices.size() / 3;
+bool NavigationMeshGenerator::_setup_tile_bake(Ref<NavigationMesh> p_nav_mesh, const Vector<float> &p_vertices, const Vector<int> &p_indices, const AABB *p_bounds, TileBakeData &r_data) {
+	r_data.verts = p_vertices.ptr();
+	r_data.nverts = p_vertices.size() / 3;
+	r_data.tris = p_indices.ptr();
+	const int ntris = p_indices.size() / 3;
 
 	float bmin[3], bmax[3];
-	rcCalcBounds(verts, nverts, bmin, bmax);
-
-	rcConfig cfg;
+	if (r_data.nverts > 0) {
+		rcCalcBounds(r_data.verts, r_data.nverts, bmin, bmax);
+	} else {
+		ERR_FAIL_COND_V(!p_bounds, false);
+		// No geometry left, the tiles are only rebuilt to clear them.
+		const Vector3 end = p_bounds->position + p_bounds->size;
+		bmin[0] = p_bounds->position.x;
+		bmin[1] = p_bounds->position.y;
+		bmin[2] = p_bounds->position.z;
+		bmax[0] = end.x;
+		bmax[1] = end.y;
+		bmax[2] = end.z;
+	}
+
+	rcConfig &cfg = r_data.cfg;
 	memset(&cfg, 0, sizeof(cfg));
 
 	cfg.cs = p_nav_mesh->get_cell_size();
@@ -345,136 +375,291 @@ void NavigationMeshGenerator::_build_recast_navigation_mesh(
 	cfg.detailSampleDist = p_nav_mesh->get_detail_sample_distance() < 0.9f ? 0 : p_nav_mesh->get_cell_size() * p_nav_mesh->get_detail_sample_distance();
 	cfg.detailSampleMaxError = p_nav_mesh->get_cell_height() * p_nav_mesh->get_detail_sample_max_error();
 
-	cfg.bmin[0] = bmin[0];
-	cfg.bmin[1] = bmin[1];
-	cfg.bmin[2] = bmin[2];
-	cfg.bmax[0] = bmax[0];
-	cfg.bmax[1] = bmax[1];
-	cfg.bmax[2] = bmax[2];
+	rcVcopy(cfg.bmin, bmin);
+	rcVcopy(cfg.bmax, bmax);
 
-#ifdef TOOLS_ENABLED
-	if (ep) {
-		ep->step(TTR("Calculating grid size..."), 2);
+	r_data.partition_type = p_nav_mesh->get_sample_partition_type();
+	r_data.filter_low_hanging_obstacles = p_nav_mesh->get_filter_low_hanging_obstacles();
+	r_data.filter_ledge_spans = p_nav_mesh->get_filter_ledge_spans();
+	r_data.filter_walkable_low_height_spans = p_nav_mesh->get_filter_walkable_low_height_spans();
+
+	if (p_nav_mesh->get_tile_size() <= 0) {
+		// Single tile covering all the geometry.
+		rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
+
+		Vector<int> tile_tris;
+		tile_tris.resize(ntris);
+		for (int i = 0; i < ntris; i++) {
+			tile_tris.write[i] = i;
+		}
+
+		r_data.tiles.push_back(Vector2i());
+		r_data.tile_tris.push_back(tile_tris);
+		return true;
 	}
-#endif
-	rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
 
-#ifdef TOOLS_ENABLED
-	if (ep) {
-		ep->step(TTR("Creating heightfield..."), 3);
+	cfg.tileSize = p_nav_mesh->get_tile_size();
+	cfg.borderSize = _get_tile_border_size(p_nav_mesh);
+	cfg.width = cfg.tileSize + cfg.borderSize * 2;
+	cfg.height = cfg.tileSize + cfg.borderSize * 2;
+
+	const float tile_width = cfg.tileSize * cfg.cs;
+	const float border = cfg.borderSize * cfg.cs;
+
+	int min_x, min_z, max_x, max_z;
+	if (p_bounds) {
+		min_x = (int)Math::floor(p_bounds->position.x / tile_width);
+		min_z = (int)Math::floor(p_bounds->position.z / tile_width);
+		max_x = (int)Math::floor((p_bounds->position.x + p_bounds->size.x) / tile_width);
+		max_z = (int)Math::floor((p_bounds->position.z + p_bounds->size.z) / tile_width);
+	} else {
+		min_x = (int)Math::floor(bmin[0] / tile_width);
+		min_z = (int)Math::floor(bmin[2] / tile_width);
+		max_x = (int)Math::floor(bmax[0] / tile_width);
+		max_z = (int)Math::floor(bmax[2] / tile_width);
 	}
-#endif
-	hf = rcAllocHeightfield();
 
-	ERR_FAIL_COND(!hf);
-	ERR_FAIL_COND(!rcCreateHeightfield(&ctx, *hf, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch));
+	const int tiles_x = max_x - min_x + 1;
+	const int tiles_z = max_z - min_z + 1;
+	ERR_FAIL_COND_V(tiles_x <= 0 || tiles_z <= 0, false);
 
-#ifdef TOOLS_ENABLED
-	if (ep) {
-		ep->step(TTR("Marking walkable triangles..."), 4);
+	r_data.tiles.resize(tiles_x * tiles_z);
+	r_data.tile_tris.resize(tiles_x * tiles_z);
+	for (int z = 0; z < tiles_z; z++) {
+		for (int x = 0; x < tiles_x; x++) {
+			r_data.tiles.write[z * tiles_x + x] = Vector2i(min_x + x, min_z + z);
+		}
 	}
-#endif
+
+	// Bin the triangles into every tile they overlap, border included.
+	for (int i = 0; i < ntris; i++) {
+		const float *v0 = &r_data.verts[r_data.tris[i * 3 + 0] * 3];
+		const float *v1 = &r_data.verts[r_data.tris[i * 3 + 1] * 3];
+		const float *v2 = &r_data.verts[r_data.tris[i * 3 + 2] * 3];
+
+		const int x0 = MAX(min_x, (int)Math::floor((MIN(v0[0], MIN(v1[0], v2[0])) - border) / tile_width));
+		const int x1 = MIN(max_x, (int)Math::floor((MAX(v0[0], MAX(v1[0], v2[0])) + border) / tile_width));
+		const int z0 = MAX(min_z, (int)Math::floor((MIN(v0[2], MIN(v1[2], v2[2])) - border) / tile_width));
+		const int z1 = MIN(max_z, (int)Math::floor((MAX(v0[2], MAX(v1[2], v2[2])) + border) / tile_width));
+
+		for (int z = z0; z <= z1; z++) {
+			for (int x = x0; x <= x1; x++) {
+				r_data.tile_tris.write[(z - min_z) * tiles_x + (x - min_x)].push_back(i);
+			}
+		}
+	}
+
+	return true;
+}
+
+bool NavigationMeshGenerator::_build_recast_tile(const rcConfig &p_cfg, const TileBakeData *p_data, const Vector<int> &p_tile_tris, rcHeightfield *&hf, rcCompactHeightfield *&chf, rcContourSet *&cset, rcPolyMesh *&poly_mesh, rcPolyMeshDetail *&detail_mesh) {
+	rcContext ctx;
+
+	const int ntris = p_tile_tris.size();
+	Vector<int> tris;
+	tris.resize(ntris * 3);
+	for (int i = 0; i < ntris; i++) {
+		const int *t = &p_data->tris[p_tile_tris[i] * 3];
+		tris.write[i * 3 + 0] = t[0];
+		tris.write[i * 3 + 1] = t[1];
+		tris.write[i * 3 + 2] = t[2];
+	}
+
+	hf = rcAllocHeightfield();
+
+	ERR_FAIL_COND_V(!hf, false);
+	ERR_FAIL_COND_V(!rcCreateHeightfield(&ctx, *hf, p_cfg.width, p_cfg.height, p_cfg.bmin, p_cfg.bmax, p_cfg.cs, p_cfg.ch), false);
+
 	{
 		Vector<unsigned char> tri_areas;
 		tri_areas.resize(ntris);
 
-		ERR_FAIL_COND(tri_areas.size() == 0);
+		ERR_FAIL_COND_V(tri_areas.size() == 0, false);
 
 		memset(tri_areas.ptrw(), 0, ntris * sizeof(unsigned char));
-		rcMarkWalkableTriangles(&ctx, cfg.walkableSlopeAngle, verts, nverts, tris, ntris, tri_areas.ptrw());
+		rcMarkWalkableTriangles(&ctx, p_cfg.walkableSlopeAngle, p_data->verts, p_data->nverts, tris.ptr(), ntris, tri_areas.ptrw());
 
-		ERR_FAIL_COND(!rcRasterizeTriangles(&ctx, verts, nverts, tris, tri_areas.ptr(), ntris, *hf, cfg.walkableClimb));
+		ERR_FAIL_COND_V(!rcRasterizeTriangles(&ctx, p_data->verts, p_data->nverts, tris.ptr(), tri_areas.ptr(), ntris, *hf, p_cfg.walkableClimb), false);
 	}
 
-	if (p_nav_mesh->get_filter_low_hanging_obstacles()) {
-		rcFilterLowHangingWalkableObstacles(&ctx, cfg.walkableClimb, *hf);
+	if (p_data->filter_low_hanging_obstacles) {
+		rcFilterLowHangingWalkableObstacles(&ctx, p_cfg.walkableClimb, *hf);
 	}
-	if (p_nav_mesh->get_filter_ledge_spans()) {
-		rcFilterLedgeSpans(&ctx, cfg.walkableHeight, cfg.walkableClimb, *hf);
+	if (p_data->filter_ledge_spans) {
+		rcFilterLedgeSpans(&ctx, p_cfg.walkableHeight, p_cfg.walkableClimb, *hf);
 	}
-	if (p_nav_mesh->get_filter_walkable_low_height_spans()) {
-		rcFilterWalkableLowHeightSpans(&ctx, cfg.walkableHeight, *hf);
+	if (p_data->filter_walkable_low_height_spans) {
+		rcFilterWalkableLowHeightSpans(&ctx, p_cfg.walkableHeight, *hf);
 	}
 
-#ifdef TOOLS_ENABLED
-	if (ep) {
-		ep->step(TTR("Constructing compact heightfield..."), 5);
-	}
-#endif
-
 	chf = rcAllocCompactHeightfield();
 
-	ERR_FAIL_COND(!chf);
-	ERR_FAIL_COND(!rcBuildCompactHeightfield(&ctx, cfg.walkableHeight, cfg.walkableClimb, *hf, *chf));
+	ERR_FAIL_COND_V(!chf, false);
+	ERR_FAIL_COND_V(!rcBuildCompactHeightfield(&ctx, p_cfg.walkableHeight, p_cfg.walkableClimb, *hf, *chf), false);
 
 	rcFreeHeightField(hf);
 	hf = nullptr;
 
-#ifdef TOOLS_ENABLED
-	if (ep) {
-		ep->step(TTR("Eroding walkable area..."), 6);
+	ERR_FAIL_COND_V(!rcErodeWalkableArea(&ctx, p_cfg.walkableRadius, *chf), false);
+
+	if (p_data->partition_type == NavigationMesh::SAMPLE_PARTITION_WATERSHED) {
+		ERR_FAIL_COND_V(!rcBuildDistanceField(&ctx, *chf), false);
+		ERR_FAIL_COND_V(!rcBuildRegions(&ctx, *chf, p_cfg.borderSize, p_cfg.minRegionArea, p_cfg.mergeRegionArea), false);
+	} else if (p_data->partition_type == NavigationMesh::SAMPLE_PARTITION_MONOTONE) {
+		ERR_FAIL_COND_V(!rcBuildRegionsMonotone(&ctx, *chf, p_cfg.borderSize, p_cfg.minRegionArea, p_cfg.mergeRegionArea), false);
+	} else {
+		ERR_FAIL_COND_V(!rcBuildLayerRegions(&ctx, *chf, p_cfg.borderSize, p_cfg.minRegionArea), false);
 	}
-#endif
 
-	ERR_FAIL_COND(!rcErodeWalkableArea(&ctx, cfg.walkableRadius, *chf));
+	cset = rcAllocContourSet();
+
+	ERR_FAIL_COND_V(!cset, false);
+	ERR_FAIL_COND_V(!rcBuildContours(&ctx, *chf, p_cfg.maxSimplificationError, p_cfg.maxEdgeLen, *cset), false);
+
+	poly_mesh = rcAllocPolyMesh();
+	ERR_FAIL_COND_V(!poly_mesh, false);
+	ERR_FAIL_COND_V(!rcBuildPolyMesh(&ctx, *cset, p_cfg.maxVertsPerPoly, *poly_mesh), false);
+
+	detail_mesh = rcAllocPolyMeshDetail();
+	ERR_FAIL_COND_V(!detail_mesh, false);
+	ERR_FAIL_COND_V(!rcBuildPolyMeshDetail(&ctx, *poly_mesh, *chf, p_cfg.detailSampleDist, p_cfg.detailSampleMaxError, *detail_mesh), false);
+
+	return true;
+}
+
+void NavigationMeshGenerator::_build_tile(uint32_t p_index, TileBakeData *p_data) {
+	const Vector<int> &tile_tris = p_data->tile_tris[p_index];
+	if (tile_tris.empty()) {
+		return; // Nothing to walk on, the tile stays empty.
+	}
+
+	rcConfig cfg = p_data->cfg;
+	if (cfg.tileSize > 0) {
+		const Vector2i &tile = p_data->tiles[p_index];
+		const float tile_width = cfg.tileSize * cfg.cs;
+		const float border = cfg.borderSize * cfg.cs;
+		cfg.bmin[0] = tile.x * tile_width - border;
+		cfg.bmin[2] = tile.y * tile_width - border;
+		cfg.bmax[0] = (tile.x + 1) * tile_width + border;
+		cfg.bmax[2] = (tile.y + 1) * tile_width + border;
+	}
+
+	rcHeightfield *hf = nullptr;
+	rcCompactHeightfield *chf = nullptr;
+	rcContourSet *cset = nullptr;
+	rcPolyMesh *poly_mesh = nullptr;
+	rcPolyMeshDetail *detail_mesh = nullptr;
+
+	if (_build_recast_tile(cfg, p_data, tile_tris, hf, chf, cset, poly_mesh, detail_mesh)) {
+		_convert_detail_mesh_to_native_navigation_mesh(detail_mesh, p_data->baked_tiles.write[p_index]);
+	}
+
+	rcFreeHeightField(hf);
+	rcFreeCompactHeightfield(chf);
+	rcFreeContourSet(cset);
+	rcFreePolyMesh(poly_mesh);
+	rcFreePolyMeshDetail(detail_mesh);
+}
 
+void NavigationMeshGenerator::_build_recast_navigation_mesh(
+		Ref<NavigationMesh> p_nav_mesh,
+#ifdef TOOLS_ENABLED
+		EditorProgress *ep,
+#endif
+		Vector<float> &vertices,
+		Vector<int> &indices,
+		const AABB *p_bounds) {
 #ifdef TOOLS_ENABLED
 	if (ep) {
-		ep->step(TTR("Partitioning..."), 7);
+		ep->step(TTR("Setting up Configuration..."), 1);
 	}
 #endif
 
-	if (p_nav_mesh->get_sample_partition_type() == NavigationMesh::SAMPLE_PARTITION_WATERSHED) {
-		ERR_FAIL_COND(!rcBuildDistanceField(&ctx, *chf));
-		ERR_FAIL_COND(!rcBuildRegions(&ctx, *chf, 0, cfg.minRegionArea, cfg.mergeRegionArea));
-	} else if (p_nav_mesh->get_sample_partition_type() == NavigationMesh::SAMPLE_PARTITION_MONOTONE) {
-		ERR_FAIL_COND(!rcBuildRegionsMonotone(&ctx, *chf, 0, cfg.minRegionArea, cfg.mergeRegionArea));
-	} else {
-		ERR_FAIL_COND(!rcBuildLayerRegions(&ctx, *chf, 0, cfg.minRegionArea));
+	TileBakeData data;
+	if (!_setup_tile_bake(p_nav_mesh, vertices, indices, p_bounds, data)) {
+		return;
 	}
+	data.baked_tiles.resize(data.tiles.size());
 
 #ifdef TOOLS_ENABLED
 	if (ep) {
-		ep->step(TTR("Creating contours..."), 8);
+		ep->step(TTR("Building navigation mesh tiles..."), 2);
 	}
 #endif
 
-	cset = rcAllocContourSet();
-
-	ERR_FAIL_COND(!cset);
-	ERR_FAIL_COND(!rcBuildContours(&ctx, *chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *cset));
+	// Tiles only read the shared data and write their own result, so they can be built in any order.
+	ThreadWorkPool::do_shared_work(data.tiles.size(), this, &NavigationMeshGenerator::_build_tile, &data, 2);
 
 #ifdef TOOLS_ENABLED
 	if (ep) {
-		ep->step(TTR("Creating polymesh..."), 9);
+		ep->step(TTR("Converting to native navigation mesh..."), 3);
 	}
 #endif
 
-	poly_mesh = rcAllocPolyMesh();
-	ERR_FAIL_COND(!poly_mesh);
-	ERR_FAIL_COND(!rcBuildPolyMesh(&ctx, *cset, cfg.maxVertsPerPoly, *poly_mesh));
+	Vector<Vector3> nav_vertices;
+	Vector<Vector<int>> nav_polygons;
 
-	detail_mesh = rcAllocPolyMeshDetail();
-	ERR_FAIL_COND(!detail_mesh);
-	ERR_FAIL_COND(!rcBuildPolyMeshDetail(&ctx, *poly_mesh, *chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *detail_mesh));
+	if (p_bounds) {
+		// Keep the polygons of the tiles that were not rebuilt, they are found by their center.
+		Set<Vector2i> rebuilt_tiles;
+		for (int i = 0; i < data.tiles.size(); i++) {
+			rebuilt_tiles.insert(data.tiles[i]);
+		}
 
-	rcFreeCompactHeightfield(chf);
-	chf = nullptr;
-	rcFreeContourSet(cset);
-	cset = nullptr;
+		const float tile_width = data.cfg.tileSize * data.cfg.cs;
+		Vector<Vector3> old_vertices = p_nav_mesh->get_vertices();
+		Vector<int> remap;
+		remap.resize(old_vertices.size());
+		for (int i = 0; i < remap.size(); i++) {
+			remap.write[i] = -1;
+		}
 
-#ifdef TOOLS_ENABLED
-	if (ep) {
-		ep->step(TTR("Converting to native navigation mesh..."), 10);
+		for (int i = 0; i < p_nav_mesh->get_polygon_count(); i++) {
+			Vector<int> polygon = p_nav_mesh->get_polygon(i);
+			ERR_CONTINUE(polygon.size() == 0);
+
+			Vector3 center;
+			for (int j = 0; j < polygon.size(); j++) {
+				ERR_FAIL_INDEX(polygon[j], old_vertices.size());
+				center += old_vertices[polygon[j]];
+			}
+			center /= polygon.size();
+
+			if (rebuilt_tiles.has(Vector2i((int)Math::floor(center.x / tile_width), (int)Math::floor(center.z / tile_width)))) {
+				continue;
+			}
+
+			for (int j = 0; j < polygon.size(); j++) {
+				if (remap[polygon[j]] == -1) {
+					remap.write[polygon[j]] = nav_vertices.size();
+					nav_vertices.push_back(old_vertices[polygon[j]]);
+				}
+				polygon.write[j] = remap[polygon[j]];
+			}
+			nav_polygons.push_back(polygon);
+		}
 	}
-#endif
 
-	_convert_detail_mesh_to_native_navigation_mesh(detail_mesh, p_nav_mesh);
+	for (int i = 0; i < data.baked_tiles.size(); i++) {
+		const BakedTile &tile = data.baked_tiles[i];
+		const int from = nav_vertices.size();
+		nav_vertices.append_array(tile.vertices);
 
-	rcFreePolyMesh(poly_mesh);
-	poly_mesh = nullptr;
-	rcFreePolyMeshDetail(detail_mesh);
-	detail_mesh = nullptr;
+		for (int j = 0; j < tile.triangles.size(); j += 3) {
+			Vector<int> nav_indices;
+			nav_indices.resize(3);
+			nav_indices.write[0] = from + tile.triangles[j + 0];
+			nav_indices.write[1] = from + tile.triangles[j + 1];
+			nav_indices.write[2] = from + tile.triangles[j + 2];
+			nav_polygons.push_back(nav_indices);
+		}
+	}
+
+	p_nav_mesh->clear_polygons();
+	p_nav_mesh->set_vertices(nav_vertices);
+	for (int i = 0; i < nav_polygons.size(); i++) {
+		p_nav_mesh->add_polygon(nav_polygons[i]);
+	}
 }
 
 NavigationMeshGenerator *NavigationMeshGenerator::get_singleton() {
@@ -482,10 +667,33 @@ NavigationMeshGenerator *NavigationMeshGenerator::get_singleton() {
 }
 
 NavigationMeshGenerator::NavigationMeshGenerator() {
-	singleton = this;
+	if (!singleton) {
+		singleton = this;
+	}
 }
 
 NavigationMeshGenerator::~NavigationMeshGenerator() {
+	if (singleton == this) {
+		singleton = nullptr;
+	}
+}
+
+void NavigationMeshGenerator::_parse_source_geometry(Ref<NavigationMesh> p_nav_mesh, Node *p_node, Vector<float> &r_vertices, Vector<int> &r_indices, const AABB *p_bake_bounds) {
+	List<Node *> parse_nodes;
+
+	if (p_nav_mesh->get_source_geometry_mode() == NavigationMesh::SOURCE_GEOMETRY_NAVMESH_CHILDREN) {
+		parse_nodes.push_back(p_node);
+	} else {
+		p_node->get_tree()->get_nodes_in_group(p_nav_mesh->get_source_group_name(), &parse_nodes);
+	}
+
+	Transform navmesh_xform = Object::cast_to<Node3D>(p_node)->get_transform().affine_inverse();
+	for (const List<Node *>::Element *E = parse_nodes.front(); E; E = E->next()) {
+		int geometry_type = p_nav_mesh->get_parsed_geometry_type();
+		uint32_t collision_mask = p_nav_mesh->get_collision_mask();
+		bool recurse_children = p_nav_mesh->get_source_geometry_mode() != NavigationMesh::SOURCE_GEOMETRY_GROUPS_EXPLICIT;
+		_parse_geometry(navmesh_xform, E->get(), r_vertices, r_indices, geometry_type, collision_mask, recurse_children, p_bake_bounds);
+	}
 }
 
 void NavigationMeshGenerator::bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node) {
@@ -494,7 +702,7 @@ void NavigationMeshGenerator::bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node)
 #ifdef TOOLS_ENABLED
 	EditorProgress *ep(nullptr);
 	if (Engine::get_singleton()->is_editor_hint()) {
-		ep = memnew(EditorProgress("bake", TTR("Navigation Mesh Generator Setup:"), 11));
+		ep = memnew(EditorProgress("bake", TTR("Navigation Mesh Generator Setup:"), 4));
 	}
 
 	if (ep) {
@@ -504,62 +712,22 @@ void NavigationMeshGenerator::bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node)
 
 	Vector<float> vertices;
 	Vector<int> indices;
-
-	List<Node *> parse_nodes;
-
-	if (p_nav_mesh->get_source_geometry_mode() == NavigationMesh::SOURCE_GEOMETRY_NAVMESH_CHILDREN) {
-		parse_nodes.push_back(p_node);
-	} else {
-		p_node->get_tree()->get_nodes_in_group(p_nav_mesh->get_source_group_name(), &parse_nodes);
-	}
-
-	Transform navmesh_xform = Object::cast_to<Node3D>(p_node)->get_transform().affine_inverse();
-	for (const List<Node *>::Element *E = parse_nodes.front(); E; E = E->next()) {
-		int geometry_type = p_nav_mesh->get_parsed_geometry_type();
-		uint32_t collision_mask = p_nav_mesh->get_collision_mask();
-		bool recurse_children = p_nav_mesh->get_source_geometry_mode() != NavigationMesh::SOURCE_GEOMETRY_GROUPS_EXPLICIT;
-		_parse_geometry(navmesh_xform, E->get(), vertices, indices, geometry_type, collision_mask, recurse_children);
-	}
+	_parse_source_geometry(p_nav_mesh, p_node, vertices, indices, nullptr);
 
 	if (vertices.size() > 0 && indices.size() > 0) {
-		rcHeightfield *hf = nullptr;
-		rcCompactHeightfield *chf = nullptr;
-		rcContourSet *cset = nullptr;
-		rcPolyMesh *poly_mesh = nullptr;
-		rcPolyMeshDetail *detail_mesh = nullptr;
-
 		_build_recast_navigation_mesh(
 				p_nav_mesh,
 #ifdef TOOLS_ENABLED
 				ep,
 #endif
-				hf,
-				chf,
-				cset,
-				poly_mesh,
-				detail_mesh,
 				vertices,
-				indices);
-
-		rcFreeHeightField(hf);
-		hf = nullptr;
-
-		rcFreeCompactHeightfield(chf);
-		chf = nullptr;
-
-		rcFreeContourSet(cset);
-		cset = nullptr;
-
-		rcFreePolyMesh(poly_mesh);
-		poly_mesh = nullptr;
-
-		rcFreePolyMeshDetail(detail_mesh);
-		detail_mesh = nullptr;
+				indices,
+				nullptr);
 	}
 
 #ifdef TOOLS_ENABLED
 	if (ep) {
-		ep->step(TTR("Done!"), 11);
+		ep->step(TTR("Done!"), 4);
 	}
 
 	if (ep) {
@@ -568,6 +736,27 @@ void NavigationMeshGenerator::bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node)
 #endif
 }
 
+void NavigationMeshGenerator::bake_tiles(Ref<NavigationMesh> p_nav_mesh, Node *p_node, const AABB &p_bounds) {
+	ERR_FAIL_COND(!p_nav_mesh.is_valid());
+	ERR_FAIL_COND_MSG(p_nav_mesh->get_tile_size() <= 0, "Only navigation meshes with a tile size can have some of their tiles rebaked.");
+
+	// Geometry away from the rebuilt tiles can't change them, so it isn't parsed.
+	const AABB bake_bounds = _get_tile_bake_bounds(p_nav_mesh, p_bounds);
+
+	Vector<float> vertices;
+	Vector<int> indices;
+	_parse_source_geometry(p_nav_mesh, p_node, vertices, indices, &bake_bounds);
+
+	_build_recast_navigation_mesh(
+			p_nav_mesh,
+#ifdef TOOLS_ENABLED
+			nullptr,
+#endif
+			vertices,
+			indices,
+			&p_bounds);
+}
+
 void NavigationMeshGenerator::clear(Ref<NavigationMesh> p_nav_mesh) {
 	if (p_nav_mesh.is_valid()) {
 		p_nav_mesh->clear_polygons();
@@ -577,6 +766,7 @@ void NavigationMeshGenerator::clear(Ref<NavigationMesh> p_nav_mesh) {
 
 void NavigationMeshGenerator::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("bake", "nav_mesh", "root_node"), &NavigationMeshGenerator::bake);
+	ClassDB::bind_method(D_METHOD("bake_tiles", "nav_mesh", "root_node", "bounds"), &NavigationMeshGenerator::bake_tiles);
 	ClassDB::bind_method(D_METHOD("clear", "nav_mesh"), &NavigationMeshGenerator::clear);
 }
 
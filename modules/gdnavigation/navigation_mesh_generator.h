@@ -50,23 +50,47 @@ protected:
 	static void _bind_methods();
 
 	static void _add_vertex(const Vector3 &p_vec3, Vector<float> &p_verticies);
-	static void _add_mesh(const Ref<Mesh> &p_mesh, const Transform &p_xform, Vector<float> &p_verticies, Vector<int> &p_indices);
-	static void _add_faces(const PackedVector3Array &p_faces, const Transform &p_xform, Vector<float> &p_verticies, Vector<int> &p_indices);
-	static void _parse_geometry(Transform p_accumulated_transform, Node *p_node, Vector<float> &p_verticies, Vector<int> &p_indices, int p_generate_from, uint32_t p_collision_mask, bool p_recurse_children);
+	static bool _is_in_bake_bounds(const AABB &p_aabb, const AABB *p_bake_bounds);
+	static void _add_mesh(const Ref<Mesh> &p_mesh, const Transform &p_xform, Vector<float> &p_verticies, Vector<int> &p_indices, const AABB *p_bake_bounds);
+	static void _add_faces(const PackedVector3Array &p_faces, const Transform &p_xform, Vector<float> &p_verticies, Vector<int> &p_indices, const AABB *p_bake_bounds);
+	static void _parse_geometry(Transform p_accumulated_transform, Node *p_node, Vector<float> &p_verticies, Vector<int> &p_indices, int p_generate_from, uint32_t p_collision_mask, bool p_recurse_children, const AABB *p_bake_bounds);
 
-	static void _convert_detail_mesh_to_native_navigation_mesh(const rcPolyMeshDetail *p_detail_mesh, Ref<NavigationMesh> p_nav_mesh);
-	static void _build_recast_navigation_mesh(
+	struct BakedTile {
+		Vector<Vector3> vertices;
+		Vector<int> triangles;
+	};
+
+	struct TileBakeData {
+		const float *verts = nullptr;
+		int nverts = 0;
+		const int *tris = nullptr;
+
+		rcConfig cfg; // Shared by all tiles, bounds and size are set per tile.
+		int partition_type = 0;
+		bool filter_low_hanging_obstacles = false;
+		bool filter_ledge_spans = false;
+		bool filter_walkable_low_height_spans = false;
+
+		Vector<Vector2i> tiles; // Tiles are aligned to the navigation mesh origin, so they don't move when geometry changes.
+		Vector<Vector<int>> tile_tris; // Triangles overlapping each tile, border included.
+		Vector<BakedTile> baked_tiles;
+	};
+
+	static int _get_tile_border_size(Ref<NavigationMesh> p_nav_mesh);
+	static AABB _get_tile_bake_bounds(Ref<NavigationMesh> p_nav_mesh, const AABB &p_bounds);
+	static bool _setup_tile_bake(Ref<NavigationMesh> p_nav_mesh, const Vector<float> &p_vertices, const Vector<int> &p_indices, const AABB *p_bounds, TileBakeData &r_data);
+	static bool _build_recast_tile(const rcConfig &p_cfg, const TileBakeData *p_data, const Vector<int> &p_tile_tris, rcHeightfield *&hf, rcCompactHeightfield *&chf, rcContourSet *&cset, rcPolyMesh *&poly_mesh, rcPolyMeshDetail *&detail_mesh);
+	void _build_tile(uint32_t p_index, TileBakeData *p_data);
+	static void _convert_detail_mesh_to_native_navigation_mesh(const rcPolyMeshDetail *p_detail_mesh, BakedTile &r_tile);
+	void _build_recast_navigation_mesh(
 			Ref<NavigationMesh> p_nav_mesh,
 #ifdef TOOLS_ENABLED
 			EditorProgress *ep,
 #endif
-			rcHeightfield *hf,
-			rcCompactHeightfield *chf,
-			rcContourSet *cset,
-			rcPolyMesh *poly_mesh,
-			rcPolyMeshDetail *detail_mesh,
 			Vector<float> &vertices,
-			Vector<int> &indices);
+			Vector<int> &indices,
+			const AABB *p_bounds);
+	static void _parse_source_geometry(Ref<NavigationMesh> p_nav_mesh, Node *p_node, Vector<float> &r_vertices, Vector<int> &r_indices, const AABB *p_bake_bounds);
 
 public:
 	static NavigationMeshGenerator *get_singleton();
@@ -75,6 +99,7 @@ public:
 	~NavigationMeshGenerator();
 
 	void bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node);
+	void bake_tiles(Ref<NavigationMesh> p_nav_mesh, Node *p_node, const AABB &p_bounds);
 	void clear(Ref<NavigationMesh> p_nav_mesh);
 };
 
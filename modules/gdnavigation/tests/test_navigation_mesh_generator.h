@@ -0,0 +1,196 @@
+/*************************************************************************/
+/*  test_navigation_mesh_generator.h                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef TEST_NAVIGATION_MESH_GENERATOR_H
+#define TEST_NAVIGATION_MESH_GENERATOR_H
+
+#include "modules/gdnavigation/navigation_mesh_generator.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavigationMeshGenerator {
+
+class TestGenerator : public NavigationMeshGenerator {
+public:
+	using NavigationMeshGenerator::_add_faces;
+	using NavigationMeshGenerator::_get_tile_bake_bounds;
+	using NavigationMeshGenerator::_is_in_bake_bounds;
+
+	void build(Ref<NavigationMesh> p_nav_mesh, Vector<float> p_vertices, Vector<int> p_indices, const AABB *p_bounds) {
+		_build_recast_navigation_mesh(
+				p_nav_mesh,
+#ifdef TOOLS_ENABLED
+				nullptr,
+#endif
+				p_vertices,
+				p_indices,
+				p_bounds);
+	}
+};
+
+// Tiles are 3 units wide, with a border of 5 cells (1.25 units).
+static Ref<NavigationMesh> _make_nav_mesh(int p_tile_size) {
+	Ref<NavigationMesh> nav_mesh;
+	nav_mesh.instance();
+	nav_mesh->set_cell_size(0.25);
+	nav_mesh->set_tile_size(p_tile_size);
+	nav_mesh->set_agent_radius(0.5);
+	nav_mesh->set_region_min_size(2);
+	return nav_mesh;
+}
+
+// Flat floor from p_from_x to p_to_x along X and 0 to 3 along Z, wound the way Recast expects.
+static void _add_floor(float p_from_x, float p_to_x, Vector<float> &r_vertices, Vector<int> &r_indices) {
+	const Vector3 corners[4] = { Vector3(p_from_x, 0, 0), Vector3(p_from_x, 0, 3), Vector3(p_to_x, 0, 3), Vector3(p_to_x, 0, 0) };
+	const int from = r_vertices.size() / 3;
+	for (int i = 0; i < 4; i++) {
+		r_vertices.push_back(corners[i].x);
+		r_vertices.push_back(corners[i].y);
+		r_vertices.push_back(corners[i].z);
+	}
+	const int triangles[6] = { 0, 1, 2, 0, 2, 3 };
+	for (int i = 0; i < 6; i++) {
+		r_indices.push_back(from + triangles[i]);
+	}
+}
+
+static float _get_walkable_area(Ref<NavigationMesh> p_nav_mesh) {
+	const Vector<Vector3> vertices = p_nav_mesh->get_vertices();
+	float area = 0;
+	for (int i = 0; i < p_nav_mesh->get_polygon_count(); i++) {
+		const Vector<int> polygon = p_nav_mesh->get_polygon(i);
+		for (int j = 2; j < polygon.size(); j++) {
+			const Vector3 a = vertices[polygon[0]];
+			const Vector3 b = vertices[polygon[j - 1]];
+			const Vector3 c = vertices[polygon[j]];
+			area += Math::abs((b.x - a.x) * (c.z - a.z) - (c.x - a.x) * (b.z - a.z)) * 0.5;
+		}
+	}
+	return area;
+}
+
+TEST_CASE("[NavigationMeshGenerator] Rebaked tiles only need geometry near them") {
+	Ref<NavigationMesh> nav_mesh = _make_nav_mesh(12);
+
+	const AABB bake_bounds = TestGenerator::_get_tile_bake_bounds(nav_mesh, AABB(Vector3(3.5, 0, 0.5), Vector3(0.5, 1, 0.5)));
+	CHECK_MESSAGE(
+			Math::is_equal_approx(bake_bounds.position.x, 1.75f),
+			"The bounds should cover the whole tile along X, plus its border.");
+	CHECK_MESSAGE(
+			Math::is_equal_approx(bake_bounds.position.x + bake_bounds.size.x, 7.25f),
+			"The bounds should cover the whole tile along X, plus its border.");
+	CHECK_MESSAGE(
+			Math::is_equal_approx(bake_bounds.position.z, -1.25f),
+			"The bounds should cover the whole tile along Z, plus its border.");
+	CHECK_MESSAGE(
+			Math::is_equal_approx(bake_bounds.position.z + bake_bounds.size.z, 4.25f),
+			"The bounds should cover the whole tile along Z, plus its border.");
+
+	CHECK_MESSAGE(
+			TestGenerator::_is_in_bake_bounds(AABB(Vector3(1, 0, 0), Vector3(1, 1, 1)), &bake_bounds),
+			"Geometry reaching into the border should be parsed.");
+	CHECK_MESSAGE(
+			TestGenerator::_is_in_bake_bounds(AABB(Vector3(4, 100, 1), Vector3(1, 1, 1)), &bake_bounds),
+			"Tiles span the whole height, geometry above the bounds should be parsed.");
+	CHECK_MESSAGE(
+			!TestGenerator::_is_in_bake_bounds(AABB(Vector3(8, 0, 0), Vector3(1, 1, 1)), &bake_bounds),
+			"Geometry past the border should not be parsed.");
+
+	PackedVector3Array faces;
+	faces.push_back(Vector3(10, 0, 0));
+	faces.push_back(Vector3(10, 0, 1));
+	faces.push_back(Vector3(11, 0, 0));
+	Vector<float> vertices;
+	Vector<int> indices;
+	TestGenerator::_add_faces(faces, Transform(), vertices, indices, &bake_bounds);
+	CHECK_MESSAGE(vertices.empty(), "Faces outside of the bounds should not be added.");
+	TestGenerator::_add_faces(faces, Transform(Basis(), Vector3(-7, 0, 0)), vertices, indices, &bake_bounds);
+	CHECK_MESSAGE(vertices.size() == 9, "Faces moved into the bounds should be added.");
+}
+
+TEST_CASE("[NavigationMeshGenerator] Tiles match at their seams") {
+	TestGenerator generator;
+	Vector<float> vertices;
+	Vector<int> indices;
+	_add_floor(0, 6, vertices, indices);
+
+	Ref<NavigationMesh> single = _make_nav_mesh(0);
+	generator.build(single, vertices, indices, nullptr);
+	Ref<NavigationMesh> tiled = _make_nav_mesh(12);
+	generator.build(tiled, vertices, indices, nullptr);
+
+	// The floor loses the agent radius on its outer edges only, an eroded seam would lose about 1 more unit.
+	const float single_area = _get_walkable_area(single);
+	CHECK_MESSAGE(single_area > 9.0, "The floor should be walkable.");
+	CHECK_MESSAGE(
+			Math::abs(_get_walkable_area(tiled) - single_area) < 0.25,
+			"Baking in tiles should cover the same area as a single bake.");
+}
+
+TEST_CASE("[NavigationMeshGenerator] Rebaking tiles keeps the other tiles") {
+	TestGenerator generator;
+	Vector<float> vertices;
+	Vector<int> indices;
+	_add_floor(0, 6, vertices, indices);
+
+	Ref<NavigationMesh> nav_mesh = _make_nav_mesh(12);
+	generator.build(nav_mesh, vertices, indices, nullptr);
+	const float full_area = _get_walkable_area(nav_mesh);
+	const int full_polygon_count = nav_mesh->get_polygon_count();
+
+	// Remove the floor of the second tile, only that tile is rebuilt.
+	const AABB second_tile(Vector3(3.5, 0, 0.5), Vector3(0.5, 1, 0.5));
+	Vector<float> half_vertices;
+	Vector<int> half_indices;
+	_add_floor(0, 3, half_vertices, half_indices);
+	generator.build(nav_mesh, half_vertices, half_indices, &second_tile);
+
+	const float half_area = _get_walkable_area(nav_mesh);
+	CHECK_MESSAGE(
+			Math::abs(half_area - full_area * 0.5) < 0.5,
+			"Only the rebuilt tile should lose its polygons.");
+	for (int i = 0; i < nav_mesh->get_vertices().size(); i++) {
+		CHECK_MESSAGE(nav_mesh->get_vertices()[i].x <= 3.01, "No polygon should be left in the rebuilt tile.");
+	}
+
+	// Put the floor back, the mesh should be the same as a full bake.
+	generator.build(nav_mesh, vertices, indices, &second_tile);
+	CHECK_MESSAGE(
+			Math::is_equal_approx(_get_walkable_area(nav_mesh), full_area),
+			"Rebaking the tile should restore its polygons.");
+	CHECK_MESSAGE(
+			nav_mesh->get_polygon_count() == full_polygon_count,
+			"Rebaking the tile should restore its polygons.");
+}
+
+} // namespace TestNavigationMeshGenerator
+
+#endif // TEST_NAVIGATION_MESH_GENERATOR_H
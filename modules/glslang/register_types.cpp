@@ -34,6 +34,7 @@
 
 #include <SPIRV/GlslangToSpv.h>
 #include <StandAlone/ResourceLimits.h>
+#include <glslang/build_info.h>
 #include <glslang/Include/Types.h>
 #include <glslang/Public/ShaderLang.h>
 
@@ -124,11 +125,20 @@ static Vector<uint8_t> _compile_shader_glsl(RenderingDevice::ShaderStage p_stage
 	return ret;
 }
 
+static String _get_cache_key_function_glsl() {
+	//must change whenever the generated SPIR-V could change, keep in sync with the settings above
+	String key = vformat("glslang %d.%d.%d%s", GLSLANG_VERSION_MAJOR, GLSLANG_VERSION_MINOR, GLSLANG_VERSION_PATCH, GLSLANG_VERSION_FLAVOR);
+	key += " SpirVGen=" + itos(glslang::GetSpirvGeneratorVersion());
+	key += " Vulkan=1.0 Spv=1.0";
+	return key;
+}
+
 void preregister_glslang_types() {
 	// initialize in case it's not initialized. This is done once per thread
 	// and it's safe to call multiple times
 	glslang::InitializeProcess();
 	RenderingDevice::shader_set_compile_function(_compile_shader_glsl);
+	RenderingDevice::shader_set_get_cache_key_function(_get_cache_key_function_glsl);
 }
 
 void register_glslang_types() {
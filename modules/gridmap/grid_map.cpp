@@ -32,6 +32,7 @@
 
 #include "core/io/marshalls.h"
 #include "core/object/message_queue.h"
+#include "core/templates/thread_work_pool.h"
 #include "scene/3d/light_3d.h"
 #include "scene/resources/mesh_library.h"
 #include "scene/resources/surface_tool.h"
@@ -217,6 +218,28 @@ int GridMap::get_octant_size() const {
 	return octant_size;
 }
 
+void GridMap::set_octant_merge_meshes(bool p_enable) {
+	octant_merge_meshes = p_enable;
+	_recreate_octant_data();
+}
+
+bool GridMap::get_octant_merge_meshes() const {
+	return octant_merge_meshes;
+}
+
+void GridMap::set_octant_visibility_range(float p_range) {
+	ERR_FAIL_COND(p_range < 0);
+	octant_visibility_range = p_range;
+
+	for (Map<OctantKey, Octant *>::Element *E = octant_map.front(); E; E = E->next()) {
+		_octant_update_visibility_range(*E->get());
+	}
+}
+
+float GridMap::get_octant_visibility_range() const {
+	return octant_visibility_range;
+}
+
 void GridMap::set_center_x(bool p_enable) {
 	center_x = p_enable;
 	_recreate_octant_data();
@@ -379,15 +402,13 @@ void GridMap::_octant_transform(const OctantKey &p_key) {
 	for (int i = 0; i < g.multimesh_instances.size(); i++) {
 		RS::get_singleton()->instance_set_transform(g.multimesh_instances[i].instance, get_global_transform());
 	}
-}
 
-bool GridMap::_octant_update(const OctantKey &p_key) {
-	ERR_FAIL_COND_V(!octant_map.has(p_key), false);
-	Octant &g = *octant_map[p_key];
-	if (!g.dirty) {
-		return false;
+	if (g.merged_instance.is_valid()) {
+		RS::get_singleton()->instance_set_transform(g.merged_instance, get_global_transform());
 	}
+}
 
+void GridMap::_octant_clear(Octant &g) {
 	//erase body shapes
 	PhysicsServer3D::get_singleton()->body_clear_shapes(g.static_body);
 
@@ -410,13 +431,22 @@ bool GridMap::_octant_update(const OctantKey &p_key) {
 	}
 	g.multimesh_instances.clear();
 
-	if (g.cells.size() == 0) {
-		//octant no longer needed
-		_octant_clean_up(p_key);
-		return true;
+	if (g.merged_instance.is_valid()) {
+		RS::get_singleton()->free(g.merged_instance);
+		g.merged_instance = RID();
 	}
+	g.merged_mesh.unref();
+}
 
-	Vector<Vector3> col_debug;
+void GridMap::_octant_prepare_update(uint32_t p_index, OctantUpdate *p_updates) {
+	OctantUpdate &update = p_updates[p_index];
+	const Octant &g = *update.octant;
+
+	bool use_multimesh = baked_meshes.size() == 0 && !octant_merge_meshes;
+	bool use_merged = baked_meshes.size() == 0 && octant_merge_meshes;
+	Map<Ref<Material>, Ref<SurfaceTool>> merged_tools;
+
+	Vector3 ofs = _get_offset();
 
 	/*
 	 * foreach item in this octant,
@@ -424,34 +454,43 @@ bool GridMap::_octant_update(const OctantKey &p_key) {
 	 * and set said multimesh bounding box to one containing all cells which have this item
 	 */
 
-	Map<int, List<Pair<Transform, IndexKey>>> multimesh_items;
-
 	for (Set<IndexKey>::Element *E = g.cells.front(); E; E = E->next()) {
-		ERR_CONTINUE(!cell_map.has(E->get()));
-		const Cell &c = cell_map[E->get()];
+		const Map<IndexKey, Cell>::Element *C = cell_map.find(E->get());
+		ERR_CONTINUE(!C);
+		const Cell &c = C->get();
 
 		if (!mesh_library.is_valid() || !mesh_library->has_item(c.item)) {
 			continue;
 		}
 
 		Vector3 cellpos = Vector3(E->get().x, E->get().y, E->get().z);
-		Vector3 ofs = _get_offset();
 
 		Transform xform;
 
 		xform.basis.set_orthogonal_index(c.rot);
 		xform.set_origin(cellpos * cell_size + ofs);
 		xform.basis.scale(Vector3(cell_scale, cell_scale, cell_scale));
-		if (baked_meshes.size() == 0) {
+		if (use_multimesh) {
 			if (mesh_library->get_item_mesh(c.item).is_valid()) {
-				if (!multimesh_items.has(c.item)) {
-					multimesh_items[c.item] = List<Pair<Transform, IndexKey>>();
-				}
-
 				Pair<Transform, IndexKey> p;
 				p.first = xform;
 				p.second = E->get();
-				multimesh_items[c.item].push_back(p);
+				update.multimesh_items[c.item].push_back(p);
+			}
+		} else if (use_merged) {
+			const Map<int, Vector<ItemSurface>>::Element *S = merge_item_surfaces.find(c.item);
+			if (S) {
+				const Vector<ItemSurface> &surfaces = S->get();
+				for (int i = 0; i < surfaces.size(); i++) {
+					Map<Ref<Material>, Ref<SurfaceTool>>::Element *T = merged_tools.find(surfaces[i].material);
+					if (!T) {
+						Ref<SurfaceTool> st;
+						st.instance();
+						st->begin(Mesh::PRIMITIVE_TRIANGLES);
+						T = merged_tools.insert(surfaces[i].material, st);
+					}
+					T->get()->append_from_arrays(Mesh::PRIMITIVE_TRIANGLES, surfaces[i].arrays, xform);
+				}
 			}
 		}
 
@@ -462,68 +501,115 @@ bool GridMap::_octant_update(const OctantKey &p_key) {
 			if (!shapes[i].shape.is_valid()) {
 				continue;
 			}
-			PhysicsServer3D::get_singleton()->body_add_shape(g.static_body, shapes[i].shape->get_rid(), xform * shapes[i].local_transform);
-			if (g.collision_debug.is_valid()) {
-				shapes.write[i].shape->add_vertices_to_array(col_debug, xform * shapes[i].local_transform);
-			}
+			OctantUpdate::Shape shape;
+			shape.shape = shapes[i].shape;
+			shape.xform = xform * shapes[i].local_transform;
+			update.shapes.push_back(shape);
 		}
 
 		// add the item's navmesh at given xform to GridMap's Navigation ancestor
 		Ref<NavigationMesh> navmesh = mesh_library->get_item_navmesh(c.item);
 		if (navmesh.is_valid()) {
-			Octant::NavMesh nm;
+			OctantUpdate::NavMesh nm;
+			nm.key = E->get();
+			nm.navmesh = navmesh;
 			nm.xform = xform * mesh_library->get_item_navmesh_transform(c.item);
+			update.navmeshes.push_back(nm);
+		}
+	}
 
-			if (navigation) {
-				RID region = NavigationServer3D::get_singleton()->region_create();
-				NavigationServer3D::get_singleton()->region_set_navmesh(region, navmesh);
-				NavigationServer3D::get_singleton()->region_set_transform(region, navigation->get_global_transform() * nm.xform);
-				NavigationServer3D::get_singleton()->region_set_map(region, navigation->get_rid());
-				nm.region = region;
-			}
-			g.navmesh_ids[E->get()] = nm;
+	for (Map<Ref<Material>, Ref<SurfaceTool>>::Element *E = merged_tools.front(); E; E = E->next()) {
+		OctantUpdate::MergedSurface surface;
+		surface.material = E->key();
+		surface.arrays = E->get()->commit_to_arrays();
+		update.merged_surfaces.push_back(surface);
+	}
+}
+
+void GridMap::_octant_commit_update(OctantUpdate &p_update) {
+	Octant &g = *p_update.octant;
+
+	Vector<Vector3> col_debug;
+
+	for (uint32_t i = 0; i < p_update.shapes.size(); i++) {
+		OctantUpdate::Shape &shape = p_update.shapes[i];
+		PhysicsServer3D::get_singleton()->body_add_shape(g.static_body, shape.shape->get_rid(), shape.xform);
+		if (g.collision_debug.is_valid()) {
+			shape.shape->add_vertices_to_array(col_debug, shape.xform);
 		}
 	}
 
+	for (uint32_t i = 0; i < p_update.navmeshes.size(); i++) {
+		const OctantUpdate::NavMesh &navmesh = p_update.navmeshes[i];
+		Octant::NavMesh nm;
+		nm.xform = navmesh.xform;
+
+		if (navigation) {
+			RID region = NavigationServer3D::get_singleton()->region_create();
+			NavigationServer3D::get_singleton()->region_set_navmesh(region, navmesh.navmesh);
+			NavigationServer3D::get_singleton()->region_set_transform(region, navigation->get_global_transform() * nm.xform);
+			NavigationServer3D::get_singleton()->region_set_map(region, navigation->get_rid());
+			nm.region = region;
+		}
+		g.navmesh_ids[navmesh.key] = nm;
+	}
+
 	//update multimeshes, only if not baked
-	if (baked_meshes.size() == 0) {
-		for (Map<int, List<Pair<Transform, IndexKey>>>::Element *E = multimesh_items.front(); E; E = E->next()) {
-			Octant::MultimeshInstance mmi;
+	for (Map<int, List<Pair<Transform, IndexKey>>>::Element *E = p_update.multimesh_items.front(); E; E = E->next()) {
+		Octant::MultimeshInstance mmi;
 
-			RID mm = RS::get_singleton()->multimesh_create();
-			RS::get_singleton()->multimesh_allocate(mm, E->get().size(), RS::MULTIMESH_TRANSFORM_3D);
-			RS::get_singleton()->multimesh_set_mesh(mm, mesh_library->get_item_mesh(E->key())->get_rid());
+		RID mm = RS::get_singleton()->multimesh_create();
+		RS::get_singleton()->multimesh_allocate(mm, E->get().size(), RS::MULTIMESH_TRANSFORM_3D);
+		RS::get_singleton()->multimesh_set_mesh(mm, mesh_library->get_item_mesh(E->key())->get_rid());
 
-			int idx = 0;
-			for (List<Pair<Transform, IndexKey>>::Element *F = E->get().front(); F; F = F->next()) {
-				RS::get_singleton()->multimesh_instance_set_transform(mm, idx, F->get().first);
+		int idx = 0;
+		for (List<Pair<Transform, IndexKey>>::Element *F = E->get().front(); F; F = F->next()) {
+			RS::get_singleton()->multimesh_instance_set_transform(mm, idx, F->get().first);
 #ifdef TOOLS_ENABLED
 
-				Octant::MultimeshInstance::Item it;
-				it.index = idx;
-				it.transform = F->get().first;
-				it.key = F->get().second;
-				mmi.items.push_back(it);
+			Octant::MultimeshInstance::Item it;
+			it.index = idx;
+			it.transform = F->get().first;
+			it.key = F->get().second;
+			mmi.items.push_back(it);
 #endif
 
-				idx++;
-			}
+			idx++;
+		}
 
-			RID instance = RS::get_singleton()->instance_create();
-			RS::get_singleton()->instance_set_base(instance, mm);
+		RID instance = RS::get_singleton()->instance_create();
+		RS::get_singleton()->instance_set_base(instance, mm);
 
-			if (is_inside_tree()) {
-				RS::get_singleton()->instance_set_scenario(instance, get_world_3d()->get_scenario());
-				RS::get_singleton()->instance_set_transform(instance, get_global_transform());
-			}
+		if (is_inside_tree()) {
+			RS::get_singleton()->instance_set_scenario(instance, get_world_3d()->get_scenario());
+			RS::get_singleton()->instance_set_transform(instance, get_global_transform());
+		}
+
+		mmi.multimesh = mm;
+		mmi.instance = instance;
 
-			mmi.multimesh = mm;
-			mmi.instance = instance;
+		g.multimesh_instances.push_back(mmi);
+	}
 
-			g.multimesh_instances.push_back(mmi);
+	if (p_update.merged_surfaces.size()) {
+		g.merged_mesh.instance();
+		for (uint32_t i = 0; i < p_update.merged_surfaces.size(); i++) {
+			g.merged_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, p_update.merged_surfaces[i].arrays);
+			g.merged_mesh->surface_set_material(g.merged_mesh->get_surface_count() - 1, p_update.merged_surfaces[i].material);
+		}
+
+		g.merged_instance = RS::get_singleton()->instance_create();
+		RS::get_singleton()->instance_set_base(g.merged_instance, g.merged_mesh->get_rid());
+		RS::get_singleton()->instance_attach_object_instance_id(g.merged_instance, get_instance_id());
+
+		if (is_inside_tree()) {
+			RS::get_singleton()->instance_set_scenario(g.merged_instance, get_world_3d()->get_scenario());
+			RS::get_singleton()->instance_set_transform(g.merged_instance, get_global_transform());
 		}
 	}
 
+	_octant_update_visibility_range(g);
+
 	if (col_debug.size()) {
 		Array arr;
 		arr.resize(RS::ARRAY_MAX);
@@ -537,8 +623,16 @@ bool GridMap::_octant_update(const OctantKey &p_key) {
 	}
 
 	g.dirty = false;
+}
 
-	return false;
+void GridMap::_octant_update_visibility_range(Octant &g) {
+	for (int i = 0; i < g.multimesh_instances.size(); i++) {
+		RS::get_singleton()->instance_geometry_set_draw_range(g.multimesh_instances[i].instance, 0, octant_visibility_range, 0, 0);
+	}
+
+	if (g.merged_instance.is_valid()) {
+		RS::get_singleton()->instance_geometry_set_draw_range(g.merged_instance, 0, octant_visibility_range, 0, 0);
+	}
 }
 
 void GridMap::_reset_physic_bodies_collision_filters() {
@@ -564,6 +658,11 @@ void GridMap::_octant_enter_world(const OctantKey &p_key) {
 		RS::get_singleton()->instance_set_transform(g.multimesh_instances[i].instance, get_global_transform());
 	}
 
+	if (g.merged_instance.is_valid()) {
+		RS::get_singleton()->instance_set_scenario(g.merged_instance, get_world_3d()->get_scenario());
+		RS::get_singleton()->instance_set_transform(g.merged_instance, get_global_transform());
+	}
+
 	if (navigation && mesh_library.is_valid()) {
 		for (Map<IndexKey, Octant::NavMesh>::Element *F = g.navmesh_ids.front(); F; F = F->next()) {
 			if (cell_map.has(F->key()) && F->get().region.is_valid() == false) {
@@ -594,6 +693,10 @@ void GridMap::_octant_exit_world(const OctantKey &p_key) {
 		RS::get_singleton()->instance_set_scenario(g.multimesh_instances[i].instance, RID());
 	}
 
+	if (g.merged_instance.is_valid()) {
+		RS::get_singleton()->instance_set_scenario(g.merged_instance, RID());
+	}
+
 	if (navigation) {
 		for (Map<IndexKey, Octant::NavMesh>::Element *F = g.navmesh_ids.front(); F; F = F->next()) {
 			if (F->get().region.is_valid()) {
@@ -630,6 +733,12 @@ void GridMap::_octant_clean_up(const OctantKey &p_key) {
 		RS::get_singleton()->free(g.multimesh_instances[i].multimesh);
 	}
 	g.multimesh_instances.clear();
+
+	if (g.merged_instance.is_valid()) {
+		RS::get_singleton()->free(g.merged_instance);
+		g.merged_instance = RID();
+	}
+	g.merged_mesh.unref();
 }
 
 void GridMap::_notification(int p_what) {
@@ -708,6 +817,9 @@ void GridMap::_update_visibility() {
 			const Octant::MultimeshInstance &mi = octant->multimesh_instances[i];
 			RS::get_singleton()->instance_set_visible(mi.instance, is_visible_in_tree());
 		}
+		if (octant->merged_instance.is_valid()) {
+			RS::get_singleton()->instance_set_visible(octant->merged_instance, is_visible_in_tree());
+		}
 	}
 }
 
@@ -742,6 +854,7 @@ void GridMap::_clear_internal() {
 
 	octant_map.clear();
 	cell_map.clear();
+	merge_item_surfaces.clear();
 }
 
 void GridMap::clear() {
@@ -758,16 +871,64 @@ void GridMap::_update_octants_callback() {
 		return;
 	}
 
+	LocalVector<OctantUpdate> updates;
 	List<OctantKey> to_delete;
 	for (Map<OctantKey, Octant *>::Element *E = octant_map.front(); E; E = E->next()) {
-		if (_octant_update(E->key())) {
+		Octant &g = *E->get();
+		if (!g.dirty) {
+			continue;
+		}
+
+		_octant_clear(g);
+
+		if (g.cells.size() == 0) {
+			//octant no longer needed
+			_octant_clean_up(E->key());
 			to_delete.push_back(E->key());
+			continue;
 		}
+
+		OctantUpdate update;
+		update.octant = &g;
+		updates.push_back(update);
 	}
 
-	while (to_delete.front()) {
-		octant_map.erase(to_delete.front()->get());
-		to_delete.pop_back();
+	if (octant_merge_meshes && baked_meshes.size() == 0 && mesh_library.is_valid()) {
+		// Mesh arrays are read back from the RenderingServer, which must happen here and not on the workers.
+		for (uint32_t i = 0; i < updates.size(); i++) {
+			for (Set<IndexKey>::Element *E = updates[i].octant->cells.front(); E; E = E->next()) {
+				const Map<IndexKey, Cell>::Element *C = cell_map.find(E->get());
+				ERR_CONTINUE(!C);
+				int item = C->get().item;
+				if (merge_item_surfaces.has(item) || !mesh_library->has_item(item)) {
+					continue;
+				}
+
+				Vector<ItemSurface> surfaces;
+				Ref<Mesh> mesh = mesh_library->get_item_mesh(item);
+				for (int j = 0; mesh.is_valid() && j < mesh->get_surface_count(); j++) {
+					if (mesh->surface_get_primitive_type(j) != Mesh::PRIMITIVE_TRIANGLES) {
+						continue;
+					}
+					ItemSurface surface;
+					surface.material = mesh->surface_get_material(j);
+					surface.arrays = mesh->surface_get_arrays(j);
+					surfaces.push_back(surface);
+				}
+				merge_item_surfaces[item] = surfaces;
+			}
+		}
+	}
+
+	ThreadWorkPool::do_shared_work(updates.size(), this, &GridMap::_octant_prepare_update, updates.ptr());
+
+	for (uint32_t i = 0; i < updates.size(); i++) {
+		_octant_commit_update(updates[i]);
+	}
+
+	for (List<OctantKey>::Element *E = to_delete.front(); E; E = E->next()) {
+		memdelete(octant_map[E->get()]);
+		octant_map.erase(E->get());
 	}
 
 	_update_visibility();
@@ -799,6 +960,12 @@ void GridMap::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_octant_size", "size"), &GridMap::set_octant_size);
 	ClassDB::bind_method(D_METHOD("get_octant_size"), &GridMap::get_octant_size);
 
+	ClassDB::bind_method(D_METHOD("set_octant_merge_meshes", "enable"), &GridMap::set_octant_merge_meshes);
+	ClassDB::bind_method(D_METHOD("get_octant_merge_meshes"), &GridMap::get_octant_merge_meshes);
+
+	ClassDB::bind_method(D_METHOD("set_octant_visibility_range", "range"), &GridMap::set_octant_visibility_range);
+	ClassDB::bind_method(D_METHOD("get_octant_visibility_range"), &GridMap::get_octant_visibility_range);
+
 	ClassDB::bind_method(D_METHOD("set_cell_item", "position", "item", "orientation"), &GridMap::set_cell_item, DEFVAL(0));
 	ClassDB::bind_method(D_METHOD("get_cell_item", "position"), &GridMap::get_cell_item);
 	ClassDB::bind_method(D_METHOD("get_cell_item_orientation", "position"), &GridMap::get_cell_item_orientation);
@@ -837,6 +1004,9 @@ void GridMap::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "cell_center_y"), "set_center_y", "get_center_y");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "cell_center_z"), "set_center_z", "get_center_z");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "cell_scale"), "set_cell_scale", "get_cell_scale");
+	ADD_GROUP("Octant", "octant_");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "octant_merge_meshes"), "set_octant_merge_meshes", "get_octant_merge_meshes");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "octant_visibility_range", PROPERTY_HINT_RANGE, "0,4096,0.01,or_greater"), "set_octant_visibility_range", "get_octant_visibility_range");
 	ADD_GROUP("Collision", "collision_");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "collision_layer", PROPERTY_HINT_LAYERS_3D_PHYSICS), "set_collision_layer", "get_collision_layer");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "collision_mask", PROPERTY_HINT_LAYERS_3D_PHYSICS), "set_collision_mask", "get_collision_mask");
@@ -1057,6 +1227,9 @@ GridMap::GridMap() {
 	center_y = true;
 	center_z = true;
 
+	octant_merge_meshes = false;
+	octant_visibility_range = 0;
+
 	clip = false;
 	clip_floor = 0;
 	clip_axis = Vector3::AXIS_Z;
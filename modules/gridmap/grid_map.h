@@ -33,6 +33,7 @@
 
 #include "scene/3d/navigation_3d.h"
 #include "scene/3d/node_3d.h"
+#include "core/templates/local_vector.h"
 #include "scene/resources/mesh_library.h"
 #include "scene/resources/multimesh.h"
 
@@ -112,6 +113,9 @@ class GridMap : public Node3D {
 		};
 
 		Vector<MultimeshInstance> multimesh_instances;
+		// Single instance with one surface per material, used instead of the multimeshes when merging octant meshes.
+		Ref<ArrayMesh> merged_mesh;
+		RID merged_instance;
 		Set<IndexKey> cells;
 		RID collision_debug;
 		RID collision_debug_instance;
@@ -151,6 +155,9 @@ class GridMap : public Node3D {
 	float cell_scale;
 	Navigation3D *navigation;
 
+	bool octant_merge_meshes;
+	float octant_visibility_range;
+
 	bool clip;
 	bool clip_above;
 	int clip_floor;
@@ -177,10 +184,49 @@ class GridMap : public Node3D {
 		return Vector3(p_key.x, p_key.y, p_key.z) * cell_size * octant_size;
 	}
 
+	/**
+	 * @brief Everything needed to rebuild a dirty Octant, gathered from the cells on worker threads.
+	 * Only the server calls are left for _octant_commit_update(), which runs on the main thread.
+	 */
+	struct OctantUpdate {
+		struct Shape {
+			Ref<Shape3D> shape;
+			Transform xform;
+		};
+
+		struct NavMesh {
+			IndexKey key;
+			Ref<NavigationMesh> navmesh;
+			Transform xform;
+		};
+
+		struct MergedSurface {
+			Ref<Material> material;
+			Array arrays;
+		};
+
+		Octant *octant = nullptr;
+		Map<int, List<Pair<Transform, IndexKey>>> multimesh_items;
+		LocalVector<Shape> shapes;
+		LocalVector<NavMesh> navmeshes;
+		LocalVector<MergedSurface> merged_surfaces;
+	};
+
+	struct ItemSurface {
+		Ref<Material> material;
+		Array arrays;
+	};
+
+	// Triangle surfaces of the items used by merged octants, read back from the meshes on the main thread.
+	Map<int, Vector<ItemSurface>> merge_item_surfaces;
+
 	void _reset_physic_bodies_collision_filters();
 	void _octant_enter_world(const OctantKey &p_key);
 	void _octant_exit_world(const OctantKey &p_key);
-	bool _octant_update(const OctantKey &p_key);
+	void _octant_clear(Octant &g);
+	void _octant_prepare_update(uint32_t p_index, OctantUpdate *p_updates);
+	void _octant_commit_update(OctantUpdate &p_update);
+	void _octant_update_visibility_range(Octant &g);
 	void _octant_clean_up(const OctantKey &p_key);
 	void _octant_transform(const OctantKey &p_key);
 	bool awaiting_update;
@@ -236,6 +282,12 @@ public:
 	void set_octant_size(int p_size);
 	int get_octant_size() const;
 
+	void set_octant_merge_meshes(bool p_enable);
+	bool get_octant_merge_meshes() const;
+
+	void set_octant_visibility_range(float p_range);
+	float get_octant_visibility_range() const;
+
 	void set_center_x(bool p_enable);
 	bool get_center_x() const;
 	void set_center_y(bool p_enable);
@@ -42,10 +42,8 @@ void class_db_api_to_json(const String &p_output_file, ClassDB::APIType p_api) {
 
 	List<StringName> names;
 
-	const StringName *k = nullptr;
-
-	while ((k = ClassDB::classes.next(k))) {
-		names.push_back(*k);
+	for (OrderedHashMap<StringName, ClassDB::ClassInfo>::Element E = ClassDB::classes.front(); E; E = E.next()) {
+		names.push_back(E.key());
 	}
 	//must be alphabetically sorted for hash to compute
 	names.sort_custom<StringName::AlphCompare>();
@@ -66,7 +64,7 @@ void class_db_api_to_json(const String &p_output_file, ClassDB::APIType p_api) {
 
 			List<StringName> snames;
 
-			k = nullptr;
+			const StringName *k = nullptr;
 
 			while ((k = t->method_map.next(k))) {
 				String name = k->operator String();
@@ -131,7 +129,7 @@ void class_db_api_to_json(const String &p_output_file, ClassDB::APIType p_api) {
 
 			List<StringName> snames;
 
-			k = nullptr;
+			const StringName *k = nullptr;
 
 			while ((k = t->constant_map.next(k))) {
 				snames.push_back(*k);
@@ -158,7 +156,7 @@ void class_db_api_to_json(const String &p_output_file, ClassDB::APIType p_api) {
 
 			List<StringName> snames;
 
-			k = nullptr;
+			const StringName *k = nullptr;
 
 			while ((k = t->signal_map.next(k))) {
 				snames.push_back(*k);
@@ -193,7 +191,7 @@ void class_db_api_to_json(const String &p_output_file, ClassDB::APIType p_api) {
 
 			List<StringName> snames;
 
-			k = nullptr;
+			const StringName *k = nullptr;
 
 			while ((k = t->property_setget.next(k))) {
 				snames.push_back(*k);
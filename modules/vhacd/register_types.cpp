@@ -29,10 +29,188 @@
 /*************************************************************************/
 
 #include "register_types.h"
+#include "core/config/engine.h"
+#include "core/config/project_settings.h"
+#include "core/crypto/crypto_core.h"
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+#include "core/os/mutex.h"
+#include "core/templates/hash_map.h"
 #include "scene/resources/mesh.h"
 #include "thirdparty/vhacd/public/VHACD.h"
 
-static Vector<Vector<Face3>> convex_decompose(const Vector<Face3> &p_faces) {
+// Decompositions are cached by a hash of their input, so meshes that did not change are not decomposed again when reimported.
+// In the editor, the cache is also kept in the imported files folder, so it survives restarts.
+// Both are bounded: the least recently used decompositions are evicted from memory, and the oldest files are removed on exit.
+#define DECOMPOSITION_CACHE_MAX_FACES (256 * 1024)
+#define DECOMPOSITION_CACHE_MAX_FILES 1024
+
+struct CachedDecomposition {
+	Vector<Vector<Face3>> hulls;
+	int face_count = 0;
+	List<String>::Element *lru = nullptr;
+};
+
+static HashMap<String, CachedDecomposition> decomposition_cache;
+static List<String> decomposition_cache_lru; // Most recently used last.
+static int decomposition_cache_faces = 0;
+static Mutex decomposition_cache_mutex;
+
+static bool _get_cached(const String &p_key, Vector<Vector<Face3>> &r_hulls) {
+	MutexLock lock(decomposition_cache_mutex);
+	CachedDecomposition *cached = decomposition_cache.getptr(p_key);
+	if (!cached) {
+		return false;
+	}
+
+	decomposition_cache_lru.move_to_back(cached->lru);
+	r_hulls = cached->hulls;
+	return true;
+}
+
+static void _add_cached(const String &p_key, const Vector<Vector<Face3>> &p_hulls) {
+	MutexLock lock(decomposition_cache_mutex);
+	if (decomposition_cache.has(p_key)) {
+		return; // Decomposed by another thread meanwhile.
+	}
+
+	CachedDecomposition cached;
+	cached.hulls = p_hulls;
+	for (int i = 0; i < p_hulls.size(); i++) {
+		cached.face_count += p_hulls[i].size();
+	}
+	cached.lru = decomposition_cache_lru.push_back(p_key);
+	decomposition_cache[p_key] = cached;
+	decomposition_cache_faces += cached.face_count;
+
+	// The entry just added is always kept, even if it's over the limit alone.
+	while (decomposition_cache_faces > DECOMPOSITION_CACHE_MAX_FACES && decomposition_cache_lru.front() != cached.lru) {
+		String evicted = decomposition_cache_lru.front()->get();
+		decomposition_cache_faces -= decomposition_cache[evicted].face_count;
+		decomposition_cache.erase(evicted);
+		decomposition_cache_lru.pop_front();
+	}
+}
+
+static String _get_cache_dir() {
+	return ProjectSettings::IMPORTED_FILES_PATH.plus_file("vhacd");
+}
+
+static String _get_cache_file(const String &p_key) {
+	return _get_cache_dir().plus_file(p_key + ".hulls");
+}
+
+struct CacheFile {
+	String path;
+	uint64_t modified_time = 0;
+
+	bool operator<(const CacheFile &p_file) const {
+		return modified_time > p_file.modified_time; // Newest first.
+	}
+};
+
+static void _prune_cache_files() {
+	DirAccess *da = DirAccess::open(_get_cache_dir());
+	if (!da) {
+		return;
+	}
+
+	Vector<CacheFile> files;
+	da->list_dir_begin();
+	String file = da->get_next();
+	while (file != String()) {
+		if (!da->current_is_dir() && file.get_extension() == "hulls") {
+			CacheFile cache_file;
+			cache_file.path = file;
+			cache_file.modified_time = FileAccess::get_modified_time(_get_cache_dir().plus_file(file));
+			files.push_back(cache_file);
+		}
+		file = da->get_next();
+	}
+	da->list_dir_end();
+
+	// Files are saved again when used, so the oldest ones are the least recently used.
+	files.sort();
+	for (int i = DECOMPOSITION_CACHE_MAX_FILES; i < files.size(); i++) {
+		da->remove(files[i].path);
+	}
+	memdelete(da);
+}
+
+static bool _load_cached_decomposition(const String &p_key, Vector<Vector<Face3>> &r_hulls) {
+	FileAccess *f = FileAccess::open(_get_cache_file(p_key), FileAccess::READ);
+	if (!f) {
+		return false;
+	}
+
+	// The counts come from the file, which may be truncated or corrupt, so check
+	// them against what is left to read before allocating anything.
+	const uint64_t face_size = 9 * (f->real_is_double ? sizeof(double) : sizeof(float));
+	bool valid = true;
+
+	uint32_t hull_count = f->get_32();
+	if (hull_count > (f->get_len() - f->get_position()) / 4) {
+		valid = false;
+	} else {
+		r_hulls.resize(hull_count);
+	}
+
+	for (int i = 0; valid && i < r_hulls.size(); i++) {
+		uint32_t face_count = f->get_32();
+		if (face_count > (f->get_len() - f->get_position()) / face_size) {
+			valid = false;
+			break;
+		}
+
+		Vector<Face3> &triangles = r_hulls.write[i];
+		triangles.resize(face_count);
+		for (int j = 0; j < triangles.size(); j++) {
+			Face3 &face = triangles.write[j];
+			for (int k = 0; k < 3; k++) {
+				face.vertex[k].x = f->get_real();
+				face.vertex[k].y = f->get_real();
+				face.vertex[k].z = f->get_real();
+			}
+		}
+	}
+
+	valid = valid && !f->eof_reached();
+	memdelete(f);
+	if (!valid) {
+		r_hulls.clear();
+	}
+	return valid;
+}
+
+static void _save_cached_decomposition(const String &p_key, const Vector<Vector<Face3>> &p_hulls) {
+	String path = _get_cache_file(p_key);
+	FileAccess *f = FileAccess::open(path, FileAccess::WRITE);
+	if (!f) {
+		DirAccess *da = DirAccess::create(DirAccess::ACCESS_RESOURCES);
+		da->make_dir_recursive(path.get_base_dir());
+		memdelete(da);
+
+		f = FileAccess::open(path, FileAccess::WRITE);
+		ERR_FAIL_COND_MSG(!f, "Cannot save convex decomposition cache file '" + path + "'.");
+	}
+
+	f->store_32(p_hulls.size());
+	for (int i = 0; i < p_hulls.size(); i++) {
+		const Vector<Face3> &triangles = p_hulls[i];
+		f->store_32(triangles.size());
+		for (int j = 0; j < triangles.size(); j++) {
+			for (int k = 0; k < 3; k++) {
+				f->store_real(triangles[j].vertex[k].x);
+				f->store_real(triangles[j].vertex[k].y);
+				f->store_real(triangles[j].vertex[k].z);
+			}
+		}
+	}
+
+	memdelete(f);
+}
+
+static Vector<Vector<Face3>> convex_decompose(const Vector<Face3> &p_faces, const Mesh::ConvexDecompositionSettings &p_settings) {
 	Vector<float> vertices;
 	vertices.resize(p_faces.size() * 9);
 	Vector<uint32_t> indices;
@@ -47,14 +225,41 @@ static Vector<Vector<Face3>> convex_decompose(const Vector<Face3> &p_faces) {
 		}
 	}
 
+	String key;
+	{
+		CryptoCore::SHA256Context ctx;
+		ctx.start();
+		ctx.update((const uint8_t *)vertices.ptr(), vertices.size() * sizeof(float));
+		ctx.update((const uint8_t *)&p_settings.resolution, sizeof(p_settings.resolution));
+		ctx.update((const uint8_t *)&p_settings.max_convex_hulls, sizeof(p_settings.max_convex_hulls));
+		unsigned char hash[32];
+		ctx.finish(hash);
+		key = String::hex_encode_buffer(hash, 32);
+	}
+
+	bool use_file_cache = Engine::get_singleton()->is_editor_hint();
+
+	Vector<Vector<Face3>> ret;
+
+	if (_get_cached(key, ret)) {
+		return ret;
+	}
+
+	if (use_file_cache && _load_cached_decomposition(key, ret)) {
+		// Refresh its modification time, so it's pruned last.
+		_save_cached_decomposition(key, ret);
+		_add_cached(key, ret);
+		return ret;
+	}
+
 	VHACD::IVHACD *decomposer = VHACD::CreateVHACD();
 	VHACD::IVHACD::Parameters params;
+	params.m_resolution = p_settings.resolution;
+	params.m_maxConvexHulls = p_settings.max_convex_hulls;
 	decomposer->Compute(vertices.ptr(), vertices.size() / 3, indices.ptr(), indices.size() / 3, params);
 
 	int hull_count = decomposer->GetNConvexHulls();
 
-	Vector<Vector<Face3>> ret;
-
 	for (int i = 0; i < hull_count; i++) {
 		Vector<Face3> triangles;
 		VHACD::IVHACD::ConvexHull hull;
@@ -75,6 +280,12 @@ static Vector<Vector<Face3>> convex_decompose(const Vector<Face3> &p_faces) {
 	decomposer->Clean();
 	decomposer->Release();
 
+	if (use_file_cache) {
+		_save_cached_decomposition(key, ret);
+	}
+
+	_add_cached(key, ret);
+
 	return ret;
 }
 
@@ -84,4 +295,11 @@ void register_vhacd_types() {
 
 void unregister_vhacd_types() {
 	Mesh::convex_composition_function = nullptr;
+	decomposition_cache.clear();
+	decomposition_cache_lru.clear();
+	decomposition_cache_faces = 0;
+
+	if (Engine::get_singleton()->is_editor_hint()) {
+		_prune_cache_files();
+	}
 }
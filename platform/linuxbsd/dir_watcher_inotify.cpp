@@ -0,0 +1,87 @@
+/*************************************************************************/
+/*  dir_watcher_inotify.cpp                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "dir_watcher_inotify.h"
+
+#ifdef __linux__
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+int DirWatcherInotify::add_watch(const String &p_path, bool p_removals_only) {
+	if (fd < 0) {
+		return -1;
+	}
+
+	uint32_t mask = IN_DELETE | IN_DELETE_SELF | IN_MOVED_FROM | IN_ONLYDIR;
+	if (p_removals_only) {
+		mask |= IN_MOVE_SELF;
+	} else {
+		mask |= IN_CREATE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO | IN_ATTRIB;
+	}
+	return inotify_add_watch(fd, p_path.utf8().get_data(), mask);
+}
+
+void DirWatcherInotify::poll(LocalVector<Event> &r_events) {
+	if (fd < 0) {
+		return;
+	}
+
+	char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+	while (true) {
+		ssize_t len = read(fd, buffer, sizeof(buffer));
+		if (len <= 0) {
+			break; // EAGAIN, no more pending events.
+		}
+
+		for (char *ptr = buffer; ptr < buffer + len;) {
+			const struct inotify_event *event = (const struct inotify_event *)ptr;
+			ptr += sizeof(struct inotify_event) + event->len;
+
+			Event ev;
+			ev.watch = (event->mask & IN_Q_OVERFLOW) ? -1 : event->wd;
+			ev.watch_removed = (event->mask & IN_IGNORED) != 0;
+			r_events.push_back(ev);
+		}
+	}
+}
+
+DirWatcherInotify::DirWatcherInotify() {
+	fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+}
+
+DirWatcherInotify::~DirWatcherInotify() {
+	if (fd >= 0) {
+		close(fd);
+	}
+}
+
+#endif // __linux__
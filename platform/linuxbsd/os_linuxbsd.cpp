@@ -31,6 +31,7 @@
 #include "os_linuxbsd.h"
 
 #include "core/os/dir_access.h"
+#include "dir_watcher_inotify.h"
 #include "main/main.h"
 
 #ifdef X11_ENABLED
@@ -55,6 +56,10 @@ void OS_LinuxBSD::initialize() {
 	crash_handler.initialize();
 
 	OS_Unix::initialize_core();
+
+#ifdef __linux__
+	DirWatcher::make_default<DirWatcherInotify>();
+#endif
 }
 
 void OS_LinuxBSD::initialize_joypads() {
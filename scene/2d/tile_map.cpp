@@ -33,6 +33,7 @@
 #include "collision_object_2d.h"
 #include "core/io/marshalls.h"
 #include "core/os/os.h"
+#include "core/templates/thread_work_pool.h"
 #include "scene/2d/area_2d.h"
 #include "servers/navigation_server_2d.h"
 #include "servers/physics_server_2d.h"
@@ -75,8 +76,8 @@ void TileMap::_notification(int p_what) {
 
 		case NOTIFICATION_EXIT_TREE: {
 			_update_quadrant_space(RID());
-			for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
-				Quadrant &q = E->get();
+			for (QuadrantMap::Iterator E = quadrant_map.iter(); E.valid; E = quadrant_map.next_iter(E)) {
+				Quadrant &q = **E.value;
 				if (navigation) {
 					for (Map<PosKey, Quadrant::NavPoly>::Element *F = q.navpoly_ids.front(); F; F = F->next()) {
 						NavigationServer2D::get_singleton()->region_set_map(F->get().region, RID());
@@ -116,8 +117,8 @@ void TileMap::_notification(int p_what) {
 
 void TileMap::_update_quadrant_space(const RID &p_space) {
 	if (!use_parent) {
-		for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
-			Quadrant &q = E->get();
+		for (QuadrantMap::Iterator E = quadrant_map.iter(); E.valid; E = quadrant_map.next_iter(E)) {
+			Quadrant &q = **E.value;
 			PhysicsServer2D::get_singleton()->body_set_space(q.body, p_space);
 		}
 	}
@@ -140,8 +141,8 @@ void TileMap::_update_quadrant_transform() {
 		nav_rel = get_relative_transform_to_parent(navigation);
 	}
 
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
-		Quadrant &q = E->get();
+	for (QuadrantMap::Iterator E = quadrant_map.iter(); E.valid; E = quadrant_map.next_iter(E)) {
+		Quadrant &q = **E.value;
 		Transform2D xform;
 		xform.set_origin(q.pos);
 
@@ -212,7 +213,7 @@ int TileMap::get_quadrant_size() const {
 	return quadrant_size;
 }
 
-void TileMap::_fix_cell_transform(Transform2D &xform, const Cell &p_cell, const Vector2 &p_offset, const Size2 &p_sc) {
+void TileMap::_fix_cell_transform(Transform2D &xform, const Cell &p_cell, const Vector2 &p_offset, const Size2 &p_sc) const {
 	Size2 s = p_sc;
 	Vector2 offset = p_offset;
 
@@ -305,391 +306,452 @@ void TileMap::_add_shape(int &shape_idx, const Quadrant &p_q, const Ref<Shape2D>
 	shape_idx++;
 }
 
-void TileMap::update_dirty_quadrants() {
-	if (!pending_update) {
-		return;
-	}
-	if (!is_inside_tree() || !tile_set.is_valid()) {
-		pending_update = false;
-		return;
-	}
+void TileMap::_prepare_quadrant_update(uint32_t p_index, QuadrantUpdate *p_updates) {
+	QuadrantUpdate &update = p_updates[p_index];
+	const Quadrant &q = *update.quadrant;
 
-	RenderingServer *vs = RenderingServer::get_singleton();
-	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
 	Vector2 tofs = get_cell_draw_offset();
-	Transform2D nav_rel;
-	if (navigation) {
-		nav_rel = get_relative_transform_to_parent(navigation);
-	}
+	Color self_modulate = get_self_modulate();
 
-	Vector2 qofs;
+	update.cells.reserve(q.cells.size());
 
-	SceneTree *st = SceneTree::get_singleton();
-	Color debug_collision_color;
-	Color debug_navigation_color;
+	for (int i = 0; i < q.cells.size(); i++) {
+		const PosKey &pk = q.cells[i];
+		const Cell &c = *tile_map.lookup_ptr(pk);
+		//moment of truth
+		if (!tile_set->has_tile(c.id)) {
+			continue;
+		}
+		Ref<Texture2D> tex = tile_set->tile_get_texture(c.id);
+		Vector2 tile_ofs = tile_set->tile_get_texture_offset(c.id);
 
-	bool debug_shapes = st && st->is_debugging_collisions_hint();
-	if (debug_shapes) {
-		debug_collision_color = st->get_debug_collisions_color();
-	}
+		Vector2 wofs = _map_to_world(pk.x, pk.y);
+		Vector2 offset = wofs - q.pos + tofs;
 
-	bool debug_navigation = st && st->is_debugging_navigation_hint();
-	if (debug_navigation) {
-		debug_navigation_color = st->get_debug_navigation_color();
-	}
+		if (!tex.is_valid()) {
+			continue;
+		}
 
-	while (dirty_quadrant_list.first()) {
-		Quadrant &q = *dirty_quadrant_list.first()->self();
+		TileSet::TileMode tile_mode = tile_set->tile_get_tile_mode(c.id);
+		Vector2 autotile_coord = Vector2(c.autotile_coord_x, c.autotile_coord_y);
 
-		for (List<RID>::Element *E = q.canvas_items.front(); E; E = E->next()) {
-			vs->free(E->get());
+		CellUpdate cell;
+		cell.key = pk;
+		cell.texture = tex;
+		cell.material = tile_set->tile_get_material(c.id);
+		cell.z_index = tile_set->tile_get_z_index(c.id);
+
+		if (tile_mode == TileSet::AUTO_TILE || tile_mode == TileSet::ATLAS_TILE) {
+			cell.z_index += tile_set->autotile_get_z_index(c.id, autotile_coord);
 		}
 
-		q.canvas_items.clear();
+		Rect2 r = tile_set->tile_get_region(c.id);
+		if (tile_mode == TileSet::AUTO_TILE || tile_mode == TileSet::ATLAS_TILE) {
+			int spacing = tile_set->autotile_get_spacing(c.id);
+			r.size = tile_set->autotile_get_size(c.id);
+			r.position += (r.size + Vector2(spacing, spacing)) * autotile_coord;
+		}
 
-		if (!use_parent) {
-			ps->body_clear_shapes(q.body);
-		} else if (collision_parent) {
-			collision_parent->shape_owner_clear_shapes(q.shape_owner_id);
+		Size2 s;
+		if (r == Rect2()) {
+			s = tex->get_size();
+		} else {
+			s = r.size;
 		}
-		int shape_idx = 0;
 
-		if (navigation) {
-			for (Map<PosKey, Quadrant::NavPoly>::Element *E = q.navpoly_ids.front(); E; E = E->next()) {
-				NavigationServer2D::get_singleton()->region_set_map(E->get().region, RID());
+		Rect2 rect;
+		rect.position = offset.floor();
+		rect.size = s;
+		rect.size.x += fp_adjust;
+		rect.size.y += fp_adjust;
+
+		if (compatibility_mode && !centered_textures) {
+			if (rect.size.y > rect.size.x) {
+				if ((c.flip_h && (c.flip_v || c.transpose)) || (c.flip_v && !c.transpose)) {
+					tile_ofs.y += rect.size.y - rect.size.x;
+				}
+			} else if (rect.size.y < rect.size.x) {
+				if ((c.flip_v && (c.flip_h || c.transpose)) || (c.flip_h && !c.transpose)) {
+					tile_ofs.x += rect.size.x - rect.size.y;
+				}
 			}
-			q.navpoly_ids.clear();
 		}
 
-		for (Map<PosKey, Quadrant::Occluder>::Element *E = q.occluder_instances.front(); E; E = E->next()) {
-			RS::get_singleton()->free(E->get().id);
+		if (c.transpose) {
+			SWAP(tile_ofs.x, tile_ofs.y);
+			if (centered_textures) {
+				rect.position.x += cell_size.x / 2 - rect.size.y / 2;
+				rect.position.y += cell_size.y / 2 - rect.size.x / 2;
+			}
+		} else if (centered_textures) {
+			rect.position += cell_size / 2 - rect.size / 2;
 		}
-		q.occluder_instances.clear();
-		Ref<ShaderMaterial> prev_material;
-		int prev_z_index = 0;
-		RID prev_canvas_item;
-		RID prev_debug_canvas_item;
 
-		for (int i = 0; i < q.cells.size(); i++) {
-			Map<PosKey, Cell>::Element *E = tile_map.find(q.cells[i]);
-			Cell &c = E->get();
-			//moment of truth
-			if (!tile_set->has_tile(c.id)) {
-				continue;
-			}
-			Ref<Texture2D> tex = tile_set->tile_get_texture(c.id);
-			Vector2 tile_ofs = tile_set->tile_get_texture_offset(c.id);
+		if (c.flip_h) {
+			rect.size.x = -rect.size.x;
+			tile_ofs.x = -tile_ofs.x;
+		}
 
-			Vector2 wofs = _map_to_world(E->key().x, E->key().y);
-			Vector2 offset = wofs - q.pos + tofs;
+		if (c.flip_v) {
+			rect.size.y = -rect.size.y;
+			tile_ofs.y = -tile_ofs.y;
+		}
 
-			if (!tex.is_valid()) {
-				continue;
-			}
+		if (compatibility_mode && !centered_textures) {
+			if (tile_origin == TILE_ORIGIN_TOP_LEFT) {
+				rect.position += tile_ofs;
 
-			Ref<ShaderMaterial> mat = tile_set->tile_get_material(c.id);
-			int z_index = tile_set->tile_get_z_index(c.id);
+			} else if (tile_origin == TILE_ORIGIN_BOTTOM_LEFT) {
+				rect.position += tile_ofs;
 
-			if (tile_set->tile_get_tile_mode(c.id) == TileSet::AUTO_TILE ||
-					tile_set->tile_get_tile_mode(c.id) == TileSet::ATLAS_TILE) {
-				z_index += tile_set->autotile_get_z_index(c.id, Vector2(c.autotile_coord_x, c.autotile_coord_y));
-			}
+				if (c.transpose) {
+					if (c.flip_h) {
+						rect.position.x -= cell_size.x;
+					} else {
+						rect.position.x += cell_size.x;
+					}
+				} else {
+					if (c.flip_v) {
+						rect.position.y -= cell_size.y;
+					} else {
+						rect.position.y += cell_size.y;
+					}
+				}
 
-			RID canvas_item;
-			RID debug_canvas_item;
+			} else if (tile_origin == TILE_ORIGIN_CENTER) {
+				rect.position += tile_ofs;
 
-			if (prev_canvas_item == RID() || prev_material != mat || prev_z_index != z_index) {
-				canvas_item = vs->canvas_item_create();
-				if (mat.is_valid()) {
-					vs->canvas_item_set_material(canvas_item, mat->get_rid());
-				}
-				vs->canvas_item_set_parent(canvas_item, get_canvas_item());
-				_update_item_material_state(canvas_item);
-				Transform2D xform;
-				xform.set_origin(q.pos);
-				vs->canvas_item_set_transform(canvas_item, xform);
-				vs->canvas_item_set_light_mask(canvas_item, get_light_mask());
-				vs->canvas_item_set_z_index(canvas_item, z_index);
-
-				vs->canvas_item_set_default_texture_filter(canvas_item, RS::CanvasItemTextureFilter(CanvasItem::get_texture_filter()));
-				vs->canvas_item_set_default_texture_repeat(canvas_item, RS::CanvasItemTextureRepeat(CanvasItem::get_texture_repeat()));
-
-				q.canvas_items.push_back(canvas_item);
-
-				if (debug_shapes) {
-					debug_canvas_item = vs->canvas_item_create();
-					vs->canvas_item_set_parent(debug_canvas_item, canvas_item);
-					vs->canvas_item_set_z_as_relative_to_parent(debug_canvas_item, false);
-					vs->canvas_item_set_z_index(debug_canvas_item, RS::CANVAS_ITEM_Z_MAX - 1);
-					q.canvas_items.push_back(debug_canvas_item);
-					prev_debug_canvas_item = debug_canvas_item;
+				if (c.flip_h) {
+					rect.position.x -= cell_size.x / 2;
+				} else {
+					rect.position.x += cell_size.x / 2;
 				}
 
-				prev_canvas_item = canvas_item;
-				prev_material = mat;
-				prev_z_index = z_index;
-
-			} else {
-				canvas_item = prev_canvas_item;
-				if (debug_shapes) {
-					debug_canvas_item = prev_debug_canvas_item;
+				if (c.flip_v) {
+					rect.position.y -= cell_size.y / 2;
+				} else {
+					rect.position.y += cell_size.y / 2;
 				}
 			}
+		} else {
+			rect.position += tile_ofs;
+		}
 
-			Rect2 r = tile_set->tile_get_region(c.id);
-			if (tile_set->tile_get_tile_mode(c.id) == TileSet::AUTO_TILE || tile_set->tile_get_tile_mode(c.id) == TileSet::ATLAS_TILE) {
-				int spacing = tile_set->autotile_get_spacing(c.id);
-				r.size = tile_set->autotile_get_size(c.id);
-				r.position += (r.size + Vector2(spacing, spacing)) * Vector2(c.autotile_coord_x, c.autotile_coord_y);
-			}
+		Color modulate = tile_set->tile_get_modulate(c.id);
+		cell.modulate = Color(modulate.r * self_modulate.r, modulate.g * self_modulate.g,
+				modulate.b * self_modulate.b, modulate.a * self_modulate.a);
+		cell.rect = rect;
+		cell.region = r;
+		cell.transpose = c.transpose;
 
-			Size2 s;
-			if (r == Rect2()) {
-				s = tex->get_size();
-			} else {
-				s = r.size;
-			}
+		Vector<TileSet::ShapeData> shapes = tile_set->tile_get_shapes(c.id);
+
+		cell.shape_from = update.shapes.size();
+		for (int j = 0; j < shapes.size(); j++) {
+			if (shapes[j].shape.is_valid()) {
+				if (tile_mode == TileSet::SINGLE_TILE || (shapes[j].autotile_coord.x == c.autotile_coord_x && shapes[j].autotile_coord.y == c.autotile_coord_y)) {
+					Transform2D xform;
+					xform.set_origin(offset.floor());
 
-			Rect2 rect;
-			rect.position = offset.floor();
-			rect.size = s;
-			rect.size.x += fp_adjust;
-			rect.size.y += fp_adjust;
+					Vector2 shape_ofs = shapes[j].shape_transform.get_origin();
 
-			if (compatibility_mode && !centered_textures) {
-				if (rect.size.y > rect.size.x) {
-					if ((c.flip_h && (c.flip_v || c.transpose)) || (c.flip_v && !c.transpose)) {
-						tile_ofs.y += rect.size.y - rect.size.x;
-					}
-				} else if (rect.size.y < rect.size.x) {
-					if ((c.flip_v && (c.flip_h || c.transpose)) || (c.flip_h && !c.transpose)) {
-						tile_ofs.x += rect.size.x - rect.size.y;
-					}
-				}
-			}
+					_fix_cell_transform(xform, c, shape_ofs, s);
+
+					xform *= shapes[j].shape_transform.untranslated();
 
-			if (c.transpose) {
-				SWAP(tile_ofs.x, tile_ofs.y);
-				if (centered_textures) {
-					rect.position.x += cell_size.x / 2 - rect.size.y / 2;
-					rect.position.y += cell_size.y / 2 - rect.size.x / 2;
+					CellShapeUpdate shape;
+					shape.data = shapes[j];
+					shape.xform = xform;
+					update.shapes.push_back(shape);
 				}
-			} else if (centered_textures) {
-				rect.position += cell_size / 2 - rect.size / 2;
 			}
+		}
+		cell.shape_count = update.shapes.size() - cell.shape_from;
 
-			if (c.flip_h) {
-				rect.size.x = -rect.size.x;
-				tile_ofs.x = -tile_ofs.x;
+		if (navigation) {
+			Ref<NavigationPolygon> navpoly;
+			Vector2 npoly_ofs;
+			if (tile_mode == TileSet::AUTO_TILE || tile_mode == TileSet::ATLAS_TILE) {
+				navpoly = tile_set->autotile_get_navigation_polygon(c.id, autotile_coord);
+				npoly_ofs = Vector2();
+			} else {
+				navpoly = tile_set->tile_get_navigation_polygon(c.id);
+				npoly_ofs = tile_set->tile_get_navigation_polygon_offset(c.id);
 			}
 
-			if (c.flip_v) {
-				rect.size.y = -rect.size.y;
-				tile_ofs.y = -tile_ofs.y;
+			if (navpoly.is_valid()) {
+				cell.navpoly = navpoly;
+				cell.navpoly_xform.set_origin(offset.floor() + q.pos);
+				_fix_cell_transform(cell.navpoly_xform, c, npoly_ofs, s);
+				cell.navpoly_local_xform.set_origin(offset.floor());
+				_fix_cell_transform(cell.navpoly_local_xform, c, npoly_ofs, s);
 			}
+		}
 
-			if (compatibility_mode && !centered_textures) {
-				if (tile_origin == TILE_ORIGIN_TOP_LEFT) {
-					rect.position += tile_ofs;
+		Ref<OccluderPolygon2D> occluder;
+		if (tile_mode == TileSet::AUTO_TILE || tile_mode == TileSet::ATLAS_TILE) {
+			occluder = tile_set->autotile_get_light_occluder(c.id, autotile_coord);
+		} else {
+			occluder = tile_set->tile_get_light_occluder(c.id);
+		}
+		if (occluder.is_valid()) {
+			Vector2 occluder_ofs = tile_set->tile_get_occluder_offset(c.id);
+			cell.occluder = occluder;
+			cell.occluder_xform.set_origin(offset.floor() + q.pos);
+			_fix_cell_transform(cell.occluder_xform, c, occluder_ofs, s);
+		}
 
-				} else if (tile_origin == TILE_ORIGIN_BOTTOM_LEFT) {
-					rect.position += tile_ofs;
+		update.cells.push_back(cell);
+	}
+}
 
-					if (c.transpose) {
-						if (c.flip_h) {
-							rect.position.x -= cell_size.x;
-						} else {
-							rect.position.x += cell_size.x;
-						}
-					} else {
-						if (c.flip_v) {
-							rect.position.y -= cell_size.y;
-						} else {
-							rect.position.y += cell_size.y;
-						}
-					}
+void TileMap::_commit_quadrant_update(QuadrantUpdate &p_update) {
+	RenderingServer *vs = RenderingServer::get_singleton();
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	Transform2D nav_rel;
+	if (navigation) {
+		nav_rel = get_relative_transform_to_parent(navigation);
+	}
 
-				} else if (tile_origin == TILE_ORIGIN_CENTER) {
-					rect.position += tile_ofs;
+	SceneTree *st = SceneTree::get_singleton();
+	Color debug_collision_color;
+	Color debug_navigation_color;
 
-					if (c.flip_h) {
-						rect.position.x -= cell_size.x / 2;
-					} else {
-						rect.position.x += cell_size.x / 2;
-					}
+	bool debug_shapes = st && st->is_debugging_collisions_hint();
+	if (debug_shapes) {
+		debug_collision_color = st->get_debug_collisions_color();
+	}
 
-					if (c.flip_v) {
-						rect.position.y -= cell_size.y / 2;
-					} else {
-						rect.position.y += cell_size.y / 2;
-					}
-				}
-			} else {
-				rect.position += tile_ofs;
-			}
+	bool debug_navigation = st && st->is_debugging_navigation_hint();
+	if (debug_navigation) {
+		debug_navigation_color = st->get_debug_navigation_color();
+	}
 
-			Color modulate = tile_set->tile_get_modulate(c.id);
-			Color self_modulate = get_self_modulate();
-			modulate = Color(modulate.r * self_modulate.r, modulate.g * self_modulate.g,
-					modulate.b * self_modulate.b, modulate.a * self_modulate.a);
-			if (r == Rect2()) {
-				tex->draw_rect(canvas_item, rect, false, modulate, c.transpose);
-			} else {
-				tex->draw_rect_region(canvas_item, rect, r, modulate, c.transpose, clip_uv);
+	Quadrant &q = *p_update.quadrant;
+
+	for (List<RID>::Element *E = q.canvas_items.front(); E; E = E->next()) {
+		vs->free(E->get());
+	}
+
+	q.canvas_items.clear();
+
+	if (!use_parent) {
+		ps->body_clear_shapes(q.body);
+	} else if (collision_parent) {
+		collision_parent->shape_owner_clear_shapes(q.shape_owner_id);
+	}
+	int shape_idx = 0;
+
+	if (navigation) {
+		for (Map<PosKey, Quadrant::NavPoly>::Element *E = q.navpoly_ids.front(); E; E = E->next()) {
+			NavigationServer2D::get_singleton()->region_set_map(E->get().region, RID());
+		}
+		q.navpoly_ids.clear();
+	}
+
+	for (Map<PosKey, Quadrant::Occluder>::Element *E = q.occluder_instances.front(); E; E = E->next()) {
+		RS::get_singleton()->free(E->get().id);
+	}
+	q.occluder_instances.clear();
+	Ref<ShaderMaterial> prev_material;
+	int prev_z_index = 0;
+	RID prev_canvas_item;
+	RID prev_debug_canvas_item;
+
+	for (uint32_t i = 0; i < p_update.cells.size(); i++) {
+		const CellUpdate &cell = p_update.cells[i];
+
+		RID canvas_item;
+		RID debug_canvas_item;
+
+		if (prev_canvas_item == RID() || prev_material != cell.material || prev_z_index != cell.z_index) {
+			canvas_item = vs->canvas_item_create();
+			if (cell.material.is_valid()) {
+				vs->canvas_item_set_material(canvas_item, cell.material->get_rid());
+			}
+			vs->canvas_item_set_parent(canvas_item, get_canvas_item());
+			_update_item_material_state(canvas_item);
+			Transform2D xform;
+			xform.set_origin(q.pos);
+			vs->canvas_item_set_transform(canvas_item, xform);
+			vs->canvas_item_set_light_mask(canvas_item, get_light_mask());
+			vs->canvas_item_set_z_index(canvas_item, cell.z_index);
+
+			vs->canvas_item_set_default_texture_filter(canvas_item, RS::CanvasItemTextureFilter(CanvasItem::get_texture_filter()));
+			vs->canvas_item_set_default_texture_repeat(canvas_item, RS::CanvasItemTextureRepeat(CanvasItem::get_texture_repeat()));
+
+			q.canvas_items.push_back(canvas_item);
+
+			if (debug_shapes) {
+				debug_canvas_item = vs->canvas_item_create();
+				vs->canvas_item_set_parent(debug_canvas_item, canvas_item);
+				vs->canvas_item_set_z_as_relative_to_parent(debug_canvas_item, false);
+				vs->canvas_item_set_z_index(debug_canvas_item, RS::CANVAS_ITEM_Z_MAX - 1);
+				q.canvas_items.push_back(debug_canvas_item);
+				prev_debug_canvas_item = debug_canvas_item;
 			}
 
-			Vector<TileSet::ShapeData> shapes = tile_set->tile_get_shapes(c.id);
+			prev_canvas_item = canvas_item;
+			prev_material = cell.material;
+			prev_z_index = cell.z_index;
 
-			for (int j = 0; j < shapes.size(); j++) {
-				Ref<Shape2D> shape = shapes[j].shape;
-				if (shape.is_valid()) {
-					if (tile_set->tile_get_tile_mode(c.id) == TileSet::SINGLE_TILE || (shapes[j].autotile_coord.x == c.autotile_coord_x && shapes[j].autotile_coord.y == c.autotile_coord_y)) {
-						Transform2D xform;
-						xform.set_origin(offset.floor());
+		} else {
+			canvas_item = prev_canvas_item;
+			if (debug_shapes) {
+				debug_canvas_item = prev_debug_canvas_item;
+			}
+		}
 
-						Vector2 shape_ofs = shapes[j].shape_transform.get_origin();
+		if (cell.region == Rect2()) {
+			cell.texture->draw_rect(canvas_item, cell.rect, false, cell.modulate, cell.transpose);
+		} else {
+			cell.texture->draw_rect_region(canvas_item, cell.rect, cell.region, cell.modulate, cell.transpose, clip_uv);
+		}
 
-						_fix_cell_transform(xform, c, shape_ofs, s);
+		Vector2 metadata = Vector2(cell.key.x, cell.key.y);
 
-						xform *= shapes[j].shape_transform.untranslated();
+		for (uint32_t j = 0; j < cell.shape_count; j++) {
+			const CellShapeUpdate &shape_update = p_update.shapes[cell.shape_from + j];
+			Ref<Shape2D> shape = shape_update.data.shape;
 
-						if (debug_canvas_item.is_valid()) {
-							vs->canvas_item_add_set_transform(debug_canvas_item, xform);
-							shape->draw(debug_canvas_item, debug_collision_color);
-						}
+			if (debug_canvas_item.is_valid()) {
+				vs->canvas_item_add_set_transform(debug_canvas_item, shape_update.xform);
+				shape->draw(debug_canvas_item, debug_collision_color);
+			}
 
-						if (shape->has_meta("decomposed")) {
-							Array _shapes = shape->get_meta("decomposed");
-							for (int k = 0; k < _shapes.size(); k++) {
-								Ref<ConvexPolygonShape2D> convex = _shapes[k];
-								if (convex.is_valid()) {
-									_add_shape(shape_idx, q, convex, shapes[j], xform, Vector2(E->key().x, E->key().y));
+			if (shape->has_meta("decomposed")) {
+				Array _shapes = shape->get_meta("decomposed");
+				for (int k = 0; k < _shapes.size(); k++) {
+					Ref<ConvexPolygonShape2D> convex = _shapes[k];
+					if (convex.is_valid()) {
+						_add_shape(shape_idx, q, convex, shape_update.data, shape_update.xform, metadata);
 #ifdef DEBUG_ENABLED
-								} else {
-									print_error("The TileSet assigned to the TileMap " + get_name() + " has an invalid convex shape.");
+					} else {
+						print_error("The TileSet assigned to the TileMap " + get_name() + " has an invalid convex shape.");
 #endif
-								}
-							}
-						} else {
-							_add_shape(shape_idx, q, shape, shapes[j], xform, Vector2(E->key().x, E->key().y));
-						}
 					}
 				}
+			} else {
+				_add_shape(shape_idx, q, shape, shape_update.data, shape_update.xform, metadata);
 			}
+		}
 
-			if (debug_canvas_item.is_valid()) {
-				vs->canvas_item_add_set_transform(debug_canvas_item, Transform2D());
-			}
-
-			if (navigation) {
-				Ref<NavigationPolygon> navpoly;
-				Vector2 npoly_ofs;
-				if (tile_set->tile_get_tile_mode(c.id) == TileSet::AUTO_TILE || tile_set->tile_get_tile_mode(c.id) == TileSet::ATLAS_TILE) {
-					navpoly = tile_set->autotile_get_navigation_polygon(c.id, Vector2(c.autotile_coord_x, c.autotile_coord_y));
-					npoly_ofs = Vector2();
-				} else {
-					navpoly = tile_set->tile_get_navigation_polygon(c.id);
-					npoly_ofs = tile_set->tile_get_navigation_polygon_offset(c.id);
-				}
+		if (debug_canvas_item.is_valid()) {
+			vs->canvas_item_add_set_transform(debug_canvas_item, Transform2D());
+		}
 
-				if (navpoly.is_valid()) {
-					Transform2D xform;
-					xform.set_origin(offset.floor() + q.pos);
-					_fix_cell_transform(xform, c, npoly_ofs, s);
-
-					RID region = NavigationServer2D::get_singleton()->region_create();
-					NavigationServer2D::get_singleton()->region_set_map(region, navigation->get_rid());
-					NavigationServer2D::get_singleton()->region_set_transform(region, nav_rel * xform);
-					NavigationServer2D::get_singleton()->region_set_navpoly(region, navpoly);
-
-					Quadrant::NavPoly np;
-					np.region = region;
-					np.xform = xform;
-					q.navpoly_ids[E->key()] = np;
-
-					if (debug_navigation) {
-						RID debug_navigation_item = vs->canvas_item_create();
-						vs->canvas_item_set_parent(debug_navigation_item, canvas_item);
-						vs->canvas_item_set_z_as_relative_to_parent(debug_navigation_item, false);
-						vs->canvas_item_set_z_index(debug_navigation_item, RS::CANVAS_ITEM_Z_MAX - 2); // Display one below collision debug
-
-						if (debug_navigation_item.is_valid()) {
-							Vector<Vector2> navigation_polygon_vertices = navpoly->get_vertices();
-							int vsize = navigation_polygon_vertices.size();
-
-							if (vsize > 2) {
-								Vector<Color> colors;
-								Vector<Vector2> vertices;
-								vertices.resize(vsize);
-								colors.resize(vsize);
-								{
-									const Vector2 *vr = navigation_polygon_vertices.ptr();
-									for (int j = 0; j < vsize; j++) {
-										vertices.write[j] = vr[j];
-										colors.write[j] = debug_navigation_color;
-									}
-								}
+		if (navigation && cell.navpoly.is_valid()) {
+			Ref<NavigationPolygon> navpoly = cell.navpoly;
+
+			RID region = NavigationServer2D::get_singleton()->region_create();
+			NavigationServer2D::get_singleton()->region_set_map(region, navigation->get_rid());
+			NavigationServer2D::get_singleton()->region_set_transform(region, nav_rel * cell.navpoly_xform);
+			NavigationServer2D::get_singleton()->region_set_navpoly(region, navpoly);
+
+			Quadrant::NavPoly np;
+			np.region = region;
+			np.xform = cell.navpoly_xform;
+			q.navpoly_ids[cell.key] = np;
+
+			if (debug_navigation) {
+				RID debug_navigation_item = vs->canvas_item_create();
+				vs->canvas_item_set_parent(debug_navigation_item, canvas_item);
+				vs->canvas_item_set_z_as_relative_to_parent(debug_navigation_item, false);
+				vs->canvas_item_set_z_index(debug_navigation_item, RS::CANVAS_ITEM_Z_MAX - 2); // Display one below collision debug
+
+				if (debug_navigation_item.is_valid()) {
+					Vector<Vector2> navigation_polygon_vertices = navpoly->get_vertices();
+					int vsize = navigation_polygon_vertices.size();
+
+					if (vsize > 2) {
+						Vector<Color> colors;
+						Vector<Vector2> vertices;
+						vertices.resize(vsize);
+						colors.resize(vsize);
+						{
+							const Vector2 *vr = navigation_polygon_vertices.ptr();
+							for (int j = 0; j < vsize; j++) {
+								vertices.write[j] = vr[j];
+								colors.write[j] = debug_navigation_color;
+							}
+						}
 
-								Vector<int> indices;
+						Vector<int> indices;
 
-								for (int j = 0; j < navpoly->get_polygon_count(); j++) {
-									Vector<int> polygon = navpoly->get_polygon(j);
+						for (int j = 0; j < navpoly->get_polygon_count(); j++) {
+							Vector<int> polygon = navpoly->get_polygon(j);
 
-									for (int k = 2; k < polygon.size(); k++) {
-										int kofs[3] = { 0, k - 1, k };
-										for (int l = 0; l < 3; l++) {
-											int idx = polygon[kofs[l]];
-											ERR_FAIL_INDEX(idx, vsize);
-											indices.push_back(idx);
-										}
-									}
+							for (int k = 2; k < polygon.size(); k++) {
+								int kofs[3] = { 0, k - 1, k };
+								for (int l = 0; l < 3; l++) {
+									int idx = polygon[kofs[l]];
+									ERR_FAIL_INDEX(idx, vsize);
+									indices.push_back(idx);
 								}
-								Transform2D navxform;
-								navxform.set_origin(offset.floor());
-								_fix_cell_transform(navxform, c, npoly_ofs, s);
-
-								vs->canvas_item_set_transform(debug_navigation_item, navxform);
-								vs->canvas_item_add_triangle_array(debug_navigation_item, indices, vertices, colors);
 							}
 						}
+
+						vs->canvas_item_set_transform(debug_navigation_item, cell.navpoly_local_xform);
+						vs->canvas_item_add_triangle_array(debug_navigation_item, indices, vertices, colors);
 					}
 				}
 			}
+		}
 
-			Ref<OccluderPolygon2D> occluder;
-			if (tile_set->tile_get_tile_mode(c.id) == TileSet::AUTO_TILE || tile_set->tile_get_tile_mode(c.id) == TileSet::ATLAS_TILE) {
-				occluder = tile_set->autotile_get_light_occluder(c.id, Vector2(c.autotile_coord_x, c.autotile_coord_y));
-			} else {
-				occluder = tile_set->tile_get_light_occluder(c.id);
-			}
-			if (occluder.is_valid()) {
-				Vector2 occluder_ofs = tile_set->tile_get_occluder_offset(c.id);
-				Transform2D xform;
-				xform.set_origin(offset.floor() + q.pos);
-				_fix_cell_transform(xform, c, occluder_ofs, s);
-
-				RID orid = RS::get_singleton()->canvas_light_occluder_create();
-				RS::get_singleton()->canvas_light_occluder_set_transform(orid, get_global_transform() * xform);
-				RS::get_singleton()->canvas_light_occluder_set_polygon(orid, occluder->get_rid());
-				RS::get_singleton()->canvas_light_occluder_attach_to_canvas(orid, get_canvas());
-				RS::get_singleton()->canvas_light_occluder_set_light_mask(orid, occluder_light_mask);
-				Quadrant::Occluder oc;
-				oc.xform = xform;
-				oc.id = orid;
-				q.occluder_instances[E->key()] = oc;
-			}
+		if (cell.occluder.is_valid()) {
+			RID orid = RS::get_singleton()->canvas_light_occluder_create();
+			RS::get_singleton()->canvas_light_occluder_set_transform(orid, get_global_transform() * cell.occluder_xform);
+			RS::get_singleton()->canvas_light_occluder_set_polygon(orid, cell.occluder->get_rid());
+			RS::get_singleton()->canvas_light_occluder_attach_to_canvas(orid, get_canvas());
+			RS::get_singleton()->canvas_light_occluder_set_light_mask(orid, occluder_light_mask);
+			Quadrant::Occluder oc;
+			oc.xform = cell.occluder_xform;
+			oc.id = orid;
+			q.occluder_instances[cell.key] = oc;
 		}
+	}
+}
 
-		dirty_quadrant_list.remove(dirty_quadrant_list.first());
+void TileMap::update_dirty_quadrants() {
+	if (!pending_update) {
+		return;
+	}
+	if (!is_inside_tree() || !tile_set.is_valid()) {
+		pending_update = false;
+		return;
+	}
+
+	LocalVector<QuadrantUpdate> updates;
+	for (SelfList<Quadrant> *E = dirty_quadrant_list.first(); E; E = E->next()) {
+		QuadrantUpdate update;
+		update.quadrant = E->self();
+		updates.push_back(update);
+	}
+
+	// Only reads the cells and the tile set, the servers are not touched until the commit.
+	ThreadWorkPool::do_shared_work(updates.size(), this, &TileMap::_prepare_quadrant_update, updates.ptr());
+
+	for (uint32_t i = 0; i < updates.size(); i++) {
+		_commit_quadrant_update(updates[i]);
+
+		dirty_quadrant_list.remove(&updates[i].quadrant->dirty_list);
 		quadrant_order_dirty = true;
 	}
 
 	pending_update = false;
 
 	if (quadrant_order_dirty) {
+		// Quadrants are drawn row by row.
+		LocalVector<PosKey> quadrants;
+		quadrants.reserve(quadrant_map.get_num_elements());
+		for (QuadrantMap::Iterator E = quadrant_map.iter(); E.valid; E = quadrant_map.next_iter(E)) {
+			quadrants.push_back(*E.key);
+		}
+		quadrants.sort();
+
 		int index = -(int64_t)0x80000000; //always must be drawn below children
-		for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
-			Quadrant &q = E->get();
+		for (uint32_t i = 0; i < quadrants.size(); i++) {
+			Quadrant &q = **quadrant_map.lookup_ptr(quadrants[i]);
 			for (List<RID>::Element *F = q.canvas_items.front(); F; F = F->next()) {
 				RS::get_singleton()->canvas_item_set_draw_index(F->get(), index++);
 			}
@@ -709,14 +771,17 @@ void TileMap::_recompute_rect_cache() {
 	}
 
 	Rect2 r_total;
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+	bool first = true;
+	for (QuadrantMap::Iterator E = quadrant_map.iter(); E.valid; E = quadrant_map.next_iter(E)) {
+		const PosKey &qk = *E.key;
 		Rect2 r;
-		r.position = _map_to_world(E->key().x * _get_quadrant_size(), E->key().y * _get_quadrant_size());
-		r.expand_to(_map_to_world(E->key().x * _get_quadrant_size() + _get_quadrant_size(), E->key().y * _get_quadrant_size()));
-		r.expand_to(_map_to_world(E->key().x * _get_quadrant_size() + _get_quadrant_size(), E->key().y * _get_quadrant_size() + _get_quadrant_size()));
-		r.expand_to(_map_to_world(E->key().x * _get_quadrant_size(), E->key().y * _get_quadrant_size() + _get_quadrant_size()));
-		if (E == quadrant_map.front()) {
+		r.position = _map_to_world(qk.x * _get_quadrant_size(), qk.y * _get_quadrant_size());
+		r.expand_to(_map_to_world(qk.x * _get_quadrant_size() + _get_quadrant_size(), qk.y * _get_quadrant_size()));
+		r.expand_to(_map_to_world(qk.x * _get_quadrant_size() + _get_quadrant_size(), qk.y * _get_quadrant_size() + _get_quadrant_size()));
+		r.expand_to(_map_to_world(qk.x * _get_quadrant_size(), qk.y * _get_quadrant_size() + _get_quadrant_size()));
+		if (first) {
 			r_total = r;
+			first = false;
 		} else {
 			r_total = r_total.merge(r);
 		}
@@ -730,10 +795,12 @@ void TileMap::_recompute_rect_cache() {
 #endif
 }
 
-Map<TileMap::PosKey, TileMap::Quadrant>::Element *TileMap::_create_quadrant(const PosKey &p_qk) {
+TileMap::Quadrant *TileMap::_create_quadrant(const PosKey &p_qk) {
 	Transform2D xform;
 	//xform.set_origin(Point2(p_qk.x,p_qk.y)*cell_size*quadrant_size);
-	Quadrant q;
+	Quadrant *quadrant = memnew(Quadrant);
+	Quadrant &q = *quadrant;
+	q.key = p_qk;
 	q.pos = _map_to_world(p_qk.x * _get_quadrant_size(), p_qk.y * _get_quadrant_size());
 	q.pos += get_cell_draw_offset();
 	if (tile_origin == TILE_ORIGIN_CENTER) {
@@ -770,11 +837,12 @@ Map<TileMap::PosKey, TileMap::Quadrant>::Element *TileMap::_create_quadrant(cons
 
 	rect_cache_dirty = true;
 	quadrant_order_dirty = true;
-	return quadrant_map.insert(p_qk, q);
+	quadrant_map.insert(p_qk, quadrant);
+	return quadrant;
 }
 
-void TileMap::_erase_quadrant(Map<PosKey, Quadrant>::Element *Q) {
-	Quadrant &q = Q->get();
+void TileMap::_erase_quadrant(Quadrant *p_q) {
+	Quadrant &q = *p_q;
 	if (!use_parent) {
 		PhysicsServer2D::get_singleton()->free(q.body);
 	} else if (collision_parent) {
@@ -801,12 +869,13 @@ void TileMap::_erase_quadrant(Map<PosKey, Quadrant>::Element *Q) {
 	}
 	q.occluder_instances.clear();
 
-	quadrant_map.erase(Q);
+	quadrant_map.remove(q.key);
+	memdelete(p_q);
 	rect_cache_dirty = true;
 }
 
-void TileMap::_make_quadrant_dirty(Map<PosKey, Quadrant>::Element *Q, bool update) {
-	Quadrant &q = Q->get();
+void TileMap::_make_quadrant_dirty(Quadrant *p_q, bool update) {
+	Quadrant &q = *p_q;
 	if (!q.dirty_list.in_list()) {
 		dirty_quadrant_list.add(&q.dirty_list);
 	}
@@ -838,7 +907,7 @@ void TileMap::_set_celld(const Vector2 &p_pos, const Dictionary &p_data) {
 void TileMap::set_cell(int p_x, int p_y, int p_tile, bool p_flip_x, bool p_flip_y, bool p_transpose, Vector2 p_autotile_coord) {
 	PosKey pk(p_x, p_y);
 
-	Map<PosKey, Cell>::Element *E = tile_map.find(pk);
+	Cell *E = tile_map.lookup_ptr(pk);
 	if (!E && p_tile == INVALID_CELL) {
 		return; //nothing to do
 	}
@@ -846,39 +915,40 @@ void TileMap::set_cell(int p_x, int p_y, int p_tile, bool p_flip_x, bool p_flip_
 	PosKey qk = pk.to_quadrant(_get_quadrant_size());
 	if (p_tile == INVALID_CELL) {
 		//erase existing
-		tile_map.erase(pk);
-		Map<PosKey, Quadrant>::Element *Q = quadrant_map.find(qk);
+		tile_map.remove(pk);
+		Quadrant **Q = quadrant_map.lookup_ptr(qk);
 		ERR_FAIL_COND(!Q);
-		Quadrant &q = Q->get();
+		Quadrant &q = **Q;
 		q.cells.erase(pk);
 		if (q.cells.size() == 0) {
-			_erase_quadrant(Q);
+			_erase_quadrant(*Q);
 		} else {
-			_make_quadrant_dirty(Q);
+			_make_quadrant_dirty(*Q);
 		}
 
 		used_size_cache_dirty = true;
 		return;
 	}
 
-	Map<PosKey, Quadrant>::Element *Q = quadrant_map.find(qk);
+	Quadrant **Q = quadrant_map.lookup_ptr(qk);
+	Quadrant *quadrant = Q ? *Q : nullptr;
 
 	if (!E) {
-		E = tile_map.insert(pk, Cell());
-		if (!Q) {
-			Q = _create_quadrant(qk);
+		tile_map.insert(pk, Cell());
+		E = tile_map.lookup_ptr(pk);
+		if (!quadrant) {
+			quadrant = _create_quadrant(qk);
 		}
-		Quadrant &q = Q->get();
-		q.cells.insert(pk);
+		quadrant->cells.insert(pk);
 	} else {
-		ERR_FAIL_COND(!Q); // quadrant should exist...
+		ERR_FAIL_COND(!quadrant); // quadrant should exist...
 
-		if (E->get().id == p_tile && E->get().flip_h == p_flip_x && E->get().flip_v == p_flip_y && E->get().transpose == p_transpose && E->get().autotile_coord_x == (uint16_t)p_autotile_coord.x && E->get().autotile_coord_y == (uint16_t)p_autotile_coord.y) {
+		if (E->id == p_tile && E->flip_h == p_flip_x && E->flip_v == p_flip_y && E->transpose == p_transpose && E->autotile_coord_x == (uint16_t)p_autotile_coord.x && E->autotile_coord_y == (uint16_t)p_autotile_coord.y) {
 			return; //nothing changed
 		}
 	}
 
-	Cell &c = E->get();
+	Cell &c = *E;
 
 	c.id = p_tile;
 	c.flip_h = p_flip_x;
@@ -887,7 +957,7 @@ void TileMap::set_cell(int p_x, int p_y, int p_tile, bool p_flip_x, bool p_flip_
 	c.autotile_coord_x = (uint16_t)p_autotile_coord.x;
 	c.autotile_coord_y = (uint16_t)p_autotile_coord.y;
 
-	_make_quadrant_dirty(Q);
+	_make_quadrant_dirty(quadrant);
 	used_size_cache_dirty = true;
 }
 
@@ -933,7 +1003,7 @@ void TileMap::update_bitmask_region(const Vector2 &p_start, const Vector2 &p_end
 void TileMap::update_cell_bitmask(int p_x, int p_y) {
 	ERR_FAIL_COND_MSG(tile_set.is_null(), "Cannot update cell bitmask if Tileset is not open.");
 	PosKey p(p_x, p_y);
-	Map<PosKey, Cell>::Element *E = tile_map.find(p);
+	Cell *E = tile_map.lookup_ptr(p);
 	if (E != nullptr) {
 		int id = get_cell(p_x, p_y);
 		if (tile_set->tile_get_tile_mode(id) == TileSet::AUTO_TILE) {
@@ -994,22 +1064,23 @@ void TileMap::update_cell_bitmask(int p_x, int p_y) {
 				}
 			}
 			Vector2 coord = tile_set->autotile_get_subtile_for_bitmask(id, mask, this, Vector2(p_x, p_y));
-			E->get().autotile_coord_x = (int)coord.x;
-			E->get().autotile_coord_y = (int)coord.y;
+			E->autotile_coord_x = (int)coord.x;
+			E->autotile_coord_y = (int)coord.y;
 
 			PosKey qk = p.to_quadrant(_get_quadrant_size());
-			Map<PosKey, Quadrant>::Element *Q = quadrant_map.find(qk);
-			_make_quadrant_dirty(Q);
+			Quadrant **Q = quadrant_map.lookup_ptr(qk);
+			ERR_FAIL_COND(!Q);
+			_make_quadrant_dirty(*Q);
 
 		} else if (tile_set->tile_get_tile_mode(id) == TileSet::SINGLE_TILE) {
-			E->get().autotile_coord_x = 0;
-			E->get().autotile_coord_y = 0;
+			E->autotile_coord_x = 0;
+			E->autotile_coord_y = 0;
 		} else if (tile_set->tile_get_tile_mode(id) == TileSet::ATLAS_TILE) {
 			if (tile_set->autotile_get_bitmask(id, Vector2(p_x, p_y)) == TileSet::BIND_CENTER) {
 				Vector2 coord = tile_set->atlastile_get_subtile_by_priority(id, this, Vector2(p_x, p_y));
 
-				E->get().autotile_coord_x = (int)coord.x;
-				E->get().autotile_coord_y = (int)coord.y;
+				E->autotile_coord_x = (int)coord.x;
+				E->autotile_coord_y = (int)coord.y;
 			}
 		}
 	}
@@ -1024,118 +1095,123 @@ void TileMap::update_dirty_bitmask() {
 
 void TileMap::fix_invalid_tiles() {
 	ERR_FAIL_COND_MSG(tile_set.is_null(), "Cannot fix invalid tiles if Tileset is not open.");
-	for (Map<PosKey, Cell>::Element *E = tile_map.front(); E; E = E->next()) {
-		if (!tile_set->has_tile(get_cell(E->key().x, E->key().y))) {
-			set_cell(E->key().x, E->key().y, INVALID_CELL);
+	// Erasing cells while iterating is not safe, collect them first.
+	LocalVector<PosKey> invalid_cells;
+	for (CellMap::Iterator E = tile_map.iter(); E.valid; E = tile_map.next_iter(E)) {
+		if (!tile_set->has_tile(E.value->id)) {
+			invalid_cells.push_back(*E.key);
 		}
 	}
+
+	for (uint32_t i = 0; i < invalid_cells.size(); i++) {
+		set_cell(invalid_cells[i].x, invalid_cells[i].y, INVALID_CELL);
+	}
 }
 
 int TileMap::get_cell(int p_x, int p_y) const {
 	PosKey pk(p_x, p_y);
 
-	const Map<PosKey, Cell>::Element *E = tile_map.find(pk);
+	const Cell *E = tile_map.lookup_ptr(pk);
 
 	if (!E) {
 		return INVALID_CELL;
 	}
 
-	return E->get().id;
+	return E->id;
 }
 
 bool TileMap::is_cell_x_flipped(int p_x, int p_y) const {
 	PosKey pk(p_x, p_y);
 
-	const Map<PosKey, Cell>::Element *E = tile_map.find(pk);
+	const Cell *E = tile_map.lookup_ptr(pk);
 
 	if (!E) {
 		return false;
 	}
 
-	return E->get().flip_h;
+	return E->flip_h;
 }
 
 bool TileMap::is_cell_y_flipped(int p_x, int p_y) const {
 	PosKey pk(p_x, p_y);
 
-	const Map<PosKey, Cell>::Element *E = tile_map.find(pk);
+	const Cell *E = tile_map.lookup_ptr(pk);
 
 	if (!E) {
 		return false;
 	}
 
-	return E->get().flip_v;
+	return E->flip_v;
 }
 
 bool TileMap::is_cell_transposed(int p_x, int p_y) const {
 	PosKey pk(p_x, p_y);
 
-	const Map<PosKey, Cell>::Element *E = tile_map.find(pk);
+	const Cell *E = tile_map.lookup_ptr(pk);
 
 	if (!E) {
 		return false;
 	}
 
-	return E->get().transpose;
+	return E->transpose;
 }
 
 void TileMap::set_cell_autotile_coord(int p_x, int p_y, const Vector2 &p_coord) {
 	PosKey pk(p_x, p_y);
 
-	const Map<PosKey, Cell>::Element *E = tile_map.find(pk);
+	Cell *E = tile_map.lookup_ptr(pk);
 
 	if (!E) {
 		return;
 	}
 
-	Cell c = E->get();
-	c.autotile_coord_x = p_coord.x;
-	c.autotile_coord_y = p_coord.y;
-	tile_map[pk] = c;
+	E->autotile_coord_x = p_coord.x;
+	E->autotile_coord_y = p_coord.y;
 
 	PosKey qk = pk.to_quadrant(_get_quadrant_size());
-	Map<PosKey, Quadrant>::Element *Q = quadrant_map.find(qk);
+	Quadrant **Q = quadrant_map.lookup_ptr(qk);
 
 	if (!Q) {
 		return;
 	}
 
-	_make_quadrant_dirty(Q);
+	_make_quadrant_dirty(*Q);
 }
 
 Vector2 TileMap::get_cell_autotile_coord(int p_x, int p_y) const {
 	PosKey pk(p_x, p_y);
 
-	const Map<PosKey, Cell>::Element *E = tile_map.find(pk);
+	const Cell *E = tile_map.lookup_ptr(pk);
 
 	if (!E) {
 		return Vector2();
 	}
 
-	return Vector2(E->get().autotile_coord_x, E->get().autotile_coord_y);
+	return Vector2(E->autotile_coord_x, E->autotile_coord_y);
 }
 
 void TileMap::_recreate_quadrants() {
 	_clear_quadrants();
 
-	for (Map<PosKey, Cell>::Element *E = tile_map.front(); E; E = E->next()) {
-		PosKey qk = PosKey(E->key().x, E->key().y).to_quadrant(_get_quadrant_size());
+	for (CellMap::Iterator E = tile_map.iter(); E.valid; E = tile_map.next_iter(E)) {
+		PosKey qk = E.key->to_quadrant(_get_quadrant_size());
 
-		Map<PosKey, Quadrant>::Element *Q = quadrant_map.find(qk);
-		if (!Q) {
-			Q = _create_quadrant(qk);
-			dirty_quadrant_list.add(&Q->get().dirty_list);
+		Quadrant **Q = quadrant_map.lookup_ptr(qk);
+		Quadrant *quadrant = Q ? *Q : nullptr;
+		if (!quadrant) {
+			quadrant = _create_quadrant(qk);
+			dirty_quadrant_list.add(&quadrant->dirty_list);
 		}
 
-		Q->get().cells.insert(E->key());
-		_make_quadrant_dirty(Q, false);
+		quadrant->cells.insert(*E.key);
+		_make_quadrant_dirty(quadrant, false);
 	}
 	update_dirty_quadrants();
 }
 
 void TileMap::_clear_quadrants() {
-	while (quadrant_map.size()) {
-		_erase_quadrant(quadrant_map.front());
+	while (!quadrant_map.empty()) {
+		_erase_quadrant(*quadrant_map.iter().value);
 	}
 }
 
@@ -1150,8 +1226,8 @@ void TileMap::set_use_parent_material(bool p_use_parent_material) {
 }
 
 void TileMap::_update_all_items_material_state() {
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
-		Quadrant &q = E->get();
+	for (QuadrantMap::Iterator E = quadrant_map.iter(); E.valid; E = quadrant_map.next_iter(E)) {
+		Quadrant &q = **E.value;
 		for (List<RID>::Element *F = q.canvas_items.front(); F; F = F->next()) {
 			_update_item_material_state(F->get());
 		}
@@ -1216,30 +1292,34 @@ void TileMap::_set_tile_data(const Vector<int> &p_data) {
 }
 
 Vector<int> TileMap::_get_tile_data() const {
+	LocalVector<PosKey> cells;
+	_get_sorted_cells(cells);
+
 	Vector<int> data;
-	data.resize(tile_map.size() * 3);
+	data.resize(cells.size() * 3);
 	int *w = data.ptrw();
 
 	// Save in highest format
 
 	int idx = 0;
-	for (const Map<PosKey, Cell>::Element *E = tile_map.front(); E; E = E->next()) {
+	for (uint32_t i = 0; i < cells.size(); i++) {
+		const Cell &c = *tile_map.lookup_ptr(cells[i]);
 		uint8_t *ptr = (uint8_t *)&w[idx];
-		encode_uint16(E->key().x, &ptr[0]);
-		encode_uint16(E->key().y, &ptr[2]);
-		uint32_t val = E->get().id;
-		if (E->get().flip_h) {
+		encode_uint16(cells[i].x, &ptr[0]);
+		encode_uint16(cells[i].y, &ptr[2]);
+		uint32_t val = c.id;
+		if (c.flip_h) {
 			val |= (1 << 29);
 		}
-		if (E->get().flip_v) {
+		if (c.flip_v) {
 			val |= (1 << 30);
 		}
-		if (E->get().transpose) {
+		if (c.transpose) {
 			val |= (1 << 31);
 		}
 		encode_uint32(val, &ptr[4]);
-		encode_uint16(E->get().autotile_coord_x, &ptr[8]);
-		encode_uint16(E->get().autotile_coord_y, &ptr[10]);
+		encode_uint16(c.autotile_coord_x, &ptr[8]);
+		encode_uint16(c.autotile_coord_y, &ptr[10]);
 		idx += 3;
 	}
 
@@ -1260,8 +1340,8 @@ Rect2 TileMap::_edit_get_rect() const {
 void TileMap::set_collision_layer(uint32_t p_layer) {
 	collision_layer = p_layer;
 	if (!use_parent) {
-		for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
-			Quadrant &q = E->get();
+		for (QuadrantMap::Iterator E = quadrant_map.iter(); E.valid; E = quadrant_map.next_iter(E)) {
+			Quadrant &q = **E.value;
 			PhysicsServer2D::get_singleton()->body_set_collision_layer(q.body, collision_layer);
 		}
 	}
@@ -1270,8 +1350,8 @@ void TileMap::set_collision_layer(uint32_t p_layer) {
 void TileMap::set_collision_mask(uint32_t p_mask) {
 	collision_mask = p_mask;
 	if (!use_parent) {
-		for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
-			Quadrant &q = E->get();
+		for (QuadrantMap::Iterator E = quadrant_map.iter(); E.valid; E = quadrant_map.next_iter(E)) {
+			Quadrant &q = **E.value;
 			PhysicsServer2D::get_singleton()->body_set_collision_mask(q.body, collision_mask);
 		}
 	}
@@ -1335,8 +1415,8 @@ void TileMap::set_collision_use_parent(bool p_use_parent) {
 void TileMap::set_collision_friction(float p_friction) {
 	friction = p_friction;
 	if (!use_parent) {
-		for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
-			Quadrant &q = E->get();
+		for (QuadrantMap::Iterator E = quadrant_map.iter(); E.valid; E = quadrant_map.next_iter(E)) {
+			Quadrant &q = **E.value;
 			PhysicsServer2D::get_singleton()->body_set_param(q.body, PhysicsServer2D::BODY_PARAM_FRICTION, p_friction);
 		}
 	}
@@ -1349,8 +1429,8 @@ float TileMap::get_collision_friction() const {
 void TileMap::set_collision_bounce(float p_bounce) {
 	bounce = p_bounce;
 	if (!use_parent) {
-		for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
-			Quadrant &q = E->get();
+		for (QuadrantMap::Iterator E = quadrant_map.iter(); E.valid; E = quadrant_map.next_iter(E)) {
+			Quadrant &q = **E.value;
 			PhysicsServer2D::get_singleton()->body_set_param(q.body, PhysicsServer2D::BODY_PARAM_BOUNCE, p_bounce);
 		}
 	}
@@ -1607,24 +1687,37 @@ bool TileMap::is_centered_textures_enabled() const {
 	return centered_textures;
 }
 
+void TileMap::_get_sorted_cells(LocalVector<PosKey> &r_cells) const {
+	r_cells.reserve(tile_map.get_num_elements());
+	for (CellMap::Iterator E = tile_map.iter(); E.valid; E = tile_map.next_iter(E)) {
+		r_cells.push_back(*E.key);
+	}
+
+	// Row by row, like the cells were always returned.
+	r_cells.sort();
+}
+
 TypedArray<Vector2i> TileMap::get_used_cells() const {
+	LocalVector<PosKey> cells;
+	_get_sorted_cells(cells);
+
 	TypedArray<Vector2i> a;
-	a.resize(tile_map.size());
-	int i = 0;
-	for (Map<PosKey, Cell>::Element *E = tile_map.front(); E; E = E->next()) {
-		Vector2i p(E->key().x, E->key().y);
-		a[i++] = p;
+	a.resize(cells.size());
+	for (uint32_t i = 0; i < cells.size(); i++) {
+		a[i] = Vector2i(cells[i].x, cells[i].y);
 	}
 
 	return a;
 }
 
 TypedArray<Vector2i> TileMap::get_used_cells_by_index(int p_id) const {
+	LocalVector<PosKey> cells;
+	_get_sorted_cells(cells);
+
 	TypedArray<Vector2i> a;
-	for (Map<PosKey, Cell>::Element *E = tile_map.front(); E; E = E->next()) {
-		if (E->value().id == p_id) {
-			Vector2i p(E->key().x, E->key().y);
-			a.push_back(p);
+	for (uint32_t i = 0; i < cells.size(); i++) {
+		if (tile_map.lookup_ptr(cells[i])->id == p_id) {
+			a.push_back(Vector2i(cells[i].x, cells[i].y));
 		}
 	}
 
@@ -1634,11 +1727,12 @@ TypedArray<Vector2i> TileMap::get_used_cells_by_index(int p_id) const {
 Rect2 TileMap::get_used_rect() { // Not const because of cache
 
 	if (used_size_cache_dirty) {
-		if (tile_map.size() > 0) {
-			used_size_cache = Rect2(tile_map.front()->key().x, tile_map.front()->key().y, 0, 0);
+		if (!tile_map.empty()) {
+			CellMap::Iterator E = tile_map.iter();
+			used_size_cache = Rect2(E.key->x, E.key->y, 0, 0);
 
-			for (Map<PosKey, Cell>::Element *E = tile_map.front(); E; E = E->next()) {
-				used_size_cache.expand_to(Vector2(E->key().x, E->key().y));
+			for (; E.valid; E = tile_map.next_iter(E)) {
+				used_size_cache.expand_to(Vector2(E.key->x, E.key->y));
 			}
 
 			used_size_cache.size += Vector2(1, 1);
@@ -1654,8 +1748,8 @@ Rect2 TileMap::get_used_rect() { // Not const because of cache
 
 void TileMap::set_occluder_light_mask(int p_mask) {
 	occluder_light_mask = p_mask;
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
-		for (Map<PosKey, Quadrant::Occluder>::Element *F = E->get().occluder_instances.front(); F; F = F->next()) {
+	for (QuadrantMap::Iterator E = quadrant_map.iter(); E.valid; E = quadrant_map.next_iter(E)) {
+		for (Map<PosKey, Quadrant::Occluder>::Element *F = (*E.value)->occluder_instances.front(); F; F = F->next()) {
 			RenderingServer::get_singleton()->canvas_light_occluder_set_light_mask(F->get().id, occluder_light_mask);
 		}
 	}
@@ -1667,8 +1761,8 @@ int TileMap::get_occluder_light_mask() const {
 
 void TileMap::set_light_mask(int p_light_mask) {
 	CanvasItem::set_light_mask(p_light_mask);
-	for (Map<PosKey, Quadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
-		for (List<RID>::Element *F = E->get().canvas_items.front(); F; F = F->next()) {
+	for (QuadrantMap::Iterator E = quadrant_map.iter(); E.valid; E = quadrant_map.next_iter(E)) {
+		for (List<RID>::Element *F = (*E.value)->canvas_items.front(); F; F = F->next()) {
 			RenderingServer::get_singleton()->canvas_item_set_light_mask(F->get(), get_light_mask());
 		}
 	}
@@ -1690,22 +1784,22 @@ bool TileMap::get_clip_uv() const {
 
 void TileMap::set_texture_filter(TextureFilter p_texture_filter) {
 	CanvasItem::set_texture_filter(p_texture_filter);
-	for (Map<PosKey, Quadrant>::Element *F = quadrant_map.front(); F; F = F->next()) {
-		Quadrant &q = F->get();
+	for (QuadrantMap::Iterator F = quadrant_map.iter(); F.valid; F = quadrant_map.next_iter(F)) {
+		Quadrant &q = **F.value;
 		for (List<RID>::Element *E = q.canvas_items.front(); E; E = E->next()) {
 			RenderingServer::get_singleton()->canvas_item_set_default_texture_filter(E->get(), RS::CanvasItemTextureFilter(p_texture_filter));
-			_make_quadrant_dirty(F);
+			_make_quadrant_dirty(*F.value);
 		}
 	}
 }
 
 void TileMap::set_texture_repeat(CanvasItem::TextureRepeat p_texture_repeat) {
 	CanvasItem::set_texture_repeat(p_texture_repeat);
-	for (Map<PosKey, Quadrant>::Element *F = quadrant_map.front(); F; F = F->next()) {
-		Quadrant &q = F->get();
+	for (QuadrantMap::Iterator F = quadrant_map.iter(); F.valid; F = quadrant_map.next_iter(F)) {
+		Quadrant &q = **F.value;
 		for (List<RID>::Element *E = q.canvas_items.front(); E; E = E->next()) {
 			RenderingServer::get_singleton()->canvas_item_set_default_texture_repeat(E->get(), RS::CanvasItemTextureRepeat(p_texture_repeat));
-			_make_quadrant_dirty(F);
+			_make_quadrant_dirty(*F.value);
 		}
 	}
 }
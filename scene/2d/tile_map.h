@@ -31,6 +31,8 @@
 #ifndef TILE_MAP_H
 #define TILE_MAP_H
 
+#include "core/templates/local_vector.h"
+#include "core/templates/oa_hash_map.h"
 #include "core/templates/self_list.h"
 #include "core/templates/vset.h"
 #include "scene/2d/navigation_2d.h"
@@ -109,6 +111,10 @@ private:
 		}
 	};
 
+	struct PosKeyHasher {
+		static _FORCE_INLINE_ uint32_t hash(const PosKey &p_key) { return hash_djb2_one_32(p_key.key); }
+	};
+
 	union Cell {
 		struct {
 			int32_t id : 24;
@@ -123,10 +129,12 @@ private:
 		Cell() { _u64t = 0; }
 	};
 
-	Map<PosKey, Cell> tile_map;
+	typedef OAHashMap<PosKey, Cell, PosKeyHasher> CellMap;
+	CellMap tile_map;
 	List<PosKey> dirty_bitmask;
 
 	struct Quadrant {
+		PosKey key;
 		Vector2 pos;
 		List<RID> canvas_items;
 		RID body;
@@ -150,6 +158,7 @@ private:
 		VSet<PosKey> cells;
 
 		void operator=(const Quadrant &q) {
+			key = q.key;
 			pos = q.pos;
 			canvas_items = q.canvas_items;
 			body = q.body;
@@ -160,6 +169,7 @@ private:
 		}
 		Quadrant(const Quadrant &q) :
 				dirty_list(this) {
+			key = q.key;
 			pos = q.pos;
 			canvas_items = q.canvas_items;
 			body = q.body;
@@ -172,7 +182,9 @@ private:
 				dirty_list(this) {}
 	};
 
-	Map<PosKey, Quadrant> quadrant_map;
+	// Quadrants are allocated separately, so they keep their address when the map grows.
+	typedef OAHashMap<PosKey, Quadrant *, PosKeyHasher> QuadrantMap;
+	QuadrantMap quadrant_map;
 
 	SelfList<Quadrant>::List dirty_quadrant_list;
 
@@ -198,13 +210,48 @@ private:
 
 	int occluder_light_mask;
 
-	void _fix_cell_transform(Transform2D &xform, const Cell &p_cell, const Vector2 &p_offset, const Size2 &p_sc);
+	// Cells of a dirty quadrant, prepared on worker threads so that only the server
+	// calls are left for the main thread.
+	struct CellUpdate {
+		PosKey key;
+		Ref<Texture2D> texture;
+		Ref<ShaderMaterial> material;
+		int z_index = 0;
+		Rect2 rect;
+		Rect2 region;
+		Color modulate;
+		bool transpose = false;
+		uint32_t shape_from = 0;
+		uint32_t shape_count = 0;
+		Ref<NavigationPolygon> navpoly;
+		Transform2D navpoly_xform;
+		Transform2D navpoly_local_xform;
+		Ref<OccluderPolygon2D> occluder;
+		Transform2D occluder_xform;
+	};
+
+	struct CellShapeUpdate {
+		TileSet::ShapeData data;
+		Transform2D xform;
+	};
+
+	struct QuadrantUpdate {
+		Quadrant *quadrant = nullptr;
+		LocalVector<CellUpdate> cells;
+		LocalVector<CellShapeUpdate> shapes;
+	};
+
+	void _prepare_quadrant_update(uint32_t p_index, QuadrantUpdate *p_updates);
+	void _commit_quadrant_update(QuadrantUpdate &p_update);
+	void _get_sorted_cells(LocalVector<PosKey> &r_cells) const;
+
+	void _fix_cell_transform(Transform2D &xform, const Cell &p_cell, const Vector2 &p_offset, const Size2 &p_sc) const;
 
 	void _add_shape(int &shape_idx, const Quadrant &p_q, const Ref<Shape2D> &p_shape, const TileSet::ShapeData &p_shape_data, const Transform2D &p_xform, const Vector2 &p_metadata);
 
-	Map<PosKey, Quadrant>::Element *_create_quadrant(const PosKey &p_qk);
-	void _erase_quadrant(Map<PosKey, Quadrant>::Element *Q);
-	void _make_quadrant_dirty(Map<PosKey, Quadrant>::Element *Q, bool update = true);
+	Quadrant *_create_quadrant(const PosKey &p_qk);
+	void _erase_quadrant(Quadrant *p_q);
+	void _make_quadrant_dirty(Quadrant *p_q, bool update = true);
 	void _recreate_quadrants();
 	void _clear_quadrants();
 	void _update_quadrant_space(const RID &p_space);
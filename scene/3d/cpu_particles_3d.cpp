@@ -1026,14 +1026,19 @@ void CPUParticles3D::_update_particle_data_buffer() {
 		}
 	}
 
+	if (!local_coords) {
+		particle_xforms.resize(pc);
+		Transform *xforms = particle_xforms.ptrw();
+		for (int i = 0; i < pc; i++) {
+			xforms[i] = r[order ? order[i] : i].transform;
+		}
+		inv_emission_transform.xform_array(xforms, xforms, pc);
+	}
+
 	for (int i = 0; i < pc; i++) {
 		int idx = order ? order[i] : i;
 
-		Transform t = r[idx].transform;
-
-		if (!local_coords) {
-			t = inv_emission_transform * t;
-		}
+		const Transform &t = local_coords ? r[idx].transform : particle_xforms[i];
 
 		if (r[idx].active) {
 			ptr[0] = t.basis.elements[0][0];
@@ -1137,8 +1142,15 @@ void CPUParticles3D::_notification(int p_what) {
 			const Particle *r = particles.ptr();
 			float *ptr = w;
 
+			particle_xforms.resize(pc);
+			Transform *xforms = particle_xforms.ptrw();
+			for (int i = 0; i < pc; i++) {
+				xforms[i] = r[i].transform;
+			}
+			inv_emission_transform.xform_array(xforms, xforms, pc);
+
 			for (int i = 0; i < pc; i++) {
-				Transform t = inv_emission_transform * r[i].transform;
+				const Transform &t = xforms[i];
 
 				if (r[i].active) {
 					ptr[0] = t.basis.elements[0][0];
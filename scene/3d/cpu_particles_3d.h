@@ -109,6 +109,7 @@ private:
 	Vector<Particle> particles;
 	Vector<float> particle_data;
 	Vector<int> particle_order;
+	Vector<Transform> particle_xforms; // Particles moved into local space, when using global coordinates.
 
 	struct SortLifetime {
 		const Particle *particles;
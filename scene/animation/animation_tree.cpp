@@ -542,8 +542,9 @@ bool AnimationTree::_update_caches(AnimationPlayer *player) {
 			Animation::TrackType track_type = anim->track_get_type(i);
 
 			TrackCache *track = nullptr;
-			if (track_cache.has(path)) {
-				track = track_cache.get(path);
+			TrackCache **track_ptr = track_cache.getptr(path);
+			if (track_ptr) {
+				track = *track_ptr;
 			}
 
 			//if not valid, delete track
@@ -672,29 +673,18 @@ bool AnimationTree::_update_caches(AnimationPlayer *player) {
 		}
 	}
 
-	List<NodePath> to_delete;
-
-	const NodePath *K = nullptr;
-	while ((K = track_cache.next(K))) {
-		TrackCache *tc = track_cache[*K];
-		if (tc->setup_pass != setup_pass) {
-			to_delete.push_back(*K);
+	for (OrderedHashMap<NodePath, TrackCache *>::Element E = track_cache.front(); E; E = E.next()) {
+		if (E.value()->setup_pass != setup_pass) {
+			memdelete(E.value());
+			track_cache.erase(E);
 		}
 	}
 
-	while (to_delete.front()) {
-		NodePath np = to_delete.front()->get();
-		memdelete(track_cache[np]);
-		track_cache.erase(np);
-		to_delete.pop_front();
-	}
-
 	state.track_map.clear();
 
-	K = nullptr;
 	int idx = 0;
-	while ((K = track_cache.next(K))) {
-		state.track_map[*K] = idx;
+	for (OrderedHashMap<NodePath, TrackCache *>::Element E = track_cache.front(); E; E = E.next()) {
+		state.track_map[E.key()] = idx;
 		idx++;
 	}
 
@@ -706,9 +696,8 @@ bool AnimationTree::_update_caches(AnimationPlayer *player) {
 }
 
 void AnimationTree::_clear_caches() {
-	const NodePath *K = nullptr;
-	while ((K = track_cache.next(K))) {
-		memdelete(track_cache[*K]);
+	for (OrderedHashMap<NodePath, TrackCache *>::Element E = track_cache.front(); E; E = E.next()) {
+		memdelete(E.value());
 	}
 	playing_caches.clear();
 
@@ -825,9 +814,10 @@ void AnimationTree::_process_graph(float p_delta) {
 			for (int i = 0; i < a->get_track_count(); i++) {
 				NodePath path = a->track_get_path(i);
 
-				ERR_CONTINUE(!track_cache.has(path));
+				TrackCache **track_ptr = track_cache.getptr(path);
+				ERR_CONTINUE(!track_ptr);
 
-				TrackCache *track = track_cache[path];
+				TrackCache *track = *track_ptr;
 				if (track->type != a->track_get_type(i)) {
 					continue; //may happen should not
 				}
@@ -1182,9 +1172,8 @@ void AnimationTree::_process_graph(float p_delta) {
 
 	{
 		// finally, set the tracks
-		const NodePath *K = nullptr;
-		while ((K = track_cache.next(K))) {
-			TrackCache *track = track_cache[*K];
+		for (OrderedHashMap<NodePath, TrackCache *>::Element E = track_cache.front(); E; E = E.next()) {
+			TrackCache *track = E.value();
 			if (track->process_pass != process_pass) {
 				continue; //not processed, ignore
 			}
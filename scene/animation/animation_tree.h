@@ -32,6 +32,7 @@
 #define ANIMATION_GRAPH_PLAYER_H
 
 #include "animation_player.h"
+#include "core/templates/ordered_hash_map.h"
 #include "scene/3d/node_3d.h"
 #include "scene/3d/skeleton_3d.h"
 #include "scene/resources/animation.h"
@@ -245,7 +246,7 @@ private:
 		}
 	};
 
-	HashMap<NodePath, TrackCache *> track_cache;
+	OrderedHashMap<NodePath, TrackCache *> track_cache;
 	Set<TrackCache *> playing_caches;
 
 	Ref<AnimationNode> root;
@@ -32,126 +32,51 @@
 
 #include "core/config/engine.h"
 
-void AudioStreamPlayer::_mix_to_bus(const AudioFrame *p_frames, int p_amount) {
-	int bus_index = AudioServer::get_singleton()->thread_find_bus_index(bus);
-
-	AudioFrame *targets[4] = { nullptr, nullptr, nullptr, nullptr };
-
-	if (AudioServer::get_singleton()->get_speaker_mode() == AudioServer::SPEAKER_MODE_STEREO) {
-		targets[0] = AudioServer::get_singleton()->thread_get_channel_mix_buffer(bus_index, 0);
-	} else {
-		switch (mix_target) {
-			case MIX_TARGET_STEREO: {
-				targets[0] = AudioServer::get_singleton()->thread_get_channel_mix_buffer(bus_index, 0);
-			} break;
-			case MIX_TARGET_SURROUND: {
-				for (int i = 0; i < AudioServer::get_singleton()->get_channel_count(); i++) {
-					targets[i] = AudioServer::get_singleton()->thread_get_channel_mix_buffer(bus_index, i);
-				}
-			} break;
-			case MIX_TARGET_CENTER: {
-				targets[0] = AudioServer::get_singleton()->thread_get_channel_mix_buffer(bus_index, 1);
-			} break;
+void AudioStreamPlayer::_update_voice_volume() {
+	AudioServer *audio_server = AudioServer::get_singleton();
+
+	for (int i = 0; i < AudioServer::MAX_CHANNELS_PER_BUS; i++) {
+		bool used = false;
+
+		if (audio_server->get_speaker_mode() == AudioServer::SPEAKER_MODE_STEREO) {
+			used = i == 0;
+		} else {
+			switch (mix_target) {
+				case MIX_TARGET_STEREO: {
+					used = i == 0;
+				} break;
+				case MIX_TARGET_SURROUND: {
+					used = i < audio_server->get_channel_count();
+				} break;
+				case MIX_TARGET_CENTER: {
+					used = i == 1;
+				} break;
+			}
 		}
-	}
 
-	for (int c = 0; c < 4; c++) {
-		if (!targets[c]) {
-			break;
-		}
-		for (int i = 0; i < p_amount; i++) {
-			targets[c][i] += p_frames[i];
-		}
+		audio_server->voice_set_channel_volume(voice, i, used ? AudioFrame(1, 1) : AudioFrame(0, 0));
 	}
 }
 
-void AudioStreamPlayer::_mix_internal(bool p_fadeout) {
-	//get data
-	AudioFrame *buffer = mix_buffer.ptrw();
-	int buffer_size = mix_buffer.size();
-
-	if (p_fadeout) {
-		// Short fadeout ramp
-		buffer_size = MIN(buffer_size, 128);
-	}
-
-	stream_playback->mix(buffer, pitch_scale, buffer_size);
-
-	//multiply volume interpolating to avoid clicks if this changes
-	float target_volume = p_fadeout ? -80.0 : volume_db;
-	float vol = Math::db2linear(mix_volume_db);
-	float vol_inc = (Math::db2linear(target_volume) - vol) / float(buffer_size);
-
-	for (int i = 0; i < buffer_size; i++) {
-		buffer[i] *= vol;
-		vol += vol_inc;
-	}
-
-	//set volume for next mix
-	mix_volume_db = target_volume;
-
-	_mix_to_bus(buffer, buffer_size);
-}
-
-void AudioStreamPlayer::_mix_audio() {
-	if (use_fadeout) {
-		_mix_to_bus(fadeout_buffer.ptr(), fadeout_buffer.size());
-		use_fadeout = false;
-	}
-
-	if (!stream_playback.is_valid() || !active ||
-			(stream_paused && !stream_paused_fade)) {
-		return;
-	}
-
-	if (stream_paused) {
-		if (stream_paused_fade) {
-			_mix_internal(true);
-			stream_paused_fade = false;
-		}
-		return;
-	}
-
-	if (setstop) {
-		_mix_internal(true);
-		stream_playback->stop();
-		setstop = false;
-	}
-
-	if (setseek >= 0.0 && !stop_has_priority) {
-		if (stream_playback->is_playing()) {
-			//fade out to avoid pops
-			_mix_internal(true);
-		}
-
-		stream_playback->start(setseek);
-		setseek = -1.0; //reset seek
-		mix_volume_db = volume_db; //reset ramp
-	}
-
-	stop_has_priority = false;
-
-	_mix_internal(false);
-}
-
 void AudioStreamPlayer::_notification(int p_what) {
 	if (p_what == NOTIFICATION_ENTER_TREE) {
-		AudioServer::get_singleton()->add_callback(_mix_audios, this);
+		AudioServer::get_singleton()->voice_set_paused(voice, stream_paused);
 		if (autoplay && !Engine::get_singleton()->is_editor_hint()) {
 			play();
 		}
 	}
 
 	if (p_what == NOTIFICATION_INTERNAL_PROCESS) {
-		if (!active || (setseek < 0 && !stream_playback->is_playing())) {
-			active = false;
+		if (!AudioServer::get_singleton()->voice_is_playing(voice)) {
+			voice = 0;
 			set_process_internal(false);
 			emit_signal("finished");
 		}
 	}
 
 	if (p_what == NOTIFICATION_EXIT_TREE) {
-		AudioServer::get_singleton()->remove_callback(_mix_audios, this);
+		// Keep the voice, so playback resumes if the node enters the tree again.
+		AudioServer::get_singleton()->voice_set_paused(voice, true);
 	}
 
 	if (p_what == NOTIFICATION_PAUSED) {
@@ -167,47 +92,18 @@ void AudioStreamPlayer::_notification(int p_what) {
 }
 
 void AudioStreamPlayer::set_stream(Ref<AudioStream> p_stream) {
-	AudioServer::get_singleton()->lock();
-
-	if (active && stream_playback.is_valid() && !stream_paused) {
-		//changing streams out of the blue is not a great idea, but at least
-		//lets try to somehow avoid a click
-
-		AudioFrame *buffer = fadeout_buffer.ptrw();
-		int buffer_size = fadeout_buffer.size();
-
-		stream_playback->mix(buffer, pitch_scale, buffer_size);
-
-		//multiply volume interpolating to avoid clicks if this changes
-		float target_volume = -80.0;
-		float vol = Math::db2linear(mix_volume_db);
-		float vol_inc = (Math::db2linear(target_volume) - vol) / float(buffer_size);
-
-		for (int i = 0; i < buffer_size; i++) {
-			buffer[i] *= vol;
-			vol += vol_inc;
-		}
+	// The voice keeps a reference to the old playback, so it can fade out on its own.
+	AudioServer::get_singleton()->voice_stop(voice);
+	voice = 0;
 
-		use_fadeout = true;
-	}
-
-	mix_buffer.resize(AudioServer::get_singleton()->thread_get_mix_buffer_size());
-
-	if (stream_playback.is_valid()) {
-		stream_playback.unref();
-		stream.unref();
-		active = false;
-		setseek = -1;
-		setstop = false;
-	}
+	stream_playback.unref();
+	stream.unref();
 
 	if (p_stream.is_valid()) {
 		stream = p_stream;
 		stream_playback = p_stream->instance_playback();
 	}
 
-	AudioServer::get_singleton()->unlock();
-
 	if (p_stream.is_valid() && stream_playback.is_null()) {
 		stream.unref();
 	}
@@ -219,6 +115,7 @@ Ref<AudioStream> AudioStreamPlayer::get_stream() const {
 
 void AudioStreamPlayer::set_volume_db(float p_volume) {
 	volume_db = p_volume;
+	AudioServer::get_singleton()->voice_set_volume_db(voice, volume_db);
 }
 
 float AudioStreamPlayer::get_volume_db() const {
@@ -228,56 +125,63 @@ float AudioStreamPlayer::get_volume_db() const {
 void AudioStreamPlayer::set_pitch_scale(float p_pitch_scale) {
 	ERR_FAIL_COND(p_pitch_scale <= 0.0);
 	pitch_scale = p_pitch_scale;
+	AudioServer::get_singleton()->voice_set_pitch_scale(voice, pitch_scale);
 }
 
 float AudioStreamPlayer::get_pitch_scale() const {
 	return pitch_scale;
 }
 
+void AudioStreamPlayer::set_priority(int p_priority) {
+	priority = p_priority;
+	AudioServer::get_singleton()->voice_set_priority(voice, priority);
+}
+
+int AudioStreamPlayer::get_priority() const {
+	return priority;
+}
+
 void AudioStreamPlayer::play(float p_from_pos) {
-	if (stream_playback.is_valid()) {
-		//mix_volume_db = volume_db; do not reset volume ramp here, can cause clicks
-		setseek = p_from_pos;
-		stop_has_priority = false;
-		active = true;
-		set_process_internal(true);
+	if (stream_playback.is_null()) {
+		return;
+	}
+
+	AudioServer *audio_server = AudioServer::get_singleton();
+
+	if (audio_server->voice_is_playing(voice)) {
+		//the server fades out before seeking, avoiding pops
+		audio_server->voice_seek(voice, p_from_pos);
+	} else {
+		//lock, so the voice is not mixed before it's fully set up
+		audio_server->lock();
+		voice = audio_server->voice_play(stream, bus, volume_db, pitch_scale, priority, p_from_pos, stream_playback);
+		_update_voice_volume();
+		audio_server->voice_set_paused(voice, stream_paused || !is_inside_tree());
+		audio_server->unlock();
 	}
+
+	set_process_internal(true);
 }
 
 void AudioStreamPlayer::seek(float p_seconds) {
-	if (stream_playback.is_valid()) {
-		setseek = p_seconds;
-	}
+	AudioServer::get_singleton()->voice_seek(voice, p_seconds);
 }
 
 void AudioStreamPlayer::stop() {
-	if (stream_playback.is_valid() && active) {
-		setstop = true;
-		stop_has_priority = true;
-	}
+	AudioServer::get_singleton()->voice_stop(voice);
 }
 
 bool AudioStreamPlayer::is_playing() const {
-	if (stream_playback.is_valid()) {
-		return active && !setstop; //&& stream_playback->is_playing();
-	}
-
-	return false;
+	return AudioServer::get_singleton()->voice_is_playing(voice);
 }
 
 float AudioStreamPlayer::get_playback_position() {
-	if (stream_playback.is_valid()) {
-		return stream_playback->get_playback_position();
-	}
-
-	return 0;
+	return AudioServer::get_singleton()->voice_get_playback_position(voice);
 }
 
 void AudioStreamPlayer::set_bus(const StringName &p_bus) {
-	//if audio is active, must lock this
-	AudioServer::get_singleton()->lock();
 	bus = p_bus;
-	AudioServer::get_singleton()->unlock();
+	AudioServer::get_singleton()->voice_set_bus(voice, bus);
 }
 
 StringName AudioStreamPlayer::get_bus() const {
@@ -299,6 +203,7 @@ bool AudioStreamPlayer::is_autoplay_enabled() {
 
 void AudioStreamPlayer::set_mix_target(MixTarget p_target) {
 	mix_target = p_target;
+	_update_voice_volume();
 }
 
 AudioStreamPlayer::MixTarget AudioStreamPlayer::get_mix_target() const {
@@ -314,14 +219,12 @@ void AudioStreamPlayer::_set_playing(bool p_enable) {
 }
 
 bool AudioStreamPlayer::_is_active() const {
-	return active;
+	return AudioServer::get_singleton()->voice_is_playing(voice);
 }
 
 void AudioStreamPlayer::set_stream_paused(bool p_pause) {
-	if (p_pause != stream_paused) {
-		stream_paused = p_pause;
-		stream_paused_fade = p_pause;
-	}
+	stream_paused = p_pause;
+	AudioServer::get_singleton()->voice_set_paused(voice, stream_paused || !is_inside_tree());
 }
 
 bool AudioStreamPlayer::get_stream_paused() const {
@@ -361,6 +264,9 @@ void AudioStreamPlayer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_pitch_scale", "pitch_scale"), &AudioStreamPlayer::set_pitch_scale);
 	ClassDB::bind_method(D_METHOD("get_pitch_scale"), &AudioStreamPlayer::get_pitch_scale);
 
+	ClassDB::bind_method(D_METHOD("set_priority", "priority"), &AudioStreamPlayer::set_priority);
+	ClassDB::bind_method(D_METHOD("get_priority"), &AudioStreamPlayer::get_priority);
+
 	ClassDB::bind_method(D_METHOD("play", "from_position"), &AudioStreamPlayer::play, DEFVAL(0.0));
 	ClassDB::bind_method(D_METHOD("seek", "to_position"), &AudioStreamPlayer::seek);
 	ClassDB::bind_method(D_METHOD("stop"), &AudioStreamPlayer::stop);
@@ -393,6 +299,7 @@ void AudioStreamPlayer::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "stream_paused", PROPERTY_HINT_NONE, ""), "set_stream_paused", "get_stream_paused");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "mix_target", PROPERTY_HINT_ENUM, "Stereo,Surround,Center"), "set_mix_target", "get_mix_target");
 	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "bus", PROPERTY_HINT_ENUM, ""), "set_bus", "get_bus");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "priority"), "set_priority", "get_priority");
 
 	ADD_SIGNAL(MethodInfo("finished"));
 
@@ -402,21 +309,17 @@ void AudioStreamPlayer::_bind_methods() {
 }
 
 AudioStreamPlayer::AudioStreamPlayer() {
-	mix_volume_db = 0;
+	voice = 0;
 	pitch_scale = 1.0;
 	volume_db = 0;
+	priority = 0;
 	autoplay = false;
-	setseek = -1;
-	active = false;
 	stream_paused = false;
-	stream_paused_fade = false;
 	mix_target = MIX_TARGET_STEREO;
-	fadeout_buffer.resize(512);
-	setstop = false;
-	use_fadeout = false;
 
 	AudioServer::get_singleton()->connect("bus_layout_changed", callable_mp(this, &AudioStreamPlayer::_bus_layout_changed));
 }
 
 AudioStreamPlayer::~AudioStreamPlayer() {
+	AudioServer::get_singleton()->voice_stop(voice);
 }
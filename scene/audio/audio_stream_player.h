@@ -47,34 +47,23 @@ public:
 private:
 	Ref<AudioStreamPlayback> stream_playback;
 	Ref<AudioStream> stream;
-	Vector<AudioFrame> mix_buffer;
-	Vector<AudioFrame> fadeout_buffer;
-	bool use_fadeout;
+	AudioServer::VoiceID voice;
 
-	volatile float setseek;
-	volatile bool active;
-	volatile bool setstop;
-	volatile bool stop_has_priority;
-
-	float mix_volume_db;
 	float pitch_scale;
 	float volume_db;
+	int priority;
 	bool autoplay;
 	bool stream_paused;
-	bool stream_paused_fade;
 	StringName bus;
 
 	MixTarget mix_target;
 
-	void _mix_internal(bool p_fadeout);
-	void _mix_audio();
-	static void _mix_audios(void *self) { reinterpret_cast<AudioStreamPlayer *>(self)->_mix_audio(); }
+	void _update_voice_volume();
 
 	void _set_playing(bool p_enable);
 	bool _is_active() const;
 
 	void _bus_layout_changed();
-	void _mix_to_bus(const AudioFrame *p_frames, int p_amount);
 
 protected:
 	void _validate_property(PropertyInfo &property) const override;
@@ -91,6 +80,9 @@ public:
 	void set_pitch_scale(float p_pitch_scale);
 	float get_pitch_scale() const;
 
+	void set_priority(int p_priority);
+	int get_priority() const;
+
 	void play(float p_from_pos = 0.0);
 	void seek(float p_seconds);
 	void stop();
@@ -30,6 +30,8 @@
 
 #include "mesh.h"
 
+#include "core/math/mesh_optimizer.h"
+#include "core/math/mesh_simplifier.h"
 #include "core/templates/pair.h"
 #include "scene/resources/concave_polygon_shape_3d.h"
 #include "scene/resources/convex_polygon_shape_3d.h"
@@ -526,12 +528,12 @@ void Mesh::clear_cache() const {
 	debug_lines.clear();
 }
 
-Vector<Ref<Shape3D>> Mesh::convex_decompose() const {
+Vector<Ref<Shape3D>> Mesh::convex_decompose(const ConvexDecompositionSettings &p_settings) const {
 	ERR_FAIL_COND_V(!convex_composition_function, Vector<Ref<Shape3D>>());
 
 	const Vector<Face3> faces = get_faces();
 
-	Vector<Vector<Face3>> decomposed = convex_composition_function(faces);
+	Vector<Vector<Face3>> decomposed = convex_composition_function(faces, p_settings);
 
 	Vector<Ref<Shape3D>> ret;
 
@@ -1361,7 +1363,13 @@ Error ArrayMesh::lightmap_unwrap_cached(int *&r_cache_data, unsigned int &r_cach
 		const Vector3 *r = rvertices.ptr();
 
 		Vector<Vector3> rnormals = arrays[Mesh::ARRAY_NORMAL];
-		const Vector3 *rn = rnormals.ptr();
+
+		Vector<Vector3> xvertices = transform.xform(rvertices);
+		const Vector3 *xr = xvertices.ptr();
+		Vector<Vector3> xnormals;
+		xnormals.resize(rnormals.size());
+		normal_basis.xform_array(rnormals.ptr(), xnormals.ptrw(), rnormals.size());
+		const Vector3 *xrn = xnormals.ptr();
 
 		int vertex_ofs = vertices.size() / 3;
 
@@ -1370,8 +1378,8 @@ Error ArrayMesh::lightmap_unwrap_cached(int *&r_cache_data, unsigned int &r_cach
 		uv_indices.resize(vertex_ofs + vc);
 
 		for (int j = 0; j < vc; j++) {
-			Vector3 v = transform.xform(r[j]);
-			Vector3 n = normal_basis.xform(rn[j]).normalized();
+			const Vector3 &v = xr[j];
+			Vector3 n = xrn[j].normalized();
 
 			vertices.write[(j + vertex_ofs) * 3 + 0] = v.x;
 			vertices.write[(j + vertex_ofs) * 3 + 1] = v.y;
@@ -1504,6 +1512,221 @@ Error ArrayMesh::lightmap_unwrap_cached(int *&r_cache_data, unsigned int &r_cach
 	return OK;
 }
 
+// Everything needed to add a surface back after clearing them, for the passes that rebuild the index and vertex arrays.
+struct ArrayMeshRebuildSurface {
+	Mesh::PrimitiveType primitive;
+	uint32_t flags;
+	Array arrays;
+	Array blend_shape_arrays;
+	Dictionary lods;
+	Ref<Material> material;
+	String name;
+};
+
+static ArrayMeshRebuildSurface _get_rebuild_surface(const ArrayMesh *p_mesh, int p_surface) {
+	ArrayMeshRebuildSurface s;
+	s.primitive = p_mesh->surface_get_primitive_type(p_surface);
+	s.flags = p_mesh->surface_get_format(p_surface) & ~((1 << Mesh::ARRAY_MAX) - 1);
+	s.arrays = p_mesh->surface_get_arrays(p_surface);
+	s.blend_shape_arrays = p_mesh->surface_get_blend_shape_arrays(p_surface);
+	s.lods = p_mesh->surface_get_lods(p_surface);
+	s.material = p_mesh->surface_get_material(p_surface);
+	s.name = p_mesh->surface_get_name(p_surface);
+	return s;
+}
+
+static void _rebuild_surfaces(ArrayMesh *p_mesh, const Vector<ArrayMeshRebuildSurface> &p_surfaces) {
+	p_mesh->clear_surfaces();
+
+	for (int i = 0; i < p_surfaces.size(); i++) {
+		const ArrayMeshRebuildSurface &s = p_surfaces[i];
+		p_mesh->add_surface_from_arrays(s.primitive, s.arrays, s.blend_shape_arrays, s.lods, s.flags);
+		p_mesh->surface_set_material(i, s.material);
+		p_mesh->surface_set_name(i, s.name);
+	}
+}
+
+template <class T>
+static Vector<T> _remap_vertex_array(const Vector<T> &p_array, const Vector<int> &p_remap, int p_vertex_count) {
+	int stride = p_array.size() / p_remap.size();
+	ERR_FAIL_COND_V(stride * p_remap.size() != p_array.size(), p_array);
+
+	Vector<T> result;
+	result.resize(p_vertex_count * stride);
+	const T *r = p_array.ptr();
+	T *w = result.ptrw();
+
+	for (int i = 0; i < p_remap.size(); i++) {
+		if (p_remap[i] < 0) {
+			continue;
+		}
+		for (int j = 0; j < stride; j++) {
+			w[p_remap[i] * stride + j] = r[i * stride + j];
+		}
+	}
+
+	return result;
+}
+
+static Variant _remap_vertex_array(const Variant &p_array, const Vector<int> &p_remap, int p_vertex_count) {
+	switch (p_array.get_type()) {
+		case Variant::PACKED_VECTOR3_ARRAY:
+			return _remap_vertex_array(PackedVector3Array(p_array), p_remap, p_vertex_count);
+		case Variant::PACKED_VECTOR2_ARRAY:
+			return _remap_vertex_array(PackedVector2Array(p_array), p_remap, p_vertex_count);
+		case Variant::PACKED_COLOR_ARRAY:
+			return _remap_vertex_array(PackedColorArray(p_array), p_remap, p_vertex_count);
+		case Variant::PACKED_FLOAT32_ARRAY:
+			return _remap_vertex_array(PackedFloat32Array(p_array), p_remap, p_vertex_count);
+		case Variant::PACKED_FLOAT64_ARRAY:
+			return _remap_vertex_array(PackedFloat64Array(p_array), p_remap, p_vertex_count);
+		case Variant::PACKED_INT32_ARRAY:
+			return _remap_vertex_array(PackedInt32Array(p_array), p_remap, p_vertex_count);
+		default: {
+			return p_array;
+		}
+	}
+}
+
+static Vector<int> _remap_indices(const Vector<int> &p_indices, const Vector<int> &p_remap) {
+	Vector<int> result = p_indices;
+	int *w = result.ptrw();
+	for (int i = 0; i < result.size(); i++) {
+		w[i] = p_remap[w[i]];
+	}
+	return result;
+}
+
+Error ArrayMesh::generate_lods(float p_max_error) {
+	ERR_FAIL_COND_V(p_max_error <= 0, ERR_INVALID_PARAMETER);
+
+	const int max_lods = 8;
+	const int min_index_count = 48;
+
+	Vector<ArrayMeshRebuildSurface> lod_surfaces;
+	bool generated = false;
+
+	for (int i = 0; i < get_surface_count(); i++) {
+		ArrayMeshRebuildSurface s = _get_rebuild_surface(this, i);
+
+		Vector<int> indices = s.arrays[ARRAY_INDEX];
+
+		if (s.primitive == PRIMITIVE_TRIANGLES && !(s.flags & ARRAY_FLAG_USE_2D_VERTICES) && indices.size() >= min_index_count) {
+			Vector<Vector3> vertices = s.arrays[ARRAY_VERTEX];
+			Vector<Vector3> normals = s.arrays[ARRAY_NORMAL];
+			Vector<Vector2> uvs = s.arrays[ARRAY_TEX_UV];
+
+			Vector<Vector<int>> lod_indices;
+			Vector<float> lod_errors;
+			Vector<int> prev_indices = indices;
+			float error = 0;
+
+			for (int j = 0; j < max_lods; j++) {
+				float step_error;
+				Vector<int> simplified = MeshSimplifier::simplify(vertices, normals, uvs, prev_indices, prev_indices.size() / 2, p_max_error, &step_error);
+				if (simplified.size() == 0 || simplified.size() > prev_indices.size() * 9 / 10) {
+					break; // Not worth another level.
+				}
+
+				// Each level is simplified from the previous one, so the errors add up.
+				error += step_error;
+				float lod_error = MAX(error, CMP_EPSILON);
+
+				Vector<int> optimized = MeshOptimizer::optimize_vertex_cache(simplified, vertices.size());
+				if (lod_errors.size() && lod_error <= lod_errors[lod_errors.size() - 1]) {
+					// No more visible than the previous level, which is then never needed.
+					lod_indices.write[lod_indices.size() - 1] = optimized;
+				} else {
+					lod_indices.push_back(optimized);
+					lod_errors.push_back(lod_error);
+				}
+
+				prev_indices = simplified;
+				if (simplified.size() < min_index_count) {
+					break;
+				}
+			}
+
+			if (lod_indices.size()) {
+				s.lods.clear();
+				for (int j = 0; j < lod_indices.size(); j++) {
+					s.lods[lod_errors[j]] = lod_indices[j];
+				}
+				generated = true;
+			}
+		}
+
+		lod_surfaces.push_back(s);
+	}
+
+	if (generated) {
+		_rebuild_surfaces(this, lod_surfaces);
+	}
+
+	return OK;
+}
+
+Error ArrayMesh::optimize_surfaces() {
+	Vector<ArrayMeshRebuildSurface> optimized_surfaces;
+	bool optimized = false;
+
+	for (int i = 0; i < get_surface_count(); i++) {
+		ArrayMeshRebuildSurface s = _get_rebuild_surface(this, i);
+
+		Vector<int> indices = s.arrays[ARRAY_INDEX];
+		int vertex_count = surface_get_array_len(i);
+
+		if (s.primitive == PRIMITIVE_TRIANGLES && indices.size()) {
+			float acmr_before;
+			float atvr_before;
+			MeshOptimizer::analyze_vertex_cache(indices, vertex_count, acmr_before, atvr_before);
+
+			indices = MeshOptimizer::optimize_vertex_cache(indices, vertex_count);
+			if (!(s.flags & ARRAY_FLAG_USE_2D_VERTICES)) {
+				indices = MeshOptimizer::optimize_overdraw(indices, s.arrays[ARRAY_VERTEX]);
+			}
+
+			int new_vertex_count;
+			Vector<int> remap = MeshOptimizer::optimize_vertex_fetch(indices, vertex_count, new_vertex_count);
+			ERR_FAIL_COND_V(remap.size() != vertex_count, ERR_BUG);
+
+			s.arrays[ARRAY_INDEX] = indices;
+			for (int j = 0; j < ARRAY_INDEX; j++) {
+				s.arrays[j] = _remap_vertex_array(s.arrays[j], remap, new_vertex_count);
+			}
+
+			for (int j = 0; j < s.blend_shape_arrays.size(); j++) {
+				Array blend_shape = s.blend_shape_arrays[j];
+				for (int k = 0; k < blend_shape.size(); k++) {
+					blend_shape[k] = _remap_vertex_array(blend_shape[k], remap, new_vertex_count);
+				}
+			}
+
+			List<Variant> lod_keys;
+			s.lods.get_key_list(&lod_keys);
+			for (List<Variant>::Element *E = lod_keys.front(); E; E = E->next()) {
+				Vector<int> lod_indices = _remap_indices(s.lods[E->get()], remap);
+				s.lods[E->get()] = MeshOptimizer::optimize_vertex_cache(lod_indices, new_vertex_count);
+			}
+
+			float acmr_after;
+			float atvr_after;
+			MeshOptimizer::analyze_vertex_cache(indices, new_vertex_count, acmr_after, atvr_after);
+			print_verbose(vformat("Mesh '%s' surface %d: ", get_name(), i) + vformat("ACMR %.3f -> %.3f, ATVR %.3f -> %.3f, ", acmr_before, acmr_after, atvr_before, atvr_after) + vformat("%d -> %d vertices.", vertex_count, new_vertex_count));
+
+			optimized = true;
+		}
+
+		optimized_surfaces.push_back(s);
+	}
+
+	if (optimized) {
+		_rebuild_surfaces(this, optimized_surfaces);
+	}
+
+	return OK;
+}
+
 void ArrayMesh::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("add_blend_shape", "name"), &ArrayMesh::add_blend_shape);
 	ClassDB::bind_method(D_METHOD("get_blend_shape_count"), &ArrayMesh::get_blend_shape_count);
@@ -1529,6 +1752,10 @@ void ArrayMesh::_bind_methods() {
 	ClassDB::set_method_flags(get_class_static(), _scs_create("regen_normalmaps"), METHOD_FLAGS_DEFAULT | METHOD_FLAG_EDITOR);
 	ClassDB::bind_method(D_METHOD("lightmap_unwrap", "transform", "texel_size"), &ArrayMesh::lightmap_unwrap);
 	ClassDB::set_method_flags(get_class_static(), _scs_create("lightmap_unwrap"), METHOD_FLAGS_DEFAULT | METHOD_FLAG_EDITOR);
+	ClassDB::bind_method(D_METHOD("generate_lods", "max_error"), &ArrayMesh::generate_lods, DEFVAL(0.5));
+	ClassDB::set_method_flags(get_class_static(), _scs_create("generate_lods"), METHOD_FLAGS_DEFAULT | METHOD_FLAG_EDITOR);
+	ClassDB::bind_method(D_METHOD("optimize_surfaces"), &ArrayMesh::optimize_surfaces);
+	ClassDB::set_method_flags(get_class_static(), _scs_create("optimize_surfaces"), METHOD_FLAGS_DEFAULT | METHOD_FLAG_EDITOR);
 	ClassDB::bind_method(D_METHOD("get_faces"), &ArrayMesh::get_faces);
 	ClassDB::bind_method(D_METHOD("generate_triangle_mesh"), &ArrayMesh::generate_triangle_mesh);
 
@@ -142,11 +142,16 @@ public:
 	Size2i get_lightmap_size_hint() const;
 	void clear_cache() const;
 
-	typedef Vector<Vector<Face3>> (*ConvexDecompositionFunc)(const Vector<Face3> &);
+	struct ConvexDecompositionSettings {
+		uint32_t resolution = 100000; // Voxels used to sample the mesh, lower is faster but less accurate.
+		uint32_t max_convex_hulls = 1024;
+	};
+
+	typedef Vector<Vector<Face3>> (*ConvexDecompositionFunc)(const Vector<Face3> &, const ConvexDecompositionSettings &);
 
 	static ConvexDecompositionFunc convex_composition_function;
 
-	Vector<Ref<Shape3D>> convex_decompose() const;
+	Vector<Ref<Shape3D>> convex_decompose(const ConvexDecompositionSettings &p_settings) const;
 
 	Mesh();
 };
@@ -238,6 +243,9 @@ public:
 	Error lightmap_unwrap(const Transform &p_base_transform = Transform(), float p_texel_size = 0.05);
 	Error lightmap_unwrap_cached(int *&r_cache_data, unsigned int &r_cache_size, bool &r_used_cache, const Transform &p_base_transform = Transform(), float p_texel_size = 0.05);
 
+	Error generate_lods(float p_max_error = 0.5);
+	Error optimize_surfaces();
+
 	virtual void reload_from_file() override;
 
 	ArrayMesh();
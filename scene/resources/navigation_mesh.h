@@ -84,6 +84,7 @@ public:
 protected:
 	float cell_size;
 	float cell_height;
+	int tile_size;
 	float agent_height;
 	float agent_radius;
 	float agent_max_climb;
@@ -133,6 +134,9 @@ public:
 	void set_cell_height(float p_value);
 	float get_cell_height() const;
 
+	void set_tile_size(int p_value);
+	int get_tile_size() const;
+
 	void set_agent_height(float p_value);
 	float get_agent_height() const;
 
@@ -90,6 +90,35 @@ uint32_t SurfaceTool::VertexHasher::hash(const Vertex &p_vtx) {
 	return h;
 }
 
+void SurfaceTool::VertexCache::init(const Vertex *p_vertices, uint32_t p_count) {
+	vertices = p_vertices;
+
+	// At most half full, so probe sequences stay short.
+	uint32_t size = next_power_of_2(MAX(p_count, 4u) * 2);
+	slots.resize(size);
+	for (uint32_t i = 0; i < size; i++) {
+		slots[i].index = 0;
+	}
+	mask = size - 1;
+}
+
+uint32_t SurfaceTool::VertexCache::find_or_insert(uint32_t p_index) {
+	const Vertex &vertex = vertices[p_index];
+	const uint32_t hash = VertexHasher::hash(vertex);
+
+	uint32_t pos = hash & mask;
+	while (slots[pos].index) {
+		if (slots[pos].hash == hash && vertices[slots[pos].index - 1] == vertex) {
+			return slots[pos].index - 1;
+		}
+		pos = (pos + 1) & mask;
+	}
+
+	slots[pos].hash = hash;
+	slots[pos].index = p_index + 1;
+	return p_index;
+}
+
 void SurfaceTool::begin(Mesh::PrimitiveType p_primitive) {
 	clear();
 
@@ -284,9 +313,8 @@ Array SurfaceTool::commit_to_arrays() {
 				array.resize(varr_len);
 				Vector3 *w = array.ptrw();
 
-				int idx = 0;
-				for (List<Vertex>::Element *E = vertex_array.front(); E; E = E->next(), idx++) {
-					const Vertex &v = E->get();
+				for (int idx = 0; idx < varr_len; idx++) {
+					const Vertex &v = vertex_array[idx];
 
 					switch (i) {
 						case Mesh::ARRAY_VERTEX: {
@@ -308,9 +336,8 @@ Array SurfaceTool::commit_to_arrays() {
 				array.resize(varr_len);
 				Vector2 *w = array.ptrw();
 
-				int idx = 0;
-				for (List<Vertex>::Element *E = vertex_array.front(); E; E = E->next(), idx++) {
-					const Vertex &v = E->get();
+				for (int idx = 0; idx < varr_len; idx++) {
+					const Vertex &v = vertex_array[idx];
 
 					switch (i) {
 						case Mesh::ARRAY_TEX_UV: {
@@ -329,9 +356,9 @@ Array SurfaceTool::commit_to_arrays() {
 				array.resize(varr_len * 4);
 				float *w = array.ptrw();
 
-				int idx = 0;
-				for (List<Vertex>::Element *E = vertex_array.front(); E; E = E->next(), idx += 4) {
-					const Vertex &v = E->get();
+				for (int vi = 0; vi < varr_len; vi++) {
+					const Vertex &v = vertex_array[vi];
+					const int idx = vi * 4;
 
 					w[idx + 0] = v.tangent.x;
 					w[idx + 1] = v.tangent.y;
@@ -350,9 +377,8 @@ Array SurfaceTool::commit_to_arrays() {
 				array.resize(varr_len);
 				Color *w = array.ptrw();
 
-				int idx = 0;
-				for (List<Vertex>::Element *E = vertex_array.front(); E; E = E->next(), idx++) {
-					const Vertex &v = E->get();
+				for (int idx = 0; idx < varr_len; idx++) {
+					const Vertex &v = vertex_array[idx];
 					w[idx] = v.color;
 				}
 
@@ -363,9 +389,9 @@ Array SurfaceTool::commit_to_arrays() {
 				array.resize(varr_len * 4);
 				int *w = array.ptrw();
 
-				int idx = 0;
-				for (List<Vertex>::Element *E = vertex_array.front(); E; E = E->next(), idx += 4) {
-					const Vertex &v = E->get();
+				for (int vi = 0; vi < varr_len; vi++) {
+					const Vertex &v = vertex_array[vi];
+					const int idx = vi * 4;
 
 					ERR_CONTINUE(v.bones.size() != 4);
 
@@ -382,9 +408,9 @@ Array SurfaceTool::commit_to_arrays() {
 				array.resize(varr_len * 4);
 				float *w = array.ptrw();
 
-				int idx = 0;
-				for (List<Vertex>::Element *E = vertex_array.front(); E; E = E->next(), idx += 4) {
-					const Vertex &v = E->get();
+				for (int vi = 0; vi < varr_len; vi++) {
+					const Vertex &v = vertex_array[vi];
+					const int idx = vi * 4;
 					ERR_CONTINUE(v.weights.size() != 4);
 
 					for (int j = 0; j < 4; j++) {
@@ -402,9 +428,8 @@ Array SurfaceTool::commit_to_arrays() {
 				array.resize(index_array.size());
 				int *w = array.ptrw();
 
-				int idx = 0;
-				for (List<int>::Element *E = index_array.front(); E; E = E->next(), idx++) {
-					w[idx] = E->get();
+				for (uint32_t idx = 0; idx < index_array.size(); idx++) {
+					w[idx] = index_array[idx];
 				}
 
 				a[i] = array;
@@ -450,24 +475,25 @@ void SurfaceTool::index() {
 		return; //already indexed
 	}
 
-	HashMap<Vertex, int, VertexHasher> indices;
-	List<Vertex> new_vertices;
-
-	for (List<Vertex>::Element *E = vertex_array.front(); E; E = E->next()) {
-		int *idxptr = indices.getptr(E->get());
-		int idx;
-		if (!idxptr) {
-			idx = indices.size();
-			new_vertices.push_back(E->get());
-			indices[E->get()] = idx;
-		} else {
-			idx = *idxptr;
+	const uint32_t vertex_count = vertex_array.size();
+	VertexCache cache;
+	cache.init(vertex_array.ptr(), vertex_count);
+
+	// Map each vertex to the first one equal to it, then to its position among the unique ones.
+	LocalVector<uint32_t> unique_index;
+	unique_index.resize(vertex_count);
+	LocalVector<Vertex> new_vertices;
+	index_array.resize(vertex_count);
+
+	for (uint32_t i = 0; i < vertex_count; i++) {
+		uint32_t first = cache.find_or_insert(i);
+		if (first == i) {
+			unique_index[i] = new_vertices.size();
+			new_vertices.push_back(vertex_array[i]);
 		}
-
-		index_array.push_back(idx);
+		index_array[i] = unique_index[first];
 	}
 
-	vertex_array.clear();
 	vertex_array = new_vertices;
 
 	format |= Mesh::ARRAY_FORMAT_INDEX;
@@ -477,22 +503,18 @@ void SurfaceTool::deindex() {
 	if (index_array.size() == 0) {
 		return; //nothing to deindex
 	}
-	Vector<Vertex> varr;
-	varr.resize(vertex_array.size());
-	int idx = 0;
-	for (List<Vertex>::Element *E = vertex_array.front(); E; E = E->next()) {
-		varr.write[idx++] = E->get();
-	}
-	vertex_array.clear();
-	for (List<int>::Element *E = index_array.front(); E; E = E->next()) {
-		ERR_FAIL_INDEX(E->get(), varr.size());
-		vertex_array.push_back(varr[E->get()]);
+
+	LocalVector<Vertex> old_vertex_array = vertex_array;
+	vertex_array.resize(index_array.size());
+	for (uint32_t i = 0; i < index_array.size(); i++) {
+		ERR_FAIL_INDEX(index_array[i], (int)old_vertex_array.size());
+		vertex_array[i] = old_vertex_array[index_array[i]];
 	}
 	format &= ~Mesh::ARRAY_FORMAT_INDEX;
 	index_array.clear();
 }
 
-void SurfaceTool::_create_list(const Ref<Mesh> &p_existing, int p_surface, List<Vertex> *r_vertex, List<int> *r_index, int &lformat) {
+void SurfaceTool::_create_list(const Ref<Mesh> &p_existing, int p_surface, LocalVector<Vertex> *r_vertex, LocalVector<int> *r_index, int &lformat) {
 	Array arr = p_existing->surface_get_arrays(p_surface);
 	ERR_FAIL_COND(arr.size() != RS::ARRAY_MAX);
 	_create_list_from_arrays(arr, r_vertex, r_index, lformat);
@@ -588,7 +610,7 @@ Vector<SurfaceTool::Vertex> SurfaceTool::create_vertex_array_from_triangle_array
 	return ret;
 }
 
-void SurfaceTool::_create_list_from_arrays(Array arr, List<Vertex> *r_vertex, List<int> *r_index, int &lformat) {
+void SurfaceTool::_create_list_from_arrays(Array arr, LocalVector<Vertex> *r_vertex, LocalVector<int> *r_index, int &lformat) {
 	Vector<Vector3> varr = arr[RS::ARRAY_VERTEX];
 	Vector<Vector3> narr = arr[RS::ARRAY_NORMAL];
 	Vector<float> tarr = arr[RS::ARRAY_TANGENT];
@@ -629,6 +651,7 @@ void SurfaceTool::_create_list_from_arrays(Array arr, List<Vertex> *r_vertex, Li
 		lformat |= RS::ARRAY_FORMAT_WEIGHTS;
 	}
 
+	r_vertex->reserve(r_vertex->size() + vc);
 	for (int i = 0; i < vc; i++) {
 		Vertex v;
 		if (lformat & RS::ARRAY_FORMAT_VERTEX) {
@@ -680,8 +703,10 @@ void SurfaceTool::_create_list_from_arrays(Array arr, List<Vertex> *r_vertex, Li
 	if (is) {
 		lformat |= RS::ARRAY_FORMAT_INDEX;
 		const int *iarr = idx.ptr();
+		const uint32_t from = r_index->size();
+		r_index->resize(from + is);
 		for (int i = 0; i < is; i++) {
-			r_index->push_back(iarr[i]);
+			(*r_index)[from + i] = iarr[i];
 		}
 	}
 }
@@ -720,20 +745,29 @@ void SurfaceTool::create_from_blend_shape(const Ref<Mesh> &p_existing, int p_sur
 }
 
 void SurfaceTool::append_from(const Ref<Mesh> &p_existing, int p_surface, const Transform &p_xform) {
+	Array arr = p_existing->surface_get_arrays(p_surface);
+	ERR_FAIL_COND(arr.size() != RS::ARRAY_MAX);
+	append_from_arrays(p_existing->surface_get_primitive_type(p_surface), arr, p_xform);
+}
+
+void SurfaceTool::append_from_arrays(Mesh::PrimitiveType p_primitive, const Array &p_arrays, const Transform &p_xform) {
+	ERR_FAIL_COND(p_arrays.size() != RS::ARRAY_MAX);
+
 	if (vertex_array.size() == 0) {
-		primitive = p_existing->surface_get_primitive_type(p_surface);
+		primitive = p_primitive;
 		format = 0;
 	}
 
 	int nformat;
-	List<Vertex> nvertices;
-	List<int> nindices;
-	_create_list(p_existing, p_surface, &nvertices, &nindices, nformat);
+	LocalVector<Vertex> nvertices;
+	LocalVector<int> nindices;
+	_create_list_from_arrays(p_arrays, &nvertices, &nindices, nformat);
 	format |= nformat;
 	int vfrom = vertex_array.size();
 
-	for (List<Vertex>::Element *E = nvertices.front(); E; E = E->next()) {
-		Vertex v = E->get();
+	vertex_array.reserve(vfrom + nvertices.size());
+	for (uint32_t vi = 0; vi < nvertices.size(); vi++) {
+		Vertex v = nvertices[vi];
 		v.vertex = p_xform.xform(v.vertex);
 		if (nformat & RS::ARRAY_FORMAT_NORMAL) {
 			v.normal = p_xform.basis.xform(v.normal);
@@ -746,8 +780,9 @@ void SurfaceTool::append_from(const Ref<Mesh> &p_existing, int p_surface, const
 		vertex_array.push_back(v);
 	}
 
-	for (List<int>::Element *E = nindices.front(); E; E = E->next()) {
-		int dst_index = E->get() + vfrom;
+	index_array.reserve(index_array.size() + nindices.size());
+	for (uint32_t i = 0; i < nindices.size(); i++) {
+		int dst_index = nindices[i] + vfrom;
 		index_array.push_back(dst_index);
 	}
 	if (index_array.size() % 3) {
@@ -758,18 +793,18 @@ void SurfaceTool::append_from(const Ref<Mesh> &p_existing, int p_surface, const
 //mikktspace callbacks
 namespace {
 struct TangentGenerationContextUserData {
-	Vector<List<SurfaceTool::Vertex>::Element *> vertices;
-	Vector<List<int>::Element *> indices;
+	LocalVector<SurfaceTool::Vertex> *vertices;
+	LocalVector<int> *indices;
 };
 } // namespace
 
 int SurfaceTool::mikktGetNumFaces(const SMikkTSpaceContext *pContext) {
 	TangentGenerationContextUserData &triangle_data = *reinterpret_cast<TangentGenerationContextUserData *>(pContext->m_pUserData);
 
-	if (triangle_data.indices.size() > 0) {
-		return triangle_data.indices.size() / 3;
+	if (triangle_data.indices->size() > 0) {
+		return triangle_data.indices->size() / 3;
 	} else {
-		return triangle_data.vertices.size() / 3;
+		return triangle_data.vertices->size() / 3;
 	}
 }
 
@@ -780,13 +815,13 @@ int SurfaceTool::mikktGetNumVerticesOfFace(const SMikkTSpaceContext *pContext, c
 void SurfaceTool::mikktGetPosition(const SMikkTSpaceContext *pContext, float fvPosOut[], const int iFace, const int iVert) {
 	TangentGenerationContextUserData &triangle_data = *reinterpret_cast<TangentGenerationContextUserData *>(pContext->m_pUserData);
 	Vector3 v;
-	if (triangle_data.indices.size() > 0) {
-		int index = triangle_data.indices[iFace * 3 + iVert]->get();
-		if (index < triangle_data.vertices.size()) {
-			v = triangle_data.vertices[index]->get().vertex;
+	if (triangle_data.indices->size() > 0) {
+		int index = triangle_data.indices->operator[](iFace * 3 + iVert);
+		if (index < (int)triangle_data.vertices->size()) {
+			v = triangle_data.vertices->operator[](index).vertex;
 		}
 	} else {
-		v = triangle_data.vertices[iFace * 3 + iVert]->get().vertex;
+		v = triangle_data.vertices->operator[](iFace * 3 + iVert).vertex;
 	}
 
 	fvPosOut[0] = v.x;
@@ -797,13 +832,13 @@ void SurfaceTool::mikktGetPosition(const SMikkTSpaceContext *pContext, float fvP
 void SurfaceTool::mikktGetNormal(const SMikkTSpaceContext *pContext, float fvNormOut[], const int iFace, const int iVert) {
 	TangentGenerationContextUserData &triangle_data = *reinterpret_cast<TangentGenerationContextUserData *>(pContext->m_pUserData);
 	Vector3 v;
-	if (triangle_data.indices.size() > 0) {
-		int index = triangle_data.indices[iFace * 3 + iVert]->get();
-		if (index < triangle_data.vertices.size()) {
-			v = triangle_data.vertices[index]->get().normal;
+	if (triangle_data.indices->size() > 0) {
+		int index = triangle_data.indices->operator[](iFace * 3 + iVert);
+		if (index < (int)triangle_data.vertices->size()) {
+			v = triangle_data.vertices->operator[](index).normal;
 		}
 	} else {
-		v = triangle_data.vertices[iFace * 3 + iVert]->get().normal;
+		v = triangle_data.vertices->operator[](iFace * 3 + iVert).normal;
 	}
 
 	fvNormOut[0] = v.x;
@@ -814,13 +849,13 @@ void SurfaceTool::mikktGetNormal(const SMikkTSpaceContext *pContext, float fvNor
 void SurfaceTool::mikktGetTexCoord(const SMikkTSpaceContext *pContext, float fvTexcOut[], const int iFace, const int iVert) {
 	TangentGenerationContextUserData &triangle_data = *reinterpret_cast<TangentGenerationContextUserData *>(pContext->m_pUserData);
 	Vector2 v;
-	if (triangle_data.indices.size() > 0) {
-		int index = triangle_data.indices[iFace * 3 + iVert]->get();
-		if (index < triangle_data.vertices.size()) {
-			v = triangle_data.vertices[index]->get().uv;
+	if (triangle_data.indices->size() > 0) {
+		int index = triangle_data.indices->operator[](iFace * 3 + iVert);
+		if (index < (int)triangle_data.vertices->size()) {
+			v = triangle_data.vertices->operator[](index).uv;
 		}
 	} else {
-		v = triangle_data.vertices[iFace * 3 + iVert]->get().uv;
+		v = triangle_data.vertices->operator[](iFace * 3 + iVert).uv;
 	}
 
 	fvTexcOut[0] = v.x;
@@ -831,13 +866,13 @@ void SurfaceTool::mikktSetTSpaceDefault(const SMikkTSpaceContext *pContext, cons
 		const tbool bIsOrientationPreserving, const int iFace, const int iVert) {
 	TangentGenerationContextUserData &triangle_data = *reinterpret_cast<TangentGenerationContextUserData *>(pContext->m_pUserData);
 	Vertex *vtx = nullptr;
-	if (triangle_data.indices.size() > 0) {
-		int index = triangle_data.indices[iFace * 3 + iVert]->get();
-		if (index < triangle_data.vertices.size()) {
-			vtx = &triangle_data.vertices[index]->get();
+	if (triangle_data.indices->size() > 0) {
+		int index = triangle_data.indices->operator[](iFace * 3 + iVert);
+		if (index < (int)triangle_data.vertices->size()) {
+			vtx = &triangle_data.vertices->operator[](index);
 		}
 	} else {
-		vtx = &triangle_data.vertices[iFace * 3 + iVert]->get();
+		vtx = &triangle_data.vertices->operator[](iFace * 3 + iVert);
 	}
 
 	if (vtx != nullptr) {
@@ -863,18 +898,12 @@ void SurfaceTool::generate_tangents() {
 	msc.m_pInterface = &mkif;
 
 	TangentGenerationContextUserData triangle_data;
-	triangle_data.vertices.resize(vertex_array.size());
-	int idx = 0;
-	for (List<Vertex>::Element *E = vertex_array.front(); E; E = E->next()) {
-		triangle_data.vertices.write[idx++] = E;
-		E->get().binormal = Vector3();
-		E->get().tangent = Vector3();
-	}
-	triangle_data.indices.resize(index_array.size());
-	idx = 0;
-	for (List<int>::Element *E = index_array.front(); E; E = E->next()) {
-		triangle_data.indices.write[idx++] = E;
+	triangle_data.vertices = &vertex_array;
+	for (uint32_t i = 0; i < vertex_array.size(); i++) {
+		vertex_array[i].binormal = Vector3();
+		vertex_array[i].tangent = Vector3();
 	}
+	triangle_data.indices = &index_array;
 	msc.m_pUserData = &triangle_data;
 
 	bool res = genTangSpaceDefault(&msc);
@@ -890,64 +919,69 @@ void SurfaceTool::generate_normals(bool p_flip) {
 
 	deindex();
 
-	HashMap<Vertex, Vector3, VertexHasher> vertex_hash;
+	const uint32_t vertex_count = vertex_array.size();
+	ERR_FAIL_COND((vertex_count % 3) != 0);
+
+	// Smooth groups accumulate the face normals of equal vertices, found by hash.
+	VertexCache cache;
+	LocalVector<uint32_t> group_first; // First vertex equal to each vertex of the group.
+	LocalVector<Vector3> group_normals; // Accumulated normals of those first vertices.
 
-	int count = 0;
 	bool smooth = false;
 	if (smooth_groups.has(0)) {
 		smooth = smooth_groups[0];
 	}
 
-	List<Vertex>::Element *B = vertex_array.front();
-	for (List<Vertex>::Element *E = B; E;) {
-		List<Vertex>::Element *v[3];
-		v[0] = E;
-		v[1] = v[0]->next();
-		ERR_FAIL_COND(!v[1]);
-		v[2] = v[1]->next();
-		ERR_FAIL_COND(!v[2]);
-		E = v[2]->next();
+	uint32_t group_begin = 0;
+	for (uint32_t vi = 0; vi < vertex_count; vi += 3) {
+		Vertex *v = &vertex_array[vi];
 
 		Vector3 normal;
 		if (!p_flip) {
-			normal = Plane(v[0]->get().vertex, v[1]->get().vertex, v[2]->get().vertex).normal;
+			normal = Plane(v[0].vertex, v[1].vertex, v[2].vertex).normal;
 		} else {
-			normal = Plane(v[2]->get().vertex, v[1]->get().vertex, v[0]->get().vertex).normal;
+			normal = Plane(v[2].vertex, v[1].vertex, v[0].vertex).normal;
 		}
 
+		const uint32_t count = vi + 3;
+		const bool group_end = smooth_groups.has(count) || count == vertex_count;
+
 		if (smooth) {
+			if (vi == group_begin) {
+				// Size the cache for the whole group.
+				uint32_t group_end_vertex = count;
+				while (group_end_vertex < vertex_count && !smooth_groups.has(group_end_vertex)) {
+					group_end_vertex += 3;
+				}
+				cache.init(vertex_array.ptr(), group_end_vertex - group_begin);
+				group_first.resize(group_end_vertex - group_begin);
+				group_normals.resize(group_end_vertex - group_begin);
+			}
+
 			for (int i = 0; i < 3; i++) {
-				Vector3 *lv = vertex_hash.getptr(v[i]->get());
-				if (!lv) {
-					vertex_hash.set(v[i]->get(), normal);
+				uint32_t first = cache.find_or_insert(vi + i) - group_begin;
+				group_first[vi + i - group_begin] = first;
+				if (first == vi + i - group_begin) {
+					group_normals[first] = normal;
 				} else {
-					(*lv) += normal;
+					group_normals[first] += normal;
 				}
 			}
 		} else {
 			for (int i = 0; i < 3; i++) {
-				v[i]->get().normal = normal;
+				v[i].normal = normal;
 			}
 		}
-		count += 3;
 
-		if (smooth_groups.has(count) || !E) {
-			if (vertex_hash.size()) {
-				while (B != E) {
-					Vector3 *lv = vertex_hash.getptr(B->get());
-					if (lv) {
-						B->get().normal = lv->normalized();
-					}
-
-					B = B->next();
+		if (group_end) {
+			if (smooth) {
+				for (uint32_t i = group_begin; i < count; i++) {
+					vertex_array[i].normal = group_normals[group_first[i - group_begin]].normalized();
 				}
-
-			} else {
-				B = E;
 			}
 
-			vertex_hash.clear();
-			if (E) {
+			group_begin = count;
+			if (count < vertex_count) {
 				smooth = smooth_groups[count];
 			}
 		}
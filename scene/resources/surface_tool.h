@@ -31,6 +31,7 @@
 #ifndef SURFACE_TOOL_H
 #define SURFACE_TOOL_H
 
+#include "core/templates/local_vector.h"
 #include "scene/resources/mesh.h"
 
 #include "thirdparty/misc/mikktspace.h"
@@ -60,6 +61,23 @@ private:
 		static _FORCE_INLINE_ uint32_t hash(const Vertex &p_vtx);
 	};
 
+	// Finds equal vertices in an array by hash, without copying them into a map.
+	class VertexCache {
+		struct Slot {
+			uint32_t hash;
+			uint32_t index; // Index in the vertex array + 1, 0 for empty slots.
+		};
+
+		const Vertex *vertices = nullptr;
+		LocalVector<Slot> slots;
+		uint32_t mask = 0;
+
+	public:
+		void init(const Vertex *p_vertices, uint32_t p_count);
+		// Index of the first vertex equal to p_vertices[p_index] seen so far, p_index itself if there is none.
+		uint32_t find_or_insert(uint32_t p_index);
+	};
+
 	struct WeightSort {
 		int index;
 		float weight;
@@ -74,8 +92,8 @@ private:
 	int format;
 	Ref<Material> material;
 	//arrays
-	List<Vertex> vertex_array;
-	List<int> index_array;
+	LocalVector<Vertex> vertex_array;
+	LocalVector<int> index_array;
 	Map<int, bool> smooth_groups;
 
 	//memory
@@ -87,8 +105,8 @@ private:
 	Vector<float> last_weights;
 	Plane last_tangent;
 
-	void _create_list_from_arrays(Array arr, List<Vertex> *r_vertex, List<int> *r_index, int &lformat);
-	void _create_list(const Ref<Mesh> &p_existing, int p_surface, List<Vertex> *r_vertex, List<int> *r_index, int &lformat);
+	void _create_list_from_arrays(Array arr, LocalVector<Vertex> *r_vertex, LocalVector<int> *r_index, int &lformat);
+	void _create_list(const Ref<Mesh> &p_existing, int p_surface, LocalVector<Vertex> *r_vertex, LocalVector<int> *r_index, int &lformat);
 
 	//mikktspace callbacks
 	static int mikktGetNumFaces(const SMikkTSpaceContext *pContext);
@@ -128,7 +146,7 @@ public:
 
 	void clear();
 
-	List<Vertex> &get_vertex_array() { return vertex_array; }
+	LocalVector<Vertex> &get_vertex_array() { return vertex_array; }
 
 	void create_from_triangle_arrays(const Array &p_arrays);
 	static Vector<Vertex> create_vertex_array_from_triangle_arrays(const Array &p_arrays);
@@ -136,6 +154,8 @@ public:
 	void create_from(const Ref<Mesh> &p_existing, int p_surface);
 	void create_from_blend_shape(const Ref<Mesh> &p_existing, int p_surface, const String &p_blend_shape_name);
 	void append_from(const Ref<Mesh> &p_existing, int p_surface, const Transform &p_xform);
+	// Same as append_from(), for arrays that were already read back from a mesh. Does not touch the RenderingServer, so it can be used from threads.
+	void append_from_arrays(Mesh::PrimitiveType p_primitive, const Array &p_arrays, const Transform &p_xform);
 	Ref<ArrayMesh> commit(const Ref<ArrayMesh> &p_existing = Ref<ArrayMesh>(), uint32_t p_flags = Mesh::ARRAY_COMPRESS_DEFAULT);
 
 	SurfaceTool();
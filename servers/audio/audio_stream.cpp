@@ -281,6 +281,14 @@ float AudioStreamRandomPitch::get_length() const {
 	return 0;
 }
 
+bool AudioStreamRandomPitch::has_loop() const {
+	if (audio_stream.is_valid()) {
+		return audio_stream->has_loop();
+	}
+
+	return false;
+}
+
 void AudioStreamRandomPitch::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_audio_stream", "stream"), &AudioStreamRandomPitch::set_audio_stream);
 	ClassDB::bind_method(D_METHOD("get_audio_stream"), &AudioStreamRandomPitch::get_audio_stream);
@@ -89,6 +89,7 @@ public:
 	virtual String get_stream_name() const = 0;
 
 	virtual float get_length() const = 0; //if supported, otherwise return 0
+	virtual bool has_loop() const { return false; }
 };
 
 // Microphone
@@ -168,6 +169,7 @@ public:
 	virtual String get_stream_name() const override;
 
 	virtual float get_length() const override; //if supported, otherwise return 0
+	virtual bool has_loop() const override;
 
 	AudioStreamRandomPitch();
 };
@@ -32,44 +32,19 @@
 #include "servers/audio_server.h"
 
 void AudioEffectEQInstance::process(const AudioFrame *p_src_frames, AudioFrame *p_dst_frames, int p_frame_count) {
-	int band_count = bands[0].size();
-	EQ::BandProcess *proc_l = bands[0].ptrw();
-	EQ::BandProcess *proc_r = bands[1].ptrw();
-	float *bgain = gains.ptrw();
+	int band_count = bands.get_band_count();
 	for (int i = 0; i < band_count; i++) {
-		bgain[i] = Math::db2linear(base->gain[i]);
+		bands.set_band_gain(i, Math::db2linear(base->gain[i]));
 	}
 
-	for (int i = 0; i < p_frame_count; i++) {
-		AudioFrame src = p_src_frames[i];
-		AudioFrame dst = AudioFrame(0, 0);
-
-		for (int j = 0; j < band_count; j++) {
-			float l = src.l;
-			float r = src.r;
-
-			proc_l[j].process_one(l);
-			proc_r[j].process_one(r);
-
-			dst.l += l * bgain[j];
-			dst.r += r * bgain[j];
-		}
-
-		p_dst_frames[i] = dst;
-	}
+	bands.process(p_src_frames, p_dst_frames, p_frame_count);
 }
 
 Ref<AudioEffectInstance> AudioEffectEQ::instance() {
 	Ref<AudioEffectEQInstance> ins;
 	ins.instance();
 	ins->base = Ref<AudioEffectEQ>(this);
-	ins->gains.resize(eq.get_band_count());
-	for (int i = 0; i < 2; i++) {
-		ins->bands[i].resize(eq.get_band_count());
-		for (int j = 0; j < ins->bands[i].size(); j++) {
-			ins->bands[i].write[j] = eq.get_band_processor(j);
-		}
-	}
+	ins->bands = eq.get_stereo_processor();
 
 	return ins;
 }
@@ -41,8 +41,7 @@ class AudioEffectEQInstance : public AudioEffectInstance {
 	friend class AudioEffectEQ;
 	Ref<AudioEffectEQ> base;
 
-	Vector<EQ::BandProcess> bands[2];
-	Vector<float> gains;
+	EQ::StereoProcess bands;
 
 public:
 	virtual void process(const AudioFrame *p_src_frames, AudioFrame *p_dst_frames, int p_frame_count) override;
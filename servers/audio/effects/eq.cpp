@@ -35,6 +35,14 @@
 #include "core/math/math_funcs.h"
 #include <math.h>
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define EQ_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define EQ_NEON
+#endif
+
 #define POW2(v) ((v) * (v))
 
 /* Helper */
@@ -68,6 +76,157 @@ EQ::BandProcess::BandProcess() {
 	history.b1 = history.b2 = history.b3 = 0;
 }
 
+EQ::StereoProcess::StereoProcess() {
+	band_count = 0;
+	lane_count = 0;
+}
+
+void EQ::StereoProcess::_resize(int p_band_count) {
+	band_count = p_band_count;
+	lane_count = ((band_count * 2 + LANES - 1) / LANES) * LANES;
+
+	Vector<float> *arrays[] = { &c1, &c2, &c3, &gain, &a2, &a3, &b2, &b3 };
+	for (int i = 0; i < 8; i++) {
+		arrays[i]->resize(lane_count);
+		float *w = arrays[i]->ptrw();
+		for (int j = 0; j < lane_count; j++) {
+			w[j] = 0;
+		}
+	}
+}
+
+void EQ::StereoProcess::set_band_gain(int p_band, float p_gain) {
+	ERR_FAIL_INDEX(p_band, band_count);
+	float *w = gain.ptrw();
+	w[p_band * 2 + 0] = p_gain;
+	w[p_band * 2 + 1] = p_gain;
+}
+
+void EQ::StereoProcess::process(const AudioFrame *p_src, AudioFrame *p_dst, int p_frames) {
+	const float *rc1 = c1.ptr();
+	const float *rc2 = c2.ptr();
+	const float *rc3 = c3.ptr();
+	const float *rgain = gain.ptr();
+	float *wa2 = a2.ptrw();
+	float *wa3 = a3.ptrw();
+	float *wb2 = b2.ptrw();
+	float *wb3 = b3.ptrw();
+
+#if defined(EQ_SSE) || defined(EQ_NEON)
+	for (int i = 0; i < p_frames; i++) {
+		p_dst[i] = AudioFrame(0, 0);
+	}
+
+	// Four stereo bands at a time, in two independent registers so the filter
+	// recursions overlap. History stays in registers for the whole block.
+	for (int l = 0; l < lane_count; l += LANES) {
+#if defined(EQ_SSE)
+		__m128 vc1[2], vc2[2], vc3[2], vgain[2], va2[2], va3[2], vb2[2], vb3[2];
+		for (int k = 0; k < 2; k++) {
+			vc1[k] = _mm_loadu_ps(rc1 + l + k * 4);
+			vc2[k] = _mm_loadu_ps(rc2 + l + k * 4);
+			vc3[k] = _mm_loadu_ps(rc3 + l + k * 4);
+			vgain[k] = _mm_loadu_ps(rgain + l + k * 4);
+			va2[k] = _mm_loadu_ps(wa2 + l + k * 4);
+			va3[k] = _mm_loadu_ps(wa3 + l + k * 4);
+			vb2[k] = _mm_loadu_ps(wb2 + l + k * 4);
+			vb3[k] = _mm_loadu_ps(wb3 + l + k * 4);
+		}
+
+		for (int i = 0; i < p_frames; i++) {
+			__m128 x = _mm_setr_ps(p_src[i].l, p_src[i].r, p_src[i].l, p_src[i].r);
+			__m128 out = _mm_setzero_ps();
+
+			for (int k = 0; k < 2; k++) {
+				__m128 b1 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(vc1[k], _mm_sub_ps(x, va3[k])), _mm_mul_ps(vc3[k], vb2[k])), _mm_mul_ps(vc2[k], vb3[k]));
+
+				va3[k] = va2[k];
+				va2[k] = x;
+				vb3[k] = vb2[k];
+				vb2[k] = b1;
+
+				out = _mm_add_ps(out, _mm_mul_ps(b1, vgain[k]));
+			}
+
+			out = _mm_add_ps(out, _mm_movehl_ps(out, out)); // Stereo sum in the low half.
+			__m128 dst = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)&p_dst[i]);
+			_mm_storel_pi((__m64 *)&p_dst[i], _mm_add_ps(dst, out));
+		}
+
+		for (int k = 0; k < 2; k++) {
+			_mm_storeu_ps(wa2 + l + k * 4, va2[k]);
+			_mm_storeu_ps(wa3 + l + k * 4, va3[k]);
+			_mm_storeu_ps(wb2 + l + k * 4, vb2[k]);
+			_mm_storeu_ps(wb3 + l + k * 4, vb3[k]);
+		}
+#elif defined(EQ_NEON)
+		float32x4_t vc1[2], vc2[2], vc3[2], vgain[2], va2[2], va3[2], vb2[2], vb3[2];
+		for (int k = 0; k < 2; k++) {
+			vc1[k] = vld1q_f32(rc1 + l + k * 4);
+			vc2[k] = vld1q_f32(rc2 + l + k * 4);
+			vc3[k] = vld1q_f32(rc3 + l + k * 4);
+			vgain[k] = vld1q_f32(rgain + l + k * 4);
+			va2[k] = vld1q_f32(wa2 + l + k * 4);
+			va3[k] = vld1q_f32(wa3 + l + k * 4);
+			vb2[k] = vld1q_f32(wb2 + l + k * 4);
+			vb3[k] = vld1q_f32(wb3 + l + k * 4);
+		}
+
+		for (int i = 0; i < p_frames; i++) {
+			float32x2_t frame = vld1_f32(&p_src[i].l);
+			float32x4_t x = vcombine_f32(frame, frame);
+			float32x4_t out = vdupq_n_f32(0);
+
+			for (int k = 0; k < 2; k++) {
+				float32x4_t b1 = vsubq_f32(vaddq_f32(vmulq_f32(vc1[k], vsubq_f32(x, va3[k])), vmulq_f32(vc3[k], vb2[k])), vmulq_f32(vc2[k], vb3[k]));
+
+				va3[k] = va2[k];
+				va2[k] = x;
+				vb3[k] = vb2[k];
+				vb2[k] = b1;
+
+				out = vaddq_f32(out, vmulq_f32(b1, vgain[k]));
+			}
+
+			float32x2_t sum = vadd_f32(vget_low_f32(out), vget_high_f32(out));
+			vst1_f32(&p_dst[i].l, vadd_f32(vld1_f32(&p_dst[i].l), sum));
+		}
+
+		for (int k = 0; k < 2; k++) {
+			vst1q_f32(wa2 + l + k * 4, va2[k]);
+			vst1q_f32(wa3 + l + k * 4, va3[k]);
+			vst1q_f32(wb2 + l + k * 4, vb2[k]);
+			vst1q_f32(wb3 + l + k * 4, vb3[k]);
+		}
+#endif
+	}
+#else
+	for (int i = 0; i < p_frames; i++) {
+		AudioFrame src = p_src[i];
+		AudioFrame dst = AudioFrame(0, 0);
+
+		for (int k = 0; k < band_count * 2; k += 2) {
+			float bl = rc1[k] * (src.l - wa3[k]) + rc3[k] * wb2[k] - rc2[k] * wb3[k];
+			float br = rc1[k + 1] * (src.r - wa3[k + 1]) + rc3[k + 1] * wb2[k + 1] - rc2[k + 1] * wb3[k + 1];
+
+			wa3[k] = wa2[k];
+			wa3[k + 1] = wa2[k + 1];
+			wa2[k] = src.l;
+			wa2[k + 1] = src.r;
+			wb3[k] = wb2[k];
+			wb3[k + 1] = wb2[k + 1];
+			wb2[k] = bl;
+			wb2[k + 1] = br;
+
+			dst.l += bl * rgain[k];
+			dst.r += br * rgain[k + 1];
+		}
+
+		p_dst[i] = dst;
+	}
+#endif
+}
+
 void EQ::recalculate_band_coefficients() {
 #define BAND_LOG(m_f) (log((m_f)) / log(2.))
 
@@ -195,6 +354,24 @@ EQ::BandProcess EQ::get_band_processor(int p_band) const {
 	return band_proc;
 }
 
+EQ::StereoProcess EQ::get_stereo_processor() const {
+	EQ::StereoProcess stereo_proc;
+	stereo_proc._resize(band.size());
+
+	float *w1 = stereo_proc.c1.ptrw();
+	float *w2 = stereo_proc.c2.ptrw();
+	float *w3 = stereo_proc.c3.ptrw();
+	for (int i = 0; i < band.size(); i++) {
+		for (int j = 0; j < 2; j++) {
+			w1[i * 2 + j] = band[i].c1;
+			w2[i * 2 + j] = band[i].c2;
+			w3[i * 2 + j] = band[i].c3;
+		}
+	}
+
+	return stereo_proc;
+}
+
 EQ::EQ() {
 	mix_rate = 44100;
 }
@@ -33,6 +33,7 @@
 #ifndef EQ_FILTER_H
 #define EQ_FILTER_H
 
+#include "core/math/audio_frame.h"
 #include "core/templates/vector.h"
 #include "core/typedefs.h"
 
@@ -66,6 +67,34 @@ public:
 		BandProcess();
 	};
 
+	// Processes every band of both channels at once. State is stored per lane as
+	// band 0 left, band 0 right, band 1 left..., so each SSE/NEON register holds
+	// two stereo bands; the filter recursion only runs along time.
+	class StereoProcess {
+		friend class EQ;
+
+		enum {
+			LANES = 8 // Two SIMD registers.
+		};
+
+		int band_count;
+		int lane_count; // Padded to a multiple of LANES, padding lanes have zero gain.
+		Vector<float> c1, c2, c3;
+		Vector<float> gain;
+		Vector<float> a2, a3, b2, b3; //history
+
+		void _resize(int p_band_count);
+
+	public:
+		void set_band_gain(int p_band, float p_gain);
+		int get_band_count() const { return band_count; }
+
+		// p_src and p_dst must not overlap.
+		void process(const AudioFrame *p_src, AudioFrame *p_dst, int p_frames);
+
+		StereoProcess();
+	};
+
 private:
 	struct Band {
 		float freq;
@@ -85,6 +114,7 @@ public:
 	void set_preset_band_mode(Preset p_preset);
 	void set_bands(const Vector<float> &p_bands);
 	BandProcess get_band_processor(int p_band) const;
+	StereoProcess get_stereo_processor() const;
 	float get_band_frequency(int p_band);
 
 	EQ();
@@ -104,21 +104,67 @@ void Reverb::process(float *p_src, float *p_dst, int p_frames) {
 		}
 	}
 
-	for (int i = 0; i < MAX_COMBS; i++) {
-		Comb &c = comb[i];
+	// Combs are processed in groups, so their lowpass recursions overlap instead of
+	// running one after another. Runs are split where any comb buffer wraps around.
+	for (int i = 0; i < MAX_COMBS; i += COMB_GROUP) {
+		float *buffer[COMB_GROUP];
+		int pos[COMB_GROUP];
+		int size_limit[COMB_GROUP];
+		float feedback[COMB_GROUP];
+		float damp[COMB_GROUP];
+		float damp_inv[COMB_GROUP];
+		float damp_h[COMB_GROUP];
+
+		for (int k = 0; k < COMB_GROUP; k++) {
+			const Comb &c = comb[i + k];
+			buffer[k] = c.buffer;
+			pos[k] = c.pos;
+			size_limit[k] = c.size - lrintf((float)c.extra_spread_frames * (1.0 - params.extra_spread));
+			feedback[k] = c.feedback;
+			damp[k] = c.damp;
+			damp_inv[k] = 1.0 - c.damp;
+			damp_h[k] = c.damp_h;
+		}
+
+		int j = 0;
+		while (j < p_frames) {
+			int run = p_frames - j;
+			for (int k = 0; k < COMB_GROUP; k++) {
+				if (pos[k] >= size_limit[k]) { //reset this now just in case
+					pos[k] = 0;
+				}
+				run = MIN(run, size_limit[k] - pos[k]);
+			}
 
-		int size_limit = c.size - lrintf((float)c.extra_spread_frames * (1.0 - params.extra_spread));
-		for (int j = 0; j < p_frames; j++) {
-			if (c.pos >= size_limit) { //reset this now just in case
-				c.pos = 0;
+			float *b[COMB_GROUP];
+			for (int k = 0; k < COMB_GROUP; k++) {
+				b[k] = buffer[k] + pos[k];
 			}
 
-			float out = undenormalise(c.buffer[c.pos] * c.feedback);
-			out = out * (1.0 - c.damp) + c.damp_h * c.damp; //lowpass
-			c.damp_h = out;
-			c.buffer[c.pos] = input_buffer[j] + out;
-			p_dst[j] += out;
-			c.pos++;
+			for (int n = 0; n < run; n++) {
+				float in = input_buffer[j + n];
+				float sum = 0;
+
+				for (int k = 0; k < COMB_GROUP; k++) {
+					float out = undenormalise(b[k][n] * feedback[k]);
+					out = out * damp_inv[k] + damp_h[k] * damp[k]; //lowpass
+					damp_h[k] = out;
+					b[k][n] = in + out;
+					sum += out;
+				}
+
+				p_dst[j + n] += sum;
+			}
+
+			for (int k = 0; k < COMB_GROUP; k++) {
+				pos[k] += run;
+			}
+			j += run;
+		}
+
+		for (int k = 0; k < COMB_GROUP; k++) {
+			comb[i + k].pos = pos[k];
+			comb[i + k].damp_h = damp_h[k];
 		}
 	}
 
@@ -161,15 +207,23 @@ void Reverb::process(float *p_src, float *p_dst, int p_frames) {
 		AllPass &a = allpass[i];
 		int size_limit = a.size - lrintf((float)a.extra_spread_frames * (1.0 - params.extra_spread));
 
-		for (int j = 0; j < p_frames; j++) {
+		int j = 0;
+		while (j < p_frames) {
 			if (a.pos >= size_limit) {
 				a.pos = 0;
 			}
 
-			float aux = a.buffer[a.pos];
-			a.buffer[a.pos] = undenormalise(allpass_feedback * aux + p_dst[j]);
-			p_dst[j] = aux - allpass_feedback * a.buffer[a.pos];
-			a.pos++;
+			int run = MIN(p_frames - j, size_limit - a.pos);
+			float *b = a.buffer + a.pos;
+
+			for (int n = 0; n < run; n++) {
+				float aux = b[n];
+				b[n] = undenormalise(allpass_feedback * aux + p_dst[j + n]);
+				p_dst[j + n] = aux - allpass_feedback * b[n];
+			}
+
+			a.pos += run;
+			j += run;
 		}
 	}
 
@@ -48,6 +48,7 @@ private:
 	enum {
 
 		MAX_COMBS = 8,
+		COMB_GROUP = 4, // Combs processed together, must divide MAX_COMBS.
 		MAX_ALLPASS = 4,
 		MAX_ECHO_MS = 500
 
@@ -83,7 +84,8 @@ private:
 	int echo_buffer_size;
 	int echo_buffer_pos;
 
-	float hpf_h1, hpf_h2 = 0;
+	float hpf_h1 = 0;
+	float hpf_h2 = 0;
 
 	struct Parameters {
 		float room_size;
@@ -35,6 +35,7 @@
 #include "core/io/resource_loader.h"
 #include "core/os/file_access.h"
 #include "core/os/os.h"
+#include "core/templates/sort_array.h"
 #include "scene/resources/audio_stream_sample.h"
 #include "servers/audio/audio_driver_dummy.h"
 #include "servers/audio/effects/audio_effect_compressor.h"
@@ -329,6 +330,8 @@ void AudioServer::_mix_step() {
 		E->get().callback(E->get().userdata);
 	}
 
+	_mix_voices();
+
 	for (int i = buses.size() - 1; i >= 0; i--) {
 		//go bus by bus
 		Bus *bus = buses[i];
@@ -483,6 +486,157 @@ AudioFrame *AudioServer::thread_get_channel_mix_buffer(int p_bus, int p_buffer)
 	return data;
 }
 
+float AudioServer::_get_voice_audibility(const Voice &p_voice) const {
+	float max_volume = 0;
+	for (int k = 0; k < channel_count; k++) {
+		max_volume = MAX(max_volume, MAX(p_voice.channel_volume[k].l, p_voice.channel_volume[k].r));
+	}
+	return max_volume * Math::db2linear(p_voice.volume_db);
+}
+
+void AudioServer::_mix_voice(Voice &p_voice, int p_frames, bool p_fade_out) {
+	AudioFrame *buffer = voice_mix_buffer.ptrw();
+	p_voice.playback->mix(buffer, p_voice.pitch_scale, p_frames);
+
+	int bus_index = thread_find_bus_index(p_voice.bus);
+	float volume = Math::db2linear(p_voice.volume_db);
+
+	for (int k = 0; k < channel_count; k++) {
+		//interpolate volume to avoid clicks when it changes
+		AudioFrame vol = p_voice.prev_volume[k];
+		AudioFrame target = p_fade_out ? AudioFrame(0, 0) : p_voice.channel_volume[k] * volume;
+		p_voice.prev_volume[k] = target;
+
+		if (vol.l == 0 && vol.r == 0 && target.l == 0 && target.r == 0) {
+			continue;
+		}
+
+		if (!thread_has_channel_mix_buffer(bus_index, k)) {
+			continue;
+		}
+
+		AudioFrame *target_buf = thread_get_channel_mix_buffer(bus_index, k);
+		AudioFrame vol_inc = (target - vol) / float(p_frames);
+
+		for (int j = 0; j < p_frames; j++) {
+			target_buf[j] += buffer[j] * vol;
+			vol += vol_inc;
+		}
+	}
+}
+
+void AudioServer::_mix_voices() {
+	for (uint32_t i = 0; i < stolen_voices.size(); i++) {
+		Voice &v = stolen_voices[i];
+		if (v.state == Voice::STATE_STOPPING) {
+			_mix_voice(v, MIN(buffer_size, (uint32_t)VOICE_FADE_FRAMES), true);
+			v.state = Voice::STATE_FINISHED;
+		}
+	}
+
+	voice_sort.clear();
+
+	for (uint32_t i = 0; i < voices.size(); i++) {
+		Voice &v = voices[i];
+
+		if (v.state == Voice::STATE_STOPPING) {
+			if (v.real) {
+				_mix_voice(v, MIN(buffer_size, (uint32_t)VOICE_FADE_FRAMES), true);
+			}
+			v.real = false;
+			v.state = Voice::STATE_FINISHED;
+			continue;
+		}
+
+		if (v.state != Voice::STATE_PLAYING) {
+			continue;
+		}
+
+		if (v.paused) {
+			if (v.real) {
+				//fade out, the playback keeps its position until unpaused
+				_mix_voice(v, MIN(buffer_size, (uint32_t)VOICE_FADE_FRAMES), true);
+				v.real = false;
+			}
+			continue;
+		}
+
+		VoiceSort vs;
+		vs.index = i;
+		vs.priority = v.priority;
+		vs.audibility = _get_voice_audibility(v);
+		voice_sort.push_back(vs);
+	}
+
+	voice_sort.sort();
+
+	float mix_rate = get_mix_rate();
+	uint32_t real_count = 0;
+
+	for (uint32_t i = 0; i < voice_sort.size(); i++) {
+		Voice &v = voices[voice_sort[i].index];
+
+		if (v.seek_to >= 0) {
+			if (v.real && v.started && v.playback->is_playing()) {
+				//fade out to avoid pops
+				_mix_voice(v, MIN(buffer_size, (uint32_t)VOICE_FADE_FRAMES), true);
+			}
+			v.position = v.seek_to;
+			v.seek_to = -1;
+			v.started = false;
+			v.real = false;
+		}
+
+		if (real_count < max_real_voices && voice_sort[i].audibility >= voice_virtual_threshold) {
+			if (!v.started) {
+				v.playback->start(v.position);
+				v.started = true;
+			} else if (v.position_dirty) {
+				v.playback->seek(v.position);
+			}
+			v.position_dirty = false;
+
+			if (!v.real) {
+				//ramp in from silence
+				for (int k = 0; k < MAX_CHANNELS_PER_BUS; k++) {
+					v.prev_volume[k] = AudioFrame(0, 0);
+				}
+				v.real = true;
+			}
+
+			_mix_voice(v, buffer_size, false);
+			real_count++;
+
+			if (!v.playback->is_playing()) {
+				v.real = false;
+				v.state = Voice::STATE_FINISHED;
+			}
+			continue;
+		}
+
+		//virtual voice, only advance time
+		if (v.real) {
+			_mix_voice(v, MIN(buffer_size, (uint32_t)VOICE_FADE_FRAMES), true);
+			v.position = v.playback->get_playback_position();
+			v.real = false;
+		}
+
+		v.position += buffer_size * v.pitch_scale / (mix_rate * global_rate_scale);
+		v.position_dirty = v.started;
+
+		if (v.length > 0 && v.position >= v.length) {
+			if (v.loop) {
+				v.position = Math::fmod(v.position, (double)v.length);
+			} else {
+				v.state = Voice::STATE_FINISHED;
+			}
+		}
+	}
+
+	voices_active = voice_sort.size();
+	voices_real = real_count;
+}
+
 int AudioServer::thread_get_mix_buffer_size() const {
 	return buffer_size;
 }
@@ -938,6 +1092,22 @@ void AudioServer::init() {
 
 	init_channels_and_buffers();
 
+	int max_voices = GLOBAL_DEF_RST("audio/voices/max_voices", 256);
+	ProjectSettings::get_singleton()->set_custom_property_info("audio/voices/max_voices", PropertyInfo(Variant::INT, "audio/voices/max_voices", PROPERTY_HINT_RANGE, "1,4096,1,or_greater"));
+	max_real_voices = GLOBAL_DEF_RST("audio/voices/max_real_voices", 64);
+	ProjectSettings::get_singleton()->set_custom_property_info("audio/voices/max_real_voices", PropertyInfo(Variant::INT, "audio/voices/max_real_voices", PROPERTY_HINT_RANGE, "1,1024,1,or_greater"));
+	voice_virtual_threshold = Math::db2linear(float(GLOBAL_DEF_RST("audio/voices/virtual_threshold_db", -60.0)));
+	ProjectSettings::get_singleton()->set_custom_property_info("audio/voices/virtual_threshold_db", PropertyInfo(Variant::FLOAT, "audio/voices/virtual_threshold_db", PROPERTY_HINT_RANGE, "-80,0,0.1"));
+
+	//the pool is allocated once, so the audio thread never reallocates it
+	voices.resize(MAX(max_voices, 1));
+	voice_sort.reserve(voices.size());
+	voice_free_list.reserve(voices.size());
+	for (int i = voices.size() - 1; i >= 0; i--) {
+		voice_free_list.push_back(i);
+	}
+	voice_mix_buffer.resize(buffer_size);
+
 	mix_count = 0;
 	set_bus_count(1);
 	set_bus_name(0, "Master");
@@ -1024,6 +1194,31 @@ void AudioServer::update() {
 	for (Set<CallbackItem>::Element *E = update_callbacks.front(); E; E = E->next()) {
 		E->get().callback(E->get().userdata);
 	}
+
+	//release finished voices here, so playbacks are never freed from the audio thread
+	bool locked = false;
+	for (uint32_t i = 0; i < voices.size(); i++) {
+		if (voices[i].state == Voice::STATE_FINISHED) {
+			if (!locked) {
+				lock();
+				locked = true;
+			}
+			_release_voice(i);
+		}
+	}
+	for (uint32_t i = 0; i < stolen_voices.size(); i++) {
+		if (stolen_voices[i].state == Voice::STATE_FINISHED) {
+			if (!locked) {
+				lock();
+				locked = true;
+			}
+			stolen_voices.remove(i);
+			i--;
+		}
+	}
+	if (locked) {
+		unlock();
+	}
 }
 
 void AudioServer::load_default_bus_layout() {
@@ -1047,6 +1242,11 @@ void AudioServer::finish() {
 	}
 
 	buses.clear();
+
+	voices.reset();
+	voice_free_list.reset();
+	stolen_voices.reset();
+	voice_sort.reset();
 }
 
 /* MISC config */
@@ -1125,6 +1325,235 @@ void AudioServer::remove_update_callback(AudioCallback p_callback, void *p_userd
 	unlock();
 }
 
+AudioServer::Voice *AudioServer::_get_voice(VoiceID p_voice) {
+	uint32_t index = p_voice & 0xFFFFFFFF;
+	if (index >= voices.size()) {
+		return nullptr;
+	}
+	Voice &v = voices[index];
+	if (v.state == Voice::STATE_FREE || v.generation != (p_voice >> 32)) {
+		return nullptr; //voice finished and its slot was reused
+	}
+	return &v;
+}
+
+const AudioServer::Voice *AudioServer::_get_voice(VoiceID p_voice) const {
+	return const_cast<AudioServer *>(this)->_get_voice(p_voice);
+}
+
+void AudioServer::_release_voice(uint32_t p_index) {
+	Voice &v = voices[p_index];
+	v.playback.unref();
+	v.state = Voice::STATE_FREE;
+	v.generation++;
+	if (v.generation == 0) {
+		v.generation = 1;
+	}
+	voice_free_list.push_back(p_index);
+}
+
+AudioServer::VoiceID AudioServer::voice_play(Ref<AudioStream> p_stream, const StringName &p_bus, float p_volume_db, float p_pitch_scale, int p_priority, float p_from_pos, const Ref<AudioStreamPlayback> &p_playback) {
+	ERR_FAIL_COND_V(p_stream.is_null(), 0);
+	ERR_FAIL_COND_V(p_pitch_scale <= 0.0, 0);
+
+	Ref<AudioStreamPlayback> playback = p_playback;
+	if (playback.is_null()) {
+		playback = p_stream->instance_playback();
+		ERR_FAIL_COND_V(playback.is_null(), 0);
+	}
+
+	lock();
+
+	if (voice_free_list.empty()) {
+		//steal the least important voice, preferring ones that are already inaudible
+		int steal = -1;
+		float steal_audibility = 0;
+		for (uint32_t i = 0; i < voices.size(); i++) {
+			const Voice &v = voices[i];
+			if (v.state != Voice::STATE_PLAYING) {
+				steal = i; //stopped, just not released yet
+				break;
+			}
+			float audibility = _get_voice_audibility(v);
+			if (steal == -1 || v.priority < voices[steal].priority || (v.priority == voices[steal].priority && audibility < steal_audibility)) {
+				steal = i;
+				steal_audibility = audibility;
+			}
+		}
+
+		if (steal == -1 || (voices[steal].state == Voice::STATE_PLAYING && voices[steal].priority > p_priority)) {
+			unlock();
+			return 0; //every voice is more important than this one
+		}
+
+		Voice &stolen = voices[steal];
+		if (stolen.real && stolen.state != Voice::STATE_FINISHED && stolen.playback != playback) {
+			//keep mixing it while it fades out, cutting it off would click
+			stolen_voices.push_back(stolen);
+			stolen_voices[stolen_voices.size() - 1].state = Voice::STATE_STOPPING;
+		}
+		_release_voice(steal);
+	}
+
+	uint32_t index = voice_free_list[voice_free_list.size() - 1];
+	voice_free_list.resize(voice_free_list.size() - 1);
+
+	Voice &v = voices[index];
+	v.playback = playback;
+	v.length = p_stream->get_length();
+	v.loop = p_stream->has_loop();
+	v.bus = p_bus;
+	v.volume_db = p_volume_db;
+	v.pitch_scale = p_pitch_scale;
+	v.priority = p_priority;
+	v.channel_volume[0] = AudioFrame(1, 1);
+	for (int k = 0; k < MAX_CHANNELS_PER_BUS; k++) {
+		if (k > 0) {
+			v.channel_volume[k] = AudioFrame(0, 0);
+		}
+		v.prev_volume[k] = AudioFrame(0, 0);
+	}
+	v.paused = false;
+	v.started = false;
+	v.real = false;
+	v.position_dirty = false;
+	v.position = MAX(p_from_pos, 0.0);
+	v.seek_to = -1;
+	v.state = Voice::STATE_PLAYING;
+
+	unlock();
+
+	return (VoiceID(v.generation) << 32) | index;
+}
+
+void AudioServer::voice_stop(VoiceID p_voice) {
+	lock();
+	Voice *v = _get_voice(p_voice);
+	if (v && v->state == Voice::STATE_PLAYING) {
+		v->state = Voice::STATE_STOPPING;
+	}
+	unlock();
+}
+
+void AudioServer::voice_seek(VoiceID p_voice, float p_position) {
+	lock();
+	Voice *v = _get_voice(p_voice);
+	if (v && v->state == Voice::STATE_PLAYING) {
+		v->seek_to = MAX(p_position, 0.0);
+	}
+	unlock();
+}
+
+bool AudioServer::voice_is_playing(VoiceID p_voice) const {
+	const_cast<AudioServer *>(this)->lock();
+	const Voice *v = _get_voice(p_voice);
+	bool playing = v && v->state == Voice::STATE_PLAYING;
+	const_cast<AudioServer *>(this)->unlock();
+	return playing;
+}
+
+bool AudioServer::voice_is_virtual(VoiceID p_voice) const {
+	const_cast<AudioServer *>(this)->lock();
+	const Voice *v = _get_voice(p_voice);
+	bool is_virtual = v && v->state == Voice::STATE_PLAYING && !v->real;
+	const_cast<AudioServer *>(this)->unlock();
+	return is_virtual;
+}
+
+float AudioServer::voice_get_playback_position(VoiceID p_voice) const {
+	const_cast<AudioServer *>(this)->lock();
+	const Voice *v = _get_voice(p_voice);
+	float position = 0;
+	if (v) {
+		if (v->seek_to >= 0) {
+			position = v->seek_to;
+		} else if (v->started && !v->position_dirty) {
+			position = v->playback->get_playback_position();
+		} else {
+			position = v->position;
+		}
+	}
+	const_cast<AudioServer *>(this)->unlock();
+	return position;
+}
+
+void AudioServer::voice_set_paused(VoiceID p_voice, bool p_paused) {
+	lock();
+	Voice *v = _get_voice(p_voice);
+	if (v) {
+		v->paused = p_paused;
+	}
+	unlock();
+}
+
+void AudioServer::voice_set_bus(VoiceID p_voice, const StringName &p_bus) {
+	lock();
+	Voice *v = _get_voice(p_voice);
+	if (v) {
+		v->bus = p_bus;
+	}
+	unlock();
+}
+
+void AudioServer::voice_set_volume_db(VoiceID p_voice, float p_volume_db) {
+	lock();
+	Voice *v = _get_voice(p_voice);
+	if (v) {
+		v->volume_db = p_volume_db;
+	}
+	unlock();
+}
+
+void AudioServer::voice_set_channel_volume(VoiceID p_voice, int p_channel, const AudioFrame &p_volume) {
+	ERR_FAIL_INDEX(p_channel, MAX_CHANNELS_PER_BUS);
+	lock();
+	Voice *v = _get_voice(p_voice);
+	if (v) {
+		v->channel_volume[p_channel] = p_volume;
+	}
+	unlock();
+}
+
+void AudioServer::voice_set_pitch_scale(VoiceID p_voice, float p_pitch_scale) {
+	ERR_FAIL_COND(p_pitch_scale <= 0.0);
+	lock();
+	Voice *v = _get_voice(p_voice);
+	if (v) {
+		v->pitch_scale = p_pitch_scale;
+	}
+	unlock();
+}
+
+void AudioServer::voice_set_priority(VoiceID p_voice, int p_priority) {
+	lock();
+	Voice *v = _get_voice(p_voice);
+	if (v) {
+		v->priority = p_priority;
+	}
+	unlock();
+}
+
+int AudioServer::get_max_voices() const {
+	const_cast<AudioServer *>(this)->lock();
+	int count = voices.size();
+	const_cast<AudioServer *>(this)->unlock();
+	return count;
+}
+
+int AudioServer::get_active_voice_count() const {
+	const_cast<AudioServer *>(this)->lock();
+	int count = voices_active;
+	const_cast<AudioServer *>(this)->unlock();
+	return count;
+}
+
+int AudioServer::get_real_voice_count() const {
+	const_cast<AudioServer *>(this)->lock();
+	int count = voices_real;
+	const_cast<AudioServer *>(this)->unlock();
+	return count;
+}
+
 void AudioServer::set_bus_layout(const Ref<AudioBusLayout> &p_bus_layout) {
 	ERR_FAIL_COND(p_bus_layout.is_null() || p_bus_layout->buses.size() == 0);
 
@@ -1288,6 +1717,22 @@ void AudioServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_bus_layout", "bus_layout"), &AudioServer::set_bus_layout);
 	ClassDB::bind_method(D_METHOD("generate_bus_layout"), &AudioServer::generate_bus_layout);
 
+	ClassDB::bind_method(D_METHOD("voice_play", "stream", "bus", "volume_db", "pitch_scale", "priority", "from_position", "playback"), &AudioServer::voice_play, DEFVAL(0), DEFVAL(1.0), DEFVAL(0), DEFVAL(0), DEFVAL(Ref<AudioStreamPlayback>()));
+	ClassDB::bind_method(D_METHOD("voice_stop", "voice"), &AudioServer::voice_stop);
+	ClassDB::bind_method(D_METHOD("voice_seek", "voice", "position"), &AudioServer::voice_seek);
+	ClassDB::bind_method(D_METHOD("voice_is_playing", "voice"), &AudioServer::voice_is_playing);
+	ClassDB::bind_method(D_METHOD("voice_is_virtual", "voice"), &AudioServer::voice_is_virtual);
+	ClassDB::bind_method(D_METHOD("voice_get_playback_position", "voice"), &AudioServer::voice_get_playback_position);
+	ClassDB::bind_method(D_METHOD("voice_set_paused", "voice", "paused"), &AudioServer::voice_set_paused);
+	ClassDB::bind_method(D_METHOD("voice_set_bus", "voice", "bus"), &AudioServer::voice_set_bus);
+	ClassDB::bind_method(D_METHOD("voice_set_volume_db", "voice", "volume_db"), &AudioServer::voice_set_volume_db);
+	ClassDB::bind_method(D_METHOD("voice_set_pitch_scale", "voice", "pitch_scale"), &AudioServer::voice_set_pitch_scale);
+	ClassDB::bind_method(D_METHOD("voice_set_priority", "voice", "priority"), &AudioServer::voice_set_priority);
+
+	ClassDB::bind_method(D_METHOD("get_max_voices"), &AudioServer::get_max_voices);
+	ClassDB::bind_method(D_METHOD("get_active_voice_count"), &AudioServer::get_active_voice_count);
+	ClassDB::bind_method(D_METHOD("get_real_voice_count"), &AudioServer::get_real_voice_count);
+
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "bus_count"), "set_bus_count", "get_bus_count");
 	ADD_PROPERTY(PropertyInfo(Variant::STRING, "device"), "set_device", "get_device");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "global_rate_scale"), "set_global_rate_scale", "get_global_rate_scale");
@@ -1311,6 +1756,10 @@ AudioServer::AudioServer() {
 	mix_time = 0;
 	mix_size = 0;
 	global_rate_scale = 1;
+	max_real_voices = 0;
+	voice_virtual_threshold = 0;
+	voices_active = 0;
+	voices_real = 0;
 }
 
 AudioServer::~AudioServer() {
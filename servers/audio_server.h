@@ -34,11 +34,13 @@
 #include "core/math/audio_frame.h"
 #include "core/object/class_db.h"
 #include "core/os/os.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/variant.h"
 #include "servers/audio/audio_effect.h"
 
 class AudioDriverDummy;
 class AudioStream;
+class AudioStreamPlayback;
 class AudioStreamSample;
 
 class AudioDriver {
@@ -159,8 +161,15 @@ public:
 		AUDIO_DATA_INVALID_ID = -1
 	};
 
+	enum {
+		MAX_CHANNELS_PER_BUS = 4
+	};
+
 	typedef void (*AudioCallback)(void *p_userdata);
 
+	// Handle to a voice in the server-side pool. Zero is never a valid voice.
+	typedef uint64_t VoiceID;
+
 private:
 	uint64_t mix_time;
 	int mix_size;
@@ -244,6 +253,69 @@ private:
 	Set<CallbackItem> callbacks;
 	Set<CallbackItem> update_callbacks;
 
+	/* VOICES */
+
+	enum {
+		VOICE_FADE_FRAMES = 128
+	};
+
+	struct Voice {
+		enum State {
+			STATE_FREE,
+			STATE_PLAYING,
+			STATE_STOPPING, // Fades out on the next mix, then finishes.
+			STATE_FINISHED, // Waiting for the main thread to release the playback.
+		};
+
+		Ref<AudioStreamPlayback> playback;
+		float length = 0; // Zero if unknown, virtual voices then never end on their own.
+		bool loop = false;
+
+		uint32_t generation = 1;
+		State state = STATE_FREE;
+
+		StringName bus;
+		float volume_db = 0;
+		float pitch_scale = 1.0;
+		int priority = 0;
+		AudioFrame channel_volume[MAX_CHANNELS_PER_BUS];
+		AudioFrame prev_volume[MAX_CHANNELS_PER_BUS];
+
+		bool paused = false;
+		bool started = false; // Whether start() was called on the playback.
+		bool real = false; // Whether the voice was mixed in the last step.
+		bool position_dirty = false; // Virtual time advanced, must seek when becoming real again.
+		double position = 0; // Playback position, only tracked while not real.
+		float seek_to = -1;
+	};
+
+	struct VoiceSort {
+		uint32_t index;
+		int priority;
+		float audibility;
+
+		bool operator<(const VoiceSort &p_sort) const {
+			return priority == p_sort.priority ? audibility > p_sort.audibility : priority > p_sort.priority;
+		}
+	};
+
+	LocalVector<Voice> voices;
+	LocalVector<uint32_t> voice_free_list;
+	LocalVector<Voice> stolen_voices; // Fading out after their slot was taken by a new voice.
+	LocalVector<VoiceSort> voice_sort;
+	Vector<AudioFrame> voice_mix_buffer;
+	uint32_t max_real_voices;
+	float voice_virtual_threshold;
+	uint32_t voices_active;
+	uint32_t voices_real;
+
+	Voice *_get_voice(VoiceID p_voice);
+	const Voice *_get_voice(VoiceID p_voice) const;
+	float _get_voice_audibility(const Voice &p_voice) const;
+	void _release_voice(uint32_t p_index);
+	void _mix_voice(Voice &p_voice, int p_frames, bool p_fade_out);
+	void _mix_voices();
+
 	friend class AudioDriver;
 	void _driver_process(int p_frames, int32_t *p_buffer);
 
@@ -347,6 +419,29 @@ public:
 	void add_update_callback(AudioCallback p_callback, void *p_userdata);
 	void remove_update_callback(AudioCallback p_callback, void *p_userdata);
 
+	/* VOICES */
+
+	// Voices are mixed by the server, so playing sounds don't need their own mix callback.
+	// When the pool is exhausted, the least important voice is stolen. Voices that don't
+	// make it into the real voice budget are virtual: their time advances but nothing is decoded.
+	VoiceID voice_play(Ref<AudioStream> p_stream, const StringName &p_bus, float p_volume_db, float p_pitch_scale, int p_priority, float p_from_pos, const Ref<AudioStreamPlayback> &p_playback);
+	void voice_stop(VoiceID p_voice);
+	void voice_seek(VoiceID p_voice, float p_position);
+	bool voice_is_playing(VoiceID p_voice) const;
+	bool voice_is_virtual(VoiceID p_voice) const;
+	float voice_get_playback_position(VoiceID p_voice) const;
+
+	void voice_set_paused(VoiceID p_voice, bool p_paused);
+	void voice_set_bus(VoiceID p_voice, const StringName &p_bus);
+	void voice_set_volume_db(VoiceID p_voice, float p_volume_db);
+	void voice_set_channel_volume(VoiceID p_voice, int p_channel, const AudioFrame &p_volume);
+	void voice_set_pitch_scale(VoiceID p_voice, float p_pitch_scale);
+	void voice_set_priority(VoiceID p_voice, int p_priority);
+
+	int get_max_voices() const;
+	int get_active_voice_count() const;
+	int get_real_voice_count() const;
+
 	void set_bus_layout(const Ref<AudioBusLayout> &p_bus_layout);
 	Ref<AudioBusLayout> generate_bus_layout() const;
 
@@ -176,6 +176,7 @@ public:
 		bool redraw_if_visible : 4;
 
 		float depth; //used for sorting
+		float lod_threshold; //largest mesh LOD error allowed, in mesh units, 0 renders full detail
 
 		SelfList<InstanceBase> dependency_item;
 
@@ -256,6 +257,7 @@ public:
 			lightmap_slice_index = 0;
 			lightmap = nullptr;
 			lightmap_cull_index = 0;
+			lod_threshold = 0;
 		}
 
 		virtual ~InstanceBase() {
@@ -1366,6 +1368,8 @@ public:
 	virtual bool free(RID p_rid) = 0;
 	virtual void update() = 0;
 
+	virtual int get_render_info(RS::RenderInfo p_info) = 0;
+
 	RasterizerCanvas() { singleton = this; }
 	virtual ~RasterizerCanvas() {}
 };
@@ -0,0 +1,259 @@
+/*************************************************************************/
+/*  rasterizer_canvas_batcher.cpp                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "rasterizer_canvas_batcher.h"
+
+typedef RasterizerCanvas::Item Item;
+
+bool RasterizerCanvasBatcher::_is_batchable(const Item::Command *p_command) {
+	if (p_command->type != Item::Command::TYPE_RECT) {
+		return false;
+	}
+	//clipped UVs are applied per draw in the fragment shader
+	return !(static_cast<const Item::CommandRect *>(p_command)->flags & RasterizerCanvas::CANVAS_RECT_CLIP_UV);
+}
+
+bool RasterizerCanvasBatcher::_is_same_state(const Item *p_a, const Item *p_b) {
+	//everything the backend sets up per item, besides transform and modulate which go in the rects
+	return p_a->material == p_b->material &&
+		   (p_a->canvas_group != nullptr) == (p_b->canvas_group != nullptr) &&
+		   p_a->final_clip_owner == p_b->final_clip_owner &&
+		   p_a->texture_filter == p_b->texture_filter &&
+		   p_a->texture_repeat == p_b->texture_repeat;
+}
+
+void RasterizerCanvasBatcher::_fill_rect(const Item::CommandRect *p_rect, const Color &p_modulate, const Transform2D &p_transform, Rect &r_rect) {
+	//same encoding as the unbatched rect path in the backends
+	Rect2 src_rect;
+	Rect2 dst_rect = Rect2(p_rect->rect.position, p_rect->rect.size);
+	r_rect.flags = 0;
+
+	if (dst_rect.size.width < 0) {
+		dst_rect.position.x += dst_rect.size.width;
+		dst_rect.size.width *= -1;
+	}
+	if (dst_rect.size.height < 0) {
+		dst_rect.position.y += dst_rect.size.height;
+		dst_rect.size.height *= -1;
+	}
+
+	if (p_rect->texture != RID()) {
+		if (p_rect->flags & RasterizerCanvas::CANVAS_RECT_REGION) {
+			src_rect = p_rect->source;
+			r_rect.flags |= RECT_FLAG_REGION;
+		} else {
+			src_rect = Rect2(0, 0, 1, 1);
+		}
+
+		if (p_rect->flags & RasterizerCanvas::CANVAS_RECT_FLIP_H) {
+			src_rect.size.x *= -1;
+		}
+
+		if (p_rect->flags & RasterizerCanvas::CANVAS_RECT_FLIP_V) {
+			src_rect.size.y *= -1;
+		}
+
+		if (p_rect->flags & RasterizerCanvas::CANVAS_RECT_TRANSPOSE) {
+			dst_rect.size.x *= -1;
+			r_rect.flags |= RECT_FLAG_TRANSPOSE;
+		}
+	} else {
+		src_rect = Rect2(0, 0, 1, 1);
+	}
+
+	r_rect.dst_rect[0] = dst_rect.position.x;
+	r_rect.dst_rect[1] = dst_rect.position.y;
+	r_rect.dst_rect[2] = dst_rect.size.width;
+	r_rect.dst_rect[3] = dst_rect.size.height;
+
+	r_rect.src_rect[0] = src_rect.position.x;
+	r_rect.src_rect[1] = src_rect.position.y;
+	r_rect.src_rect[2] = src_rect.size.width;
+	r_rect.src_rect[3] = src_rect.size.height;
+
+	r_rect.modulation[0] = p_rect->modulate.r * p_modulate.r;
+	r_rect.modulation[1] = p_rect->modulate.g * p_modulate.g;
+	r_rect.modulation[2] = p_rect->modulate.b * p_modulate.b;
+	r_rect.modulation[3] = p_rect->modulate.a * p_modulate.a;
+
+	r_rect.world[0] = p_transform.elements[0][0];
+	r_rect.world[1] = p_transform.elements[0][1];
+	r_rect.world[2] = p_transform.elements[1][0];
+	r_rect.world[3] = p_transform.elements[1][1];
+	r_rect.world[4] = p_transform.elements[2][0];
+	r_rect.world[5] = p_transform.elements[2][1];
+
+	r_rect.pad = 0;
+}
+
+void RasterizerCanvasBatcher::clear() {
+	rects.clear();
+	batches.clear();
+	item_count = 0;
+	last_item = nullptr;
+	last_item_mergeable = false;
+	run_open = false;
+}
+
+void RasterizerCanvasBatcher::reset_stats() {
+	stats = Stats();
+}
+
+bool RasterizerCanvasBatcher::_merge_item(const Item *p_item, const Transform2D &p_transform) {
+	uint32_t count = 0;
+	for (const Item::Command *c = p_item->commands; c; c = c->next) {
+		if (!_is_batchable(c) || static_cast<const Item::CommandRect *>(c)->texture != open_run.texture) {
+			return false;
+		}
+		count++;
+	}
+
+	if (count == 0 || rects.size() + count > max_rects) {
+		return false;
+	}
+
+	rects.resize(rects.size() + count);
+	Rect *rect = &rects[rects.size() - count];
+	for (const Item::Command *c = p_item->commands; c; c = c->next) {
+		_fill_rect(static_cast<const Item::CommandRect *>(c), p_item->final_modulate, p_transform, *rect++);
+	}
+
+	open_run.rect_count += count;
+	open_run.merged_items++;
+	stats.commands += count;
+	return true;
+}
+
+void RasterizerCanvasBatcher::_close_run() {
+	if (!run_open) {
+		return;
+	}
+	run_open = false;
+
+	if (open_run.rect_count < min_batch_size) {
+		//too short, drawn one by one
+		rects.resize(open_run.rect_offset);
+		return;
+	}
+
+	batches.push_back(open_run);
+	stats.batched_commands += open_run.rect_count;
+	stats.batches++;
+}
+
+void RasterizerCanvasBatcher::add_item(const Item *p_item, const Transform2D &p_transform, bool p_mergeable) {
+	uint32_t item = item_count++;
+
+	bool merge = run_open && p_mergeable && last_item_mergeable && _is_same_state(last_item, p_item);
+	last_item = p_item;
+	last_item_mergeable = p_mergeable;
+
+	if (merge && _merge_item(p_item, p_transform)) {
+		return;
+	}
+
+	_close_run();
+
+	Transform2D transform = p_transform;
+
+	const Item::Command *c = p_item->commands;
+	while (c) {
+		stats.commands++;
+
+		if (!_is_batchable(c)) {
+			if (c->type == Item::Command::TYPE_TRANSFORM) {
+				transform = p_transform * static_cast<const Item::CommandTransform *>(c)->xform;
+			}
+			c = c->next;
+			continue;
+		}
+
+		//find the run of compatible rects starting here
+		RID texture = static_cast<const Item::CommandRect *>(c)->texture;
+		uint32_t count = 1;
+		const Item::Command *end = c->next;
+		while (end && _is_batchable(end) && static_cast<const Item::CommandRect *>(end)->texture == texture) {
+			count++;
+			end = end->next;
+		}
+
+		uint32_t space = max_rects - MIN(max_rects, rects.size());
+		//a run reaching the end of the item may still grow with the next ones
+		bool open = end == nullptr && count <= space;
+		count = MIN(count, space);
+
+		if (count < min_batch_size && !open) {
+			//too short (or out of space), drawn one by one
+			stats.commands += MAX(count, 1u) - 1;
+			for (uint32_t i = 0; i < MAX(count, 1u); i++) {
+				c = c->next;
+			}
+			continue;
+		}
+
+		Batch batch;
+		batch.item = item;
+		batch.merged_items = 0;
+		batch.first_command = c;
+		batch.command_count = count;
+		batch.rect_offset = rects.size();
+		batch.rect_count = count;
+		batch.texture = texture;
+
+		rects.resize(rects.size() + count);
+		Rect *rect = &rects[batch.rect_offset];
+		for (uint32_t i = 0; i < count; i++) {
+			_fill_rect(static_cast<const Item::CommandRect *>(c), p_item->final_modulate, transform, rect[i]);
+			c = c->next;
+		}
+
+		stats.commands += count - 1;
+
+		open_run = batch;
+		run_open = true;
+		if (!open) {
+			_close_run();
+		}
+	}
+}
+
+void RasterizerCanvasBatcher::finish() {
+	_close_run();
+}
+
+void RasterizerCanvasBatcher::set_max_rects(uint32_t p_max_rects) {
+	max_rects = p_max_rects;
+	rects.reserve(max_rects);
+}
+
+void RasterizerCanvasBatcher::set_min_batch_size(uint32_t p_size) {
+	ERR_FAIL_COND(p_size < 2);
+	min_batch_size = p_size;
+}
@@ -0,0 +1,122 @@
+/*************************************************************************/
+/*  rasterizer_canvas_batcher.h                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef RASTERIZER_CANVAS_BATCHER_H
+#define RASTERIZER_CANVAS_BATCHER_H
+
+#include "core/templates/local_vector.h"
+#include "servers/rendering/rasterizer.h"
+
+// Backend independent batching of canvas item commands. Runs of consecutive
+// compatible rects are merged into batches, so a backend can draw each one
+// as a single instanced draw reading the per-rect data from a buffer. Each
+// rect carries its own transform, so a run can continue into the following
+// items when they share the same state.
+class RasterizerCanvasBatcher {
+public:
+	enum {
+		RECT_FLAG_REGION = 1, // src_rect is in pixels, must be scaled by the texture pixel size
+		RECT_FLAG_TRANSPOSE = 2, // UVs are transposed, like FLAGS_TRANSPOSE_RECT for unbatched rects
+	};
+
+	// Laid out to match a std430 storage buffer.
+	struct Rect {
+		float dst_rect[4];
+		float src_rect[4];
+		float modulation[4];
+		float world[6]; // mat2x3, columns first
+		uint32_t flags;
+		uint32_t pad;
+	};
+
+	struct Batch {
+		uint32_t item; // index of the item the batch starts in
+		uint32_t merged_items; // following items drawn entirely by this batch
+		const RasterizerCanvas::Item::Command *first_command;
+		uint32_t command_count; // commands of the first item
+		uint32_t rect_offset;
+		uint32_t rect_count;
+		RID texture;
+	};
+
+	struct Stats {
+		uint32_t commands = 0;
+		uint32_t batched_commands = 0;
+		uint32_t batches = 0;
+	};
+
+private:
+	LocalVector<Rect> rects;
+	LocalVector<Batch> batches;
+	uint32_t max_rects = 0;
+	uint32_t min_batch_size = 2;
+	Stats stats;
+
+	uint32_t item_count = 0;
+	const RasterizerCanvas::Item *last_item = nullptr;
+	bool last_item_mergeable = false;
+	// Run ending the last item, kept open so the next item can continue it.
+	Batch open_run;
+	bool run_open = false;
+
+	static bool _is_batchable(const RasterizerCanvas::Item::Command *p_command);
+	static bool _is_same_state(const RasterizerCanvas::Item *p_a, const RasterizerCanvas::Item *p_b);
+	static void _fill_rect(const RasterizerCanvas::Item::CommandRect *p_rect, const Color &p_modulate, const Transform2D &p_transform, Rect &r_rect);
+
+	bool _merge_item(const RasterizerCanvas::Item *p_item, const Transform2D &p_transform);
+	void _close_run();
+
+public:
+	void clear();
+	void reset_stats();
+
+	// Batches the commands of an item, items must be added in drawing order
+	// with the transform their commands are drawn with. Only mergeable items
+	// (as decided by the backend, e.g. unlit ones) can share a batch with the
+	// previous item, and only when they consist of compatible rects alone.
+	// Batches are sorted by the item they start in; call finish() after the
+	// last item.
+	void add_item(const RasterizerCanvas::Item *p_item, const Transform2D &p_transform, bool p_mergeable = false);
+	void finish();
+
+	_FORCE_INLINE_ const Rect *get_rects() const { return rects.ptr(); }
+	_FORCE_INLINE_ uint32_t get_rect_count() const { return rects.size(); }
+	_FORCE_INLINE_ const Batch *get_batches() const { return batches.ptr(); }
+	_FORCE_INLINE_ uint32_t get_batch_count() const { return batches.size(); }
+	_FORCE_INLINE_ const Stats &get_stats() const { return stats; }
+
+	void set_max_rects(uint32_t p_max_rects);
+	uint32_t get_max_rects() const { return max_rects; }
+
+	void set_min_batch_size(uint32_t p_size);
+	uint32_t get_min_batch_size() const { return min_batch_size; }
+};
+
+#endif // RASTERIZER_CANVAS_BATCHER_H
@@ -363,7 +363,28 @@ void RasterizerCanvasRD::_bind_canvas_texture(RD::DrawListID p_draw_list, RID p_
 	r_last_texture = p_texture;
 }
 
-void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_item, RD::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, Light *p_lights, PipelineVariants *p_pipeline_variants) {
+uint32_t RasterizerCanvasRD::_get_item_lights(const Item *p_item, Light *p_lights, uint32_t *r_lights) {
+	uint32_t light_count = 0;
+	Light *light = p_lights;
+
+	while (light) {
+		if (light->render_index_cache >= 0 && p_item->light_mask & light->item_mask && p_item->z_final >= light->z_min && p_item->z_final <= light->z_max && p_item->global_rect_cache.intersects_transformed(light->xform_cache, light->rect_cache)) {
+			uint32_t light_index = light->render_index_cache;
+			r_lights[light_count >> 2] |= light_index << ((light_count & 3) * 8);
+
+			light_count++;
+
+			if (light_count == MAX_LIGHTS_PER_ITEM) {
+				break;
+			}
+		}
+		light = light->next_ptr;
+	}
+
+	return light_count;
+}
+
+void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_item, RD::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, Light *p_lights, PipelineVariants *p_pipeline_variants, const RasterizerCanvasBatcher::Batch *p_batches, uint32_t p_batch_count) {
 	//create an empty push constant
 
 	RS::CanvasItemTextureFilter current_filter = default_filter;
@@ -393,8 +414,8 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 	push_constant.color_texture_pixel_size[0] = 0;
 	push_constant.color_texture_pixel_size[1] = 0;
 
-	push_constant.pad[0] = 0;
-	push_constant.pad[1] = 0;
+	push_constant.batch_offset = 0;
+	push_constant.pad = 0;
 
 	push_constant.lights[0] = 0;
 	push_constant.lights[1] = 0;
@@ -403,28 +424,10 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 
 	uint32_t base_flags = 0;
 
-	uint16_t light_count = 0;
+	uint32_t light_count = _get_item_lights(p_item, p_lights, push_constant.lights);
 	PipelineLightMode light_mode;
 
-	{
-		Light *light = p_lights;
-
-		while (light) {
-			if (light->render_index_cache >= 0 && p_item->light_mask & light->item_mask && p_item->z_final >= light->z_min && p_item->z_final <= light->z_max && p_item->global_rect_cache.intersects_transformed(light->xform_cache, light->rect_cache)) {
-				uint32_t light_index = light->render_index_cache;
-				push_constant.lights[light_count >> 2] |= light_index << ((light_count & 3) * 8);
-
-				light_count++;
-
-				if (light_count == MAX_LIGHTS_PER_ITEM) {
-					break;
-				}
-			}
-			light = light->next_ptr;
-		}
-
-		base_flags |= light_count << FLAGS_LIGHT_COUNT_SHIFT;
-	}
+	base_flags |= light_count << FLAGS_LIGHT_COUNT_SHIFT;
 
 	light_mode = (light_count > 0 || using_directional_lights) ? PIPELINE_LIGHT_MODE_ENABLED : PIPELINE_LIGHT_MODE_DISABLED;
 
@@ -435,6 +438,8 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 	RID last_texture;
 	Size2 texpixel_size;
 
+	uint32_t current_batch = 0;
+
 	const Item::Command *c = p_item->commands;
 	while (c) {
 		push_constant.flags = base_flags | (push_constant.flags & (FLAGS_DEFAULT_NORMAL_MAP_USED | FLAGS_DEFAULT_SPECULAR_MAP_USED)); //reset on each command for sanity, keep canvastexture binding config
@@ -453,6 +458,24 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 
 				_bind_canvas_texture(p_draw_list, rect->texture, current_filter, current_repeat, last_texture, push_constant, texpixel_size);
 
+				if (current_batch < p_batch_count && p_batches[current_batch].first_command == c) {
+					//a run of rects sharing this texture, possibly continuing into the next items, drawn as instances of the batched rect data
+					const RasterizerCanvasBatcher::Batch &batch = p_batches[current_batch++];
+
+					push_constant.flags |= FLAGS_USE_BATCH;
+					push_constant.batch_offset = batch.rect_offset;
+
+					RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
+					RD::get_singleton()->draw_list_bind_index_array(p_draw_list, shader.quad_index_array);
+					RD::get_singleton()->draw_list_draw(p_draw_list, true, batch.rect_count);
+					info.draw_calls++;
+
+					for (uint32_t i = 1; i < batch.command_count; i++) {
+						c = c->next;
+					}
+					break;
+				}
+
 				Rect2 src_rect;
 				Rect2 dst_rect;
 
@@ -518,6 +541,7 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 				RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
 				RD::get_singleton()->draw_list_bind_index_array(p_draw_list, shader.quad_index_array);
 				RD::get_singleton()->draw_list_draw(p_draw_list, true);
+				info.draw_calls++;
 
 			} break;
 
@@ -582,6 +606,7 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 				RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
 				RD::get_singleton()->draw_list_bind_index_array(p_draw_list, shader.quad_index_array);
 				RD::get_singleton()->draw_list_draw(p_draw_list, true);
+				info.draw_calls++;
 
 				//restore if overrided
 				push_constant.color_texture_pixel_size[0] = texpixel_size.x;
@@ -627,6 +652,7 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 					RD::get_singleton()->draw_list_bind_index_array(p_draw_list, pb->indices);
 				}
 				RD::get_singleton()->draw_list_draw(p_draw_list, pb->indices.is_valid());
+				info.draw_calls++;
 
 			} break;
 			case Item::Command::TYPE_PRIMITIVE: {
@@ -657,6 +683,7 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 				}
 				RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
 				RD::get_singleton()->draw_list_draw(p_draw_list, true);
+				info.draw_calls++;
 
 				if (primitive->point_count == 4) {
 					for (uint32_t j = 1; j < 3; j++) {
@@ -672,6 +699,7 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 
 					RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
 					RD::get_singleton()->draw_list_draw(p_draw_list, true);
+					info.draw_calls++;
 				}
 
 			} break;
@@ -1088,6 +1116,14 @@ RID RasterizerCanvasRD::_create_base_uniform_set(RID p_to_render_target, bool p_
 		uniforms.push_back(u);
 	}
 
+	{
+		RD::Uniform u;
+		u.type = RD::UNIFORM_TYPE_STORAGE_BUFFER;
+		u.binding = 9;
+		u.ids.push_back(state.batch_buffer);
+		uniforms.push_back(u);
+	}
+
 	RID uniform_set = RD::get_singleton()->uniform_set_create(uniforms, shader.default_version_rd_shader, BASE_UNIFORM_SET);
 	if (p_backbuffer) {
 		storage->render_target_set_backbuffer_uniform_set(p_to_render_target, uniform_set);
@@ -1132,6 +1168,22 @@ void RasterizerCanvasRD::_render_items(RID p_to_render_target, int p_item_count,
 
 	RD::FramebufferFormatID fb_format = RD::get_singleton()->framebuffer_get_format(framebuffer);
 
+	//batch rect runs before the draw list, so their data is uploaded in a single update
+	batcher.clear();
+	if (state.batching_enabled) {
+		for (int i = 0; i < p_item_count; i++) {
+			//lights are applied with the transform and light list of the item, so only unlit items share batches
+			uint32_t lights[4] = { 0, 0, 0, 0 };
+			bool mergeable = !using_directional_lights && _get_item_lights(items[i], p_lights, lights) == 0;
+			batcher.add_item(items[i], canvas_transform_inverse * items[i]->final_transform, mergeable);
+		}
+		batcher.finish();
+	}
+
+	if (batcher.get_rect_count()) {
+		RD::get_singleton()->buffer_update(state.batch_buffer, 0, sizeof(RasterizerCanvasBatcher::Rect) * batcher.get_rect_count(), batcher.get_rects(), true);
+	}
+
 	RD::DrawListID draw_list = RD::get_singleton()->draw_list_begin(framebuffer, clear ? RD::INITIAL_ACTION_CLEAR : RD::INITIAL_ACTION_KEEP, RD::FINAL_ACTION_READ, RD::INITIAL_ACTION_KEEP, RD::FINAL_ACTION_DISCARD, clear_colors);
 
 	RD::get_singleton()->draw_list_bind_uniform_set(draw_list, fb_uniform_set, BASE_UNIFORM_SET);
@@ -1141,6 +1193,8 @@ void RasterizerCanvasRD::_render_items(RID p_to_render_target, int p_item_count,
 
 	PipelineVariants *pipeline_variants = &shader.pipeline_variants;
 
+	uint32_t current_batch = 0;
+
 	for (int i = 0; i < p_item_count; i++) {
 		Item *ci = items[i];
 
@@ -1182,12 +1236,25 @@ void RasterizerCanvasRD::_render_items(RID p_to_render_target, int p_item_count,
 			}
 		}
 
-		_render_item(draw_list, ci, fb_format, canvas_transform_inverse, current_clip, p_lights, pipeline_variants);
+		uint32_t first_batch = current_batch;
+		while (current_batch < batcher.get_batch_count() && batcher.get_batches()[current_batch].item == uint32_t(i)) {
+			current_batch++;
+		}
+
+		_render_item(draw_list, ci, fb_format, canvas_transform_inverse, current_clip, p_lights, pipeline_variants, batcher.get_batches() + first_batch, current_batch - first_batch);
 
 		prev_material = material;
+
+		if (current_batch > first_batch) {
+			//items merged into the last batch were drawn with it
+			i += batcher.get_batches()[current_batch - 1].merged_items;
+		}
 	}
 
 	RD::get_singleton()->draw_list_end();
+
+	info.batched_commands += batcher.get_stats().batched_commands;
+	batcher.reset_stats();
 }
 
 void RasterizerCanvasRD::canvas_render_items(RID p_to_render_target, Item *p_item_list, const Color &p_modulate, Light *p_light_list, Light *p_directional_light_list, const Transform2D &p_canvas_transform, RenderingServer::CanvasItemTextureFilter p_default_filter, RenderingServer::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel) {
@@ -2167,6 +2234,22 @@ void RasterizerCanvasRD::set_time(double p_time) {
 void RasterizerCanvasRD::update() {
 }
 
+void RasterizerCanvasRD::render_info_begin_frame() {
+	frame_info = info;
+	info = Info();
+}
+
+int RasterizerCanvasRD::get_render_info(RS::RenderInfo p_info) {
+	switch (p_info) {
+		case RS::INFO_2D_DRAW_CALLS_IN_FRAME:
+			return frame_info.draw_calls;
+		case RS::INFO_2D_BATCHED_COMMANDS_IN_FRAME:
+			return frame_info.batched_commands;
+		default:
+			return 0;
+	}
+}
+
 RasterizerCanvasRD::RasterizerCanvasRD(RasterizerStorageRD *p_storage) {
 	storage = p_storage;
 
@@ -2388,6 +2471,11 @@ RasterizerCanvasRD::RasterizerCanvasRD(RasterizerStorageRD *p_storage) {
 		state.canvas_state_buffer = RD::get_singleton()->uniform_buffer_create(sizeof(State::Buffer));
 		state.lights_uniform_buffer = RD::get_singleton()->uniform_buffer_create(sizeof(LightUniform) * state.max_lights_per_render);
 
+		uint32_t max_batched_rects = MAX(int(GLOBAL_GET("rendering/2d/batching/max_rects")), 1);
+		state.batching_enabled = GLOBAL_GET("rendering/2d/batching/enabled");
+		state.batch_buffer = RD::get_singleton()->storage_buffer_create(sizeof(RasterizerCanvasBatcher::Rect) * max_batched_rects);
+		batcher.set_max_rects(max_batched_rects);
+
 		RD::SamplerState shadow_sampler_state;
 		shadow_sampler_state.mag_filter = RD::SAMPLER_FILTER_LINEAR;
 		shadow_sampler_state.min_filter = RD::SAMPLER_FILTER_LINEAR;
@@ -2537,6 +2625,7 @@ RasterizerCanvasRD::~RasterizerCanvasRD() {
 
 		memdelete_arr(state.light_uniforms);
 		RD::get_singleton()->free(state.lights_uniform_buffer);
+		RD::get_singleton()->free(state.batch_buffer);
 		RD::get_singleton()->free(shader.default_skeleton_uniform_buffer);
 		RD::get_singleton()->free(shader.default_skeleton_texture_buffer);
 	}
@@ -32,6 +32,7 @@
 #define RASTERIZER_CANVAS_RD_H
 
 #include "servers/rendering/rasterizer.h"
+#include "servers/rendering/rasterizer_canvas_batcher.h"
 #include "servers/rendering/rasterizer_rd/rasterizer_storage_rd.h"
 #include "servers/rendering/rasterizer_rd/render_pipeline_vertex_format_cache_rd.h"
 #include "servers/rendering/rasterizer_rd/shader_compiler_rd.h"
@@ -78,6 +79,7 @@ class RasterizerCanvasRD : public RasterizerCanvas {
 
 		FLAGS_NINEPACH_DRAW_CENTER = (1 << 12),
 		FLAGS_USING_PARTICLES = (1 << 13),
+		FLAGS_USE_BATCH = (1 << 14),
 
 		FLAGS_USE_SKELETON = (1 << 15),
 		FLAGS_NINEPATCH_H_MODE_SHIFT = 16,
@@ -352,6 +354,9 @@ class RasterizerCanvasRD : public RasterizerCanvas {
 
 		RID default_transforms_uniform_set;
 
+		RID batch_buffer;
+		bool batching_enabled;
+
 		uint32_t max_lights_per_render;
 		uint32_t max_lights_per_item;
 
@@ -370,7 +375,8 @@ class RasterizerCanvasRD : public RasterizerCanvas {
 				float ninepatch_margins[4];
 				float dst_rect[4];
 				float src_rect[4];
-				float pad[2];
+				uint32_t batch_offset; //first rect in the batch buffer, when FLAGS_USE_BATCH is set
+				uint32_t pad;
 			};
 			//primitive
 			struct {
@@ -390,6 +396,16 @@ class RasterizerCanvasRD : public RasterizerCanvas {
 
 	Item *items[MAX_RENDER_ITEMS];
 
+	RasterizerCanvasBatcher batcher;
+
+	struct Info {
+		uint32_t draw_calls = 0;
+		uint32_t batched_commands = 0;
+	};
+
+	Info info; //current frame
+	Info frame_info; //last finished frame
+
 	bool using_directional_lights = false;
 	RID default_canvas_texture;
 
@@ -402,7 +418,8 @@ class RasterizerCanvasRD : public RasterizerCanvas {
 	RID _create_base_uniform_set(RID p_to_render_target, bool p_backbuffer);
 
 	inline void _bind_canvas_texture(RD::DrawListID p_draw_list, RID p_texture, RS::CanvasItemTextureFilter p_base_filter, RS::CanvasItemTextureRepeat p_base_repeat, RID &r_last_texture, PushConstant &push_constant, Size2 &r_texpixel_size); //recursive, so regular inline used instead.
-	void _render_item(RenderingDevice::DrawListID p_draw_list, const Item *p_item, RenderingDevice::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, Light *p_lights, PipelineVariants *p_pipeline_variants);
+	uint32_t _get_item_lights(const Item *p_item, Light *p_lights, uint32_t *r_lights);
+	void _render_item(RenderingDevice::DrawListID p_draw_list, const Item *p_item, RenderingDevice::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, Light *p_lights, PipelineVariants *p_pipeline_variants, const RasterizerCanvasBatcher::Batch *p_batches, uint32_t p_batch_count);
 	void _render_items(RID p_to_render_target, int p_item_count, const Transform2D &p_canvas_transform_inverse, Light *p_lights, bool p_to_backbuffer = false);
 
 	_FORCE_INLINE_ void _update_transform_2d_to_mat2x4(const Transform2D &p_transform, float *p_mat2x4);
@@ -437,6 +454,9 @@ public:
 
 	void set_time(double p_time);
 	void update();
+
+	void render_info_begin_frame();
+	int get_render_info(RS::RenderInfo p_info);
 	bool free(RID p_rid);
 	RasterizerCanvasRD(RasterizerStorageRD *p_storage);
 	~RasterizerCanvasRD();
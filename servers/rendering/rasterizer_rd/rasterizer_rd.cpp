@@ -31,6 +31,7 @@
 #include "rasterizer_rd.h"
 
 #include "core/config/project_settings.h"
+#include "servers/rendering/rasterizer_rd/shader_rd.h"
 
 void RasterizerRD::prepare_for_blitting_render_targets() {
 	RD::get_singleton()->prepare_screen_for_drawing();
@@ -85,6 +86,7 @@ void RasterizerRD::begin_frame(double frame_step) {
 	time = Math::fmod(time, time_roll_over);
 
 	canvas->set_time(time);
+	canvas->render_info_begin_frame();
 	scene->set_time(time, frame_step);
 }
 
@@ -168,6 +170,8 @@ void RasterizerRD::finalize() {
 	RD::get_singleton()->free(copy_viewports_rd_index_buffer);
 	RD::get_singleton()->free(copy_viewports_rd_shader);
 	RD::get_singleton()->free(copy_viewports_sampler);
+
+	ShaderRD::shader_cache_finish();
 }
 
 RasterizerRD *RasterizerRD::singleton = nullptr;
@@ -177,6 +181,10 @@ RasterizerRD::RasterizerRD() {
 	thread_work_pool.init();
 	time = 0;
 
+	if (GLOBAL_GET("rendering/shader_cache/enabled")) {
+		ShaderRD::shader_cache_init(ShaderRD::SHADER_CACHE_USER_DIR);
+	}
+
 	storage = memnew(RasterizerStorageRD);
 	canvas = memnew(RasterizerCanvasRD(storage));
 	scene = memnew(RasterizerSceneHighEndRD(storage));
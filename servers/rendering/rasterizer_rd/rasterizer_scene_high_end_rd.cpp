@@ -30,6 +30,7 @@
 
 #include "rasterizer_scene_high_end_rd.h"
 #include "core/config/project_settings.h"
+#include "servers/rendering/rasterizer_rd/rasterizer_rd.h"
 #include "servers/rendering/rendering_device.h"
 #include "servers/rendering/rendering_server_raster.h"
 
@@ -803,11 +804,9 @@ bool RasterizerSceneHighEndRD::free(RID p_rid) {
 	return false;
 }
 
-void RasterizerSceneHighEndRD::_fill_instances(RenderList::Element **p_elements, int p_element_count, bool p_for_depth, bool p_has_sdfgi, bool p_has_opaque_gi) {
-	uint32_t lightmap_captures_used = 0;
-
-	for (int i = 0; i < p_element_count; i++) {
-		const RenderList::Element *e = p_elements[i];
+void RasterizerSceneHighEndRD::_fill_instance_range(FillInstances *p_fill, uint32_t p_from, uint32_t p_to) {
+	for (uint32_t i = p_from; i < p_to; i++) {
+		const RenderList::Element *e = p_fill->elements[i];
 		InstanceData &id = scene_state.instances[i];
 		bool store_transform = true;
 		id.flags = 0;
@@ -869,7 +868,7 @@ void RasterizerSceneHighEndRD::_fill_instances(RenderList::Element **p_elements,
 			RasterizerStorageRD::store_transform(Transform(), id.normal_transform);
 		}
 
-		if (p_for_depth) {
+		if (p_fill->for_depth) {
 			id.gi_offset = 0xFFFFFFFF;
 			continue;
 		}
@@ -892,9 +891,10 @@ void RasterizerSceneHighEndRD::_fill_instances(RenderList::Element **p_elements,
 				id.gi_offset = 0xFFFFFFFF;
 			}
 		} else if (!e->instance->lightmap_sh.empty()) {
-			if (lightmap_captures_used < scene_state.max_lightmap_captures) {
+			uint32_t capture_index = e->lightmap_capture_index;
+			if (capture_index < scene_state.max_lightmap_captures) {
 				const Color *src_capture = e->instance->lightmap_sh.ptr();
-				LightmapCaptureData &lcd = scene_state.lightmap_captures[lightmap_captures_used];
+				LightmapCaptureData &lcd = scene_state.lightmap_captures[capture_index];
 				for (int j = 0; j < 9; j++) {
 					lcd.sh[j * 4 + 0] = src_capture[j].r;
 					lcd.sh[j * 4 + 1] = src_capture[j].g;
@@ -902,12 +902,11 @@ void RasterizerSceneHighEndRD::_fill_instances(RenderList::Element **p_elements,
 					lcd.sh[j * 4 + 3] = src_capture[j].a;
 				}
 				id.flags |= INSTANCE_DATA_FLAG_USE_LIGHTMAP_CAPTURE;
-				id.gi_offset = lightmap_captures_used;
-				lightmap_captures_used++;
+				id.gi_offset = capture_index;
 			}
 
 		} else {
-			if (p_has_opaque_gi) {
+			if (p_fill->has_opaque_gi) {
 				id.flags |= INSTANCE_DATA_FLAG_USE_GI_BUFFERS;
 			}
 
@@ -934,13 +933,47 @@ void RasterizerSceneHighEndRD::_fill_instances(RenderList::Element **p_elements,
 					id.gi_offset |= 0xFFFF0000;
 				}
 			} else {
-				if (p_has_sdfgi && (e->instance->baked_light || e->instance->dynamic_gi)) {
+				if (p_fill->has_sdfgi && (e->instance->baked_light || e->instance->dynamic_gi)) {
 					id.flags |= INSTANCE_DATA_FLAG_USE_SDFGI;
 				}
 				id.gi_offset = 0xFFFFFFFF;
 			}
 		}
 	}
+}
+
+void RasterizerSceneHighEndRD::_fill_instances_chunk(uint32_t p_chunk, FillInstances *p_fill) {
+	uint32_t from = p_chunk * FILL_INSTANCES_CHUNK;
+	_fill_instance_range(p_fill, from, MIN(from + FILL_INSTANCES_CHUNK, p_fill->element_count));
+}
+
+void RasterizerSceneHighEndRD::_fill_instances(RenderList::Element **p_elements, int p_element_count, bool p_for_depth, bool p_has_sdfgi, bool p_has_opaque_gi) {
+	FillInstances fill;
+	fill.elements = p_elements;
+	fill.element_count = p_element_count;
+	fill.for_depth = p_for_depth;
+	fill.has_sdfgi = p_has_sdfgi;
+	fill.has_opaque_gi = p_has_opaque_gi;
+
+	//capture slots are handed out in list order, so which instances get one past the limit doesn't depend on the threads
+	uint32_t lightmap_captures_used = 0;
+	if (!p_for_depth) {
+		for (int i = 0; i < p_element_count; i++) {
+			RenderList::Element *e = p_elements[i];
+			if (!e->instance->lightmap && !e->instance->lightmap_sh.empty() && lightmap_captures_used < scene_state.max_lightmap_captures) {
+				e->lightmap_capture_index = lightmap_captures_used++;
+			} else {
+				e->lightmap_capture_index = 0xFFFFFFFF;
+			}
+		}
+	}
+
+	if (p_element_count > FILL_INSTANCES_CHUNK) {
+		uint32_t chunks = (p_element_count + FILL_INSTANCES_CHUNK - 1) / FILL_INSTANCES_CHUNK;
+		RasterizerRD::thread_work_pool.do_work(chunks, this, &RasterizerSceneHighEndRD::_fill_instances_chunk, &fill);
+	} else {
+		_fill_instance_range(&fill, 0, p_element_count);
+	}
 
 	RD::get_singleton()->buffer_update(scene_state.instance_buffer, 0, sizeof(InstanceData) * p_element_count, scene_state.instances, true);
 	if (lightmap_captures_used) {
@@ -1086,12 +1119,12 @@ void RasterizerSceneHighEndRD::_render_list(RenderingDevice::DrawListID p_draw_l
 
 		switch (e->instance->base_type) {
 			case RS::INSTANCE_MESH: {
-				storage->mesh_surface_get_arrays_and_format(e->instance->base, e->surface_index, pipeline->get_vertex_input_mask(), vertex_array_rd, index_array_rd, vertex_format);
+				storage->mesh_surface_get_arrays_and_format(e->instance->base, e->surface_index, e->instance->lod_threshold, pipeline->get_vertex_input_mask(), vertex_array_rd, index_array_rd, vertex_format);
 			} break;
 			case RS::INSTANCE_MULTIMESH: {
 				RID mesh = storage->multimesh_get_mesh(e->instance->base);
 				ERR_CONTINUE(!mesh.is_valid()); //should be a bug
-				storage->mesh_surface_get_arrays_and_format(mesh, e->surface_index, pipeline->get_vertex_input_mask(), vertex_array_rd, index_array_rd, vertex_format);
+				storage->mesh_surface_get_arrays_and_format(mesh, e->surface_index, e->instance->lod_threshold, pipeline->get_vertex_input_mask(), vertex_array_rd, index_array_rd, vertex_format);
 			} break;
 			case RS::INSTANCE_IMMEDIATE: {
 				ERR_CONTINUE(true); //should be a bug
@@ -1099,7 +1132,7 @@ void RasterizerSceneHighEndRD::_render_list(RenderingDevice::DrawListID p_draw_l
 			case RS::INSTANCE_PARTICLES: {
 				RID mesh = storage->particles_get_draw_pass_mesh(e->instance->base, e->surface_index >> 16);
 				ERR_CONTINUE(!mesh.is_valid()); //should be a bug
-				storage->mesh_surface_get_arrays_and_format(mesh, e->surface_index & 0xFFFF, pipeline->get_vertex_input_mask(), vertex_array_rd, index_array_rd, vertex_format);
+				storage->mesh_surface_get_arrays_and_format(mesh, e->surface_index & 0xFFFF, e->instance->lod_threshold, pipeline->get_vertex_input_mask(), vertex_array_rd, index_array_rd, vertex_format);
 			} break;
 			default: {
 				ERR_CONTINUE(true); //should be a bug
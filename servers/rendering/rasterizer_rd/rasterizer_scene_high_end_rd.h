@@ -31,6 +31,7 @@
 #ifndef RASTERIZER_SCENE_HIGHEND_RD_H
 #define RASTERIZER_SCENE_HIGHEND_RD_H
 
+#include "core/templates/radix_sort.h"
 #include "servers/rendering/rasterizer_rd/rasterizer_scene_rd.h"
 #include "servers/rendering/rasterizer_rd/rasterizer_storage_rd.h"
 #include "servers/rendering/rasterizer_rd/render_pipeline_vertex_format_cache_rd.h"
@@ -433,6 +434,7 @@ class RasterizerSceneHighEndRD : public RasterizerSceneRD {
 				uint64_t sort_key;
 			};
 			uint32_t surface_index;
+			uint32_t lightmap_capture_index; //assigned in list order by _fill_instances
 		};
 
 		Element *base_elements;
@@ -446,7 +448,10 @@ class RasterizerSceneHighEndRD : public RasterizerSceneRD {
 			alpha_element_count = 0;
 		}
 
-		//should eventually be replaced by radix
+		//radix sort on the 64 bits key, comparison sort is only used for short lists
+		enum {
+			RADIX_SORT_THRESHOLD = 256
+		};
 
 		struct SortByKey {
 			_FORCE_INLINE_ bool operator()(const Element *A, const Element *B) const {
@@ -454,12 +459,27 @@ class RasterizerSceneHighEndRD : public RasterizerSceneRD {
 			}
 		};
 
+		struct SortKey {
+			_FORCE_INLINE_ uint64_t operator()(const Element *A) const {
+				return A->sort_key;
+			}
+		};
+
+		typedef RadixSort<Element *, SortKey> RadixSorter;
+
+		RadixSorter::Pair *sort_pairs = nullptr;
+		RadixSorter::Pair *sort_pairs_tmp = nullptr;
+
 		void sort_by_key(bool p_alpha) {
-			SortArray<Element *, SortByKey> sorter;
-			if (p_alpha) {
-				sorter.sort(&elements[max_elements - alpha_element_count], alpha_element_count);
+			Element **sort_elements = p_alpha ? &elements[max_elements - alpha_element_count] : elements;
+			int sort_count = p_alpha ? alpha_element_count : element_count;
+
+			if (sort_count < RADIX_SORT_THRESHOLD) {
+				SortArray<Element *, SortByKey> sorter;
+				sorter.sort(sort_elements, sort_count);
 			} else {
-				sorter.sort(elements, element_count);
+				RadixSorter sorter;
+				sorter.sort(sort_elements, sort_count, sort_pairs, sort_pairs_tmp);
 			}
 		}
 
@@ -524,6 +544,8 @@ class RasterizerSceneHighEndRD : public RasterizerSceneRD {
 			alpha_element_count = 0;
 			elements = memnew_arr(Element *, max_elements);
 			base_elements = memnew_arr(Element, max_elements);
+			sort_pairs = memnew_arr(RadixSorter::Pair, max_elements);
+			sort_pairs_tmp = memnew_arr(RadixSorter::Pair, max_elements);
 			for (int i = 0; i < max_elements; i++) {
 				elements[i] = &base_elements[i]; // assign elements
 			}
@@ -536,6 +558,8 @@ class RasterizerSceneHighEndRD : public RasterizerSceneRD {
 		~RenderList() {
 			memdelete_arr(elements);
 			memdelete_arr(base_elements);
+			memdelete_arr(sort_pairs);
+			memdelete_arr(sort_pairs_tmp);
 		}
 	};
 
@@ -574,6 +598,21 @@ class RasterizerSceneHighEndRD : public RasterizerSceneRD {
 	void _setup_environment(RID p_environment, RID p_render_buffers, const CameraMatrix &p_cam_projection, const Transform &p_cam_transform, RID p_reflection_probe, bool p_no_fog, const Size2 &p_screen_pixel_size, RID p_shadow_atlas, bool p_flip_y, const Color &p_default_bg_color, float p_znear, float p_zfar, bool p_opaque_render_buffers = false, bool p_pancake_shadows = false);
 	void _setup_lightmaps(InstanceBase **p_lightmap_cull_result, int p_lightmap_cull_count, const Transform &p_cam_transform);
 
+	//instance data is filled in chunks on the rasterizer thread pool
+	enum {
+		FILL_INSTANCES_CHUNK = 512
+	};
+
+	struct FillInstances {
+		RenderList::Element **elements;
+		uint32_t element_count;
+		bool for_depth;
+		bool has_sdfgi;
+		bool has_opaque_gi;
+	};
+
+	void _fill_instance_range(FillInstances *p_fill, uint32_t p_from, uint32_t p_to);
+	void _fill_instances_chunk(uint32_t p_chunk, FillInstances *p_fill);
 	void _fill_instances(RenderList::Element **p_elements, int p_element_count, bool p_for_depth, bool p_has_sdfgi = false, bool p_has_opaque_gi = false);
 	void _render_list(RenderingDevice::DrawListID p_draw_list, RenderingDevice::FramebufferFormatID p_framebuffer_Format, RenderList::Element **p_elements, int p_element_count, bool p_reverse_cull, PassMode p_pass_mode, bool p_no_gi, RID p_radiance_uniform_set, RID p_render_buffers_uniform_set, bool p_force_wireframe = false, const Vector2 &p_uv_offset = Vector2());
 	_FORCE_INLINE_ void _add_geometry(InstanceBase *p_instance, uint32_t p_surface, RID p_material, PassMode p_pass_mode, uint32_t p_geometry_index, bool p_using_sdfgi = false);
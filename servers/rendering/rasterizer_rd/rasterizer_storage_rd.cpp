@@ -2694,37 +2694,8 @@ AABB RasterizerStorageRD::mesh_get_aabb(RID p_mesh, RID p_skeleton) {
 						laabb.merge_with(baabb);
 					}
 				}
-			} else {
-				for (int j = 0; j < bs; j++) {
-					if (skbones[0].size == Vector3()) {
-						continue; //bone is unused
-					}
-
-					const float *dataptr = baseptr + j * 12;
-
-					Transform mtx;
-
-					mtx.basis.elements[0][0] = dataptr[0];
-					mtx.basis.elements[0][1] = dataptr[1];
-					mtx.basis.elements[0][2] = dataptr[2];
-					mtx.origin.x = dataptr[3];
-					mtx.basis.elements[1][0] = dataptr[4];
-					mtx.basis.elements[1][1] = dataptr[5];
-					mtx.basis.elements[1][2] = dataptr[6];
-					mtx.origin.y = dataptr[7];
-					mtx.basis.elements[2][0] = dataptr[8];
-					mtx.basis.elements[2][1] = dataptr[9];
-					mtx.basis.elements[2][2] = dataptr[10];
-					mtx.origin.z = dataptr[11];
-
-					AABB baabb = mtx.xform(skbones[j]);
-					if (first) {
-						laabb = baabb;
-						first = false;
-					} else {
-						laabb.merge_with(baabb);
-					}
-				}
+			} else if (skbones[0].size != Vector3()) {
+				laabb = AABB::merge_transformed_array(skbones, 1, baseptr, 12, bs);
 			}
 
 			if (laabb.size == Vector3()) {
@@ -3090,35 +3061,25 @@ void RasterizerStorageRD::_multimesh_mark_all_dirty(MultiMesh *multimesh, bool p
 
 void RasterizerStorageRD::_multimesh_re_create_aabb(MultiMesh *multimesh, const float *p_data, int p_instances) {
 	ERR_FAIL_COND(multimesh->mesh.is_null());
-	AABB aabb;
 	AABB mesh_aabb = mesh_get_aabb(multimesh->mesh);
+
+	if (multimesh->xform_format == RS::MULTIMESH_TRANSFORM_3D) {
+		multimesh->aabb = AABB::merge_transformed_array(&mesh_aabb, 0, p_data, multimesh->stride_cache, p_instances);
+		return;
+	}
+
+	AABB aabb;
 	for (int i = 0; i < p_instances; i++) {
 		const float *data = p_data + multimesh->stride_cache * i;
 		Transform t;
 
-		if (multimesh->xform_format == RS::MULTIMESH_TRANSFORM_3D) {
-			t.basis.elements[0][0] = data[0];
-			t.basis.elements[0][1] = data[1];
-			t.basis.elements[0][2] = data[2];
-			t.origin.x = data[3];
-			t.basis.elements[1][0] = data[4];
-			t.basis.elements[1][1] = data[5];
-			t.basis.elements[1][2] = data[6];
-			t.origin.y = data[7];
-			t.basis.elements[2][0] = data[8];
-			t.basis.elements[2][1] = data[9];
-			t.basis.elements[2][2] = data[10];
-			t.origin.z = data[11];
+		t.basis.elements[0].x = data[0];
+		t.basis.elements[1].x = data[1];
+		t.origin.x = data[3];
 
-		} else {
-			t.basis.elements[0].x = data[0];
-			t.basis.elements[1].x = data[1];
-			t.origin.x = data[3];
-
-			t.basis.elements[0].y = data[4];
-			t.basis.elements[1].y = data[5];
-			t.origin.y = data[7];
-		}
+		t.basis.elements[0].y = data[4];
+		t.basis.elements[1].y = data[5];
+		t.origin.y = data[7];
 
 		if (i == 0) {
 			aabb = t.xform(mesh_aabb);
@@ -30,6 +30,12 @@
 
 #include "shader_rd.h"
 
+#include "core/crypto/crypto_core.h"
+#include "core/io/marshalls.h"
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
 #include "core/string/string_builder.h"
 #include "rasterizer_rd.h"
 #include "servers/rendering/rendering_device.h"
@@ -198,6 +204,274 @@ void ShaderRD::_clear_version(Version *p_version) {
 	}
 }
 
+String ShaderRD::shader_cache_root;
+String ShaderRD::shader_cache_dir;
+CharString ShaderRD::shader_cache_key;
+Mutex ShaderRD::shader_cache_mutex;
+Set<String> ShaderRD::shader_cache_live_files;
+
+void ShaderRD::shader_cache_init(const String &p_dir) {
+	ERR_FAIL_COND(!RD::get_singleton());
+
+	//compiled SPIR-V is only valid for the compiler (and settings) that produced it
+	String key = RD::get_singleton()->shader_get_cache_key() + "\n" + itos(CACHE_FORMAT_VERSION) + "\n";
+	String dir = p_dir.plus_file(key.md5_text().substr(0, 16));
+
+	DirAccess *da = DirAccess::create_for_path(dir);
+	Error err = da->make_dir_recursive(dir);
+	memdelete(da);
+	ERR_FAIL_COND_MSG(err != OK, "Can't create shader cache directory: " + dir + ", shader cache disabled.");
+
+	shader_cache_root = p_dir;
+	shader_cache_dir = dir;
+	shader_cache_key = key.utf8();
+	shader_cache_live_files.clear();
+
+	RD::shader_set_cache_function(_shader_cache_load);
+	RD::shader_set_cache_save_function(_shader_cache_save);
+
+	_load_pipeline_cache();
+}
+
+void ShaderRD::shader_cache_finish() {
+	if (shader_cache_dir.empty()) {
+		return;
+	}
+
+	RD::shader_set_cache_function(nullptr);
+	RD::shader_set_cache_save_function(nullptr);
+
+	_save_pipeline_cache();
+
+	MutexLock lock(shader_cache_mutex);
+	_prune_shader_cache();
+
+	shader_cache_root = String();
+	shader_cache_dir = String();
+	shader_cache_live_files.clear();
+}
+
+void ShaderRD::_prune_shader_cache() {
+	//the editor and the game share the cache, so entries are never removed just because this run didn't use them:
+	//only directories of other compiler keys (or older cache layouts), and entries nobody used for CACHE_MAX_AGE, go away
+	DirAccess *da = DirAccess::open(shader_cache_root);
+	if (da) {
+		String current = shader_cache_dir.get_file();
+		List<String> stale_dirs;
+		List<String> stale_files;
+
+		da->list_dir_begin();
+		String file = da->get_next();
+		while (file != String()) {
+			if (da->current_is_dir()) {
+				if (file != "." && file != ".." && file != current) {
+					stale_dirs.push_back(file);
+				}
+			} else if (file.get_extension() == "spv") {
+				stale_files.push_back(file);
+			}
+			file = da->get_next();
+		}
+		da->list_dir_end();
+
+		for (List<String>::Element *E = stale_dirs.front(); E; E = E->next()) {
+			if (da->change_dir(E->get()) == OK) {
+				da->erase_contents_recursive();
+				da->change_dir("..");
+				da->remove(E->get());
+			}
+		}
+		for (List<String>::Element *E = stale_files.front(); E; E = E->next()) {
+			da->remove(E->get());
+		}
+		memdelete(da);
+	}
+
+	da = DirAccess::open(shader_cache_dir);
+	if (da) {
+		uint64_t now = (uint64_t)OS::get_singleton()->get_unix_time();
+		List<String> stale_files;
+
+		da->list_dir_begin();
+		String file = da->get_next();
+		while (file != String()) {
+			if (!da->current_is_dir() && !shader_cache_live_files.has(file)) {
+				String ext = file.get_extension();
+				uint64_t max_age = ext == "tmp" ? CACHE_REFRESH_AGE : CACHE_MAX_AGE;
+				if ((ext == "spv" || ext == "tmp") && FileAccess::get_modified_time(shader_cache_dir.plus_file(file)) + max_age < now) {
+					stale_files.push_back(file);
+				}
+			}
+			file = da->get_next();
+		}
+		da->list_dir_end();
+
+		for (List<String>::Element *E = stale_files.front(); E; E = E->next()) {
+			da->remove(E->get());
+		}
+		memdelete(da);
+	}
+}
+
+void ShaderRD::_load_pipeline_cache() {
+	FileAccess *f = FileAccess::open(shader_cache_dir.plus_file(PIPELINE_CACHE_FILE), FileAccess::READ);
+	if (!f) {
+		return;
+	}
+
+	Vector<uint8_t> data;
+
+	uint8_t header[4] = {};
+	f->get_buffer(header, 4);
+	if (header[0] == 'G' && header[1] == 'D' && header[2] == 'P' && header[3] == 'C' && f->get_32() == PIPELINE_CACHE_FORMAT_VERSION) {
+		uint32_t size = f->get_32();
+		if (size > 0 && size == f->get_len() - f->get_position()) {
+			data.resize(size);
+			f->get_buffer(data.ptrw(), size);
+		}
+	}
+
+	f->close();
+	memdelete(f);
+
+	if (data.size()) {
+		RD::get_singleton()->pipeline_cache_set_data(data);
+	}
+}
+
+void ShaderRD::_save_pipeline_cache() {
+	Vector<uint8_t> data = RD::get_singleton()->pipeline_cache_get_data();
+	if (data.empty()) {
+		return;
+	}
+
+	String path = shader_cache_dir.plus_file(PIPELINE_CACHE_FILE);
+	String tmp_path = path + ".tmp";
+
+	FileAccess *f = FileAccess::open(tmp_path, FileAccess::WRITE);
+	ERR_FAIL_COND_MSG(!f, "Can't write pipeline cache file: " + tmp_path);
+
+	f->store_buffer((const uint8_t *)"GDPC", 4);
+	f->store_32(PIPELINE_CACHE_FORMAT_VERSION);
+	f->store_32(data.size());
+	f->store_buffer(data.ptr(), data.size());
+
+	bool failed = f->get_error() != OK;
+	f->close();
+	memdelete(f);
+
+	DirAccess *da = DirAccess::create_for_path(tmp_path);
+	if (failed || da->rename(tmp_path, path) != OK) {
+		da->remove(tmp_path);
+	}
+	memdelete(da);
+}
+
+void ShaderRD::shader_cache_get_live_files(List<String> *r_files) {
+	MutexLock lock(shader_cache_mutex);
+	for (Set<String>::Element *E = shader_cache_live_files.front(); E; E = E->next()) {
+		r_files->push_back(E->get());
+	}
+}
+
+String ShaderRD::shader_cache_get_dir() {
+	return shader_cache_dir;
+}
+
+String ShaderRD::_get_shader_cache_file(RD::ShaderStage p_stage, const String &p_source_code, RD::ShaderLanguage p_language) {
+	CryptoCore::SHA256Context ctx;
+	ctx.start();
+	ctx.update((const uint8_t *)shader_cache_key.get_data(), shader_cache_key.length());
+
+	uint8_t stage[2] = { uint8_t(p_stage), uint8_t(p_language) };
+	ctx.update(stage, 2);
+	CharString cs = p_source_code.utf8();
+	ctx.update((const uint8_t *)cs.get_data(), cs.length());
+
+	unsigned char hash[32];
+	ctx.finish(hash);
+
+	return String::hex_encode_buffer(hash, 32) + ".spv";
+}
+
+void ShaderRD::_mark_shader_cache_file_live(const String &p_file) {
+	MutexLock lock(shader_cache_mutex);
+	shader_cache_live_files.insert(p_file);
+}
+
+Vector<uint8_t> ShaderRD::_shader_cache_load(RD::ShaderStage p_stage, const String &p_source_code, RD::ShaderLanguage p_language) {
+	String file = _get_shader_cache_file(p_stage, p_source_code, p_language);
+
+	//user cache first, then the read-only one shipped with the exported project
+	const String dirs[2] = { shader_cache_dir, SHADER_CACHE_EXPORT_DIR };
+
+	for (int d = 0; d < 2; d++) {
+		FileAccess *f = FileAccess::open(dirs[d].plus_file(file), FileAccess::READ);
+		if (!f) {
+			continue;
+		}
+
+		Vector<uint8_t> spirv;
+
+		uint8_t header[4] = {};
+		f->get_buffer(header, 4);
+		if (header[0] == 'G' && header[1] == 'D' && header[2] == 'S' && header[3] == 'C' && f->get_32() == CACHE_FORMAT_VERSION && f->get_32() == uint32_t(p_stage)) {
+			uint32_t size = f->get_32();
+			if (size >= 4 && (size % 4) == 0 && size == f->get_len() - f->get_position()) {
+				spirv.resize(size);
+				f->get_buffer(spirv.ptrw(), size);
+				if (decode_uint32(spirv.ptr()) != SPIRV_MAGIC) {
+					spirv.clear();
+				}
+			}
+		}
+
+		f->close();
+		memdelete(f);
+
+		if (spirv.size()) {
+			if (d == 0 && FileAccess::get_modified_time(dirs[d].plus_file(file)) + CACHE_REFRESH_AGE < (uint64_t)OS::get_singleton()->get_unix_time()) {
+				_shader_cache_save(p_stage, p_source_code, p_language, spirv); //still in use, keep it from aging out
+			} else {
+				_mark_shader_cache_file_live(file);
+			}
+			return spirv;
+		}
+
+		WARN_PRINT("Ignoring invalid shader cache file: " + dirs[d].plus_file(file));
+	}
+
+	return Vector<uint8_t>();
+}
+
+void ShaderRD::_shader_cache_save(RD::ShaderStage p_stage, const String &p_source_code, RD::ShaderLanguage p_language, const Vector<uint8_t> &p_spirv) {
+	String file = _get_shader_cache_file(p_stage, p_source_code, p_language);
+	String path = shader_cache_dir.plus_file(file);
+	//write to a temporary file and rename it, so a partially written file is never picked up
+	String tmp_path = path + "." + itos(Thread::get_caller_id()) + ".tmp";
+
+	FileAccess *f = FileAccess::open(tmp_path, FileAccess::WRITE);
+	ERR_FAIL_COND_MSG(!f, "Can't write shader cache file: " + tmp_path);
+
+	f->store_buffer((const uint8_t *)"GDSC", 4);
+	f->store_32(CACHE_FORMAT_VERSION);
+	f->store_32(p_stage);
+	f->store_32(p_spirv.size());
+	f->store_buffer(p_spirv.ptr(), p_spirv.size());
+
+	bool failed = f->get_error() != OK;
+	f->close();
+	memdelete(f);
+
+	DirAccess *da = DirAccess::create_for_path(tmp_path);
+	if (failed || da->rename(tmp_path, path) != OK) {
+		da->remove(tmp_path);
+	} else {
+		_mark_shader_cache_file_live(file);
+	}
+	memdelete(da);
+}
+
 void ShaderRD::_compile_variant(uint32_t p_variant, Version *p_version) {
 	Vector<RD::ShaderStageData> stages;
 
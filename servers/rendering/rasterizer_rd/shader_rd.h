@@ -35,7 +35,9 @@
 #include "core/templates/hash_map.h"
 #include "core/templates/map.h"
 #include "core/templates/rid_owner.h"
+#include "core/templates/set.h"
 #include "core/variant/variant.h"
+#include "servers/rendering/rendering_device.h"
 
 #include <stdio.h>
 /**
@@ -67,6 +69,31 @@ class ShaderRD {
 
 	Mutex variant_set_mutex;
 
+	//on-disk SPIR-V cache plugged into the RenderingDevice cache hook, one file per stage addressed by a hash of the compiler key and the source
+	//files live in a subdirectory named after the compiler key, so entries from other compilers or cache versions can be removed as a whole
+	enum {
+		CACHE_FORMAT_VERSION = 2,
+		SPIRV_MAGIC = 0x07230203,
+		PIPELINE_CACHE_FORMAT_VERSION = 1,
+		CACHE_MAX_AGE = 30 * 24 * 60 * 60, //seconds an unused entry is kept
+		CACHE_REFRESH_AGE = 24 * 60 * 60, //entries used after this many seconds are rewritten, to keep them from aging out
+	};
+
+	static String shader_cache_root;
+	static String shader_cache_dir;
+	static CharString shader_cache_key;
+	static Mutex shader_cache_mutex;
+	static Set<String> shader_cache_live_files; //files loaded or saved by this run
+
+	static void _prune_shader_cache();
+	static void _load_pipeline_cache();
+	static void _save_pipeline_cache();
+
+	static String _get_shader_cache_file(RD::ShaderStage p_stage, const String &p_source_code, RD::ShaderLanguage p_language);
+	static void _mark_shader_cache_file_live(const String &p_file);
+	static Vector<uint8_t> _shader_cache_load(RD::ShaderStage p_stage, const String &p_source_code, RD::ShaderLanguage p_language);
+	static void _shader_cache_save(RD::ShaderStage p_stage, const String &p_source_code, RD::ShaderLanguage p_language, const Vector<uint8_t> &p_spirv);
+
 	void _compile_variant(uint32_t p_variant, Version *p_version);
 
 	void _clear_version(Version *p_version);
@@ -102,6 +129,17 @@ protected:
 	void setup(const char *p_vertex_code, const char *p_fragment_code, const char *p_compute_code, const char *p_name);
 
 public:
+	static constexpr const char *SHADER_CACHE_USER_DIR = "user://shader_cache";
+	//read-only cache, filled from the live files of the editor's cache when exporting
+	static constexpr const char *SHADER_CACHE_EXPORT_DIR = "res://.shader_cache";
+	//driver pipeline cache, kept next to the SPIR-V of the current compiler key
+	static constexpr const char *PIPELINE_CACHE_FILE = "pipelines.cache";
+
+	static void shader_cache_init(const String &p_dir);
+	static void shader_cache_finish();
+	static void shader_cache_get_live_files(List<String> *r_files);
+	static String shader_cache_get_dir();
+
 	RID version_create();
 
 	void version_set_code(RID p_version, const String &p_uniforms, const String &p_vertex_globals, const String &p_vertex_code, const String &p_fragment_globals, const String &p_fragment_light, const String &p_fragment_code, const Vector<String> &p_custom_defines);
@@ -72,10 +72,14 @@ public:
 
 	typedef Vector<uint8_t> (*ShaderCompileFunction)(ShaderStage p_stage, const String &p_source_code, ShaderLanguage p_language, String *r_error);
 	typedef Vector<uint8_t> (*ShaderCacheFunction)(ShaderStage p_stage, const String &p_source_code, ShaderLanguage p_language);
+	typedef void (*ShaderCacheSaveFunction)(ShaderStage p_stage, const String &p_source_code, ShaderLanguage p_language, const Vector<uint8_t> &p_spirv);
+	typedef String (*ShaderGetCacheKeyFunction)();
 
 private:
 	static ShaderCompileFunction compile_function;
 	static ShaderCacheFunction cache_function;
+	static ShaderCacheSaveFunction cache_save_function;
+	static ShaderGetCacheKeyFunction get_cache_key_function;
 
 	static RenderingDevice *singleton;
 
@@ -588,6 +592,11 @@ public:
 
 	static void shader_set_compile_function(ShaderCompileFunction p_function);
 	static void shader_set_cache_function(ShaderCacheFunction p_function);
+	static void shader_set_cache_save_function(ShaderCacheSaveFunction p_function);
+	static void shader_set_get_cache_key_function(ShaderGetCacheKeyFunction p_function);
+
+	//identifies the compiler (and its settings) producing SPIR-V, so cached bytecode can be invalidated
+	String shader_get_cache_key() const;
 
 	struct ShaderStageData {
 		ShaderStage shader_stage;
@@ -1055,6 +1064,10 @@ public:
 
 	virtual uint64_t get_memory_usage() const = 0;
 
+	//driver cache of built pipelines, saved and restored across runs by the shader cache
+	virtual Vector<uint8_t> pipeline_cache_get_data();
+	virtual void pipeline_cache_set_data(const Vector<uint8_t> &p_data);
+
 	virtual RenderingDevice *create_local_device() = 0;
 
 	static RenderingDevice *get_singleton();
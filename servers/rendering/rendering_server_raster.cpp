@@ -187,7 +187,13 @@ void RenderingServerRaster::finish() {
 /* STATUS INFORMATION */
 
 int RenderingServerRaster::get_render_info(RenderInfo p_info) {
-	return RSG::storage->get_render_info(p_info);
+	switch (p_info) {
+		case INFO_2D_DRAW_CALLS_IN_FRAME:
+		case INFO_2D_BATCHED_COMMANDS_IN_FRAME:
+			return RSG::canvas_render->get_render_info(p_info);
+		default:
+			return RSG::storage->get_render_info(p_info);
+	}
 }
 
 String RenderingServerRaster::get_video_adapter_name() const {
@@ -638,6 +638,8 @@ public:
 	BIND2(scenario_set_camera_effects, RID, RID)
 	BIND2(scenario_set_fallback_environment, RID, RID)
 
+	BIND1(mesh_lod_set_threshold_pixels, float)
+
 	/* INSTANCING API */
 	BIND0R(RID, instance_create)
 
@@ -30,6 +30,7 @@
 
 #include "rendering_server_scene.h"
 
+#include "core/config/project_settings.h"
 #include "core/os/os.h"
 #include "rendering_server_globals.h"
 #include "rendering_server_raster.h"
@@ -329,6 +330,10 @@ void RenderingServerScene::scenario_set_reflection_atlas_size(RID p_scenario, in
 	RSG::scene_render->reflection_atlas_set_size(scenario->reflection_atlas, p_reflection_size, p_reflection_count);
 }
 
+void RenderingServerScene::mesh_lod_set_threshold_pixels(float p_pixels) {
+	mesh_lod_threshold_pixels = p_pixels;
+}
+
 /* INSTANCING API */
 
 void RenderingServerScene::_instance_queue_update(Instance *p_instance, bool p_update_aabb, bool p_update_dependencies) {
@@ -902,6 +907,13 @@ void RenderingServerScene::instance_geometry_set_material_override(RID p_instanc
 }
 
 void RenderingServerScene::instance_geometry_set_draw_range(RID p_instance, float p_min, float p_max, float p_min_margin, float p_max_margin) {
+	Instance *instance = instance_owner.getornull(p_instance);
+	ERR_FAIL_COND(!instance);
+
+	instance->lod_begin = p_min;
+	instance->lod_end = p_max;
+	instance->lod_begin_hysteresis = p_min_margin;
+	instance->lod_end_hysteresis = p_max_margin;
 }
 
 void RenderingServerScene::instance_geometry_set_as_instance_lod(RID p_instance, RID p_as_lod_of_instance) {
@@ -1285,7 +1297,29 @@ void RenderingServerScene::_update_instance_lightmap_captures(Instance *p_instan
 	}
 }
 
-bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_shadow_atlas, Scenario *p_scenario) {
+void RenderingServerScene::_update_instance_lod_threshold(Instance *p_instance, const Transform &p_cam_transform, bool p_cam_orthogonal, float p_lod_error_scale) {
+	if (p_lod_error_scale <= 0) {
+		p_instance->lod_threshold = 0;
+		return;
+	}
+
+	float distance = 1.0;
+	if (!p_cam_orthogonal) {
+		// Measured to the closest point of the bounds, so no part of the instance gets a coarser LOD than it should.
+		const Vector3 &origin = p_cam_transform.origin;
+		const AABB &aabb = p_instance->transformed_aabb;
+		Vector3 end = aabb.position + aabb.size;
+		Vector3 closest(CLAMP(origin.x, aabb.position.x, end.x), CLAMP(origin.y, aabb.position.y, end.y), CLAMP(origin.z, aabb.position.z, end.z));
+		distance = closest.distance_to(origin);
+	}
+
+	// LOD errors are in mesh units.
+	Vector3 scale = p_instance->transform.basis.get_scale().abs();
+	float max_scale = MAX(scale.x, MAX(scale.y, scale.z));
+	p_instance->lod_threshold = max_scale > 0 ? p_lod_error_scale * distance / max_scale : 0.0;
+}
+
+bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, float p_lod_error_scale, RID p_shadow_atlas, Scenario *p_scenario) {
 	InstanceLightData *light = static_cast<InstanceLightData *>(p_instance->base_data);
 
 	Transform light_transform = p_instance->transform;
@@ -1521,20 +1555,19 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 
 				//now that we now all ranges, we can proceed to make the light frustum planes, for culling octree
 
-				Vector<Plane> light_frustum_planes;
-				light_frustum_planes.resize(6);
+				Plane light_frustum_planes[6];
 
 				//right/left
-				light_frustum_planes.write[0] = Plane(x_vec, x_max);
-				light_frustum_planes.write[1] = Plane(-x_vec, -x_min);
+				light_frustum_planes[0] = Plane(x_vec, x_max);
+				light_frustum_planes[1] = Plane(-x_vec, -x_min);
 				//top/bottom
-				light_frustum_planes.write[2] = Plane(y_vec, y_max);
-				light_frustum_planes.write[3] = Plane(-y_vec, -y_min);
+				light_frustum_planes[2] = Plane(y_vec, y_max);
+				light_frustum_planes[3] = Plane(-y_vec, -y_min);
 				//near/far
-				light_frustum_planes.write[4] = Plane(z_vec, z_max + 1e6);
-				light_frustum_planes.write[5] = Plane(-z_vec, -z_min); // z_min is ok, since casters further than far-light plane are not needed
+				light_frustum_planes[4] = Plane(z_vec, z_max + 1e6);
+				light_frustum_planes[5] = Plane(-z_vec, -z_min); // z_min is ok, since casters further than far-light plane are not needed
 
-				int cull_count = p_scenario->octree.cull_convex(light_frustum_planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
+				int cull_count = p_scenario->octree.cull_convex(light_frustum_planes, 6, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
 
 				// a pre pass will need to be needed to determine the actual z-near to be used
 
@@ -1554,6 +1587,9 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 					instance->transformed_aabb.project_range_in_plane(Plane(z_vec, 0), min, max);
 					instance->depth = near_plane.distance_to(instance->transform.origin);
 					instance->depth_layer = 0;
+					if (instance->last_render_pass != render_pass) {
+						_update_instance_lod_threshold(instance, p_cam_transform, p_cam_orthogonal, p_lod_error_scale);
+					}
 					if (j == 0 || max > cull_max) {
 						cull_max = max;
 					}
@@ -1672,16 +1708,15 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 					real_t radius = RSG::storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_RANGE);
 
 					real_t z = i == 0 ? -1 : 1;
-					Vector<Plane> planes;
-					planes.resize(6);
-					planes.write[0] = light_transform.xform(Plane(Vector3(0, 0, z), radius));
-					planes.write[1] = light_transform.xform(Plane(Vector3(1, 0, z).normalized(), radius));
-					planes.write[2] = light_transform.xform(Plane(Vector3(-1, 0, z).normalized(), radius));
-					planes.write[3] = light_transform.xform(Plane(Vector3(0, 1, z).normalized(), radius));
-					planes.write[4] = light_transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
-					planes.write[5] = light_transform.xform(Plane(Vector3(0, 0, -z), 0));
-
-					int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
+					Plane planes[6];
+					planes[0] = light_transform.xform(Plane(Vector3(0, 0, z), radius));
+					planes[1] = light_transform.xform(Plane(Vector3(1, 0, z).normalized(), radius));
+					planes[2] = light_transform.xform(Plane(Vector3(-1, 0, z).normalized(), radius));
+					planes[3] = light_transform.xform(Plane(Vector3(0, 1, z).normalized(), radius));
+					planes[4] = light_transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
+					planes[5] = light_transform.xform(Plane(Vector3(0, 0, -z), 0));
+
+					int cull_count = p_scenario->octree.cull_convex(planes, 6, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
 					Plane near_plane(light_transform.origin, light_transform.basis.get_axis(2) * z);
 
 					for (int j = 0; j < cull_count; j++) {
@@ -1697,6 +1732,9 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 
 							instance->depth = near_plane.distance_to(instance->transform.origin);
 							instance->depth_layer = 0;
+							if (instance->last_render_pass != render_pass) {
+								_update_instance_lod_threshold(instance, p_cam_transform, p_cam_orthogonal, p_lod_error_scale);
+							}
 						}
 					}
 
@@ -1749,6 +1787,9 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 							}
 							instance->depth = near_plane.distance_to(instance->transform.origin);
 							instance->depth_layer = 0;
+							if (instance->last_render_pass != render_pass) {
+								_update_instance_lod_threshold(instance, p_cam_transform, p_cam_orthogonal, p_lod_error_scale);
+							}
 						}
 					}
 
@@ -1786,6 +1827,9 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 					}
 					instance->depth = near_plane.distance_to(instance->transform.origin);
 					instance->depth_layer = 0;
+					if (instance->last_render_pass != render_pass) {
+						_update_instance_lod_threshold(instance, p_cam_transform, p_cam_orthogonal, p_lod_error_scale);
+					}
 				}
 			}
 
@@ -1798,6 +1842,10 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 	return animated_material_found;
 }
 
+float RenderingServerScene::_get_screen_lod_threshold(const Size2 &p_viewport_size) const {
+	return mesh_lod_threshold_pixels / p_viewport_size.height;
+}
+
 void RenderingServerScene::render_camera(RID p_render_buffers, RID p_camera, RID p_scenario, Size2 p_viewport_size, RID p_shadow_atlas) {
 // render to mono camera
 #ifndef _3D_DISABLED
@@ -1843,7 +1891,7 @@ void RenderingServerScene::render_camera(RID p_render_buffers, RID p_camera, RID
 
 	RID environment = _render_get_environment(p_camera, p_scenario);
 
-	_prepare_scene(camera->transform, camera_matrix, ortho, camera->vaspect, p_render_buffers, environment, camera->visible_layers, p_scenario, p_shadow_atlas, RID());
+	_prepare_scene(camera->transform, camera_matrix, ortho, camera->vaspect, _get_screen_lod_threshold(p_viewport_size), p_render_buffers, environment, camera->visible_layers, p_scenario, p_shadow_atlas, RID());
 	_render_scene(p_render_buffers, camera->transform, camera_matrix, ortho, environment, camera->effects, p_scenario, p_shadow_atlas, RID(), -1);
 #endif
 }
@@ -1922,17 +1970,17 @@ void RenderingServerScene::render_camera(RID p_render_buffers, Ref<XRInterface>
 		mono_transform *= apply_z_shift;
 
 		// now prepare our scene with our adjusted transform projection matrix
-		_prepare_scene(mono_transform, combined_matrix, false, false, p_render_buffers, environment, camera->visible_layers, p_scenario, p_shadow_atlas, RID());
+		_prepare_scene(mono_transform, combined_matrix, false, false, _get_screen_lod_threshold(p_viewport_size), p_render_buffers, environment, camera->visible_layers, p_scenario, p_shadow_atlas, RID());
 	} else if (p_eye == XRInterface::EYE_MONO) {
 		// For mono render, prepare as per usual
-		_prepare_scene(cam_transform, camera_matrix, false, false, p_render_buffers, environment, camera->visible_layers, p_scenario, p_shadow_atlas, RID());
+		_prepare_scene(cam_transform, camera_matrix, false, false, _get_screen_lod_threshold(p_viewport_size), p_render_buffers, environment, camera->visible_layers, p_scenario, p_shadow_atlas, RID());
 	}
 
 	// And render our scene...
 	_render_scene(p_render_buffers, cam_transform, camera_matrix, false, environment, camera->effects, p_scenario, p_shadow_atlas, RID(), -1);
 };
 
-void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_render_buffers, RID p_environment, uint32_t p_visible_layers, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, bool p_using_shadows) {
+void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, float p_screen_lod_threshold, RID p_render_buffers, RID p_environment, uint32_t p_visible_layers, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, bool p_using_shadows) {
 	// Note, in stereo rendering:
 	// - p_cam_transform will be a transform in the middle of our two eyes
 	// - p_cam_projection is a wider frustrum that encompasses both eyes
@@ -1982,6 +2030,10 @@ void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const
 	uint64_t frame_number = RSG::rasterizer->get_frame_number();
 	float lightmap_probe_update_speed = RSG::storage->lightmap_get_probe_capture_update_speed() * RSG::rasterizer->get_frame_delta_time();
 
+	// Mesh error covering p_screen_lod_threshold of the viewport height; per unit of distance for perspective cameras,
+	// as matrix[1][1] is the projected height of one unit at distance one, in half viewports.
+	float lod_error_scale = p_screen_lod_threshold > 0 ? 2.0 * p_screen_lod_threshold / p_cam_projection.matrix[1][1] : 0.0;
+
 	for (int i = 0; i < instance_cull_count; i++) {
 		Instance *ins = instance_cull_result[i];
 
@@ -2057,7 +2109,7 @@ void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const
 				lightmap_cull_count++;
 			}
 
-		} else if (((1 << ins->base_type) & RS::INSTANCE_GEOMETRY_MASK) && ins->visible && ins->cast_shadows != RS::SHADOW_CASTING_SETTING_SHADOWS_ONLY) {
+		} else if (((1 << ins->base_type) & RS::INSTANCE_GEOMETRY_MASK) && ins->visible && ins->cast_shadows != RS::SHADOW_CASTING_SETTING_SHADOWS_ONLY && _instance_in_draw_range(ins, p_cam_transform.origin)) {
 			keep = true;
 
 			InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(ins->base_data);
@@ -2131,6 +2183,8 @@ void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const
 
 			ins->depth = near_plane.distance_to(ins->transform.origin);
 			ins->depth_layer = CLAMP(int(ins->depth * 16 / z_far), 0, 15);
+
+			_update_instance_lod_threshold(ins, p_cam_transform, p_cam_orthogonal, lod_error_scale);
 		}
 
 		if (!keep) {
@@ -2182,7 +2236,7 @@ void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const
 		for (int i = 0; i < directional_shadow_count; i++) {
 			RENDER_TIMESTAMP(">Rendering Directional Light " + itos(i));
 
-			_light_instance_update_shadow(lights_with_shadow[i], p_cam_transform, p_cam_projection, p_cam_orthogonal, p_cam_vaspect, p_shadow_atlas, scenario);
+			_light_instance_update_shadow(lights_with_shadow[i], p_cam_transform, p_cam_projection, p_cam_orthogonal, p_cam_vaspect, lod_error_scale, p_shadow_atlas, scenario);
 
 			RENDER_TIMESTAMP("<Rendering Directional Light " + itos(i));
 		}
@@ -2281,7 +2335,7 @@ void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const
 			if (redraw) {
 				//must redraw!
 				RENDER_TIMESTAMP(">Rendering Light " + itos(i));
-				light->shadow_dirty = _light_instance_update_shadow(ins, p_cam_transform, p_cam_projection, p_cam_orthogonal, p_cam_vaspect, p_shadow_atlas, scenario);
+				light->shadow_dirty = _light_instance_update_shadow(ins, p_cam_transform, p_cam_projection, p_cam_orthogonal, p_cam_vaspect, lod_error_scale, p_shadow_atlas, scenario);
 				RENDER_TIMESTAMP("<Rendering Light " + itos(i));
 			}
 		}
@@ -2462,7 +2516,7 @@ bool RenderingServerScene::_render_reflection_probe_step(Instance *p_instance, i
 		}
 
 		RENDER_TIMESTAMP("Render Reflection Probe, Step " + itos(p_step));
-		_prepare_scene(xform, cm, false, false, RID(), RID(), RSG::storage->reflection_probe_get_cull_mask(p_instance->base), p_instance->scenario->self, shadow_atlas, reflection_probe->instance, use_shadows);
+		_prepare_scene(xform, cm, false, false, 0.0, RID(), RID(), RSG::storage->reflection_probe_get_cull_mask(p_instance->base), p_instance->scenario->self, shadow_atlas, reflection_probe->instance, use_shadows);
 		_render_scene(RID(), xform, cm, false, RID(), RID(), p_instance->scenario->self, shadow_atlas, reflection_probe->instance, p_step);
 
 	} else {
@@ -3034,6 +3088,7 @@ RenderingServerScene *RenderingServerScene::singleton = nullptr;
 RenderingServerScene::RenderingServerScene() {
 	render_pass = 1;
 	singleton = this;
+	mesh_lod_threshold_pixels = GLOBAL_GET("rendering/quality/mesh_lod/threshold_pixels");
 }
 
 RenderingServerScene::~RenderingServerScene() {
@@ -141,6 +141,9 @@ public:
 	virtual void scenario_set_fallback_environment(RID p_scenario, RID p_environment);
 	virtual void scenario_set_reflection_atlas_size(RID p_scenario, int p_reflection_size, int p_reflection_count);
 
+	float mesh_lod_threshold_pixels;
+	virtual void mesh_lod_set_threshold_pixels(float p_pixels);
+
 	/* INSTANCING API */
 
 	struct InstanceBaseData {
@@ -447,15 +450,37 @@ public:
 
 	_FORCE_INLINE_ void _update_instance(Instance *p_instance);
 	_FORCE_INLINE_ void _update_instance_aabb(Instance *p_instance);
+
+	// Draw range set with instance_geometry_set_draw_range(), measured from the camera to the closest point of the instance bounds.
+	static _FORCE_INLINE_ bool _instance_in_draw_range(const Instance *p_instance, const Vector3 &p_cam_pos) {
+		if (p_instance->lod_begin <= 0 && p_instance->lod_end <= 0) {
+			return true;
+		}
+
+		const AABB &aabb = p_instance->transformed_aabb;
+		Vector3 closest = Vector3(
+				CLAMP(p_cam_pos.x, aabb.position.x, aabb.position.x + aabb.size.x),
+				CLAMP(p_cam_pos.y, aabb.position.y, aabb.position.y + aabb.size.y),
+				CLAMP(p_cam_pos.z, aabb.position.z, aabb.position.z + aabb.size.z));
+		float distance = closest.distance_to(p_cam_pos);
+
+		if (distance < p_instance->lod_begin - p_instance->lod_begin_hysteresis) {
+			return false;
+		}
+		return p_instance->lod_end <= 0 || distance <= p_instance->lod_end + p_instance->lod_end_hysteresis;
+	}
 	_FORCE_INLINE_ void _update_dirty_instance(Instance *p_instance);
 	_FORCE_INLINE_ void _update_instance_lightmap_captures(Instance *p_instance);
 
-	_FORCE_INLINE_ bool _light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_shadow_atlas, Scenario *p_scenario);
+	// Instances that are not visible to the camera but cast shadows get their LOD here too, so it's never stale.
+	float _get_screen_lod_threshold(const Size2 &p_viewport_size) const;
+	_FORCE_INLINE_ void _update_instance_lod_threshold(Instance *p_instance, const Transform &p_cam_transform, bool p_cam_orthogonal, float p_lod_error_scale);
+	_FORCE_INLINE_ bool _light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, float p_lod_error_scale, RID p_shadow_atlas, Scenario *p_scenario);
 
 	RID _render_get_environment(RID p_camera, RID p_scenario);
 
 	bool _render_reflection_probe_step(Instance *p_instance, int p_step);
-	void _prepare_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_render_buffers, RID p_environment, uint32_t p_visible_layers, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, bool p_using_shadows = true);
+	void _prepare_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, float p_screen_lod_threshold, RID p_render_buffers, RID p_environment, uint32_t p_visible_layers, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, bool p_using_shadows = true);
 	void _render_scene(RID p_render_buffers, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_environment, RID p_force_camera_effects, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, int p_reflection_probe_pass);
 	void render_empty_scene(RID p_render_buffers, RID p_scenario, RID p_shadow_atlas);
 
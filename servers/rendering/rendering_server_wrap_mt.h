@@ -539,6 +539,8 @@ public:
 	FUNC2(scenario_set_camera_effects, RID, RID)
 	FUNC2(scenario_set_fallback_environment, RID, RID)
 
+	FUNC1(mesh_lod_set_threshold_pixels, float)
+
 	/* INSTANCING API */
 	FUNCRID(instance)
 
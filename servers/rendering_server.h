@@ -1022,6 +1022,8 @@ public:
 	virtual void scenario_set_fallback_environment(RID p_scenario, RID p_environment) = 0;
 	virtual void scenario_set_camera_effects(RID p_scenario, RID p_camera_effects) = 0;
 
+	virtual void mesh_lod_set_threshold_pixels(float p_pixels) = 0;
+
 	/* INSTANCING API */
 
 	enum InstanceType {
@@ -1343,6 +1345,8 @@ public:
 		INFO_VIDEO_MEM_USED,
 		INFO_TEXTURE_MEM_USED,
 		INFO_VERTEX_MEM_USED,
+		INFO_2D_DRAW_CALLS_IN_FRAME,
+		INFO_2D_BATCHED_COMMANDS_IN_FRAME,
 	};
 
 	virtual int get_render_info(RenderInfo p_info) = 0;
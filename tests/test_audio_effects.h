@@ -0,0 +1,315 @@
+/*************************************************************************/
+/*  test_audio_effects.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_AUDIO_EFFECTS_H
+#define TEST_AUDIO_EFFECTS_H
+
+#include "core/math/math_funcs.h"
+#include "core/string/print_string.h"
+#include "servers/audio/effects/eq.h"
+#include "servers/audio/effects/reverb.h"
+
+#include "tests/test_macros.h"
+
+namespace TestAudioEffects {
+
+const int BLOCK_FRAMES = 1024;
+
+static void _fill_test_block(AudioFrame *p_frames, int p_block) {
+	for (int i = 0; i < BLOCK_FRAMES; i++) {
+		float t = p_block * BLOCK_FRAMES + i;
+		p_frames[i] = AudioFrame(Math::sin(t * 0.013) * 0.7, Math::sin(t * 0.171) * Math::cos(t * 0.002));
+	}
+}
+
+// Scalar reference, processing band by band with EQ::BandProcess.
+static void _process_eq_scalar(Vector<EQ::BandProcess> *p_bands, const Vector<float> &p_gains, const AudioFrame *p_src, AudioFrame *p_dst) {
+	EQ::BandProcess *proc_l = p_bands[0].ptrw();
+	EQ::BandProcess *proc_r = p_bands[1].ptrw();
+
+	for (int i = 0; i < BLOCK_FRAMES; i++) {
+		AudioFrame dst = AudioFrame(0, 0);
+
+		for (int j = 0; j < p_gains.size(); j++) {
+			float l = p_src[i].l;
+			float r = p_src[i].r;
+
+			proc_l[j].process_one(l);
+			proc_r[j].process_one(r);
+
+			dst.l += l * p_gains[j];
+			dst.r += r * p_gains[j];
+		}
+
+		p_dst[i] = dst;
+	}
+}
+
+static void _setup_eq(EQ &r_eq, EQ::Preset p_preset, Vector<EQ::BandProcess> *r_bands, Vector<float> &r_gains, EQ::StereoProcess &r_stereo) {
+	r_eq.set_mix_rate(44100);
+	r_eq.set_preset_band_mode(p_preset);
+	r_stereo = r_eq.get_stereo_processor();
+
+	for (int i = 0; i < r_eq.get_band_count(); i++) {
+		float gain = Math::db2linear(float(i % 5) * 3.0 - 6.0);
+		r_gains.push_back(gain);
+		r_stereo.set_band_gain(i, gain);
+		r_bands[0].push_back(r_eq.get_band_processor(i));
+		r_bands[1].push_back(r_eq.get_band_processor(i));
+	}
+}
+
+TEST_CASE("[AudioEffects] EQ stereo processor matches the scalar band processors") {
+	const EQ::Preset presets[] = { EQ::PRESET_6_BANDS, EQ::PRESET_8_BANDS, EQ::PRESET_10_BANDS, EQ::PRESET_21_BANDS, EQ::PRESET_31_BANDS };
+
+	for (int p = 0; p < 5; p++) {
+		EQ eq;
+		Vector<EQ::BandProcess> bands[2];
+		Vector<float> gains;
+		EQ::StereoProcess stereo;
+		_setup_eq(eq, presets[p], bands, gains, stereo);
+
+		CHECK(stereo.get_band_count() == eq.get_band_count());
+
+		AudioFrame src[BLOCK_FRAMES];
+		AudioFrame expected[BLOCK_FRAMES];
+		AudioFrame result[BLOCK_FRAMES];
+		float max_error = 0;
+
+		// Several blocks, so filter history is carried over correctly.
+		for (int b = 0; b < 8; b++) {
+			_fill_test_block(src, b);
+			_process_eq_scalar(bands, gains, src, expected);
+			stereo.process(src, result, BLOCK_FRAMES);
+
+			for (int i = 0; i < BLOCK_FRAMES; i++) {
+				max_error = MAX(max_error, Math::abs(expected[i].l - result[i].l));
+				max_error = MAX(max_error, Math::abs(expected[i].r - result[i].r));
+			}
+		}
+
+		CHECK_MESSAGE(
+				max_error < 1e-4,
+				vformat("EQ stereo processor output should match the scalar reference with %d bands.", eq.get_band_count()));
+	}
+}
+
+// Scalar reference, the per-sample Reverb::process() that runs each comb and
+// allpass filter over the whole block, one after another.
+struct ReverbReference {
+	struct Filter {
+		Vector<float> buffer;
+		int size_limit = 0;
+		int pos = 0;
+		float damp_h = 0;
+	};
+
+	Filter comb[8];
+	Filter allpass[4];
+	Vector<float> echo;
+	int echo_pos = 0;
+	float hpf_h1 = 0;
+	float hpf_h2 = 0;
+
+	float feedback = 0;
+	float damp = 0;
+	int predelay_frames = 0;
+	float predelay_fb = 0;
+	float hpf = 0;
+	float wet = 0;
+	float dry = 0;
+	float mix_rate = 0;
+
+	static void _setup_filter(Filter &r_filter, float p_tuning, float p_mix_rate, float p_spread_base, float p_spread) {
+		int extra_spread_frames = lrint(p_spread_base * p_mix_rate);
+		int len = MAX(5, lrint(p_tuning * p_mix_rate) + extra_spread_frames);
+		r_filter.buffer.resize(len);
+		for (int i = 0; i < len; i++) {
+			r_filter.buffer.write[i] = 0;
+		}
+		r_filter.size_limit = len - lrintf((float)extra_spread_frames * (1.0 - p_spread));
+	}
+
+	void process(const float *p_src, float *p_dst, int p_frames) {
+		float input[Reverb::INPUT_BUFFER_MAX_SIZE];
+
+		for (int i = 0; i < p_frames; i++) {
+			if (echo_pos >= echo.size()) {
+				echo_pos = 0;
+			}
+			int read_pos = echo_pos - predelay_frames;
+			while (read_pos < 0) {
+				read_pos += echo.size();
+			}
+			input[i] = undenormalise(echo[read_pos] * predelay_fb + p_src[i]);
+			echo.write[echo_pos++] = input[i];
+			p_dst[i] = 0;
+		}
+
+		if (hpf > 0) {
+			float hpaux = expf(-2.0 * Math_PI * hpf * 6000 / mix_rate);
+			for (int i = 0; i < p_frames; i++) {
+				float in = input[i];
+				input[i] = in * ((1.0 + hpaux) / 2.0) + hpf_h1 * (-(1.0 + hpaux) / 2.0) + hpf_h2 * hpaux;
+				hpf_h2 = input[i];
+				hpf_h1 = in;
+			}
+		}
+
+		for (int i = 0; i < 8; i++) {
+			Filter &c = comb[i];
+			for (int j = 0; j < p_frames; j++) {
+				if (c.pos >= c.size_limit) {
+					c.pos = 0;
+				}
+				float out = undenormalise(c.buffer[c.pos] * feedback);
+				out = out * (1.0 - damp) + c.damp_h * damp;
+				c.damp_h = out;
+				c.buffer.write[c.pos++] = input[j] + out;
+				p_dst[j] += out;
+			}
+		}
+
+		for (int i = 0; i < 4; i++) {
+			Filter &a = allpass[i];
+			for (int j = 0; j < p_frames; j++) {
+				if (a.pos >= a.size_limit) {
+					a.pos = 0;
+				}
+				float aux = a.buffer[a.pos];
+				a.buffer.write[a.pos] = undenormalise(0.7f * aux + p_dst[j]);
+				p_dst[j] = aux - 0.7f * a.buffer[a.pos++];
+			}
+		}
+
+		for (int i = 0; i < p_frames; i++) {
+			p_dst[i] = p_dst[i] * wet * 0.6f + p_src[i] * dry;
+		}
+	}
+};
+
+TEST_CASE("[AudioEffects] Reverb matches the per-sample reference") {
+	// Freeverb tunings, as in Reverb.
+	const float comb_tunings[8] = { 0.025306122448979593f, 0.026938775510204082f, 0.028956916099773241f, 0.03074829931972789f, 0.032244897959183672f, 0.03380952380952381f, 0.035306122448979592f, 0.036666666666666667f };
+	const float allpass_tunings[4] = { 0.0051020408163265302f, 0.007732426303854875f, 0.01f, 0.012607709750566893f };
+
+	const float mix_rate = 44100;
+	const float spread_base = 0.002;
+	const float spread = 0.5;
+	const float room_size = 0.8;
+	const float damp = 0.3;
+
+	Reverb reverb;
+	reverb.set_mix_rate(mix_rate);
+	reverb.set_extra_spread_base(spread_base);
+	reverb.set_extra_spread(spread);
+	reverb.set_room_size(room_size);
+	reverb.set_damp(damp);
+	reverb.set_wet(1.0);
+	reverb.set_dry(0.5);
+	reverb.set_predelay(40);
+	reverb.set_predelay_feedback(0.3);
+	reverb.set_highpass(0.2);
+
+	ReverbReference reference;
+	for (int i = 0; i < 8; i++) {
+		ReverbReference::_setup_filter(reference.comb[i], comb_tunings[i], mix_rate, spread_base, spread);
+	}
+	for (int i = 0; i < 4; i++) {
+		ReverbReference::_setup_filter(reference.allpass[i], allpass_tunings[i], mix_rate, spread_base, spread);
+	}
+	reference.echo.resize((int)(0.5 * mix_rate + 1.0));
+	for (int i = 0; i < reference.echo.size(); i++) {
+		reference.echo.write[i] = 0;
+	}
+	reference.feedback = 0.7 + room_size * 0.28;
+	float auxdmp = (damp / 2.0 + 0.5) * (damp / 2.0 + 0.5);
+	reference.damp = expf(-2.0 * Math_PI * auxdmp * 10000 / mix_rate);
+	reference.predelay_frames = lrint((40 / 1000.0) * mix_rate);
+	reference.predelay_fb = 0.3;
+	reference.hpf = 0.2;
+	reference.wet = 1.0;
+	reference.dry = 0.5;
+	reference.mix_rate = mix_rate;
+
+	// Uneven block sizes, so runs are split at different points of the comb buffers.
+	const int block_sizes[] = { BLOCK_FRAMES, 1, 333, 517, BLOCK_FRAMES, 7, 1000 };
+	float src[BLOCK_FRAMES];
+	float expected[BLOCK_FRAMES];
+	float result[BLOCK_FRAMES];
+	float max_error = 0;
+	int t = 0;
+
+	for (int b = 0; b < 40; b++) {
+		int frames = block_sizes[b % 7];
+		for (int i = 0; i < frames; i++) {
+			// Silence in the second half, so the tail decays towards denormals.
+			src[i] = t < 20000 ? Math::sin(t * 0.031) * Math::cos(t * 0.0007) : 0.0;
+			t++;
+		}
+
+		reference.process(src, expected, frames);
+		reverb.process(src, result, frames);
+
+		for (int i = 0; i < frames; i++) {
+			max_error = MAX(max_error, Math::abs(expected[i] - result[i]));
+		}
+	}
+
+	CHECK_MESSAGE(
+			max_error < 1e-4,
+			"Reverb output should match the per-sample reference.");
+}
+
+// Run with `godot --test audio-effects-benchmark`.
+static void benchmark() {
+	const int blocks = 2000;
+
+	EQ eq;
+	Vector<EQ::BandProcess> bands[2];
+	Vector<float> gains;
+	EQ::StereoProcess stereo;
+	_setup_eq(eq, EQ::PRESET_21_BANDS, bands, gains, stereo);
+
+	AudioFrame src[BLOCK_FRAMES];
+	AudioFrame dst[BLOCK_FRAMES];
+	_fill_test_block(src, 0);
+
+	print_line(vformat("EQ 21 bands, %d blocks of %d frames:", blocks, BLOCK_FRAMES));
+	print_benchmark("stereo processor",
+			benchmark_usec(blocks, [&]() { _process_eq_scalar(bands, gains, src, dst); }),
+			benchmark_usec(blocks, [&]() { stereo.process(src, dst, BLOCK_FRAMES); }));
+}
+
+REGISTER_TEST_COMMAND("audio-effects-benchmark", &benchmark);
+
+} // namespace TestAudioEffects
+
+#endif // TEST_AUDIO_EFFECTS_H
@@ -0,0 +1,228 @@
+/*************************************************************************/
+/*  test_audio_voices.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef TEST_AUDIO_VOICES_H
+#define TEST_AUDIO_VOICES_H
+
+#include "core/config/project_settings.h"
+#include "servers/audio/audio_stream.h"
+#include "servers/audio_server.h"
+
+#include "tests/test_macros.h"
+
+namespace TestAudioVoices {
+
+const int MIX_FRAMES = 1024;
+
+// Mixes only when asked to, so tests are deterministic.
+class TestAudioDriver : public AudioDriver {
+public:
+	Vector<int32_t> output;
+
+	virtual const char *get_name() const override { return "Test"; }
+	virtual Error init() override { return OK; }
+	virtual void start() override {}
+	virtual int get_mix_rate() const override { return 44100; }
+	virtual SpeakerMode get_speaker_mode() const override { return SPEAKER_MODE_STEREO; }
+	virtual void lock() override {}
+	virtual void unlock() override {}
+	virtual void finish() override {}
+
+	void mix() {
+		output.resize(MIX_FRAMES * 2);
+		audio_server_process(MIX_FRAMES, output.ptrw());
+	}
+
+	// Left channel of the last mix, converted back from the driver format.
+	float get_sample(int p_frame) const {
+		return output[p_frame * 2] / float(((1 << 20) - 1) << 11);
+	}
+};
+
+class TestPlayback : public AudioStreamPlayback {
+public:
+	float value = 0;
+	bool playing = false;
+	float position = 0;
+
+	virtual void start(float p_from_pos) override {
+		playing = true;
+		position = p_from_pos;
+	}
+	virtual void stop() override { playing = false; }
+	virtual bool is_playing() const override { return playing; }
+	virtual int get_loop_count() const override { return 0; }
+	virtual float get_playback_position() const override { return position; }
+	virtual void seek(float p_time) override { position = p_time; }
+	virtual void mix(AudioFrame *p_buffer, float p_rate_scale, int p_frames) override {
+		for (int i = 0; i < p_frames; i++) {
+			p_buffer[i] = AudioFrame(value, value);
+		}
+		position += p_frames * p_rate_scale / 44100.0;
+	}
+};
+
+// Endless stream of a constant value.
+class TestStream : public AudioStream {
+public:
+	float value = 0;
+
+	virtual Ref<AudioStreamPlayback> instance_playback() override {
+		Ref<TestPlayback> playback;
+		playback.instance();
+		playback->value = value;
+		return playback;
+	}
+	virtual String get_stream_name() const override { return "Test"; }
+	virtual float get_length() const override { return 0; }
+};
+
+static TestAudioDriver test_driver;
+
+static AudioServer *_create_server(int p_max_voices, int p_max_real_voices) {
+	ProjectSettings::get_singleton()->set_setting("audio/voices/max_voices", p_max_voices);
+	ProjectSettings::get_singleton()->set_setting("audio/voices/max_real_voices", p_max_real_voices);
+	test_driver.set_singleton();
+	AudioServer *server = memnew(AudioServer);
+	server->init();
+	return server;
+}
+
+static void _destroy_server(AudioServer *p_server) {
+	p_server->finish();
+	memdelete(p_server);
+	ProjectSettings::get_singleton()->clear("audio/voices/max_voices");
+	ProjectSettings::get_singleton()->clear("audio/voices/max_real_voices");
+}
+
+static Ref<TestStream> _make_stream(float p_value) {
+	Ref<TestStream> stream;
+	stream.instance();
+	stream->value = p_value;
+	return stream;
+}
+
+TEST_CASE("[AudioServer] Stopped voices are released and their IDs invalidated") {
+	AudioServer *server = _create_server(1, 1);
+	Ref<TestStream> stream = _make_stream(0.25);
+
+	AudioServer::VoiceID first = server->voice_play(stream, "Master", 0, 1, 0, 0, Ref<AudioStreamPlayback>());
+	REQUIRE(first != 0);
+	CHECK(server->voice_is_playing(first));
+
+	server->voice_stop(first);
+	test_driver.mix();
+	server->update();
+	CHECK(!server->voice_is_playing(first));
+
+	// Reuses the slot, the old ID must not reach the new voice.
+	AudioServer::VoiceID second = server->voice_play(stream, "Master", 0, 1, 0, 0, Ref<AudioStreamPlayback>());
+	REQUIRE(second != 0);
+	CHECK(second != first);
+	server->voice_stop(first);
+	CHECK(server->voice_is_playing(second));
+
+	_destroy_server(server);
+}
+
+TEST_CASE("[AudioServer] Full voice pool steals the least important voice") {
+	AudioServer *server = _create_server(2, 2);
+	Ref<TestStream> stream = _make_stream(0.25);
+
+	AudioServer::VoiceID loud = server->voice_play(stream, "Master", 0, 1, 0, 0, Ref<AudioStreamPlayback>());
+	AudioServer::VoiceID quiet = server->voice_play(stream, "Master", -20, 1, 0, 0, Ref<AudioStreamPlayback>());
+	test_driver.mix();
+
+	AudioServer::VoiceID stealer = server->voice_play(stream, "Master", 0, 1, 0, 0, Ref<AudioStreamPlayback>());
+	CHECK(stealer != 0);
+	CHECK(server->voice_is_playing(loud));
+	CHECK(!server->voice_is_playing(quiet));
+	CHECK(server->voice_is_playing(stealer));
+
+	// Every playing voice is more important.
+	AudioServer::VoiceID unimportant = server->voice_play(stream, "Master", 0, 1, -1, 0, Ref<AudioStreamPlayback>());
+	CHECK(unimportant == 0);
+	CHECK(server->voice_is_playing(loud));
+	CHECK(server->voice_is_playing(stealer));
+
+	_destroy_server(server);
+}
+
+TEST_CASE("[AudioServer] Stolen voices fade out instead of being cut") {
+	AudioServer *server = _create_server(1, 1);
+
+	server->voice_play(_make_stream(0.25), "Master", 0, 1, 0, 0, Ref<AudioStreamPlayback>());
+	test_driver.mix();
+	CHECK(test_driver.get_sample(MIX_FRAMES - 1) == doctest::Approx(0.25).epsilon(0.01));
+
+	// The new voice is silent, so only the stolen one can be heard.
+	server->voice_play(_make_stream(0), "Master", 0, 1, 0, 0, Ref<AudioStreamPlayback>());
+	test_driver.mix();
+	CHECK_MESSAGE(test_driver.get_sample(0) == doctest::Approx(0.25).epsilon(0.01), "The stolen voice should start its fade from its previous volume.");
+	CHECK(test_driver.get_sample(32) > 0);
+	CHECK(test_driver.get_sample(32) < 0.25);
+	CHECK(test_driver.get_sample(MIX_FRAMES - 1) == doctest::Approx(0));
+
+	server->update();
+	test_driver.mix();
+	CHECK(test_driver.get_sample(0) == doctest::Approx(0));
+
+	_destroy_server(server);
+}
+
+TEST_CASE("[AudioServer] Voices over the real voice budget are virtual") {
+	AudioServer *server = _create_server(4, 1);
+	Ref<TestStream> stream = _make_stream(0.25);
+
+	AudioServer::VoiceID loud = server->voice_play(stream, "Master", 0, 1, 0, 0, Ref<AudioStreamPlayback>());
+	AudioServer::VoiceID quiet = server->voice_play(stream, "Master", -10, 1, 0, 0, Ref<AudioStreamPlayback>());
+	test_driver.mix();
+
+	CHECK(server->get_active_voice_count() == 2);
+	CHECK(server->get_real_voice_count() == 1);
+	CHECK(!server->voice_is_virtual(loud));
+	CHECK(server->voice_is_virtual(quiet));
+
+	// Virtual voices still advance their position.
+	CHECK(server->voice_get_playback_position(quiet) == doctest::Approx(MIX_FRAMES / 44100.0));
+
+	// Raising the priority makes it real.
+	server->voice_set_priority(quiet, 1);
+	test_driver.mix();
+	CHECK(server->voice_is_virtual(loud));
+	CHECK(!server->voice_is_virtual(quiet));
+
+	_destroy_server(server);
+}
+
+} // namespace TestAudioVoices
+
+#endif // TEST_AUDIO_VOICES_H
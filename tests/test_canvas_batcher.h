@@ -0,0 +1,295 @@
+/*************************************************************************/
+/*  test_canvas_batcher.h                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_CANVAS_BATCHER_H
+#define TEST_CANVAS_BATCHER_H
+
+#include "core/templates/rid_owner.h"
+#include "servers/rendering/rasterizer_canvas_batcher.h"
+
+#include "tests/test_macros.h"
+
+namespace TestCanvasBatcher {
+
+typedef RasterizerCanvas::Item Item;
+
+static Item::CommandRect *add_rect(Item &p_item, const Rect2 &p_rect, RID p_texture, uint8_t p_flags = 0, const Rect2 &p_source = Rect2()) {
+	Item::CommandRect *rect = p_item.alloc_command<Item::CommandRect>();
+	rect->rect = p_rect;
+	rect->modulate = Color(1, 1, 1, 1);
+	rect->texture = p_texture;
+	rect->flags = p_flags;
+	rect->source = p_source;
+	return rect;
+}
+
+TEST_CASE("[CanvasBatcher] Consecutive rects with the same texture are merged") {
+	RID_Owner<int> texture_owner;
+	RID texture_a = texture_owner.make_rid(0);
+	RID texture_b = texture_owner.make_rid(1);
+
+	Item item;
+	for (int i = 0; i < 10; i++) {
+		add_rect(item, Rect2(i * 16, 0, 16, 16), texture_a);
+	}
+	for (int i = 0; i < 5; i++) {
+		add_rect(item, Rect2(i * 16, 16, 16, 16), texture_b);
+	}
+
+	RasterizerCanvasBatcher batcher;
+	batcher.set_max_rects(1024);
+
+	batcher.add_item(&item, Transform2D());
+	batcher.finish();
+	REQUIRE(batcher.get_batch_count() == 2);
+	CHECK(batcher.get_rect_count() == 15);
+
+	const RasterizerCanvasBatcher::Batch *batches = batcher.get_batches();
+	CHECK(batches[0].item == 0);
+	CHECK(batches[0].merged_items == 0);
+	CHECK(batches[0].first_command == item.commands);
+	CHECK(batches[0].command_count == 10);
+	CHECK(batches[0].rect_count == 10);
+	CHECK(batches[0].rect_offset == 0);
+	CHECK(batches[0].texture == texture_a);
+	CHECK(batches[1].command_count == 5);
+	CHECK(batches[1].rect_offset == 10);
+	CHECK(batches[1].texture == texture_b);
+
+	CHECK(batcher.get_stats().commands == 15);
+	CHECK(batcher.get_stats().batched_commands == 15);
+	CHECK(batcher.get_stats().batches == 2);
+
+	texture_owner.free(texture_a);
+	texture_owner.free(texture_b);
+}
+
+TEST_CASE("[CanvasBatcher] Incompatible commands split batches") {
+	RID_Owner<int> texture_owner;
+	RID texture = texture_owner.make_rid(0);
+
+	Item item;
+	add_rect(item, Rect2(0, 0, 16, 16), texture);
+	add_rect(item, Rect2(16, 0, 16, 16), texture);
+	// Clipped UVs are never batched.
+	add_rect(item, Rect2(32, 0, 16, 16), texture, RasterizerCanvas::CANVAS_RECT_CLIP_UV | RasterizerCanvas::CANVAS_RECT_REGION, Rect2(0, 0, 8, 8));
+	add_rect(item, Rect2(48, 0, 16, 16), texture);
+	// A transform changes the state of the following commands.
+	Item::CommandTransform *xform = item.alloc_command<Item::CommandTransform>();
+	xform->xform = Transform2D(0, Vector2(10, 10));
+	add_rect(item, Rect2(0, 0, 16, 16), texture);
+	add_rect(item, Rect2(16, 0, 16, 16), texture);
+	add_rect(item, Rect2(32, 0, 16, 16), texture);
+
+	RasterizerCanvasBatcher batcher;
+	batcher.set_max_rects(1024);
+	batcher.add_item(&item, Transform2D());
+	batcher.finish();
+
+	REQUIRE(batcher.get_batch_count() == 2);
+	CHECK(batcher.get_batches()[0].command_count == 2);
+	CHECK(batcher.get_batches()[0].first_command == item.commands);
+	CHECK(batcher.get_batches()[1].command_count == 3);
+	CHECK(batcher.get_batches()[1].first_command == xform->next);
+	CHECK(batcher.get_stats().commands == 8);
+	CHECK(batcher.get_stats().batched_commands == 5);
+
+	// Rects after the transform command are drawn with it.
+	CHECK(batcher.get_rects()[0].world[4] == doctest::Approx(0));
+	CHECK(batcher.get_rects()[2].world[4] == doctest::Approx(10));
+	CHECK(batcher.get_rects()[2].world[5] == doctest::Approx(10));
+
+	texture_owner.free(texture);
+}
+
+TEST_CASE("[CanvasBatcher] Rect data matches the unbatched encoding") {
+	RID_Owner<int> texture_owner;
+	RID texture = texture_owner.make_rid(0);
+
+	Item item;
+	item.final_modulate = Color(0.5, 1, 1, 0.5);
+	add_rect(item, Rect2(10, 20, -30, 40), texture, RasterizerCanvas::CANVAS_RECT_REGION | RasterizerCanvas::CANVAS_RECT_FLIP_H, Rect2(4, 8, 16, 32));
+	add_rect(item, Rect2(0, 0, 8, 8), texture)->modulate = Color(1, 0, 1, 1);
+	add_rect(item, Rect2(0, 0, 8, 4), texture, RasterizerCanvas::CANVAS_RECT_TRANSPOSE);
+
+	RasterizerCanvasBatcher batcher;
+	batcher.set_max_rects(1024);
+	batcher.add_item(&item, Transform2D(0, Vector2(5, 6)));
+	batcher.finish();
+	REQUIRE(batcher.get_rect_count() == 3);
+
+	const RasterizerCanvasBatcher::Rect &region = batcher.get_rects()[0];
+	// Negative sizes are moved to the position.
+	CHECK(region.dst_rect[0] == doctest::Approx(-20));
+	CHECK(region.dst_rect[1] == doctest::Approx(20));
+	CHECK(region.dst_rect[2] == doctest::Approx(30));
+	CHECK(region.dst_rect[3] == doctest::Approx(40));
+	// Regions stay in pixels, flips negate the size.
+	CHECK(region.flags == RasterizerCanvasBatcher::RECT_FLAG_REGION);
+	CHECK(region.src_rect[0] == doctest::Approx(4));
+	CHECK(region.src_rect[1] == doctest::Approx(8));
+	CHECK(region.src_rect[2] == doctest::Approx(-16));
+	CHECK(region.src_rect[3] == doctest::Approx(32));
+	CHECK(region.modulation[0] == doctest::Approx(0.5));
+	CHECK(region.modulation[3] == doctest::Approx(0.5));
+	CHECK(region.world[0] == doctest::Approx(1));
+	CHECK(region.world[3] == doctest::Approx(1));
+	CHECK(region.world[4] == doctest::Approx(5));
+	CHECK(region.world[5] == doctest::Approx(6));
+
+	const RasterizerCanvasBatcher::Rect &full = batcher.get_rects()[1];
+	CHECK(full.flags == 0);
+	CHECK(full.src_rect[2] == doctest::Approx(1));
+	CHECK(full.src_rect[3] == doctest::Approx(1));
+	CHECK(full.modulation[0] == doctest::Approx(0.5));
+	CHECK(full.modulation[1] == doctest::Approx(0));
+
+	// Transposed rects keep the size encoding of the unbatched path, and flag the UV swap the shader can't see in draw_data.
+	const RasterizerCanvasBatcher::Rect &transposed = batcher.get_rects()[2];
+	CHECK(transposed.flags == RasterizerCanvasBatcher::RECT_FLAG_TRANSPOSE);
+	CHECK(transposed.dst_rect[2] == doctest::Approx(-8));
+	CHECK(transposed.dst_rect[3] == doctest::Approx(4));
+
+	texture_owner.free(texture);
+}
+
+TEST_CASE("[CanvasBatcher] Batches are limited by the rect capacity and minimum size") {
+	RID_Owner<int> texture_owner;
+	RID texture = texture_owner.make_rid(0);
+
+	Item item;
+	for (int i = 0; i < 10; i++) {
+		add_rect(item, Rect2(i * 16, 0, 16, 16), texture);
+	}
+
+	RasterizerCanvasBatcher batcher;
+	batcher.set_max_rects(6);
+	batcher.add_item(&item, Transform2D());
+	batcher.finish();
+
+	// The rest of the run no longer fits and is drawn unbatched.
+	REQUIRE(batcher.get_batch_count() == 1);
+	CHECK(batcher.get_batches()[0].command_count == 6);
+	CHECK(batcher.get_rect_count() == 6);
+	CHECK(batcher.get_stats().commands == 10);
+
+	Item other;
+	for (int i = 0; i < 3; i++) {
+		add_rect(other, Rect2(i * 16, 0, 16, 16), texture);
+	}
+
+	batcher.clear();
+	batcher.reset_stats();
+	batcher.set_min_batch_size(4);
+	batcher.add_item(&other, Transform2D());
+	batcher.finish();
+	CHECK(batcher.get_batch_count() == 0);
+	CHECK(batcher.get_rect_count() == 0);
+	CHECK(batcher.get_stats().commands == 3);
+	CHECK(batcher.get_stats().batched_commands == 0);
+
+	// Batches of consecutive items are sorted by item.
+	batcher.clear();
+	batcher.set_min_batch_size(2);
+	batcher.add_item(&other, Transform2D());
+	batcher.add_item(&other, Transform2D());
+	batcher.finish();
+	REQUIRE(batcher.get_batch_count() == 2);
+	CHECK(batcher.get_batches()[0].item == 0);
+	CHECK(batcher.get_batches()[1].item == 1);
+
+	texture_owner.free(texture);
+}
+
+TEST_CASE("[CanvasBatcher] Runs continue into consecutive items with the same state") {
+	RID_Owner<int> texture_owner;
+	RID texture = texture_owner.make_rid(0);
+	RID other_texture = texture_owner.make_rid(1);
+
+	// Like sprites, one rect per item.
+	Item sprites[4];
+	for (int i = 0; i < 4; i++) {
+		add_rect(sprites[i], Rect2(0, 0, 16, 16), texture);
+		sprites[i].final_modulate = Color(1, 1, 1, 0.25 * i);
+	}
+
+	RasterizerCanvasBatcher batcher;
+	batcher.set_max_rects(1024);
+	for (int i = 0; i < 4; i++) {
+		batcher.add_item(&sprites[i], Transform2D(0, Vector2(i * 16, 0)), true);
+	}
+	batcher.finish();
+
+	REQUIRE(batcher.get_batch_count() == 1);
+	const RasterizerCanvasBatcher::Batch &batch = batcher.get_batches()[0];
+	CHECK(batch.item == 0);
+	CHECK(batch.merged_items == 3);
+	CHECK(batch.first_command == sprites[0].commands);
+	CHECK(batch.command_count == 1);
+	CHECK(batch.rect_count == 4);
+	CHECK(batcher.get_stats().commands == 4);
+	CHECK(batcher.get_stats().batched_commands == 4);
+
+	// Each rect keeps the transform and modulate of its item.
+	CHECK(batcher.get_rects()[3].world[4] == doctest::Approx(48));
+	CHECK(batcher.get_rects()[3].modulation[3] == doctest::Approx(0.75));
+
+	// Items that can't be merged (lit, different clip, other textures or
+	// commands) close the run and get their own batches.
+	Item clip_owner;
+	sprites[2].final_clip_owner = &clip_owner;
+	add_rect(sprites[3], Rect2(0, 0, 16, 16), other_texture);
+
+	batcher.clear();
+	batcher.reset_stats();
+	batcher.add_item(&sprites[0], Transform2D(), true);
+	batcher.add_item(&sprites[1], Transform2D(), true);
+	batcher.add_item(&sprites[2], Transform2D(), true);
+	batcher.add_item(&sprites[3], Transform2D(), true);
+	batcher.add_item(&sprites[0], Transform2D(), false);
+	batcher.add_item(&sprites[1], Transform2D(), true);
+	batcher.finish();
+
+	REQUIRE(batcher.get_batch_count() == 1);
+	CHECK(batcher.get_batches()[0].item == 0);
+	CHECK(batcher.get_batches()[0].merged_items == 1);
+	CHECK(batcher.get_batches()[0].rect_count == 2);
+	// The single rects left over are drawn unbatched.
+	CHECK(batcher.get_rect_count() == 2);
+	CHECK(batcher.get_stats().commands == 7);
+	CHECK(batcher.get_stats().batched_commands == 2);
+
+	texture_owner.free(texture);
+	texture_owner.free(other_texture);
+}
+
+} // namespace TestCanvasBatcher
+
+#endif // TEST_CANVAS_BATCHER_H
@@ -0,0 +1,136 @@
+/*************************************************************************/
+/*  test_frame_arena.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_FRAME_ARENA_H
+#define TEST_FRAME_ARENA_H
+
+#include "core/os/frame_arena.h"
+#include "core/templates/local_vector.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFrameArena {
+
+TEST_CASE("[FrameArena] Memory is reused once freed") {
+	uint8_t *a = (uint8_t *)FrameArena::alloc(100);
+	uint8_t *b = (uint8_t *)FrameArena::alloc(100);
+	REQUIRE(a != nullptr);
+	REQUIRE(b != nullptr);
+	CHECK(b >= a + 100);
+	CHECK_MESSAGE(((uintptr_t)a) % 16 == 0, "Allocations should be aligned to 16 bytes.");
+	CHECK_MESSAGE(((uintptr_t)b) % 16 == 0, "Allocations should be aligned to 16 bytes.");
+
+	// Most recent allocation, it is given back right away.
+	FrameArena::free(b);
+	uint8_t *c = (uint8_t *)FrameArena::alloc(100);
+	CHECK(c == b);
+
+	FrameArena::free(a);
+	FrameArena::free(c);
+
+	// Nothing is live, the arena starts over.
+	uint8_t *d = (uint8_t *)FrameArena::alloc(100);
+	CHECK(d == a);
+	FrameArena::free(d);
+}
+
+TEST_CASE("[FrameArena] Reallocation keeps contents") {
+	uint8_t *a = (uint8_t *)FrameArena::alloc(16);
+	for (int i = 0; i < 16; i++) {
+		a[i] = i;
+	}
+
+	// Grows in place while nothing was allocated after it.
+	uint8_t *grown = (uint8_t *)FrameArena::realloc(a, 64);
+	CHECK(grown == a);
+
+	uint8_t *b = (uint8_t *)FrameArena::alloc(16);
+	uint8_t *moved = (uint8_t *)FrameArena::realloc(grown, 256);
+	CHECK(moved != grown);
+
+	bool intact = true;
+	for (int i = 0; i < 16; i++) {
+		intact = intact && moved[i] == i;
+	}
+	CHECK_MESSAGE(intact, "Contents should be kept when a block moves.");
+
+	FrameArena::free(b);
+	FrameArena::free(moved);
+}
+
+TEST_CASE("[FrameArena] Allocations larger than a chunk") {
+	size_t capacity = FrameArena::get_thread_capacity();
+
+	uint8_t *small = (uint8_t *)FrameArena::alloc(64);
+	uint8_t *large = (uint8_t *)FrameArena::alloc(1 << 20);
+	REQUIRE(large != nullptr);
+	large[0] = 1;
+	large[(1 << 20) - 1] = 2;
+	CHECK(FrameArena::get_thread_capacity() > capacity + (1 << 20));
+
+	FrameArena::free(large);
+	FrameArena::free(small);
+
+	// The chunks are merged once nothing is live, so both fit in one afterwards.
+	small = (uint8_t *)FrameArena::alloc(64);
+	large = (uint8_t *)FrameArena::alloc(1 << 20);
+	CHECK(large == small + 64 + 16);
+	FrameArena::free(large);
+	FrameArena::free(small);
+}
+
+TEST_CASE("[FrameVector] Push, resize and copy from Vector") {
+	FrameVector<int> numbers;
+	for (int i = 0; i < 1000; i++) {
+		numbers.push_back(i);
+	}
+	CHECK(numbers.size() == 1000);
+	CHECK(numbers[999] == 999);
+
+	FrameVector<String> strings;
+	strings.push_back("a");
+	strings.resize(3);
+	strings[2] = "c";
+	CHECK(strings[0] == "a");
+	CHECK(strings[1] == "");
+	CHECK(strings[2] == "c");
+
+	Vector<int> source;
+	source.push_back(4);
+	source.push_back(5);
+	FrameVector<int> copy;
+	copy = source;
+	CHECK(copy.size() == 2);
+	CHECK(copy[1] == 5);
+}
+
+} // namespace TestFrameArena
+
+#endif // TEST_FRAME_ARENA_H
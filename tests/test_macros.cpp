@@ -31,6 +31,8 @@
 #define DOCTEST_CONFIG_IMPLEMENT
 #include "test_macros.h"
 
+#include "core/string/print_string.h"
+
 Map<String, TestFunc> *test_commands = nullptr;
 
 int register_test_command(String p_command, TestFunc p_function) {
@@ -40,3 +42,7 @@ int register_test_command(String p_command, TestFunc p_function) {
 	test_commands->insert(p_command, p_function);
 	return 0;
 }
+
+void print_benchmark(const String &p_name, uint64_t p_reference_usec, uint64_t p_usec) {
+	print_line(vformat("  %s: reference %d usec, optimized %d usec (%.2fx)", p_name, p_reference_usec, p_usec, double(p_reference_usec) / MAX(p_usec, (uint64_t)1)));
+}
@@ -31,6 +31,7 @@
 #ifndef TEST_MACROS_H
 #define TEST_MACROS_H
 
+#include "core/os/os.h"
 #include "core/templates/map.h"
 #include "core/variant/variant.h"
 
@@ -120,4 +121,18 @@ int register_test_command(String p_command, TestFunc p_function);
 			register_test_command(m_command, m_function);               \
 	DOCTEST_GLOBAL_NO_WARNINGS_END()
 
+// Helpers for benchmark test commands, which time an optimized path against its reference.
+
+// Returns the microseconds taken by `p_iterations` calls of `p_function`.
+template <class F>
+uint64_t benchmark_usec(int p_iterations, F p_function) {
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_iterations; i++) {
+		p_function();
+	}
+	return OS::get_singleton()->get_ticks_usec() - begin;
+}
+
+void print_benchmark(const String &p_name, uint64_t p_reference_usec, uint64_t p_usec);
+
 #endif // TEST_MACROS_H
@@ -33,23 +33,36 @@
 #include "core/templates/list.h"
 
 #include "test_astar.h"
+#include "test_audio_effects.h"
+#include "test_audio_voices.h"
 #include "test_basis.h"
+#include "test_canvas_batcher.h"
 #include "test_class_db.h"
 #include "test_color.h"
 #include "test_command_queue.h"
 #include "test_expression.h"
+#include "test_frame_arena.h"
 #include "test_gradient.h"
 #include "test_gui.h"
 #include "test_list.h"
 #include "test_math.h"
+#include "test_memory.h"
+#include "test_mesh_optimizer.h"
+#include "test_mesh_simplifier.h"
 #include "test_method_bind.h"
+#include "test_multiplayer_sync.h"
 #include "test_oa_hash_map.h"
 #include "test_ordered_hash_map.h"
 #include "test_physics_2d.h"
 #include "test_physics_3d.h"
+#include "test_radix_sort.h"
 #include "test_render.h"
+#include "test_rendering_server_scene.h"
+#include "test_rid.h"
 #include "test_shader_lang.h"
 #include "test_string.h"
+#include "test_surface_tool.h"
+#include "test_transform.h"
 #include "test_validate_testing.h"
 #include "test_variant.h"
 
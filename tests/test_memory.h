@@ -0,0 +1,125 @@
+/*************************************************************************/
+/*  test_memory.h                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_MEMORY_H
+#define TEST_MEMORY_H
+
+#include "core/os/memory.h"
+#include "core/os/small_object_allocator.h"
+#include "core/os/thread.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMemory {
+
+TEST_CASE("[Memory] Allocate, grow and shrink across size classes") {
+	const size_t sizes[] = { 1, 15, 16, 17, 100, 255, 256, 257, 4000 };
+
+	for (int i = 0; i < 9; i++) {
+		uint8_t *mem = (uint8_t *)memalloc(sizes[i]);
+		REQUIRE(mem != nullptr);
+		CHECK_MESSAGE(((uintptr_t)mem) % 8 == 0, "Blocks should be aligned.");
+		for (size_t j = 0; j < sizes[i]; j++) {
+			mem[j] = uint8_t(j * 7 + i);
+		}
+
+		// Grow into a larger block and then shrink back, contents must survive.
+		mem = (uint8_t *)memrealloc(mem, sizes[i] + 300);
+		REQUIRE(mem != nullptr);
+		mem = (uint8_t *)memrealloc(mem, sizes[i]);
+		REQUIRE(mem != nullptr);
+
+		bool intact = true;
+		for (size_t j = 0; j < sizes[i]; j++) {
+			intact = intact && mem[j] == uint8_t(j * 7 + i);
+		}
+		CHECK_MESSAGE(intact, vformat("Contents of a %d byte block should be kept on realloc.", (int64_t)sizes[i]));
+		memfree(mem);
+	}
+}
+
+TEST_CASE("[Memory] Small blocks come from the small-object allocator") {
+	void *small = Memory::alloc_static(SmallObjectAllocator::MAX_SIZE / 2);
+	void *large = Memory::alloc_static(SmallObjectAllocator::MAX_SIZE * 4);
+
+	CHECK(SmallObjectAllocator::owns((uint8_t *)small));
+	CHECK_FALSE(SmallObjectAllocator::owns((uint8_t *)large));
+
+	Memory::free_static(small);
+	Memory::free_static(large);
+}
+
+#ifdef DEBUG_ENABLED
+TEST_CASE("[Memory] Usage is accounted to the allocation tag") {
+	uint64_t before = Memory::get_mem_usage_by_tag(Memory::TAG_VARIANT);
+	void *mem = Memory::alloc_static(1000, false, Memory::TAG_VARIANT);
+	CHECK(Memory::get_mem_usage_by_tag(Memory::TAG_VARIANT) == before + 1000);
+
+	Memory::free_static(mem);
+	CHECK(Memory::get_mem_usage_by_tag(Memory::TAG_VARIANT) == before);
+}
+#endif
+
+struct CrossThreadFree {
+	Vector<void *> blocks;
+
+	static void free_blocks(void *p_userdata) {
+		CrossThreadFree *cross = static_cast<CrossThreadFree *>(p_userdata);
+		for (int i = 0; i < cross->blocks.size(); i++) {
+			memfree(cross->blocks[i]);
+		}
+	}
+};
+
+TEST_CASE("[Memory] Blocks can be freed from another thread") {
+	CrossThreadFree cross;
+	for (int i = 0; i < 10000; i++) {
+		void *mem = memalloc(16 + (i % 15) * 16);
+		memset(mem, 0xCD, 16);
+		cross.blocks.push_back(mem);
+	}
+
+	Thread *thread = Thread::create(&CrossThreadFree::free_blocks, &cross);
+	Thread::wait_to_finish(thread);
+	memdelete(thread);
+
+	// Blocks freed by the other thread are reusable from here.
+	for (int i = 0; i < 10000; i++) {
+		cross.blocks.write[i] = memalloc(16 + (i % 15) * 16);
+		REQUIRE(cross.blocks[i] != nullptr);
+	}
+	for (int i = 0; i < 10000; i++) {
+		memfree(cross.blocks[i]);
+	}
+}
+
+} // namespace TestMemory
+
+#endif // TEST_MEMORY_H
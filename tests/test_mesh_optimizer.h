@@ -0,0 +1,186 @@
+/*************************************************************************/
+/*  test_mesh_optimizer.h                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_MESH_OPTIMIZER_H
+#define TEST_MESH_OPTIMIZER_H
+
+#include "core/math/mesh_optimizer.h"
+#include "core/math/random_pcg.h"
+#include "core/templates/map.h"
+
+#include "thirdparty/doctest/doctest.h"
+
+namespace TestMeshOptimizer {
+
+// Wavy grid with its triangles in random order, the worst case for the vertex cache.
+static void _make_shuffled_grid(int p_size, Vector<Vector3> &r_vertices, Vector<int> &r_indices) {
+	for (int y = 0; y <= p_size; y++) {
+		for (int x = 0; x <= p_size; x++) {
+			r_vertices.push_back(Vector3(x, Math::sin(x * 0.5) * Math::cos(y * 0.5), y));
+		}
+	}
+	for (int y = 0; y < p_size; y++) {
+		for (int x = 0; x < p_size; x++) {
+			int a = y * (p_size + 1) + x;
+			r_indices.push_back(a);
+			r_indices.push_back(a + 1);
+			r_indices.push_back(a + p_size + 1);
+			r_indices.push_back(a + 1);
+			r_indices.push_back(a + p_size + 2);
+			r_indices.push_back(a + p_size + 1);
+		}
+	}
+
+	RandomPCG rng(7);
+	int *w = r_indices.ptrw();
+	for (int i = r_indices.size() / 3 - 1; i > 0; i--) {
+		int j = rng.rand() % (i + 1);
+		for (int k = 0; k < 3; k++) {
+			SWAP(w[i * 3 + k], w[j * 3 + k]);
+		}
+	}
+}
+
+// Triangles as a count per vertex triple, rotated to start at the lowest index so winding is kept.
+static Map<Vector3i, int> _get_triangles(const Vector<int> &p_indices) {
+	Map<Vector3i, int> triangles;
+	for (int i = 0; i < p_indices.size(); i += 3) {
+		int a = p_indices[i + 0];
+		int b = p_indices[i + 1];
+		int c = p_indices[i + 2];
+		while (a > b || a > c) {
+			int t = a;
+			a = b;
+			b = c;
+			c = t;
+		}
+
+		Vector3i key(a, b, c);
+		if (triangles.has(key)) {
+			triangles[key]++;
+		} else {
+			triangles[key] = 1;
+		}
+	}
+	return triangles;
+}
+
+static bool _same_triangles(const Vector<int> &p_a, const Vector<int> &p_b) {
+	Map<Vector3i, int> a = _get_triangles(p_a);
+	Map<Vector3i, int> b = _get_triangles(p_b);
+	if (a.size() != b.size()) {
+		return false;
+	}
+	for (Map<Vector3i, int>::Element *E = a.front(); E; E = E->next()) {
+		if (!b.has(E->key()) || b[E->key()] != E->get()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("[MeshOptimizer] Vertex cache and overdraw ordering") {
+	Vector<Vector3> vertices;
+	Vector<int> indices;
+	_make_shuffled_grid(32, vertices, indices);
+
+	float acmr;
+	float atvr;
+	MeshOptimizer::analyze_vertex_cache(indices, vertices.size(), acmr, atvr);
+	CHECK_MESSAGE(acmr > 2.0, "Shuffled triangles should miss the cache most of the time.");
+
+	Vector<int> cache_optimized = MeshOptimizer::optimize_vertex_cache(indices, vertices.size());
+	CHECK_MESSAGE(_same_triangles(indices, cache_optimized), "Only the triangle order should change.");
+
+	float optimized_acmr;
+	float optimized_atvr;
+	MeshOptimizer::analyze_vertex_cache(cache_optimized, vertices.size(), optimized_acmr, optimized_atvr);
+	CHECK_MESSAGE(optimized_acmr < 0.8, "A grid should be drawn with few cache misses per triangle.");
+	CHECK_MESSAGE(optimized_atvr < 1.6, "A grid should be drawn with few vertices transformed more than once.");
+
+	Vector<int> overdraw_optimized = MeshOptimizer::optimize_overdraw(cache_optimized, vertices, 1.05);
+	CHECK_MESSAGE(_same_triangles(indices, overdraw_optimized), "Only the triangle order should change.");
+
+	float overdraw_acmr;
+	float overdraw_atvr;
+	MeshOptimizer::analyze_vertex_cache(overdraw_optimized, vertices.size(), overdraw_acmr, overdraw_atvr);
+	CHECK_MESSAGE(overdraw_acmr <= optimized_acmr * 1.05 + CMP_EPSILON, "Clustering should stay within the cache miss threshold.");
+}
+
+TEST_CASE("[MeshOptimizer] Vertex cache ordering with degenerate triangles") {
+	Vector<Vector3> vertices;
+	Vector<int> indices;
+	_make_shuffled_grid(4, vertices, indices);
+	Vector<int> valid_indices = indices;
+
+	indices.push_back(0);
+	indices.push_back(0);
+	indices.push_back(1);
+	indices.push_back(2);
+	indices.push_back(3);
+	indices.push_back(2);
+	indices.push_back(4);
+	indices.push_back(4);
+	indices.push_back(4);
+
+	Vector<int> optimized = MeshOptimizer::optimize_vertex_cache(indices, vertices.size());
+	CHECK_MESSAGE(_same_triangles(valid_indices, optimized), "Degenerate triangles should be dropped, and every other triangle kept once.");
+}
+
+TEST_CASE("[MeshOptimizer] Vertex fetch remap") {
+	Vector<int> indices;
+	indices.push_back(4);
+	indices.push_back(2);
+	indices.push_back(0);
+	indices.push_back(0);
+	indices.push_back(2);
+	indices.push_back(5);
+
+	Vector<int> remapped = indices;
+	int vertex_count = 0;
+	Vector<int> remap = MeshOptimizer::optimize_vertex_fetch(remapped, 6, vertex_count);
+
+	CHECK_MESSAGE(vertex_count == 4, "Unused vertices should be dropped.");
+	REQUIRE(remap.size() == 6);
+	CHECK(remap[4] == 0);
+	CHECK(remap[2] == 1);
+	CHECK(remap[0] == 2);
+	CHECK(remap[5] == 3);
+	CHECK(remap[1] == -1);
+	CHECK(remap[3] == -1);
+
+	for (int i = 0; i < indices.size(); i++) {
+		CHECK_MESSAGE(remapped[i] == remap[indices[i]], "Indices should go through the remap.");
+	}
+}
+
+} // namespace TestMeshOptimizer
+
+#endif // TEST_MESH_OPTIMIZER_H
@@ -0,0 +1,172 @@
+/*************************************************************************/
+/*  test_mesh_simplifier.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_MESH_SIMPLIFIER_H
+#define TEST_MESH_SIMPLIFIER_H
+
+#include "core/math/mesh_simplifier.h"
+
+#include "thirdparty/doctest/doctest.h"
+
+namespace TestMeshSimplifier {
+
+// Flat grid in the XZ plane, facing down (-Y).
+static void _make_grid(int p_size, Vector<Vector3> &r_vertices, Vector<int> &r_indices) {
+	for (int y = 0; y <= p_size; y++) {
+		for (int x = 0; x <= p_size; x++) {
+			r_vertices.push_back(Vector3(x, 0, y));
+		}
+	}
+	for (int y = 0; y < p_size; y++) {
+		for (int x = 0; x < p_size; x++) {
+			int a = y * (p_size + 1) + x;
+			r_indices.push_back(a);
+			r_indices.push_back(a + 1);
+			r_indices.push_back(a + p_size + 1);
+			r_indices.push_back(a + 1);
+			r_indices.push_back(a + p_size + 2);
+			r_indices.push_back(a + p_size + 1);
+		}
+	}
+}
+
+// Closed sphere without seams: a subdivided octahedron projected on the unit sphere.
+static void _make_sphere(int p_subdivisions, Vector<Vector3> &r_vertices, Vector<int> &r_indices) {
+	const Vector3 corners[6] = { Vector3(1, 0, 0), Vector3(-1, 0, 0), Vector3(0, 1, 0), Vector3(0, -1, 0), Vector3(0, 0, 1), Vector3(0, 0, -1) };
+	const int faces[8][3] = { { 0, 2, 4 }, { 2, 1, 4 }, { 1, 3, 4 }, { 3, 0, 4 }, { 2, 0, 5 }, { 1, 2, 5 }, { 3, 1, 5 }, { 0, 3, 5 } };
+
+	for (int f = 0; f < 8; f++) {
+		const Vector3 &a = corners[faces[f][0]];
+		const Vector3 &b = corners[faces[f][1]];
+		const Vector3 &c = corners[faces[f][2]];
+		int n = p_subdivisions;
+
+		// Vertices along shared edges are duplicated here and welded below.
+		int base = r_vertices.size();
+		for (int i = 0; i <= n; i++) {
+			for (int j = 0; j <= n - i; j++) {
+				Vector3 p = a + (b - a) * (float(i) / n) + (c - a) * (float(j) / n);
+				r_vertices.push_back(p.normalized());
+			}
+		}
+
+		int row = base;
+		for (int i = 0; i < n; i++) {
+			int next_row = row + (n - i + 1);
+			for (int j = 0; j < n - i; j++) {
+				r_indices.push_back(row + j);
+				r_indices.push_back(next_row + j);
+				r_indices.push_back(row + j + 1);
+				if (j < n - i - 1) {
+					r_indices.push_back(row + j + 1);
+					r_indices.push_back(next_row + j);
+					r_indices.push_back(next_row + j + 1);
+				}
+			}
+			row = next_row;
+		}
+	}
+
+	// Weld the duplicated edge vertices, so the sphere is closed.
+	for (int i = 0; i < r_indices.size(); i++) {
+		const Vector3 &p = r_vertices[r_indices[i]];
+		for (int j = 0; j < r_indices[i]; j++) {
+			if (r_vertices[j].is_equal_approx(p)) {
+				r_indices.write[i] = j;
+				break;
+			}
+		}
+	}
+}
+
+static int _count_inverted_triangles(const Vector<Vector3> &p_vertices, const Vector<int> &p_indices, const Vector3 &p_expected_normal) {
+	int inverted = 0;
+	for (int i = 0; i < p_indices.size(); i += 3) {
+		const Vector3 &a = p_vertices[p_indices[i + 0]];
+		const Vector3 &b = p_vertices[p_indices[i + 1]];
+		const Vector3 &c = p_vertices[p_indices[i + 2]];
+		Vector3 expected = p_expected_normal == Vector3() ? (a + b + c) : p_expected_normal;
+		// Some tolerance, triangles along a great circle of the sphere stand on edge.
+		if ((b - a).cross(c - a).normalized().dot(expected.normalized()) < -0.01) {
+			inverted++;
+		}
+	}
+	return inverted;
+}
+
+TEST_CASE("[MeshSimplifier] Flat interior collapses without error and keeps the border") {
+	Vector<Vector3> vertices;
+	Vector<int> indices;
+	_make_grid(10, vertices, indices);
+
+	float error = -1;
+	Vector<int> simplified = MeshSimplifier::simplify(vertices, Vector<Vector3>(), Vector<Vector2>(), indices, 0, 0.01, &error);
+
+	// 40 border vertices can't go, which leaves 38 triangles to fill the polygon they form.
+	CHECK_MESSAGE(simplified.size() == 38 * 3, "All interior vertices should be collapsed.");
+	CHECK_MESSAGE(Math::is_zero_approx(error), "Collapsing vertices on a plane should not introduce any error.");
+	CHECK_MESSAGE(_count_inverted_triangles(vertices, simplified, Vector3(0, -1, 0)) == 0, "No triangle should be flipped.");
+
+	bool border_kept = true;
+	for (int i = 0; i < vertices.size(); i++) {
+		const Vector3 &v = vertices[i];
+		if (v.x != 0 && v.x != 10 && v.z != 0 && v.z != 10) {
+			continue;
+		}
+		border_kept = border_kept && simplified.find(i) != -1;
+	}
+	CHECK_MESSAGE(border_kept, "Border vertices should all be kept.");
+}
+
+TEST_CASE("[MeshSimplifier] Target index count and error limit") {
+	Vector<Vector3> vertices;
+	Vector<int> indices;
+	_make_sphere(16, vertices, indices);
+
+	float error = -1;
+	Vector<int> half = MeshSimplifier::simplify(vertices, vertices, Vector<Vector2>(), indices, indices.size() / 2, 1.0, &error);
+	CHECK_MESSAGE(half.size() <= indices.size() / 2, "The target index count should be reached.");
+	CHECK_MESSAGE(half.size() >= indices.size() / 2 - 6, "Collapses should stop soon after reaching the target.");
+	CHECK_MESSAGE(error > 0, "Simplifying a curved surface should introduce some error.");
+	CHECK_MESSAGE(error < 0.05, "Halving a dense sphere should stay close to its surface.");
+	CHECK_MESSAGE(_count_inverted_triangles(vertices, half, Vector3()) == 0, "No triangle should be flipped.");
+
+	Vector<int> limited = MeshSimplifier::simplify(vertices, vertices, Vector<Vector2>(), indices, 0, 0.005, &error);
+	CHECK_MESSAGE(limited.size() > indices.size() / 2, "The error limit should stop the simplification early.");
+	CHECK_MESSAGE(error <= 0.01, "The reported error should respect the limit, relative to the mesh extent.");
+
+	Vector<int> unchanged = MeshSimplifier::simplify(vertices, vertices, Vector<Vector2>(), indices, indices.size(), 1.0, &error);
+	CHECK_MESSAGE(unchanged == indices, "Nothing should change when already at the target.");
+	CHECK(error == 0);
+}
+
+} // namespace TestMeshSimplifier
+
+#endif // TEST_MESH_SIMPLIFIER_H
@@ -0,0 +1,277 @@
+/*************************************************************************/
+/*  test_multiplayer_sync.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef TEST_MULTIPLAYER_SYNC_H
+#define TEST_MULTIPLAYER_SYNC_H
+
+#include "core/io/multiplayer_sync_encoding.h"
+
+#include "thirdparty/doctest/doctest.h"
+
+namespace TestMultiplayerSync {
+
+// One value of every Variant type, which can be compared after a round-trip.
+static Vector<Variant> _make_values() {
+	Vector<Variant> values;
+	values.resize(Variant::VARIANT_MAX);
+
+	values.write[Variant::NIL] = Variant();
+	values.write[Variant::BOOL] = true;
+	values.write[Variant::INT] = (int64_t)-1234567890123;
+	values.write[Variant::FLOAT] = 2.5;
+	values.write[Variant::STRING] = "replicated";
+	values.write[Variant::VECTOR2] = Vector2(1.5, -2.25);
+	values.write[Variant::VECTOR2I] = Vector2i(3, -4);
+	values.write[Variant::RECT2] = Rect2(1, 2, 3, 4);
+	values.write[Variant::RECT2I] = Rect2i(-1, -2, 3, 4);
+	values.write[Variant::VECTOR3] = Vector3(0.5, -1.75, 8);
+	values.write[Variant::VECTOR3I] = Vector3i(5, 6, -7);
+	values.write[Variant::TRANSFORM2D] = Transform2D(0.5, Vector2(3, 4));
+	values.write[Variant::PLANE] = Plane(Vector3(0, 1, 0), 2);
+	values.write[Variant::QUAT] = Quat(0, 0, 0, 1);
+	values.write[Variant::AABB] = AABB(Vector3(1, 2, 3), Vector3(4, 5, 6));
+	values.write[Variant::BASIS] = Basis(Vector3(0, 1, 0), 0.5);
+	values.write[Variant::TRANSFORM] = Transform(Basis(), Vector3(1, 2, 3));
+	values.write[Variant::COLOR] = Color(0.25, 0.5, 0.75, 1);
+	values.write[Variant::STRING_NAME] = StringName("sync_name");
+	values.write[Variant::NODE_PATH] = NodePath("Root/Player");
+	values.write[Variant::RID] = RID();
+	values.write[Variant::OBJECT] = (Object *)nullptr;
+	values.write[Variant::CALLABLE] = Callable();
+	values.write[Variant::SIGNAL] = Signal();
+
+	Dictionary dictionary;
+	dictionary["health"] = 100;
+	values.write[Variant::DICTIONARY] = dictionary;
+
+	Array array;
+	array.push_back(1);
+	array.push_back("two");
+	values.write[Variant::ARRAY] = array;
+
+	PackedByteArray bytes;
+	bytes.push_back(7);
+	bytes.push_back(255);
+	values.write[Variant::PACKED_BYTE_ARRAY] = bytes;
+
+	PackedInt32Array int32s;
+	int32s.push_back(-3);
+	values.write[Variant::PACKED_INT32_ARRAY] = int32s;
+
+	PackedInt64Array int64s;
+	int64s.push_back((int64_t)1 << 40);
+	values.write[Variant::PACKED_INT64_ARRAY] = int64s;
+
+	PackedFloat32Array float32s;
+	float32s.push_back(0.5);
+	values.write[Variant::PACKED_FLOAT32_ARRAY] = float32s;
+
+	PackedFloat64Array float64s;
+	float64s.push_back(0.125);
+	values.write[Variant::PACKED_FLOAT64_ARRAY] = float64s;
+
+	PackedStringArray strings;
+	strings.push_back("a");
+	strings.push_back("bc");
+	values.write[Variant::PACKED_STRING_ARRAY] = strings;
+
+	PackedVector2Array vector2s;
+	vector2s.push_back(Vector2(1, 2));
+	vector2s.push_back(Vector2(-3, 4));
+	values.write[Variant::PACKED_VECTOR2_ARRAY] = vector2s;
+
+	PackedVector3Array vector3s;
+	vector3s.push_back(Vector3(1, 2, 3));
+	values.write[Variant::PACKED_VECTOR3_ARRAY] = vector3s;
+
+	PackedColorArray colors;
+	colors.push_back(Color(1, 0, 0, 0.5));
+	values.write[Variant::PACKED_COLOR_ARRAY] = colors;
+
+	return values;
+}
+
+// Base values of the same type as `p_value`, so numbers are sent as deltas.
+static Variant _make_base(const Variant &p_value) {
+	switch (p_value.get_type()) {
+		case Variant::INT:
+			return 1000;
+		case Variant::FLOAT:
+			return -4.0;
+		case Variant::VECTOR2:
+			return Vector2(10, 20);
+		case Variant::VECTOR3:
+			return Vector3(-10, 0, 30);
+		default:
+			return p_value;
+	}
+}
+
+TEST_CASE("[MultiplayerSync] Bit writer and reader round-trip") {
+	Vector<uint8_t> buffer;
+	SyncBitWriter w(buffer, 0);
+	w.put_bits(1, 1);
+	w.put_bits(0x15, 5);
+	w.put_bits(0xDEADBEEF, 32);
+	w.put_varint(0);
+	w.put_varint(15);
+	w.put_varint(16);
+	w.put_varint(UINT64_MAX);
+	w.put_zigzag(-1);
+	w.put_zigzag(INT64_MIN);
+	w.put_zigzag(INT64_MAX);
+	const uint8_t bytes[3] = { 1, 2, 255 };
+	w.put_bytes(bytes, 3);
+	const int bits = w.get_bit_offset();
+	CHECK(buffer.size() == (bits + 7) / 8);
+
+	SyncBitReader r(buffer.ptr(), buffer.size());
+	CHECK(r.get_bits(1) == 1);
+	CHECK(r.get_bits(5) == 0x15);
+	CHECK(r.get_bits(32) == 0xDEADBEEF);
+	CHECK(r.get_varint() == 0);
+	CHECK(r.get_varint() == 15);
+	CHECK(r.get_varint() == 16);
+	CHECK(r.get_varint() == UINT64_MAX);
+	CHECK(r.get_zigzag() == -1);
+	CHECK(r.get_zigzag() == INT64_MIN);
+	CHECK(r.get_zigzag() == INT64_MAX);
+	uint8_t read_bytes[3] = {};
+	r.get_bytes(read_bytes, 3);
+	CHECK(read_bytes[0] == 1);
+	CHECK(read_bytes[1] == 2);
+	CHECK(read_bytes[2] == 255);
+	CHECK(!r.has_error());
+
+	// Reading past the end is reported, not undefined.
+	r.get_bits(8 - (bits & 7) + 1);
+	CHECK(r.has_error());
+}
+
+TEST_CASE("[MultiplayerSync] Writer starts after the packet header") {
+	Vector<uint8_t> buffer;
+	buffer.resize(3);
+	buffer.write[0] = 0xAB;
+	SyncBitWriter w(buffer, 1);
+	w.put_bits(0x3F, 6);
+	CHECK(buffer[0] == 0xAB);
+
+	SyncBitReader r(buffer.ptr() + 1, buffer.size() - 1);
+	CHECK(r.get_bits(6) == 0x3F);
+}
+
+TEST_CASE("[MultiplayerSync] Value round-trip of every Variant type") {
+	const Vector<Variant> values = _make_values();
+
+	for (int use_base = 0; use_base < 2; use_base++) {
+		Vector<uint8_t> buffer;
+		SyncBitWriter w(buffer, 0);
+		for (int i = 0; i < values.size(); i++) {
+			const Variant base = use_base ? _make_base(values[i]) : Variant();
+			CHECK_MESSAGE(sync_encode_value(w, values[i], base, 0, false) == OK, String("Encoding type ") + Variant::get_type_name(Variant::Type(i)));
+		}
+
+		SyncBitReader r(buffer.ptr(), buffer.size());
+		for (int i = 0; i < values.size(); i++) {
+			const Variant base = use_base ? _make_base(values[i]) : Variant();
+			// Null objects are sent as nil.
+			const Variant expected = i == Variant::OBJECT ? Variant() : values[i];
+			Variant decoded;
+			REQUIRE(sync_decode_value(r, decoded, base, 0, false) == OK);
+			CHECK_MESSAGE(decoded.get_type() == expected.get_type(), String("Decoding type ") + Variant::get_type_name(Variant::Type(i)));
+			CHECK_MESSAGE(decoded.hash() == expected.hash(), String("Decoding type ") + Variant::get_type_name(Variant::Type(i)));
+		}
+		CHECK(!r.has_error());
+	}
+}
+
+TEST_CASE("[MultiplayerSync] Quantized deltas") {
+	const real_t step = 0.25;
+	const Variant value = sync_quantize_value(Vector3(1.3, -2.6, 100.1), step);
+	CHECK(value == Variant(Vector3(1.25, -2.5, 100)));
+	const Variant base = Vector3(1, -2.5, 99);
+
+	Vector<uint8_t> buffer;
+	SyncBitWriter w(buffer, 0);
+	REQUIRE(sync_encode_value(w, value, base, step, false) == OK);
+	// Type plus three small deltas, much less than three full floats.
+	CHECK(w.get_bit_offset() < SYNC_TYPE_BITS + 32);
+
+	SyncBitReader r(buffer.ptr(), buffer.size());
+	Variant decoded;
+	REQUIRE(sync_decode_value(r, decoded, base, step, false) == OK);
+	CHECK(decoded == value);
+}
+
+TEST_CASE("[MultiplayerSync] Quantized values out of range") {
+	const real_t step = 0.01;
+	// Far more steps than fit in an integer, and non finite values.
+	const Variant value = Vector3(1e30, -1e30, NAN);
+	const Variant base = Vector3(-1e30, INFINITY, 0);
+
+	Vector<uint8_t> buffer;
+	SyncBitWriter w(buffer, 0);
+	REQUIRE(sync_encode_value(w, value, base, step, false) == OK);
+
+	SyncBitReader r(buffer.ptr(), buffer.size());
+	Variant decoded;
+	REQUIRE(sync_decode_value(r, decoded, base, step, false) == OK);
+	CHECK(!r.has_error());
+	const Vector3 v = decoded;
+	CHECK_MESSAGE(v.x > 1e13, "Huge values should saturate, keeping their sign.");
+	CHECK_MESSAGE(v.y < -1e13, "Huge values should saturate, keeping their sign.");
+	CHECK(v.z == 0);
+}
+
+TEST_CASE("[MultiplayerSync] Malformed values are rejected") {
+	ERR_PRINT_OFF;
+
+	Vector<uint8_t> buffer;
+	SyncBitWriter w(buffer, 0);
+	w.put_bits(Variant::VARIANT_MAX, SYNC_TYPE_BITS);
+	SyncBitReader r(buffer.ptr(), buffer.size());
+	Variant decoded;
+	CHECK(sync_decode_value(r, decoded, Variant(), 0, false) != OK);
+
+	// A byte array which claims more data than the packet holds.
+	Vector<uint8_t> truncated;
+	SyncBitWriter tw(truncated, 0);
+	tw.put_bits(Variant::PACKED_BYTE_ARRAY, SYNC_TYPE_BITS);
+	tw.put_varint(1000);
+	SyncBitReader tr(truncated.ptr(), truncated.size());
+	CHECK(sync_decode_value(tr, decoded, Variant(), 0, false) != OK);
+
+	ERR_PRINT_ON;
+}
+
+} // namespace TestMultiplayerSync
+
+#endif // TEST_MULTIPLAYER_SYNC_H
@@ -134,6 +134,83 @@ TEST_CASE("[OrderedHashMap] Const iteration") {
 	}
 }
 
+TEST_CASE("[OrderedHashMap] Erase during iteration") {
+	OrderedHashMap<int, int> map;
+	for (int i = 0; i < 100; i++) {
+		map.insert(i, i * 2);
+	}
+
+	for (OrderedHashMap<int, int>::Element E = map.front(); E; E = E.next()) {
+		if (E.key() % 2 == 0) {
+			map.erase(E);
+		}
+	}
+
+	CHECK(map.size() == 50);
+
+	int expected_key = 1;
+	bool in_order = true;
+	for (OrderedHashMap<int, int>::Element E = map.front(); E; E = E.next()) {
+		in_order = in_order && E.key() == expected_key && E.value() == expected_key * 2;
+		expected_key += 2;
+	}
+	CHECK_MESSAGE(in_order, "Remaining elements should keep their insertion order.");
+
+	// Erased entries are reused, but new elements still go to the back.
+	map.insert(1000, 0);
+	CHECK(map.back().key() == 1000);
+	CHECK(map.front().key() == 1);
+}
+
+TEST_CASE("[OrderedHashMap] Pointers stay valid while growing") {
+	OrderedHashMap<int, int> map;
+	map.insert(-1, 1234);
+	int *value = map.getptr(-1);
+	const int *key = &map.front().key();
+
+	for (int i = 0; i < 10000; i++) {
+		map.insert(i, i);
+	}
+
+	CHECK(map.size() == 10001);
+	CHECK(map.getptr(-1) == value);
+	CHECK(*value == 1234);
+	CHECK(&map.front().key() == key);
+	CHECK(map.getptr(10000) == nullptr);
+
+	bool all_found = true;
+	for (int i = 0; i < 10000; i++) {
+		const int *found = map.getptr(i);
+		all_found = all_found && found && *found == i;
+	}
+	CHECK(all_found);
+}
+
+TEST_CASE("[OrderedHashMap] Clear and copy") {
+	OrderedHashMap<int, int> map;
+	for (int i = 0; i < 50; i++) {
+		map.insert(i, i);
+	}
+
+	OrderedHashMap<int, int> copy;
+	copy.insert(-1, -1);
+	copy = map;
+	CHECK(copy.size() == 50);
+	CHECK(!copy.has(-1));
+	CHECK(copy.front().key() == 0);
+	CHECK(copy.back().key() == 49);
+
+	map.clear();
+	CHECK(map.empty());
+	CHECK(!map.has(10));
+	CHECK(!map.front());
+
+	map.insert(7, 70);
+	CHECK(map.size() == 1);
+	CHECK(map[7] == 70);
+	CHECK(copy[7] == 7);
+}
+
 } // namespace TestOrderedHashMap
 
 #endif // TEST_ORDERED_HASH_MAP_H
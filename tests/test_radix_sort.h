@@ -0,0 +1,133 @@
+/*************************************************************************/
+/*  test_radix_sort.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_RADIX_SORT_H
+#define TEST_RADIX_SORT_H
+
+#include "core/math/random_number_generator.h"
+#include "core/templates/radix_sort.h"
+#include "core/templates/sort_array.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRadixSort {
+
+struct Item {
+	uint64_t key;
+	int index;
+};
+
+struct ItemKey {
+	_FORCE_INLINE_ uint64_t operator()(const Item *p_item) const {
+		return p_item->key;
+	}
+};
+
+// Key, then original position, which is the order a stable sort keeps.
+struct ItemCompare {
+	_FORCE_INLINE_ bool operator()(const Item *p_a, const Item *p_b) const {
+		if (p_a->key == p_b->key) {
+			return p_a->index < p_b->index;
+		}
+		return p_a->key < p_b->key;
+	}
+};
+
+static void _check_sort(Item *p_items, int p_count) {
+	Vector<Item *> sorted;
+	Vector<Item *> expected;
+	for (int i = 0; i < p_count; i++) {
+		p_items[i].index = i;
+		sorted.push_back(&p_items[i]);
+		expected.push_back(&p_items[i]);
+	}
+
+	Vector<RadixSort<Item *, ItemKey>::Pair> pairs;
+	Vector<RadixSort<Item *, ItemKey>::Pair> pairs_tmp;
+	pairs.resize(p_count);
+	pairs_tmp.resize(p_count);
+
+	RadixSort<Item *, ItemKey> radix;
+	radix.sort(sorted.ptrw(), p_count, pairs.ptrw(), pairs_tmp.ptrw());
+	SortArray<Item *, ItemCompare> reference;
+	reference.sort(expected.ptrw(), p_count);
+
+	bool matches = true;
+	for (int i = 0; i < p_count; i++) {
+		if (sorted[i] != expected[i]) {
+			matches = false;
+			break;
+		}
+	}
+	CHECK_MESSAGE(matches, vformat("Radix sort of %d items should match a stable comparison sort.", p_count));
+}
+
+TEST_CASE("[RadixSort] Sorts like a stable comparison sort") {
+	RandomNumberGenerator rng;
+	rng.set_seed(2468);
+
+	const int count = 1000;
+	Item items[count];
+
+	// Full range keys.
+	for (int i = 0; i < count; i++) {
+		items[i].key = (uint64_t(rng.randi()) << 32) | rng.randi();
+	}
+	_check_sort(items, count);
+
+	// Few distinct keys, so stability matters, spread over low and high bytes.
+	for (int i = 0; i < count; i++) {
+		items[i].key = (uint64_t(rng.randi_range(0, 3)) << 56) | rng.randi_range(0, 5);
+	}
+	_check_sort(items, count);
+
+	// A single distinct key, every pass is skipped.
+	for (int i = 0; i < count; i++) {
+		items[i].key = 0x0123456789ABCDEF;
+	}
+	_check_sort(items, count);
+
+	// Already sorted and reversed.
+	for (int i = 0; i < count; i++) {
+		items[i].key = uint64_t(i) * 0x10001;
+	}
+	_check_sort(items, count);
+	for (int i = 0; i < count; i++) {
+		items[i].key = uint64_t(count - i) << 20;
+	}
+	_check_sort(items, count);
+
+	_check_sort(items, 1);
+	_check_sort(items, 0);
+}
+
+} // namespace TestRadixSort
+
+#endif // TEST_RADIX_SORT_H
@@ -0,0 +1,85 @@
+/*************************************************************************/
+/*  test_rendering_server_scene.h                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_RENDERING_SERVER_SCENE_H
+#define TEST_RENDERING_SERVER_SCENE_H
+
+#include "servers/rendering/rendering_server_scene.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRenderingServerScene {
+
+typedef RenderingServerScene::Instance Instance;
+
+TEST_CASE("[RenderingServerScene] Instances without a draw range are always drawn") {
+	Instance instance;
+	instance.transformed_aabb = AABB(Vector3(-1, -1, -1), Vector3(2, 2, 2));
+
+	// The defaults of GeometryInstance3D.
+	CHECK(RenderingServerScene::_instance_in_draw_range(&instance, Vector3()));
+	CHECK(RenderingServerScene::_instance_in_draw_range(&instance, Vector3(0, 0, 100000)));
+}
+
+TEST_CASE("[RenderingServerScene] Draw range is measured to the closest point of the bounds") {
+	Instance instance;
+	instance.transformed_aabb = AABB(Vector3(-1, -1, -1), Vector3(2, 2, 2));
+	instance.lod_end = 10;
+
+	CHECK(RenderingServerScene::_instance_in_draw_range(&instance, Vector3()));
+	CHECK(RenderingServerScene::_instance_in_draw_range(&instance, Vector3(0, 0, 11)));
+	CHECK_FALSE(RenderingServerScene::_instance_in_draw_range(&instance, Vector3(0, 0, 11.5)));
+
+	// The margin extends the range.
+	instance.lod_end_hysteresis = 1;
+	CHECK(RenderingServerScene::_instance_in_draw_range(&instance, Vector3(0, 0, 11.5)));
+	CHECK_FALSE(RenderingServerScene::_instance_in_draw_range(&instance, Vector3(0, 0, 12.5)));
+}
+
+TEST_CASE("[RenderingServerScene] Instances closer than the draw range start are not drawn") {
+	Instance instance;
+	instance.transformed_aabb = AABB(Vector3(-1, -1, -1), Vector3(2, 2, 2));
+	instance.lod_begin = 5;
+
+	// Inside the bounds, the distance is zero.
+	CHECK_FALSE(RenderingServerScene::_instance_in_draw_range(&instance, Vector3()));
+	CHECK_FALSE(RenderingServerScene::_instance_in_draw_range(&instance, Vector3(5, 0, 0)));
+	CHECK(RenderingServerScene::_instance_in_draw_range(&instance, Vector3(6, 0, 0)));
+	// No end, drawn at any distance beyond the start.
+	CHECK(RenderingServerScene::_instance_in_draw_range(&instance, Vector3(100000, 0, 0)));
+
+	instance.lod_begin_hysteresis = 2;
+	CHECK(RenderingServerScene::_instance_in_draw_range(&instance, Vector3(4, 0, 0)));
+	CHECK_FALSE(RenderingServerScene::_instance_in_draw_range(&instance, Vector3(3.5, 0, 0)));
+}
+
+} // namespace TestRenderingServerScene
+
+#endif // TEST_RENDERING_SERVER_SCENE_H
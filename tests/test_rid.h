@@ -0,0 +1,153 @@
+/*************************************************************************/
+/*  test_rid.h                                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_RID_H
+#define TEST_RID_H
+
+#include "core/os/thread.h"
+#include "core/templates/rid_owner.h"
+
+#include "tests/test_macros.h"
+
+#include <atomic>
+
+namespace TestRID {
+
+TEST_CASE("[RID_Owner] Make, lookup and free") {
+	RID_Owner<int> owner;
+
+	RID a = owner.make_rid(10);
+	RID b = owner.make_rid(20);
+
+	CHECK(owner.owns(a));
+	CHECK(owner.owns(b));
+	CHECK(*owner.getornull(a) == 10);
+	CHECK(*owner.getornull(b) == 20);
+	CHECK(owner.get_rid_count() == 2);
+	CHECK(owner.getornull(RID()) == nullptr);
+
+	owner.free(a);
+	CHECK_FALSE(owner.owns(a));
+	CHECK(owner.getornull(a) == nullptr);
+
+	// The slot is reused, but the old RID stays invalid.
+	RID c = owner.make_rid(30);
+	CHECK(owner.getornull(a) == nullptr);
+	CHECK(*owner.getornull(c) == 30);
+
+	owner.free(b);
+	owner.free(c);
+	CHECK(owner.get_rid_count() == 0);
+}
+
+TEST_CASE("[RID_Owner] Growing over many chunks keeps existing RIDs valid") {
+	// Small chunks, so the chunk directory is replaced several times.
+	RID_Owner<int, true> owner(16);
+
+	Vector<RID> rids;
+	for (int i = 0; i < 1000; i++) {
+		rids.push_back(owner.make_rid(i));
+	}
+
+	bool all_valid = true;
+	for (int i = 0; i < rids.size(); i++) {
+		int *value = owner.getornull(rids[i]);
+		all_valid = all_valid && value && *value == i;
+	}
+	CHECK_MESSAGE(all_valid, "Every RID should resolve to its value after growing.");
+
+	List<RID> owned;
+	owner.get_owned_list(&owned);
+	CHECK(owned.size() == 1000);
+
+	for (int i = 0; i < rids.size(); i++) {
+		owner.free(rids[i]);
+	}
+	CHECK(owner.get_rid_count() == 0);
+}
+
+struct ConcurrentLookup {
+	RID_Owner<int, true> owner;
+	Vector<RID> rids;
+	std::atomic<bool> done = { false };
+	std::atomic<int> errors = { 0 };
+
+	ConcurrentLookup() :
+			owner(16) {}
+
+	static void reader(void *p_userdata) {
+		ConcurrentLookup *lookup = static_cast<ConcurrentLookup *>(p_userdata);
+		while (!lookup->done.load()) {
+			for (int i = 0; i < lookup->rids.size(); i++) {
+				int *value = lookup->owner.getornull(lookup->rids[i]);
+				if (!value || *value != i) {
+					lookup->errors++;
+				}
+			}
+		}
+	}
+};
+
+TEST_CASE("[RID_Owner] Lookups from other threads while allocating") {
+	ConcurrentLookup lookup;
+	for (int i = 0; i < 64; i++) {
+		lookup.rids.push_back(lookup.owner.make_rid(i));
+	}
+
+	Thread *readers[2];
+	for (int i = 0; i < 2; i++) {
+		readers[i] = Thread::create(&ConcurrentLookup::reader, &lookup);
+	}
+
+	// Allocation and free happen while readers resolve the first RIDs.
+	Vector<RID> extra;
+	for (int i = 0; i < 5000; i++) {
+		extra.push_back(lookup.owner.make_rid(-1));
+	}
+	for (int i = 0; i < extra.size(); i++) {
+		lookup.owner.free(extra[i]);
+	}
+
+	lookup.done.store(true);
+	for (int i = 0; i < 2; i++) {
+		Thread::wait_to_finish(readers[i]);
+		memdelete(readers[i]);
+	}
+
+	CHECK_MESSAGE(lookup.errors.load() == 0, "Lookups of live RIDs should never fail while the owner grows.");
+
+	for (int i = 0; i < lookup.rids.size(); i++) {
+		lookup.owner.free(lookup.rids[i]);
+	}
+}
+
+} // namespace TestRID
+
+#endif // TEST_RID_H
@@ -38,6 +38,7 @@
 #include "core/io/ip_address.h"
 #include "core/os/main_loop.h"
 #include "core/os/os.h"
+#include "core/string/print_string.h"
 #include "core/string/ustring.h"
 
 #ifdef MODULE_REGEX_ENABLED
@@ -1297,6 +1298,135 @@ TEST_CASE("[String] humanize_size") {
 	CHECK(String::humanize_size(5345555000) == "4.97 GiB");
 }
 
+TEST_CASE("[String] Copies are unshared when modified") {
+	String a = "Shared text";
+	String b = a;
+	String c = a;
+
+	b += " grows";
+	CHECK(a == "Shared text");
+	CHECK(b == "Shared text grows");
+
+	c.resize(7);
+	c[6] = 0;
+	CHECK(a == "Shared text");
+	CHECK(c == "Shared");
+
+	String d = a + a;
+	CHECK(d == "Shared textShared text");
+	CHECK(a == "Shared text");
+
+	Vector<String> strings;
+	strings.push_back("one");
+	strings.push_back("two");
+	Vector<String> strings_copy = strings;
+	strings_copy.resize(1);
+	strings_copy.push_back("three");
+	CHECK(strings.size() == 2);
+	CHECK(strings[1] == "two");
+	CHECK(strings_copy.size() == 2);
+	CHECK(strings_copy[0] == "one");
+	CHECK(strings_copy[1] == "three");
+}
+
+// Scalar references for the vectorized String code paths.
+static int _find_scalar(const String &p_string, const String &p_what, int p_from) {
+	for (int i = p_from; i <= p_string.length() - p_what.length(); i++) {
+		int j = 0;
+		while (j < p_what.length() && p_string[i + j] == p_what[j]) {
+			j++;
+		}
+		if (j == p_what.length()) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+static uint32_t _hash_scalar(const String &p_string) {
+	uint32_t hashv = 5381;
+	for (int i = 0; i < p_string.length(); i++) {
+		hashv = ((hashv << 5) + hashv) + p_string[i];
+	}
+	return hashv;
+}
+
+// Mostly ASCII text with a few accented, CJK and astral characters sprinkled in.
+static String _make_test_text(int p_length, int p_seed) {
+	const char32_t unicode[] = { 0xe9, 0x436, 0x4e2d, 0x1f600 };
+	String text;
+	text.resize(p_length + 1);
+	char32_t *dst = text.ptrw();
+	uint32_t state = p_seed * 2654435761u + 1;
+	for (int i = 0; i < p_length; i++) {
+		state = state * 1103515245u + 12345u;
+		uint32_t r = (state >> 16) & 0x7fff;
+		dst[i] = (r % 23 == 0) ? unicode[r % 4] : char32_t('a' + r % 4);
+	}
+	dst[p_length] = 0;
+	return text;
+}
+
+TEST_CASE("[String] Vectorized search, hashing and conversion match the scalar code") {
+	for (int length = 0; length < 80; length++) {
+		const String text = _make_test_text(length, length);
+
+		CHECK(text.hash() == _hash_scalar(text));
+		CHECK(text.hash() == String::hash(text.get_data(), text.length()));
+		const CharString utf8 = text.utf8();
+		CHECK(String::utf8(utf8.get_data()) == text);
+		CHECK(String::utf8(utf8.get_data(), utf8.length()) == text);
+		CHECK(String::hash(utf8.get_data()) == String::hash(utf8.get_data(), utf8.length()));
+
+		String upper = text.to_upper();
+		for (int i = 0; i < text.length(); i++) {
+			const char32_t c = text[i];
+			if (c >= 'a' && c <= 'z') {
+				CHECK(upper[i] == c - ('a' - 'A'));
+			} else if (c < 128) {
+				CHECK(upper[i] == c);
+			}
+		}
+		CHECK(upper.to_lower() == text);
+
+		for (int key_length = 1; key_length <= 5; key_length++) {
+			for (int from = 0; from <= length; from += 3) {
+				const String key = _make_test_text(key_length, length * 7 + key_length);
+				CHECK(text.find(key, from) == _find_scalar(text, key, from));
+				if (length >= key_length) {
+					const String present = text.substr(length - key_length, key_length);
+					CHECK(text.find(present, from) == _find_scalar(text, present, from));
+				}
+			}
+		}
+	}
+}
+
+// Run with `godot --test string-benchmark`.
+static void benchmark() {
+	const int iterations = 2000;
+	const String text = _make_test_text(4096, 0) + "needle";
+	const String key = "needle";
+	uint64_t checksum = 0;
+
+	const uint64_t find_scalar_usec = benchmark_usec(iterations, [&]() { checksum += _find_scalar(text, key, 0); });
+	const uint64_t find_usec = benchmark_usec(iterations, [&]() { checksum += text.find(key); });
+	const uint64_t hash_scalar_usec = benchmark_usec(iterations, [&]() { checksum += _hash_scalar(text); });
+	const uint64_t hash_usec = benchmark_usec(iterations, [&]() { checksum += text.hash(); });
+
+	// UTF-8 conversion has no scalar reference left, time the round trip of ASCII text, which takes the block path.
+	const String ascii = String("The quick brown fox jumps over the lazy dog. ").repeat(100);
+	const CharString ascii_utf8 = ascii.utf8();
+	const uint64_t utf8_usec = benchmark_usec(iterations, [&]() { checksum += String::utf8(ascii_utf8.get_data(), ascii_utf8.length()).utf8().length(); });
+
+	print_line(vformat("String of %d characters, %d iterations (checksum %d):", text.length(), iterations, checksum));
+	print_benchmark("find", find_scalar_usec, find_usec);
+	print_benchmark("hash", hash_scalar_usec, hash_usec);
+	print_line(vformat("  utf8 round trip of %d ASCII characters: %d usec", ascii.length(), utf8_usec));
+}
+
+REGISTER_TEST_COMMAND("string-benchmark", &benchmark);
+
 } // namespace TestString
 
 #endif // TEST_STRING_H
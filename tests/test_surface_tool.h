@@ -0,0 +1,123 @@
+/*************************************************************************/
+/*  test_surface_tool.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef TEST_SURFACE_TOOL_H
+#define TEST_SURFACE_TOOL_H
+
+#include "scene/resources/surface_tool.h"
+
+#include "thirdparty/doctest/doctest.h"
+
+namespace TestSurfaceTool {
+
+// A grid of quads, two triangles each, sharing the vertices between neighbors.
+static void _add_grid(SurfaceTool *p_st, int p_size) {
+	for (int y = 0; y < p_size; y++) {
+		for (int x = 0; x < p_size; x++) {
+			const Vector3 a(x, (x * y) % 3, y);
+			const Vector3 b(x + 1, ((x + 1) * y) % 3, y);
+			const Vector3 c(x, (x * (y + 1)) % 3, y + 1);
+			const Vector3 d(x + 1, ((x + 1) * (y + 1)) % 3, y + 1);
+			p_st->add_vertex(a);
+			p_st->add_vertex(b);
+			p_st->add_vertex(c);
+			p_st->add_vertex(b);
+			p_st->add_vertex(d);
+			p_st->add_vertex(c);
+		}
+	}
+}
+
+TEST_CASE("[SurfaceTool] Indexing shares equal vertices") {
+	Ref<SurfaceTool> st = memnew(SurfaceTool);
+	st->begin(Mesh::PRIMITIVE_TRIANGLES);
+	_add_grid(st.ptr(), 8);
+	CHECK(st->get_vertex_array().size() == 8 * 8 * 6);
+
+	Array flat = st->commit_to_arrays();
+	st->index();
+	CHECK_MESSAGE(
+			st->get_vertex_array().size() == 9 * 9,
+			"Indexing should leave one vertex per grid point.");
+
+	Array indexed = st->commit_to_arrays();
+	Vector<int> indices = indexed[Mesh::ARRAY_INDEX];
+	Vector<Vector3> vertices = indexed[Mesh::ARRAY_VERTEX];
+	Vector<Vector3> flat_vertices = flat[Mesh::ARRAY_VERTEX];
+	CHECK(indices.size() == flat_vertices.size());
+	for (int i = 0; i < indices.size(); i++) {
+		CHECK(vertices[indices[i]] == flat_vertices[i]);
+	}
+
+	st->deindex();
+	Array deindexed = st->commit_to_arrays();
+	CHECK(Vector<Vector3>(deindexed[Mesh::ARRAY_VERTEX]) == flat_vertices);
+}
+
+TEST_CASE("[SurfaceTool] Normal generation with smooth groups") {
+	Ref<SurfaceTool> st = memnew(SurfaceTool);
+	st->begin(Mesh::PRIMITIVE_TRIANGLES);
+
+	// Two triangles folded along a shared edge, smooth and then flat.
+	for (int group = 0; group < 2; group++) {
+		st->add_smooth_group(group == 0);
+		st->add_vertex(Vector3(0, 0, 0));
+		st->add_vertex(Vector3(1, 0, 0));
+		st->add_vertex(Vector3(0, 0, 1));
+		st->add_vertex(Vector3(1, 0, 0));
+		st->add_vertex(Vector3(1, 1, 1));
+		st->add_vertex(Vector3(0, 0, 1));
+	}
+	st->generate_normals();
+
+	Array arrays = st->commit_to_arrays();
+	Vector<Vector3> normals = arrays[Mesh::ARRAY_NORMAL];
+	REQUIRE(normals.size() == 12);
+
+	const Vector3 flat_a = Plane(Vector3(0, 0, 0), Vector3(1, 0, 0), Vector3(0, 0, 1)).normal;
+	const Vector3 flat_b = Plane(Vector3(1, 0, 0), Vector3(1, 1, 1), Vector3(0, 0, 1)).normal;
+	const Vector3 shared = (flat_a + flat_b).normalized();
+
+	// The shared edge is averaged in the smooth group.
+	CHECK(normals[0].is_equal_approx(flat_a));
+	CHECK(normals[1].is_equal_approx(shared));
+	CHECK(normals[2].is_equal_approx(shared));
+	CHECK(normals[3].is_equal_approx(shared));
+	CHECK(normals[4].is_equal_approx(flat_b));
+	CHECK(normals[5].is_equal_approx(shared));
+
+	for (int i = 6; i < 9; i++) {
+		CHECK(normals[i].is_equal_approx(flat_a));
+		CHECK(normals[i + 3].is_equal_approx(flat_b));
+	}
+}
+
+} // namespace TestSurfaceTool
+
+#endif // TEST_SURFACE_TOOL_H
@@ -0,0 +1,258 @@
+/*************************************************************************/
+/*  test_transform.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef TEST_TRANSFORM_H
+#define TEST_TRANSFORM_H
+
+#include "core/math/camera_matrix.h"
+#include "core/math/geometry_3d.h"
+#include "core/math/random_number_generator.h"
+#include "core/math/transform.h"
+#include "core/os/os.h"
+#include "core/string/print_string.h"
+
+#include "tests/test_macros.h"
+
+namespace TestTransform {
+
+static Transform _random_transform(RandomNumberGenerator &p_rng) {
+	Basis basis(Vector3(p_rng.randf_range(-1, 1), p_rng.randf_range(-1, 1), p_rng.randf_range(-1, 1)).normalized(), p_rng.randf_range(-Math_PI, Math_PI));
+	basis.scale(Vector3(p_rng.randf_range(0.5, 2), p_rng.randf_range(0.5, 2), p_rng.randf_range(0.5, 2)));
+	return Transform(basis, Vector3(p_rng.randf_range(-100, 100), p_rng.randf_range(-100, 100), p_rng.randf_range(-100, 100)));
+}
+
+TEST_CASE("[Transform] Batch transforms match the single versions") {
+	RandomNumberGenerator rng;
+	rng.set_seed(1234);
+	const Transform xform = _random_transform(rng);
+
+	// Odd count, so the last point is written without touching past the end of the array.
+	const int count = 37;
+	Vector3 points[count + 1];
+	Vector3 result[count + 1];
+	for (int i = 0; i < count; i++) {
+		points[i] = Vector3(rng.randf_range(-50, 50), rng.randf_range(-50, 50), rng.randf_range(-50, 50));
+	}
+	result[count] = Vector3(1, 2, 3);
+
+	xform.xform_array(points, result, count);
+	for (int i = 0; i < count; i++) {
+		CHECK(result[i].is_equal_approx(xform.xform(points[i])));
+	}
+	CHECK(result[count] == Vector3(1, 2, 3));
+
+	xform.basis.xform_array(points, result, count);
+	for (int i = 0; i < count; i++) {
+		CHECK(result[i].is_equal_approx(xform.basis.xform(points[i])));
+	}
+
+	// In place.
+	Vector3 in_place[count];
+	for (int i = 0; i < count; i++) {
+		in_place[i] = points[i];
+	}
+	xform.xform_array(in_place, in_place, count);
+	for (int i = 0; i < count; i++) {
+		CHECK(in_place[i].is_equal_approx(xform.xform(points[i])));
+	}
+
+	Transform transforms[count];
+	Transform composed[count];
+	for (int i = 0; i < count; i++) {
+		transforms[i] = _random_transform(rng);
+	}
+	xform.xform_array(transforms, composed, count);
+	for (int i = 0; i < count; i++) {
+		CHECK(composed[i].is_equal_approx(xform * transforms[i]));
+	}
+
+	// In place.
+	xform.xform_array(transforms, transforms, count);
+	for (int i = 0; i < count; i++) {
+		CHECK(transforms[i].is_equal_approx(composed[i]));
+	}
+}
+
+TEST_CASE("[AABB] Batch convex shape test matches the single version") {
+	RandomNumberGenerator rng;
+	rng.set_seed(4321);
+
+	CameraMatrix projection;
+	projection.set_perspective(70, 1.5, 0.5, 100);
+	const Vector<Plane> planes = projection.get_projection_planes(Transform(Basis(Vector3(0, 1, 0), 0.3), Vector3(10, -5, 20)));
+	const Vector<Vector3> points = Geometry3D::compute_convex_mesh_points(planes.ptr(), planes.size());
+
+	const int count = 203;
+	AABB aabbs[count];
+	bool results[count];
+	int expected_count = 0;
+	for (int i = 0; i < count; i++) {
+		aabbs[i] = AABB(Vector3(rng.randf_range(-150, 150), rng.randf_range(-150, 150), rng.randf_range(-150, 150)), Vector3(rng.randf_range(0, 30), rng.randf_range(0, 30), rng.randf_range(0, 30)));
+		expected_count += aabbs[i].intersects_convex_shape(planes.ptr(), planes.size(), points.ptr(), points.size());
+	}
+
+	CHECK(AABB::intersects_convex_shape_array(aabbs, count, planes.ptr(), planes.size(), points.ptr(), points.size(), results) == expected_count);
+	for (int i = 0; i < count; i++) {
+		CHECK(results[i] == aabbs[i].intersects_convex_shape(planes.ptr(), planes.size(), points.ptr(), points.size()));
+	}
+	CHECK_MESSAGE(expected_count > 0, "Some of the boxes should be inside the frustum.");
+	CHECK_MESSAGE(expected_count < count, "Some of the boxes should be outside the frustum.");
+
+	CHECK(AABB::intersects_convex_shape_array(aabbs, count, planes.ptr(), planes.size(), nullptr, 0, results) == 0);
+}
+
+TEST_CASE("[AABB] Batch transformed merge matches merging the single transforms") {
+	RandomNumberGenerator rng;
+	rng.set_seed(5678);
+
+	// Not a multiple of four, and padded like multimesh data with colors.
+	const int count = 23;
+	const int stride = 16;
+	AABB aabbs[count];
+	Transform xforms[count];
+	float data[count * stride];
+	for (int i = 0; i < count; i++) {
+		aabbs[i] = AABB(Vector3(rng.randf_range(-10, 10), rng.randf_range(-10, 10), rng.randf_range(-10, 10)), Vector3(rng.randf_range(0, 5), rng.randf_range(0, 5), rng.randf_range(0, 5)));
+		xforms[i] = _random_transform(rng);
+		for (int r = 0; r < 3; r++) {
+			for (int k = 0; k < 3; k++) {
+				data[i * stride + r * 4 + k] = xforms[i].basis.elements[r][k];
+			}
+			data[i * stride + r * 4 + 3] = xforms[i].origin[r];
+		}
+	}
+
+	AABB expected = xforms[0].xform(aabbs[0]);
+	AABB expected_same = expected;
+	for (int i = 1; i < count; i++) {
+		expected.merge_with(xforms[i].xform(aabbs[i]));
+		expected_same.merge_with(xforms[i].xform(aabbs[0]));
+	}
+
+	CHECK(AABB::merge_transformed_array(aabbs, 1, data, stride, count).is_equal_approx(expected));
+	CHECK_MESSAGE(
+			AABB::merge_transformed_array(aabbs, 0, data, stride, count).is_equal_approx(expected_same),
+			"A box stride of 0 should transform the same box every time.");
+	CHECK(AABB::merge_transformed_array(aabbs, 1, data, stride, 3).is_equal_approx(xforms[0].xform(aabbs[0]).merge(xforms[1].xform(aabbs[1])).merge(xforms[2].xform(aabbs[2]))));
+	CHECK(AABB::merge_transformed_array(aabbs, 1, data, stride, 0) == AABB());
+}
+
+// Run with `godot --test transform-benchmark`.
+static void benchmark() {
+	const int iterations = 200;
+	const int count = 10000;
+
+	RandomNumberGenerator rng;
+	const Transform xform = _random_transform(rng);
+	Vector<Vector3> points;
+	points.resize(count);
+	for (int i = 0; i < count; i++) {
+		points.write[i] = Vector3(rng.randf_range(-50, 50), rng.randf_range(-50, 50), rng.randf_range(-50, 50));
+	}
+	Vector<Vector3> result;
+	result.resize(count);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		const Vector3 *r = points.ptr();
+		Vector3 *w = result.ptrw();
+		for (int j = 0; j < count; j++) {
+			w[j] = xform.xform(r[j]);
+		}
+	}
+	uint64_t single_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		xform.xform_array(points.ptr(), result.ptrw(), count);
+	}
+	uint64_t batch_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	Vector<Transform> transforms;
+	transforms.resize(count);
+	for (int i = 0; i < count; i++) {
+		transforms.write[i] = _random_transform(rng);
+	}
+	Vector<Transform> composed;
+	composed.resize(count);
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		const Transform *r = transforms.ptr();
+		Transform *w = composed.ptrw();
+		for (int j = 0; j < count; j++) {
+			w[j] = xform * r[j];
+		}
+	}
+	uint64_t compose_single_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		xform.xform_array(transforms.ptr(), composed.ptrw(), count);
+	}
+	uint64_t compose_batch_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	CameraMatrix projection;
+	projection.set_perspective(70, 1.5, 0.5, 100);
+	const Vector<Plane> planes = projection.get_projection_planes(Transform());
+	const Vector<Vector3> frustum_points = Geometry3D::compute_convex_mesh_points(planes.ptr(), planes.size());
+	Vector<AABB> aabbs;
+	aabbs.resize(count);
+	for (int i = 0; i < count; i++) {
+		aabbs.write[i] = AABB(points[i] * 3, Vector3(2, 2, 2));
+	}
+	bool *results = memnew_arr(bool, count);
+	uint64_t checksum = 0;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		for (int j = 0; j < count; j++) {
+			checksum += aabbs[j].intersects_convex_shape(planes.ptr(), planes.size(), frustum_points.ptr(), frustum_points.size());
+		}
+	}
+	uint64_t cull_single_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		checksum += AABB::intersects_convex_shape_array(aabbs.ptr(), count, planes.ptr(), planes.size(), frustum_points.ptr(), frustum_points.size(), results);
+	}
+	uint64_t cull_batch_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	memdelete_arr(results);
+
+	print_line(vformat("%d iterations over %d elements (checksum %d):", iterations, count, checksum));
+	print_line(vformat("  point transform: single %d usec, batch %d usec (%.2fx)", single_usec, batch_usec, double(single_usec) / MAX(batch_usec, (uint64_t)1)));
+	print_line(vformat("  transform composition: single %d usec, batch %d usec (%.2fx)", compose_single_usec, compose_batch_usec, double(compose_single_usec) / MAX(compose_batch_usec, (uint64_t)1)));
+	print_line(vformat("  frustum test: single %d usec, batch %d usec (%.2fx)", cull_single_usec, cull_batch_usec, double(cull_single_usec) / MAX(cull_batch_usec, (uint64_t)1)));
+}
+
+REGISTER_TEST_COMMAND("transform-benchmark", &benchmark);
+
+} // namespace TestTransform
+
+#endif // TEST_TRANSFORM_H
@@ -51,6 +51,11 @@ public:
 	virtual int set_option(ENetSocketOption p_option, int p_value) = 0;
 	virtual void close() = 0;
 	virtual void set_refuse_new_connections(bool p_enable) {} /* Only used by dtls server */
+	/* Waits until data may be available, or the timeout (in msec) expires. */
+	virtual Error wait(int p_timeout) {
+		OS::get_singleton()->delay_usec(p_timeout * 1000);
+		return OK;
+	}
 	virtual ~ENetGodotSocket() {}
 };
 
@@ -98,6 +103,10 @@ public:
 		return sock->recvfrom(p_buffer, p_len, r_read, r_ip, r_port);
 	}
 
+	Error wait(int p_timeout) {
+		return sock->poll(NetSocket::POLL_TYPE_IN, p_timeout);
+	}
+
 	int set_option(ENetSocketOption p_option, int p_value) {
 		switch (p_option) {
 			case ENET_SOCKOPT_NONBLOCK: {
@@ -493,9 +502,23 @@ int enet_socket_receive(ENetSocket socket, ENetAddress *address, ENetBuffer *buf
 	return read;
 }
 
-// Not implemented
 int enet_socket_wait(ENetSocket socket, enet_uint32 *condition, enet_uint32 timeout) {
-	return 0; // do we need this function?
+	ENetGodotSocket *sock = (ENetGodotSocket *)socket;
+
+	if (!(*condition & ENET_SOCKET_WAIT_RECEIVE)) {
+		// Sending never blocks.
+		return 0;
+	}
+
+	Error err = sock->wait(timeout);
+	if (err == OK) {
+		*condition = ENET_SOCKET_WAIT_RECEIVE;
+	} else if (err == ERR_BUSY) {
+		*condition = ENET_SOCKET_WAIT_NONE;
+	} else {
+		return -1;
+	}
+	return 0;
 }
 
 int enet_socket_get_address(ENetSocket socket, ENetAddress *address) {